@@ -3,6 +3,7 @@
 #include "RA_BuildVer.h"
 #include "RA_Defs.h"
 #include "RA_Log.h"
+#include "RA_MemManager.h"
 #include "RA_Resource.h"
 
 #include "api\Login.hh"
@@ -11,6 +12,7 @@
 #include "data\EmulatorContext.hh"
 #include "data\GameContext.hh"
 #include "data\SessionTracker.hh"
+#include "data\SubmissionJournal.hh"
 #include "data\UserContext.hh"
 
 #include "services\AchievementRuntime.hh"
@@ -18,6 +20,8 @@
 #include "services\Http.hh"
 #include "services\IAudioSystem.hh"
 #include "services\IConfiguration.hh"
+#include "services\IFileSystem.hh"
+#include "services\MemoryTrace.hh"
 #include "services\ServiceLocator.hh"
 
 #include "ui\drawing\gdi\GDISurface.hh"
@@ -30,6 +34,7 @@
 #include "RA_Dlg_Achievement.h"
 #include "RA_Dlg_AchEditor.h"
 #include "RA_Dlg_GameLibrary.h"
+#include "RA_Dlg_MemBookmark.h"
 #include "RA_Dlg_Memory.h"
 #endif
 
@@ -85,6 +90,9 @@ static void HandleLoginResponse(const ra::api::Login::Response& response)
         auto& pSessionTracker = ra::services::ServiceLocator::GetMutable<ra::data::SessionTracker>();
         pSessionTracker.Initialize(response.Username);
 
+        // resubmit any unlocks the server didn't respond to last time
+        ra::services::ServiceLocator::GetMutable<ra::data::SubmissionJournal>().Initialize(response.Username);
+
         // show the welcome message
         ra::services::ServiceLocator::Get<ra::services::IAudioSystem>().PlayAudioFile(L"Overlay\\login.wav");
 
@@ -220,162 +228,338 @@ API void _RA_RenderOverlay(HDC hDC, const RECT* rcSize)
 }
 #endif
 
-static void ProcessAchievements()
+API int CCONV _RA_CaptureState(char* pBuffer, int nBufferSize)
 {
-    auto& pRuntime = ra::services::ServiceLocator::GetMutable<ra::services::AchievementRuntime>();
-    if (pRuntime.IsPaused())
+    const auto& pRuntime = ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>();
+    const auto nSize = pRuntime.GetStateSize();
+
+    if (pBuffer != nullptr && nBufferSize > 0 && ra::to_unsigned(nBufferSize) >= nSize)
+        pRuntime.CaptureState(reinterpret_cast<unsigned char*>(pBuffer), ra::to_unsigned(nBufferSize));
+
+    return gsl::narrow_cast<int>(nSize);
+}
+
+API void CCONV _RA_RestoreState(const char* pBuffer, int nBufferSize)
+{
+    if (pBuffer == nullptr || nBufferSize <= 0)
         return;
 
-#ifndef RA_UTEST
-    {
-        auto* pEditingAchievement = g_AchievementEditorDialog.ActiveAchievement();
-        if (pEditingAchievement && pEditingAchievement->Active())
-            pEditingAchievement->SetDirtyFlag(Achievement::DirtyFlags::Conditions);
-    }
-#endif
+    auto& pRuntime = ra::services::ServiceLocator::GetMutable<ra::services::AchievementRuntime>();
+    pRuntime.RestoreState(reinterpret_cast<const unsigned char*>(pBuffer), ra::to_unsigned(nBufferSize));
+}
 
+static void HandleRuntimeChange(const ra::services::AchievementRuntime::Change& pChange)
+{
     const auto& pGameContext = ra::services::ServiceLocator::Get<ra::data::GameContext>();
 
-    std::vector<ra::services::AchievementRuntime::Change> vChanges;
-    pRuntime.Process(vChanges);
-
-    for (const auto& pChange : vChanges)
+    switch (pChange.nType)
     {
-        switch (pChange.nType)
+        case ra::services::AchievementRuntime::ChangeType::AchievementReset:
         {
-            case ra::services::AchievementRuntime::ChangeType::AchievementReset:
+            // we only watch for AchievementReset if PauseOnReset is set, so handle that now.
+            ra::services::ServiceLocator::Get<ra::data::EmulatorContext>().Pause();
+            const auto* pAchievement = pGameContext.FindAchievement(pChange.nId);
+            if (pAchievement)
             {
-                // we only watch for AchievementReset if PauseOnReset is set, so handle that now.
-                ra::services::ServiceLocator::Get<ra::data::EmulatorContext>().Pause();
-                const auto* pAchievement = pGameContext.FindAchievement(pChange.nId);
-                if (pAchievement)
-                {
-                    std::wstring sMessage = ra::StringPrintf(L"Pause on Reset: %s", pAchievement->Title());
-                    ra::ui::viewmodels::MessageBoxViewModel::ShowMessage(sMessage);
-                }
-                break;
+                std::wstring sMessage = ra::StringPrintf(L"Pause on Reset: %s", pAchievement->Title());
+                ra::ui::viewmodels::MessageBoxViewModel::ShowMessage(sMessage);
             }
+            break;
+        }
 
-            case ra::services::AchievementRuntime::ChangeType::AchievementTriggered:
-            {
-                pGameContext.AwardAchievement(pChange.nId);
+        case ra::services::AchievementRuntime::ChangeType::AchievementTriggered:
+        {
+            pGameContext.AwardAchievement(pChange.nId);
 
 #pragma warning(push)
 #pragma warning(disable : 26462)
-                auto* pAchievement = pGameContext.FindAchievement(pChange.nId);
+            auto* pAchievement = pGameContext.FindAchievement(pChange.nId);
 #pragma warning(pop)
-                if (!pAchievement)
-                    break;
+            if (!pAchievement)
+                break;
 
-                if (pGameContext.HasRichPresence())
-                    pAchievement->SetUnlockRichPresence(pGameContext.GetRichPresenceDisplayString());
+            if (pGameContext.HasRichPresence())
+                pAchievement->SetUnlockRichPresence(pGameContext.GetRichPresenceDisplayString());
 
 #ifndef RA_UTEST
-                //	Reverse find where I am in the list:
-                unsigned int nOffset = 0;
-                for (nOffset = 0; nOffset < g_pActiveAchievements->NumAchievements(); ++nOffset)
-                {
-                    if (pAchievement == &g_pActiveAchievements->GetAchievement(nOffset))
-                        break;
-                }
+            //	Reverse find where I am in the list:
+            unsigned int nOffset = 0;
+            for (nOffset = 0; nOffset < g_pActiveAchievements->NumAchievements(); ++nOffset)
+            {
+                if (pAchievement == &g_pActiveAchievements->GetAchievement(nOffset))
+                    break;
+            }
 
-                ASSERT(nOffset < g_pActiveAchievements->NumAchievements());
-                if (nOffset < g_pActiveAchievements->NumAchievements())
-                {
-                    g_AchievementsDialog.ReloadLBXData(nOffset);
+            ASSERT(nOffset < g_pActiveAchievements->NumAchievements());
+            if (nOffset < g_pActiveAchievements->NumAchievements())
+            {
+                g_AchievementsDialog.ReloadLBXData(nOffset);
 
-                    if (g_AchievementEditorDialog.ActiveAchievement() == pAchievement)
-                        g_AchievementEditorDialog.LoadAchievement(pAchievement, TRUE);
-                }
+                if (g_AchievementEditorDialog.ActiveAchievement() == pAchievement)
+                    g_AchievementEditorDialog.LoadAchievement(pAchievement, TRUE);
+            }
 #endif
 
-                if (pAchievement->GetPauseOnTrigger())
+            if (pAchievement->GetPauseOnTrigger())
+            {
+                ra::services::ServiceLocator::Get<ra::data::EmulatorContext>().Pause();
+                std::wstring sMessage = ra::StringPrintf(L"Pause on Trigger: %s", pAchievement->Title());
+                ra::ui::viewmodels::MessageBoxViewModel::ShowMessage(sMessage);
+            }
+
+            break;
+        }
+
+        case ra::services::AchievementRuntime::ChangeType::LeaderboardStarted:
+        {
+            const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
+            if (pLeaderboard)
+            {
+                const auto& pConfiguration = ra::services::ServiceLocator::Get<ra::services::IConfiguration>();
+                if (pConfiguration.IsFeatureEnabled(ra::services::Feature::LeaderboardNotifications))
                 {
-                    ra::services::ServiceLocator::Get<ra::data::EmulatorContext>().Pause();
-                    std::wstring sMessage = ra::StringPrintf(L"Pause on Trigger: %s", pAchievement->Title());
-                    ra::ui::viewmodels::MessageBoxViewModel::ShowMessage(sMessage);
+                    ra::services::ServiceLocator::Get<ra::services::IAudioSystem>().PlayAudioFile(L"Overlay\\lb.wav");
+                    ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>().QueueMessage(
+                        L"Leaderboard Attempt Started", ra::Widen(pLeaderboard->Title()), ra::Widen(pLeaderboard->Description()));
                 }
 
-                break;
+                auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
+                auto& pScoreTracker = pOverlayManager.AddScoreTracker(pLeaderboard->ID());
+                const auto sDisplayText = pLeaderboard->FormatScore(pChange.nValue);
+                pScoreTracker.SetDisplayText(ra::Widen(sDisplayText));
             }
 
-            case ra::services::AchievementRuntime::ChangeType::LeaderboardStarted:
+            break;
+        }
+
+        case ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated:
+        {
+            const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
+            if (pLeaderboard)
             {
-                const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
-                if (pLeaderboard)
+                auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
+                auto* pScoreTracker = pOverlayManager.GetScoreTracker(pChange.nId);
+                if (pScoreTracker != nullptr)
                 {
-                    const auto& pConfiguration = ra::services::ServiceLocator::Get<ra::services::IConfiguration>();
-                    if (pConfiguration.IsFeatureEnabled(ra::services::Feature::LeaderboardNotifications))
-                    {
-                        ra::services::ServiceLocator::Get<ra::services::IAudioSystem>().PlayAudioFile(L"Overlay\\lb.wav");
-                        ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>().QueueMessage(
-                            L"Leaderboard Attempt Started", ra::Widen(pLeaderboard->Title()), ra::Widen(pLeaderboard->Description()));
-                    }
-
-                    auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
-                    auto& pScoreTracker = pOverlayManager.AddScoreTracker(pLeaderboard->ID());
                     const auto sDisplayText = pLeaderboard->FormatScore(pChange.nValue);
-                    pScoreTracker.SetDisplayText(ra::Widen(sDisplayText));
+                    pScoreTracker->SetDisplayText(ra::Widen(sDisplayText));
                 }
-
-                break;
             }
 
-            case ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated:
+            break;
+        }
+
+        case ra::services::AchievementRuntime::ChangeType::LeaderboardCanceled:
+        {
+            const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
+            if (pLeaderboard)
             {
-                const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
-                if (pLeaderboard)
+                const auto& pConfiguration = ra::services::ServiceLocator::Get<ra::services::IConfiguration>();
+                if (pConfiguration.IsFeatureEnabled(ra::services::Feature::LeaderboardCancelNotifications))
                 {
-                    auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
-                    auto* pScoreTracker = pOverlayManager.GetScoreTracker(pChange.nId);
-                    if (pScoreTracker != nullptr)
-                    {
-                        const auto sDisplayText = pLeaderboard->FormatScore(pChange.nValue);
-                        pScoreTracker->SetDisplayText(ra::Widen(sDisplayText));
-                    }
+                    ra::services::ServiceLocator::Get<ra::services::IAudioSystem>().PlayAudioFile(L"Overlay\\lbcancel.wav");
+                    ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>().QueueMessage(
+                        L"Leaderboard Attempt Canceled", ra::Widen(pLeaderboard->Title()), ra::Widen(pLeaderboard->Description()));
                 }
 
-                break;
+                auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
+                pOverlayManager.RemoveScoreTracker(pLeaderboard->ID());
             }
 
-            case ra::services::AchievementRuntime::ChangeType::LeaderboardCanceled:
-            {
-                const auto* pLeaderboard = pGameContext.FindLeaderboard(pChange.nId);
-                if (pLeaderboard)
+            break;
+        }
+
+        case ra::services::AchievementRuntime::ChangeType::LeaderboardTriggered:
+        {
+            pGameContext.SubmitLeaderboardEntry(pChange.nId, pChange.nValue); // will show the scoreboard when submission completes
+
+            auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
+            pOverlayManager.RemoveScoreTracker(pChange.nId);
+            break;
+        }
+    }
+}
+
+// LeaderboardUpdated changes only affect the score trackers, so while frames are being batched only the most
+// recent value for each leaderboard is kept. They're dispatched by the next non-batched frame.
+static std::vector<ra::services::AchievementRuntime::Change> s_vDeferredChanges;
+
+static void DeferLeaderboardUpdate(const ra::services::AchievementRuntime::Change& pChange)
+{
+    for (auto& pDeferredChange : s_vDeferredChanges)
+    {
+        if (pDeferredChange.nId == pChange.nId)
+        {
+            pDeferredChange.nValue = pChange.nValue;
+            return;
+        }
+    }
+
+    s_vDeferredChanges.push_back(pChange);
+}
+
+static void DiscardDeferredLeaderboardUpdate(unsigned int nId) noexcept
+{
+    for (auto pIter = s_vDeferredChanges.begin(); pIter != s_vDeferredChanges.end(); ++pIter)
+    {
+        if (pIter->nId == nId)
+        {
+            s_vDeferredChanges.erase(pIter);
+            break;
+        }
+    }
+}
+
+static std::unique_ptr<ra::services::TextWriter> s_pMemoryTraceFile;
+static std::unique_ptr<ra::services::MemoryTraceWriter> s_pMemoryTrace;
+static unsigned int s_nMemoryTraceActivations = 0;
+
+static void RecordMemoryTraceFrame(const ra::services::AchievementRuntime& pRuntime)
+{
+    // only rebuild the captured regions when something new has been activated. deactivated entries just
+    // leave a few extra bytes in the capture.
+    if (pRuntime.GetActivationCount() != s_nMemoryTraceActivations)
+    {
+        std::vector<const rc_memref_value_t*> vMemRefs;
+        pRuntime.GetMemRefs(vMemRefs);
+        s_pMemoryTrace->SetMemRefs(vMemRefs);
+
+        s_nMemoryTraceActivations = pRuntime.GetActivationCount();
+    }
+
+    s_pMemoryTrace->WriteFrame();
+}
+
+API int CCONV _RA_StartMemoryTrace(const char* sFilename)
+{
+    _RA_StopMemoryTrace();
+
+    if (sFilename == nullptr || *sFilename == '\0')
+        return 0;
+
+    const auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
+    s_pMemoryTraceFile = pFileSystem.CreateTextFile(ra::Widen(sFilename));
+    if (s_pMemoryTraceFile == nullptr)
+        return 0;
+
+    s_pMemoryTrace = std::make_unique<ra::services::MemoryTraceWriter>(*s_pMemoryTraceFile,
+        gsl::narrow<unsigned int>(g_MemManager.TotalBankSize()));
+
+    // force the regions to be calculated on the first frame
+    const auto& pRuntime = ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>();
+    s_nMemoryTraceActivations = pRuntime.GetActivationCount() - 1;
+
+    RA_LOG("Recording memory trace to %s", sFilename);
+    return 1;
+}
+
+API void CCONV _RA_StopMemoryTrace()
+{
+    if (s_pMemoryTrace != nullptr)
+    {
+        RA_LOG("Recorded %u frames to memory trace", s_pMemoryTrace->GetFrameCount());
+        s_pMemoryTrace.reset();
+    }
+
+    s_pMemoryTraceFile.reset();
+}
+
+// reused every frame to avoid allocating. the handlers can show UI that pumps messages and processes another frame,
+// so the buffer is swapped out while its changes are being dispatched.
+static std::vector<ra::services::AchievementRuntime::Change> s_vChanges;
+
+static void ProcessAchievements(bool bBatched)
+{
+    auto& pRuntime = ra::services::ServiceLocator::GetMutable<ra::services::AchievementRuntime>();
+    if (pRuntime.IsPaused())
+        return;
+
+    if (s_pMemoryTrace != nullptr)
+        RecordMemoryTraceFrame(pRuntime);
+
+#ifndef RA_UTEST
+    {
+        auto* pEditingAchievement = g_AchievementEditorDialog.ActiveAchievement();
+        if (pEditingAchievement && pEditingAchievement->Active())
+            pEditingAchievement->SetDirtyFlag(Achievement::DirtyFlags::Conditions);
+    }
+#endif
+
+    std::vector<ra::services::AchievementRuntime::Change> vChanges;
+    vChanges.swap(s_vChanges);
+    vChanges.clear();
+    pRuntime.Process(vChanges);
+
+    for (const auto& pChange : vChanges)
+    {
+        switch (pChange.nType)
+        {
+            case ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated:
+                if (bBatched)
                 {
-                    const auto& pConfiguration = ra::services::ServiceLocator::Get<ra::services::IConfiguration>();
-                    if (pConfiguration.IsFeatureEnabled(ra::services::Feature::LeaderboardCancelNotifications))
-                    {
-                        ra::services::ServiceLocator::Get<ra::services::IAudioSystem>().PlayAudioFile(L"Overlay\\lbcancel.wav");
-                        ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>().QueueMessage(
-                            L"Leaderboard Attempt Canceled", ra::Widen(pLeaderboard->Title()), ra::Widen(pLeaderboard->Description()));
-                    }
-
-                    auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
-                    pOverlayManager.RemoveScoreTracker(pLeaderboard->ID());
+                    DeferLeaderboardUpdate(pChange);
+                    continue;
                 }
 
                 break;
-            }
 
+            case ra::services::AchievementRuntime::ChangeType::LeaderboardStarted:
+            case ra::services::AchievementRuntime::ChangeType::LeaderboardCanceled:
             case ra::services::AchievementRuntime::ChangeType::LeaderboardTriggered:
-            {
-                pGameContext.SubmitLeaderboardEntry(pChange.nId, pChange.nValue); // will show the scoreboard when submission completes
+                // a pending update would overwrite the score tracker state set by this change
+                if (!s_vDeferredChanges.empty())
+                    DiscardDeferredLeaderboardUpdate(pChange.nId);
 
-                auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
-                pOverlayManager.RemoveScoreTracker(pChange.nId);
                 break;
-            }
+
+            default:
+                break;
         }
+
+        HandleRuntimeChange(pChange);
+    }
+
+    // keep whichever buffer is larger for the next frame
+    if (vChanges.capacity() > s_vChanges.capacity())
+        s_vChanges.swap(vChanges);
+}
+
+static void FlushDeferredChanges()
+{
+    std::vector<ra::services::AchievementRuntime::Change> vChanges;
+    vChanges.swap(s_vDeferredChanges);
+
+    for (const auto& pChange : vChanges)
+        HandleRuntimeChange(pChange);
+
+    // changes deferred by a nested frame are kept for the next flush
+    if (s_vDeferredChanges.empty())
+    {
+        vChanges.clear();
+        s_vDeferredChanges.swap(vChanges);
     }
 }
 
 API void CCONV _RA_DoAchievementsFrame()
 {
-    ProcessAchievements();
+    // apply anything held back by batched frames before this frame's changes so newer values win
+    if (!s_vDeferredChanges.empty())
+        FlushDeferredChanges();
+
+    ProcessAchievements(false);
 
 #ifndef RA_UTEST
     // make sure we process the achievements _before_ the frozen bookmarks modify the memory
     g_MemoryDialog.Invalidate();
 #endif
 }
+
+API void CCONV _RA_DoAchievementsFrameBatched()
+{
+    ProcessAchievements(true);
+
+#ifndef RA_UTEST
+    // frozen bookmarks still have to be written every frame, but the viewers don't need to be repainted
+    g_MemBookmarkDialog.UpdateBookmarks(FALSE);
+#endif
+}
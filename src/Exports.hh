@@ -59,12 +59,31 @@ extern "C" {
     // Immediately after saving a new state.
     API void CCONV _RA_OnSaveState(const char* sFileName);
 
+    // Captures the achievement runtime state into pBuffer for rewind/run-ahead. Does not touch the file system.
+    // Returns the number of bytes required. Nothing is written if nBufferSize is smaller than that.
+    API int CCONV _RA_CaptureState(char* pBuffer, int nBufferSize);
+
+    // Restores the achievement runtime state from a buffer populated by _RA_CaptureState.
+    API void CCONV _RA_RestoreState(const char* pBuffer, int nBufferSize);
+
     // Immediately after resetting the system.
     API void CCONV _RA_OnReset();
 
     // Perform one test for all achievements in the current set. Call this once per frame/cycle.
     API void CCONV _RA_DoAchievementsFrame();
 
+    // Same as _RA_DoAchievementsFrame, but for frames that won't be rendered (fast-forward, run-ahead). Score tracker
+    // updates and memory viewer repaints are deferred until the next call to _RA_DoAchievementsFrame.
+    API void CCONV _RA_DoAchievementsFrameBatched();
+
+    // Starts recording the memory used by the loaded achievements and leaderboards to a trace file, one frame per
+    // call to _RA_DoAchievementsFrame or _RA_DoAchievementsFrameBatched. Returns 0 if no filename is provided or the
+    // file can't be created.
+    API int CCONV _RA_StartMemoryTrace(const char* sFilename);
+
+    // Stops the recording started by _RA_StartMemoryTrace.
+    API void CCONV _RA_StopMemoryTrace();
+
     // Use in special cases where the emulator contains more than one console ID.
     API void CCONV _RA_SetConsoleID(unsigned int nConsoleID);
 
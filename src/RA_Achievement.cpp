@@ -301,43 +301,59 @@ static void MakeConditionGroup(ConditionSet& vConditions, rc_condset_t* pCondSet
 
 void Achievement::ParseTrigger(const char* sTrigger)
 {
-    m_vConditions.Clear();
-
     const int nSize = rc_trigger_size(sTrigger);
     if (nSize < 0)
     {
         // parse error occurred
-        RA_LOG("rc_parse_trigger returned %d", nSize);
-        m_pTrigger = nullptr;
-
-        ra::ui::viewmodels::MessageBoxViewModel::ShowWarningMessage(
-            ra::StringPrintf(L"Unable to activate achievement: %s", Title()),
-            ra::StringPrintf(L"Parse error %d", nSize));
+        SetTriggerParseError(nSize);
     }
     else
     {
+        // the runtime has to stop referencing the old trigger before it's replaced
+        const bool bWasActive = m_bActive;
+        if (bWasActive)
+            SetActive(false);
+
         // allocate space and parse again
         m_pTriggerBuffer = std::make_shared<std::vector<unsigned char>>(nSize);
-        auto* pTrigger = rc_parse_trigger(m_pTriggerBuffer->data(), sTrigger, nullptr, 0);
-        m_pTrigger = pTrigger;
+        ParseTrigger(sTrigger, m_pTriggerBuffer->data());
 
-        if (m_bActive)
-        {
-            SetActive(false);
+        if (bWasActive)
             SetActive(true);
-        }
+    }
+}
 
-        // wrap rc_trigger_t in a ConditionSet for the UI
-        MakeConditionGroup(m_vConditions, pTrigger->requirement);
-        rc_condset_t* alternative = pTrigger->alternative;
-        while (alternative != nullptr)
-        {
-            MakeConditionGroup(m_vConditions, alternative);
-            alternative = alternative->next;
-        }
+void Achievement::ParseTrigger(const char* sTrigger, void* pBuffer)
+{
+    Expects(!m_bActive);
+
+    m_vConditions.Clear();
+
+    auto* pTrigger = rc_parse_trigger(pBuffer, sTrigger, nullptr, 0);
+    m_pTrigger = pTrigger;
+
+    // wrap rc_trigger_t in a ConditionSet for the UI
+    MakeConditionGroup(m_vConditions, pTrigger->requirement);
+    rc_condset_t* alternative = pTrigger->alternative;
+    while (alternative != nullptr)
+    {
+        MakeConditionGroup(m_vConditions, alternative);
+        alternative = alternative->next;
     }
 }
 
+void Achievement::SetTriggerParseError(int nError)
+{
+    m_vConditions.Clear();
+
+    RA_LOG("rc_parse_trigger returned %d", nError);
+    m_pTrigger = nullptr;
+
+    ra::ui::viewmodels::MessageBoxViewModel::ShowWarningMessage(
+        ra::StringPrintf(L"Unable to activate achievement: %s", Title()),
+        ra::StringPrintf(L"Parse error %d", nError));
+}
+
 static constexpr bool HasHitCounts(const rc_condset_t* pCondSet) noexcept
 {
     rc_condition_t* condition = pCondSet->conditions;
@@ -415,7 +431,12 @@ void Achievement::SetConditionHitCount(size_t nGroup, size_t nIndex, unsigned in
     rc_trigger_t* pTrigger = static_cast<rc_trigger_t*>(m_pTrigger);
     rc_condition_t* pCondition = GetTriggerCondition(pTrigger, nGroup, nIndex);
     if (pCondition)
+    {
         pCondition->current_hits = nCurrentHits;
+
+        if (m_bActive && ra::services::ServiceLocator::Exists<ra::services::AchievementRuntime>())
+            ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>().SyncHitCounts(ID());
+    }
 }
 
 void Achievement::AddAltGroup() noexcept { m_vConditions.AddGroup(); }
@@ -490,6 +511,9 @@ void Achievement::Reset() noexcept
         rc_trigger_t* pTrigger = static_cast<rc_trigger_t*>(m_pTrigger);
         rc_reset_trigger(pTrigger);
 
+        if (m_bActive && ra::services::ServiceLocator::Exists<ra::services::AchievementRuntime>())
+            ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>().SyncHitCounts(ID());
+
         SetDirtyFlag(DirtyFlags::Conditions);
     }
 }
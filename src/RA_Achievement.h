@@ -109,6 +109,17 @@ public:
 
     void ParseTrigger(const char* pTrigger);
 
+    /// <summary>
+    /// Parses a trigger into a caller-provided buffer of at least <c>rc_trigger_size</c> bytes. The achievement
+    /// must not be active.
+    /// </summary>
+    void ParseTrigger(const char* pTrigger, void* pBuffer);
+
+    /// <summary>
+    /// Clears the trigger and notifies the user that it could not be parsed.
+    /// </summary>
+    void SetTriggerParseError(int nError);
+
     // Used for rendering updates when editing achievements. Usually always false.
     _NODISCARD _CONSTANT_FN GetDirtyFlags() const noexcept { return m_nDirtyFlags; }
     _NODISCARD _CONSTANT_FN IsDirty() const noexcept { return (m_nDirtyFlags != DirtyFlags()); }
@@ -134,7 +145,7 @@ public:
 
 protected:
     void* m_pTrigger = nullptr;                                   // rc_trigger_t
-    std::shared_ptr<std::vector<unsigned char>> m_pTriggerBuffer; // buffer for rc_trigger_t
+    std::shared_ptr<std::vector<unsigned char>> m_pTriggerBuffer; // buffer for rc_trigger_t, if not parsed by LoadGame
 
 private:
     ra::AchievementID m_nAchievementID{};
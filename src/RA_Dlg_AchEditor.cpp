@@ -14,12 +14,14 @@
 #include "data\EmulatorContext.hh"
 #include "data\GameContext.hh"
 
+#include "services\AchievementRuntime.hh"
 #include "services\IConfiguration.hh"
 #include "services\ServiceLocator.hh"
 
 #include "ui\drawing\gdi\ImageRepository.hh"
 
 #include "ui\viewmodels\MessageBoxViewModel.hh"
+#include "ui\viewmodels\RuntimeTraceViewModel.hh"
 
 #include "ra_math.h"
 
@@ -910,6 +912,33 @@ INT_PTR Dlg_AchievementEditor::AchievementEditorProc(HWND hDlg, UINT uMsg, WPARA
                 }
                 break;
 
+                case IDC_RA_CHK_ACH_RECORD_HISTORY:
+                {
+                    if (ActiveAchievement() != nullptr)
+                    {
+                        // the history is written to RACache\Data\<id>-Trace.txt when the achievement triggers
+                        auto& pRuntime = ra::services::ServiceLocator::GetMutable<ra::services::AchievementRuntime>();
+                        const auto nId = ActiveAchievement()->ID();
+                        pRuntime.SetTraced(nId, !pRuntime.IsTraced(nId));
+                    }
+
+                    bHandled = TRUE;
+                }
+                break;
+
+                case IDC_RA_ACH_VIEW_HISTORY:
+                {
+                    if (ActiveAchievement() != nullptr)
+                    {
+                        ra::ui::viewmodels::RuntimeTraceViewModel vmRuntimeTrace;
+                        vmRuntimeTrace.Load(ActiveAchievement()->ID());
+                        vmRuntimeTrace.ShowModal();
+                    }
+
+                    bHandled = TRUE;
+                }
+                break;
+
                 case IDC_RA_BADGENAME:
                 {
                     switch (HIWORD(wParam))
@@ -2114,6 +2143,8 @@ void Dlg_AchievementEditor::LoadAchievement(Achievement* pCheevo, _UNUSED BOOL)
         CheckDlgButton(m_hAchievementEditorDlg, IDC_RA_CHK_ACH_PAUSE_ON_TRIGGER,
                        ActiveAchievement()->GetPauseOnTrigger());
         CheckDlgButton(m_hAchievementEditorDlg, IDC_RA_CHK_ACH_PAUSE_ON_RESET, ActiveAchievement()->GetPauseOnReset());
+        CheckDlgButton(m_hAchievementEditorDlg, IDC_RA_CHK_ACH_RECORD_HISTORY,
+                       ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>().IsTraced(ActiveAchievement()->ID()));
 
         if (m_pSelectedAchievement->Category() == ra::etoi(AchievementSet::Type::Local))
             SetDlgItemTextA(m_hAchievementEditorDlg, IDC_RA_ACH_ID, "0");
@@ -2293,6 +2324,7 @@ void GenerateResizes(HWND hDlg)
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_LBX_CONDITIONS), AlignType::BottomRight, true);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_ACH_GROUP), AlignType::Bottom, true);
 
+    vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_CHK_ACH_RECORD_HISTORY), AlignType::Right, false);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_CHK_ACH_PAUSE_ON_RESET), AlignType::Right, false);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_CHK_ACH_PAUSE_ON_TRIGGER), AlignType::Right, false);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_CHK_ACH_ACTIVE), AlignType::Right, false);
@@ -2306,6 +2338,7 @@ void GenerateResizes(HWND hDlg)
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_PASTECOND), AlignType::Bottom, false);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_MOVECONDUP), AlignType::Bottom, false);
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_MOVECONDDOWN), AlignType::Bottom, false);
+    vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDC_RA_ACH_VIEW_HISTORY), AlignType::Bottom, false);
 
     vDlgAchEditorResize.emplace_back(::GetDlgItem(hDlg, IDCLOSE), AlignType::BottomRight, false);
 }
@@ -594,10 +594,21 @@ void MemoryViewerControl::RenderMemViewer(HWND hTarget)
                 notes = 0;
                 bookmarks = 0;
                 freeze = 0;
-                for (int j = 0; j < 16; ++j)
+
+                // mark every byte covered by a note, including the tails of multi-byte notes
+                const auto nRowAddress = ra::to_unsigned(addr);
+                pGameContext.EnumerateCodeNotes(nRowAddress, nRowAddress + 15,
+                    [nRowAddress, &notes](ra::ByteAddress nAddress, unsigned int nSize)
                 {
-                    notes |= (pGameContext.FindCodeNote(addr + j) != nullptr) ? (1 << j) : 0;
+                    const auto nFirst = std::max(nAddress, nRowAddress) - nRowAddress;
+                    const auto nLast = std::min(nAddress + (nSize - 1), nRowAddress + 15) - nRowAddress;
+                    for (auto j = nFirst; j <= nLast; ++j)
+                        notes |= (1 << j);
+                    return true;
+                });
 
+                for (int j = 0; j < 16; ++j)
+                {
                     if (g_MemBookmarkDialog.BookmarkExists(addr + j))
                     {
                         const auto& bm = g_MemBookmarkDialog.FindBookmark(addr + j);
@@ -912,7 +923,8 @@ INT_PTR Dlg_Memory::MemoryProc(HWND hDlg, UINT nMsg, WPARAM wParam, LPARAM lPara
                         unsigned int nVal = 0;
                         UpdateSearchResult(result, nVal, sValue);
                         const auto& pGameContext = ra::services::ServiceLocator::Get<ra::data::GameContext>();
-                        const auto* pNote = pGameContext.FindCodeNote(result.nAddress);
+                        ra::ByteAddress nNoteAddress{};
+                        const auto* pNote = pGameContext.FindCodeNoteCovering(result.nAddress, nNoteAddress);
 
                         HBRUSH hBrush{};
                         COLORREF color{};
@@ -1575,10 +1587,22 @@ INT_PTR Dlg_Memory::MemoryProc(HWND hDlg, UINT nMsg, WPARAM wParam, LPARAM lPara
                         }
                         case CBN_EDITCHANGE:
                         {
-                            OnWatchingMemChange();
-
                             TCHAR sAddrBuffer[64];
                             GetDlgItemText(hDlg, IDC_RA_WATCHING, sAddrBuffer, 64);
+
+                            // anything that can't be an address narrows the list to the notes containing it
+                            const std::wstring sText = ra::Widen(sAddrBuffer);
+                            if (sText.find_first_not_of(L"0123456789abcdefABCDEFxX") != std::wstring::npos)
+                            {
+                                FilterCodeNotes(sText);
+                                return TRUE;
+                            }
+
+                            if (m_bCodeNotesFiltered)
+                                FilterCodeNotes(L"");
+
+                            OnWatchingMemChange();
+
                             auto nAddr = ra::ByteAddressFromString(ra::Narrow(sAddrBuffer));
                             MemoryViewerControl::setAddress(
                                 (nAddr & ~(0xf)) - (ra::to_signed(MemoryViewerControl::m_nDisplayedLines / 2) << 4) +
@@ -1647,6 +1671,41 @@ void Dlg_Memory::OnWatchingMemChange()
     Invalidate();
 }
 
+void Dlg_Memory::FilterCodeNotes(const std::wstring& sFilter)
+{
+    HWND hMemWatch = GetDlgItem(m_hWnd, IDC_RA_WATCHING);
+    if (hMemWatch == nullptr)
+        return;
+
+    // deleting the items leaves the text being typed alone
+    while (ComboBox_DeleteString(hMemWatch, 0) != CB_ERR)
+    {
+    }
+
+    const auto& pGameContext = ra::services::ServiceLocator::Get<ra::data::GameContext>();
+    if (sFilter.empty())
+    {
+        pGameContext.EnumerateCodeNotes([hMemWatch](ra::ByteAddress nAddress)
+        {
+            ComboBox_AddString(hMemWatch, NativeStr(ra::ByteAddressToString(nAddress)).c_str());
+            return true;
+        });
+
+        m_bCodeNotesFiltered = false;
+        return;
+    }
+
+    for (const auto nAddress : pGameContext.SearchCodeNotes(sFilter))
+        ComboBox_AddString(hMemWatch, NativeStr(ra::ByteAddressToString(nAddress)).c_str());
+
+    m_bCodeNotesFiltered = true;
+
+    // opening the list selects the text, put the caret back where the user was typing
+    ComboBox_ShowDropdown(hMemWatch, TRUE);
+    ComboBox_SetEditSel(hMemWatch, sFilter.length(), sFilter.length());
+    SetCursor(LoadCursor(nullptr, IDC_ARROW));
+}
+
 void Dlg_Memory::RepopulateCodeNotes()
 {
     HWND hMemWatch = GetDlgItem(g_MemoryDialog.m_hWnd, IDC_RA_WATCHING);
@@ -1676,6 +1735,7 @@ void Dlg_Memory::RepopulateCodeNotes()
     });
 
     // reset the combobox
+    m_bCodeNotesFiltered = false;
     SetDlgItemText(m_hWnd, IDC_RA_MEMSAVENOTE, TEXT(""));
     SetDlgItemText(hMemWatch, IDC_RA_WATCHING, TEXT(""));
     while (ComboBox_DeleteString(hMemWatch, 0) != CB_ERR)
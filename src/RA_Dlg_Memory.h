@@ -106,10 +106,12 @@ private:
 
     static void UpdateSearchResult(const ra::services::SearchResults::Result& result, _Out_ unsigned int& nMemVal, std::wstring& sBuffer);
     bool CompareSearchResult(unsigned int nCurVal, unsigned int nPrevVal);
+    void FilterCodeNotes(const std::wstring& sFilter);
 
     static HWND m_hWnd;
 
     unsigned int m_nCodeNotesGameId = 0;
+    bool m_bCodeNotesFiltered = false;
 
     unsigned int m_nStart = 0;
     unsigned int m_nEnd = 0;
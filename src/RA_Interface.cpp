@@ -25,9 +25,14 @@ void    (CCONV *_RA_InstallMemoryBank)(int nBankID, void* pReader, void* pWriter
 void    (CCONV *_RA_ClearMemoryBanks)() = nullptr;
 void    (CCONV *_RA_OnLoadState)(const char* sFilename) = nullptr;
 void    (CCONV *_RA_OnSaveState)(const char* sFilename) = nullptr;
+int     (CCONV *_RA_CaptureState)(char* pBuffer, int nBufferSize) = nullptr;
+void    (CCONV *_RA_RestoreState)(const char* pBuffer, int nBufferSize) = nullptr;
 void    (CCONV *_RA_OnReset)() = nullptr;
 //	Achievements:
 void    (CCONV *_RA_DoAchievementsFrame)() = nullptr;
+void    (CCONV *_RA_DoAchievementsFrameBatched)() = nullptr;
+int     (CCONV *_RA_StartMemoryTrace)(const char* sFilename) = nullptr;
+void    (CCONV *_RA_StopMemoryTrace)() = nullptr;
 //	User:
 void    (CCONV *_RA_AttemptLogin)(bool bBlocking) = nullptr;
 //	Tools:
@@ -160,6 +165,17 @@ void RA_OnSaveState(const char* sFilename)
         _RA_OnSaveState(sFilename);
 }
 
+int RA_CaptureState(char* pBuffer, int nBufferSize)
+{
+    return (_RA_CaptureState != nullptr) ? _RA_CaptureState(pBuffer, nBufferSize) : 0;
+}
+
+void RA_RestoreState(const char* pBuffer, int nBufferSize)
+{
+    if (_RA_RestoreState != nullptr)
+        _RA_RestoreState(pBuffer, nBufferSize);
+}
+
 void RA_OnReset()
 {
     if (_RA_OnReset != nullptr)
@@ -172,6 +188,25 @@ void RA_DoAchievementsFrame()
         _RA_DoAchievementsFrame();
 }
 
+void RA_DoAchievementsFrameBatched()
+{
+    if (_RA_DoAchievementsFrameBatched != nullptr)
+        _RA_DoAchievementsFrameBatched();
+    else if (_RA_DoAchievementsFrame != nullptr)
+        _RA_DoAchievementsFrame();
+}
+
+bool RA_StartMemoryTrace(const char* sFilename)
+{
+    return (_RA_StartMemoryTrace != nullptr) ? (_RA_StartMemoryTrace(sFilename) != 0) : false;
+}
+
+void RA_StopMemoryTrace()
+{
+    if (_RA_StopMemoryTrace != nullptr)
+        _RA_StopMemoryTrace();
+}
+
 void RA_SetConsoleID(unsigned int nConsoleID)
 {
     if (_RA_SetConsoleID != nullptr)
@@ -464,8 +499,13 @@ static const char* CCONV _RA_InstallIntegration()
     _RA_SetPaused = (void(CCONV *)(bool))                                             GetProcAddress(g_hRADLL, "_RA_SetPaused");
     _RA_OnLoadState = (void(CCONV *)(const char*))                                    GetProcAddress(g_hRADLL, "_RA_OnLoadState");
     _RA_OnSaveState = (void(CCONV *)(const char*))                                    GetProcAddress(g_hRADLL, "_RA_OnSaveState");
+    _RA_CaptureState = (int(CCONV *)(char*, int))                                     GetProcAddress(g_hRADLL, "_RA_CaptureState");
+    _RA_RestoreState = (void(CCONV *)(const char*, int))                              GetProcAddress(g_hRADLL, "_RA_RestoreState");
     _RA_OnReset = (void(CCONV *)())                                                   GetProcAddress(g_hRADLL, "_RA_OnReset");
     _RA_DoAchievementsFrame = (void(CCONV *)())                                       GetProcAddress(g_hRADLL, "_RA_DoAchievementsFrame");
+    _RA_DoAchievementsFrameBatched = (void(CCONV *)())                                GetProcAddress(g_hRADLL, "_RA_DoAchievementsFrameBatched");
+    _RA_StartMemoryTrace = (int(CCONV *)(const char*))                                GetProcAddress(g_hRADLL, "_RA_StartMemoryTrace");
+    _RA_StopMemoryTrace = (void(CCONV *)())                                           GetProcAddress(g_hRADLL, "_RA_StopMemoryTrace");
     _RA_SetConsoleID = (int(CCONV *)(unsigned int))                                   GetProcAddress(g_hRADLL, "_RA_SetConsoleID");
     _RA_HardcoreModeIsActive = (int(CCONV *)())                                       GetProcAddress(g_hRADLL, "_RA_HardcoreModeIsActive");
     _RA_WarnDisableHardcore = (bool(CCONV *)(const char*))                            GetProcAddress(g_hRADLL, "_RA_WarnDisableHardcore");
@@ -638,8 +678,13 @@ void RA_Shutdown()
     _RA_SetPaused = nullptr;
     _RA_OnLoadState = nullptr;
     _RA_OnSaveState = nullptr;
+    _RA_CaptureState = nullptr;
+    _RA_RestoreState = nullptr;
     _RA_OnReset = nullptr;
     _RA_DoAchievementsFrame = nullptr;
+    _RA_DoAchievementsFrameBatched = nullptr;
+    _RA_StartMemoryTrace = nullptr;
+    _RA_StopMemoryTrace = nullptr;
     _RA_SetConsoleID = nullptr;
     _RA_HardcoreModeIsActive = nullptr;
     _RA_WarnDisableHardcore = nullptr;
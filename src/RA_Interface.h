@@ -132,6 +132,17 @@ extern void RA_Shutdown();
 //	Perform one test for all achievements in the current set. Call this once per frame/cycle.
 extern void RA_DoAchievementsFrame();
 
+//	Same as RA_DoAchievementsFrame, but for frames that won't be rendered (fast-forward, run-ahead).
+//	UI updates are deferred until the next call to RA_DoAchievementsFrame.
+extern void RA_DoAchievementsFrameBatched();
+
+//	Starts recording the memory used by the loaded achievements to a trace file, one frame per RA_DoAchievementsFrame
+//	or RA_DoAchievementsFrameBatched call. Returns false if the file could not be created.
+extern bool RA_StartMemoryTrace(const char* sFilename);
+
+//	Stops the recording started by RA_StartMemoryTrace.
+extern void RA_StopMemoryTrace();
+
 //	Updates and renders all on-screen overlays.
 extern void RA_UpdateRenderOverlay(HDC hDC, struct ControllerInput* pInput, float fDeltaTime, RECT* prcSize, bool Full_Screen,
                                    bool Paused);
@@ -187,6 +198,13 @@ extern bool RA_WarnDisableHardcore(const char* sActivity);
 extern void RA_OnLoadState(const char* sFilename);
 extern void RA_OnSaveState(const char* sFilename);
 
+//  Captures the achievement state into an in-memory buffer (rewind, run-ahead).
+//  Returns the number of bytes required. Nothing is written if nBufferSize is smaller than that.
+extern int RA_CaptureState(char* pBuffer, int nBufferSize);
+
+//  Restores the achievement state from a buffer populated by RA_CaptureState.
+extern void RA_RestoreState(const char* pBuffer, int nBufferSize);
+
 //  Should be called immediately after resetting the system.
 extern void RA_OnReset();
 
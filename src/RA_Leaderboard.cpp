@@ -30,23 +30,42 @@ void RA_Leaderboard::ParseFromString(const char* sBuffer, const char* sFormat)
     if (nSize < 0)
     {
         // parse error occurred
-        RA_LOG("rc_parse_lboard returned %d", nSize);
-        m_pLeaderboard = nullptr;
-
-        ra::ui::viewmodels::MessageBoxViewModel::ShowWarningMessage(
-            ra::StringPrintf(L"Unable to activate leaderboard: %s", Title()),
-            ra::StringPrintf(L"Parse error %d", nSize));
+        SetParseError(nSize);
     }
     else
     {
+        // the runtime has to stop referencing the old definition before it's replaced
+        const bool bWasActive = m_bActive;
+        if (bWasActive)
+            SetActive(false);
+
         // allocate space and parse again
         m_pLeaderboardBuffer = std::make_shared<std::vector<unsigned char>>(nSize);
-        m_pLeaderboard = rc_parse_lboard(m_pLeaderboardBuffer->data(), sBuffer, nullptr, 0);
+        ParseFromString(sBuffer, m_pLeaderboardBuffer->data(), sFormat);
 
-        m_nFormat = rc_parse_format(sFormat);
+        if (bWasActive)
+            SetActive(true);
     }
 }
 
+void RA_Leaderboard::ParseFromString(const char* sBuffer, void* pBuffer, const char* sFormat)
+{
+    Expects(!m_bActive);
+
+    m_pLeaderboard = rc_parse_lboard(pBuffer, sBuffer, nullptr, 0);
+    m_nFormat = rc_parse_format(sFormat);
+}
+
+void RA_Leaderboard::SetParseError(int nError)
+{
+    RA_LOG("rc_parse_lboard returned %d", nError);
+    m_pLeaderboard = nullptr;
+
+    ra::ui::viewmodels::MessageBoxViewModel::ShowWarningMessage(
+        ra::StringPrintf(L"Unable to activate leaderboard: %s", Title()),
+        ra::StringPrintf(L"Parse error %d", nError));
+}
+
 void RA_Leaderboard::SetActive(bool bActive) noexcept
 {
     if (m_bActive != bActive)
@@ -16,6 +16,17 @@ public:
 
     void ParseFromString(const char* sBuffer, const char* sFormat);
 
+    /// <summary>
+    /// Parses a leaderboard definition into a caller-provided buffer of at least <c>rc_lboard_size</c> bytes. The
+    /// leaderboard must not be active.
+    /// </summary>
+    void ParseFromString(const char* sBuffer, void* pBuffer, const char* sFormat);
+
+    /// <summary>
+    /// Clears the definition and notifies the user that it could not be parsed.
+    /// </summary>
+    void SetParseError(int nError);
+
     ra::LeaderboardID ID() const noexcept { return m_nID; }
 
     const std::string& Title() const noexcept { return m_sTitle; }
@@ -59,7 +70,7 @@ public:
 
 protected:
     void* m_pLeaderboard = nullptr;                                   //  rc_lboard_t
-    std::shared_ptr<std::vector<unsigned char>> m_pLeaderboardBuffer; //  buffer for rc_lboard_t
+    std::shared_ptr<std::vector<unsigned char>> m_pLeaderboardBuffer; //  buffer for rc_lboard_t, if not parsed by LoadGame
 
     bool m_bActive = false;
 
@@ -33,6 +33,7 @@
 #define IDD_RA_REPORTBROKENACHIEVEMENTS 1508
 #define IDD_RA_GAMELIBRARY              1509
 #define IDD_RA_ROMCHECKSUM              1510
+#define IDD_RA_RUNTIMETRACE             1511
 #define IDC_RA_TESTVAL                  1512
 #define IDC_RA_DOTEST                   1513
 #define IDC_RA_MEMSAVENOTE              1514
@@ -130,6 +131,9 @@
 #define IDC_RA_SEARCHRANGE              1604
 #define IDC_RA_MOVECONDDOWN             1605
 #define IDC_RA_ROMCHECKSUMHEADER        1606
+#define IDC_RA_CHK_ACH_RECORD_HISTORY   1607
+#define IDC_RA_RUNTIMETRACETEXT         1608
+#define IDC_RA_ACH_VIEW_HISTORY         1609
 #define IDM_RA_MENUSTART                1700
 #define IDM_RA_RETROACHIEVEMENTS        1700
 #define IDM_RA_FILES_TEST1              1701
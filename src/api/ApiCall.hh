@@ -3,6 +3,7 @@
 #pragma once
 
 #include "services\IThreadPool.hh"
+#include "services\RequestCoalescer.hh"
 #include "services\ServiceLocator.hh"
 
 #include <string>
@@ -22,25 +23,114 @@ enum class ApiResult
 
 struct ApiRequestBase
 {
+    /// <summary>
+    /// Determines how soon the request is sent relative to other queued requests. Requests that need to be sent
+    /// sooner (or later) than other requests should declare their own Priority.
+    /// </summary>
+    static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::Normal;
+
+    /// <summary>
+    /// How long a successful response may be shared with identical requests made after it completes. Only used by
+    /// requests that call <see cref="CallAsyncCoalesced" />.
+    /// </summary>
+    static constexpr std::chrono::milliseconds CacheDuration{ 0 };
+
 protected:
     template<class TRequest, class TCallback>
     static void CallAsync(const TRequest& request, TCallback&& callback)
     {
-        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(
+        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(TRequest::Priority,
             [request, callback = std::move(callback)]{ callback(request.Call()); });
     }
 
     template<class TRequest, class TCallback>
     static void CallAsyncWithRetry(const TRequest& request, TCallback&& callback)
     {
-        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(
+        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(TRequest::Priority,
             [request, callback = std::move(callback)]
         {
             DoAsyncWithRetry(std::move(request), std::move(callback), std::chrono::milliseconds(0));
         });
     }
 
+    /// <summary>
+    /// Calls the server asynchronously, sharing the response with any identical requests (as determined by
+    /// <c>TRequest::CoalesceKey()</c>) made before it completes.
+    /// </summary>
+    template<class TRequest, class TCallback>
+    static void CallAsyncCoalesced(const TRequest& request, TCallback&& callback)
+    {
+        if (!ra::services::ServiceLocator::Exists<ra::services::RequestCoalescer>())
+        {
+            CallAsync<TRequest, TCallback>(request, std::move(callback));
+            return;
+        }
+
+        using TResponse = decltype(request.Call());
+
+        ra::services::RequestCoalescer::Callback fCallback =
+            [callback = std::move(callback)](const std::shared_ptr<const void>& pResponse)
+        {
+            callback(*static_cast<const TResponse*>(pResponse.get()));
+        };
+
+        auto sKey = request.CoalesceKey();
+        auto& pCoalescer = ra::services::ServiceLocator::GetMutable<ra::services::RequestCoalescer>();
+        auto& pThreadPool = ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>();
+
+        std::shared_ptr<const void> pCachedResponse;
+        switch (pCoalescer.Join(sKey, std::move(fCallback), pCachedResponse))
+        {
+            case ra::services::RequestCoalescer::JoinResult::Send:
+                pThreadPool.RunAsync(TRequest::Priority, [request, sKey = std::move(sKey)]()
+                {
+                    // the key has to be completed even if the call fails, or any identical request made later
+                    // would join it and never get a response
+                    std::shared_ptr<const TResponse> pResponse;
+                    try
+                    {
+                        pResponse = std::make_shared<const TResponse>(request.Call());
+                    }
+                    catch (const std::exception& ex)
+                    {
+                        pResponse = MakeErrorResponse<TResponse>(ex.what());
+                    }
+                    catch (...)
+                    {
+                        pResponse = MakeErrorResponse<TResponse>("Unknown error");
+                    }
+
+                    const auto tCacheDuration = pResponse->Succeeded() ? TRequest::CacheDuration : std::chrono::milliseconds(0);
+
+                    auto& pCoalescer = ra::services::ServiceLocator::GetMutable<ra::services::RequestCoalescer>();
+                    pCoalescer.Complete(sKey, std::move(pResponse), tCacheDuration);
+                });
+                break;
+
+            case ra::services::RequestCoalescer::JoinResult::Cached:
+                // callbacks are always called asynchronously, even if the response is already available
+                pThreadPool.RunAsync(TRequest::Priority, [fCallback = std::move(fCallback), pCachedResponse]()
+                {
+                    fCallback(pCachedResponse);
+                });
+                break;
+
+            default:
+                // an identical request is already in flight. the callback will be called when it completes
+                break;
+        }
+    }
+
 private:
+    template<class TResponse>
+    static std::shared_ptr<const TResponse> MakeErrorResponse(const char* sErrorMessage)
+    {
+        auto pResponse = std::make_shared<TResponse>();
+        pResponse->Result = ApiResult::Error;
+        pResponse->ErrorMessage = sErrorMessage;
+        return pResponse;
+    }
+
     template<class TRequest, class TCallback>
     static void DoAsyncWithRetry(const TRequest& request, TCallback&& callback, std::chrono::milliseconds delay)
     {
@@ -62,7 +152,7 @@ private:
                 delay = std::chrono::minutes(2);
         }
 
-        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().ScheduleAsync(delay,
+        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().ScheduleAsync(delay, TRequest::Priority,
             [request = std::move(request), callback = std::move(callback), delay]
         {
             DoAsyncWithRetry(std::move(request), std::move(callback), delay);
@@ -23,6 +23,8 @@ public:
         bool Hardcore{ false };
         std::string GameHash;
 
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::High;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
@@ -35,13 +35,22 @@ public:
         unsigned int NumEntries{ 10U };
         bool FriendsOnly{ false };
 
+        // the overlay requests this every time the achievement is selected
+        static constexpr std::chrono::milliseconds CacheDuration{ std::chrono::seconds(30) };
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
 
+        std::string CoalesceKey() const
+        {
+            return std::string(Name()) + ":" + std::to_string(AchievementId) + ":" + std::to_string(FirstEntry) +
+                ":" + std::to_string(NumEntries) + (FriendsOnly ? ":1" : ":0");
+        }
+
         void CallAsync(Callback&& callback) const
         {
-            ApiRequestBase::CallAsync<Request, Callback>(*this, std::move(callback));
+            ApiRequestBase::CallAsyncCoalesced<Request, Callback>(*this, std::move(callback));
         }
     };
 };
@@ -33,6 +33,7 @@ public:
             std::string BadgeName;
             time_t Created{};
             time_t Updated{};
+            int DefinitionSize{}; // buffer size needed to parse Definition, 0 if not known
         };
         std::vector<Achievement> Achievements;
 
@@ -43,6 +44,7 @@ public:
             std::string Description;
             std::string Definition;
             std::string Format;
+            int DefinitionSize{}; // buffer size needed to parse Definition, 0 if not known
         };
         std::vector<Leaderboard> Leaderboards;
     };
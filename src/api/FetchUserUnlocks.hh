@@ -26,9 +26,14 @@ public:
 
         Response Call() const;
 
+        std::string CoalesceKey() const
+        {
+            return std::string(Name()) + ":" + std::to_string(GameId) + (Hardcore ? ":1" : ":0");
+        }
+
         void CallAsync(Callback&& callback) const
         {
-            ApiRequestBase::CallAsync<Request, Callback>(*this, std::move(callback));
+            ApiRequestBase::CallAsyncCoalesced<Request, Callback>(*this, std::move(callback));
         }
     };
 };
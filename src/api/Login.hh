@@ -26,6 +26,8 @@ public:
         std::string Password;
         std::string ApiToken;
 
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::Critical;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
@@ -18,6 +18,8 @@ public:
 
     struct Request : ApiRequestBase
     {
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::Critical;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
@@ -21,6 +21,8 @@ public:
         unsigned int GameId{};
         std::wstring CurrentActivity;
 
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::Idle;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
@@ -20,6 +20,8 @@ public:
     {
         unsigned int GameId{ 0U };
 
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::Idle;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
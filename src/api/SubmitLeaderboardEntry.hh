@@ -35,6 +35,8 @@ public:
         unsigned int Score{ 0U };
         std::string GameHash;
 
+        static constexpr ra::services::TaskPriority Priority = ra::services::TaskPriority::High;
+
         using Callback = std::function<void(const Response& response)>;
 
         Response Call() const;
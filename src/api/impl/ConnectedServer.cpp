@@ -1,6 +1,9 @@
 #include "ConnectedServer.hh"
 
 #include "DisconnectedServer.hh"
+#include "GameDataCache.hh"
+#include "JsonResponseReader.hh"
+#include "OfflineServer.hh"
 #include "RA_Defs.h"
 
 #include "RA_md5factory.h"
@@ -36,31 +39,45 @@ _NODISCARD static bool HandleHttpError(_In_ const ra::services::Http::Response&
     return false;
 }
 
-_NODISCARD static bool GetJson([[maybe_unused]] _In_ const char* sApiName,
-                               _In_ const ra::services::Http::Response& httpResponse,
-                               _Inout_ ApiResponseBase& pResponse, _Out_ rapidjson::Document& pDocument)
+_NODISCARD static bool CheckResponse([[maybe_unused]] _In_ const char* sApiName,
+                                     _In_ const ra::services::Http::Response& httpResponse,
+                                     _Inout_ ApiResponseBase& pResponse)
 {
-    /*this function can throw std::bad_alloc (from the strings allocator) but very low chance*/
     if (HandleHttpError(httpResponse, pResponse))
     {
-        pDocument.SetArray();
-
         RA_LOG_ERR("-- %s: %s", sApiName, pResponse.ErrorMessage.c_str());
         return false;
     }
 
     if (httpResponse.Content().empty())
     {
-        pDocument.SetArray();
-
         RA_LOG_ERR("-- %s: Empty JSON response", sApiName);
         pResponse.Result = ApiResult::Failed;
         pResponse.ErrorMessage = "Empty JSON response";
         return false;
     }
 
-    RA_LOG_INFO("-- %s Response: %s", sApiName, httpResponse.Content());
+    // some responses (patch data, code notes) are hundreds of KB. only log enough to identify the response
+    constexpr size_t MaxLoggedResponseLength = 256;
+    const auto& sContent = httpResponse.Content();
+    if (sContent.length() <= MaxLoggedResponseLength)
+    {
+        RA_LOG_INFO("-- %s Response: %s", sApiName, sContent);
+    }
+    else
+    {
+        RA_LOG_INFO("-- %s Response (%zu bytes): %s...", sApiName, sContent.length(),
+                    sContent.substr(0, MaxLoggedResponseLength));
+    }
+
+    return true;
+}
 
+_NODISCARD static bool ParseJson([[maybe_unused]] _In_ const char* sApiName,
+                                 _In_ const ra::services::Http::Response& httpResponse,
+                                 _Inout_ ApiResponseBase& pResponse, _Out_ rapidjson::Document& pDocument)
+{
+    /*this function can throw std::bad_alloc (from the strings allocator) but very low chance*/
     pDocument.Parse(httpResponse.Content());
     if (pDocument.HasParseError())
     {
@@ -117,6 +134,18 @@ _NODISCARD static bool GetJson([[maybe_unused]] _In_ const char* sApiName,
     return true;
 }
 
+_NODISCARD static bool GetJson(_In_ const char* sApiName, _In_ const ra::services::Http::Response& httpResponse,
+                               _Inout_ ApiResponseBase& pResponse, _Out_ rapidjson::Document& pDocument)
+{
+    if (!CheckResponse(sApiName, httpResponse, pResponse))
+    {
+        pDocument.SetArray();
+        return false;
+    }
+
+    return ParseJson(sApiName, httpResponse, pResponse, pDocument);
+}
+
 static void GetRequiredJsonField(_Out_ std::string& sValue, _In_ const rapidjson::Value& pDocument,
                                  _In_ const char* const sField, _Inout_ ApiResponseBase& response)
 {
@@ -155,27 +184,6 @@ static void GetOptionalJsonField(_Out_ std::string& sValue, _In_ const rapidjson
     }
 }
 
-static void GetRequiredJsonField(_Out_ std::wstring& sValue, _In_ const rapidjson::Value& pDocument,
-    _In_ const char* const sField, _Inout_ ApiResponseBase& response)
-{
-    if (!pDocument.HasMember(sField))
-    {
-        sValue.clear();
-
-        response.Result = ApiResult::Error;
-        if (response.ErrorMessage.empty())
-            response.ErrorMessage = ra::StringPrintf("%s not found in response", sField);
-    }
-    else
-    {
-        auto& pField = pDocument[sField];
-        if (pField.IsString())
-            sValue = ra::Widen(pField.GetString());
-        else
-            sValue.clear();
-    }
-}
-
 static void GetRequiredJsonField(_Out_ unsigned int& nValue, _In_ const rapidjson::Value& pDocument,
     _In_ const char* const sField, _Inout_ ApiResponseBase& response)
 {
@@ -224,8 +232,9 @@ static void AppendUrlParam(_Inout_ std::string& sParams, _In_ const char* const
     ra::services::Http::UrlEncodeAppend(sParams, sValue);
 }
 
-static bool DoRequest(const std::string& sHost, const char* restrict sApiName, const char* restrict sRequestName,
-    const std::string& sInputParams, ApiResponseBase& pResponse, rapidjson::Document& document)
+static ra::services::Http::Response SendRequest(const std::string& sHost, const char* restrict sApiName,
+    const char* restrict sRequestName, const std::string& sInputParams,
+    const ra::services::Http::Validators& pValidators = {})
 {
     std::string sPostData;
 
@@ -242,11 +251,50 @@ static bool DoRequest(const std::string& sHost, const char* restrict sApiName, c
 
     ra::services::Http::Request httpRequest(ra::StringPrintf("%s/dorequest.php", sHost));
     httpRequest.SetPostData(sPostData);
+    httpRequest.SetValidators(pValidators);
 
-    const auto httpResponse = httpRequest.Call();
+    return httpRequest.Call();
+}
+
+static bool DoRequest(const std::string& sHost, const char* restrict sApiName, const char* restrict sRequestName,
+    const std::string& sInputParams, ApiResponseBase& pResponse, rapidjson::Document& document)
+{
+    const auto httpResponse = SendRequest(sHost, sApiName, sRequestName, sInputParams);
     return GetJson(sApiName, httpResponse, pResponse, document);
 }
 
+/// <summary>
+/// Applies the status fields of a response decoded by the <see cref="JsonResponseReader" />.
+/// </summary>
+/// <returns><c>true</c> if the response was successful and contained the expected payload.</returns>
+static bool CheckEnvelope([[maybe_unused]] _In_ const char* sApiName, _In_ const JsonResponseReader::Envelope& pEnvelope,
+                          _In_ const char* sPayloadName, _Inout_ ApiResponseBase& pResponse)
+{
+    if (!pEnvelope.Error.empty())
+    {
+        pResponse.Result = ApiResult::Error;
+        pResponse.ErrorMessage = pEnvelope.Error;
+        RA_LOG_ERR("-- %s Error: %s", sApiName, pResponse.ErrorMessage);
+        return false;
+    }
+
+    if (!pEnvelope.Success)
+    {
+        pResponse.Result = ApiResult::Failed;
+        RA_LOG_ERR("-- %s Error: Success=false", sApiName);
+        return false;
+    }
+
+    if (!pEnvelope.HasPayload)
+    {
+        pResponse.Result = ApiResult::Error;
+        pResponse.ErrorMessage = ra::StringPrintf("%s not found in response", sPayloadName);
+        return false;
+    }
+
+    return true;
+}
+
 static bool DoUpload(const std::string& sHost, const char* restrict sApiName, const char* restrict sRequestName,
     const std::wstring& sFilePath, ApiResponseBase& pResponse, rapidjson::Document& document)
 {
@@ -579,150 +627,142 @@ ResolveHash::Response ConnectedServer::ResolveHash(const ResolveHash::Request& r
 FetchGameData::Response ConnectedServer::FetchGameData(const FetchGameData::Request& request)
 {
     FetchGameData::Response response;
-    rapidjson::Document document;
     std::string sPostData;
 
     AppendUrlParam(sPostData, "g", std::to_string(request.GameId));
 
-    if (DoRequest(m_sHost, FetchGameData::Name(), "patch", sPostData, response, document))
+    // if there's a cached copy, the server only has to send the patch data if it's changed
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    const auto sGameId = std::to_wstring(request.GameId);
+    const auto pValidators = pLocalStorage.GetValidators(ra::services::StorageItemType::GameData, sGameId);
+
+    const auto httpResponse = SendRequest(m_sHost, FetchGameData::Name(), "patch", sPostData, pValidators);
+    if (httpResponse.StatusCode() == ra::services::Http::StatusCode::NotModified && !pValidators.IsEmpty())
     {
-        if (!document.HasMember("PatchData"))
-        {
-            response.Result = ApiResult::Error;
-            response.ErrorMessage = ra::StringPrintf("%s not found in response", "PatchData");
-        }
-        else
-        {
-            response.Result = ApiResult::Success;
+        RA_LOG_INFO("-- %s: Not modified, using cached copy", FetchGameData::Name());
+        auto pCachedResponse = OfflineServer().FetchGameData(request);
+        if (pCachedResponse.Succeeded())
+            return pCachedResponse;
+
+        // the cached copy couldn't be used. forget it and ask for the full patch data
+        pLocalStorage.SetValidators(ra::services::StorageItemType::GameData, sGameId, {});
+        return FetchGameData(request);
+    }
 
-            const auto& PatchData = document["PatchData"];
+    if (!CheckResponse(FetchGameData::Name(), httpResponse, response))
+        return std::move(response);
 
-            // store a copy in the cache for offline mode
-            auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-            auto pData = pLocalStorage.WriteText(ra::services::StorageItemType::GameData, std::to_wstring(request.GameId));
-            if (pData != nullptr)
-            {
-                rapidjson::Document patchData;
-                patchData.CopyFrom(PatchData, document.GetAllocator());
-                SaveDocument(patchData, *pData.get());
-            }
+    // if the patch data hasn't changed since it was last cached, use the already decoded copy
+    const auto& sContent = httpResponse.Content();
+    const auto sContentHash = RAGenerateMD5(sContent);
+    if (GameDataCache::Read(request.GameId, sContentHash, response))
+    {
+        response.Result = ApiResult::Success;
+        pLocalStorage.SetValidators(ra::services::StorageItemType::GameData, sGameId, httpResponse.GetValidators());
+        return std::move(response);
+    }
 
-            // process it
-            ProcessGamePatchData(response, PatchData);
+    response.Result = ApiResult::Success;
+
+    JsonResponseReader::Envelope pEnvelope;
+    if (!JsonResponseReader::ReadGameData(sContent, response, pEnvelope))
+    {
+        // let the DOM parser build the error message
+        rapidjson::Document document;
+        if (ParseJson(FetchGameData::Name(), httpResponse, response, document))
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = "JSON Parse Error";
         }
+
+        return std::move(response);
     }
 
-    return std::move(response);
-}
+    if (!CheckEnvelope(FetchGameData::Name(), pEnvelope, "PatchData", response))
+        return std::move(response);
 
-void ConnectedServer::ProcessGamePatchData(ra::api::FetchGameData::Response &response, const rapidjson::Value& PatchData)
-{
-    GetRequiredJsonField(response.Title, PatchData, "Title", response);
-    GetRequiredJsonField(response.ConsoleId, PatchData, "ConsoleID", response);
-    GetOptionalJsonField(response.ForumTopicId, PatchData, "ForumTopicID");
-    GetOptionalJsonField(response.Flags, PatchData, "Flags");
-    GetOptionalJsonField(response.ImageIcon, PatchData, "ImageIcon");
-    GetOptionalJsonField(response.RichPresence, PatchData, "RichPresencePatch");
-
-    if (!response.ImageIcon.empty())
+    // store a copy in the cache for offline mode
     {
-        // ImageIcon value will be "/Images/001234.png" - extract the "001234"
-        auto nIndex = response.ImageIcon.find_last_of('/');
-        if (nIndex != std::string::npos)
-            response.ImageIcon.erase(0, nIndex + 1);
-        nIndex = response.ImageIcon.find_last_of('.');
-        if (nIndex != std::string::npos)
-            response.ImageIcon.erase(nIndex);
+        auto pData = pLocalStorage.WriteText(ra::services::StorageItemType::GameData, sGameId);
+        if (pData != nullptr)
+            pData->Write(sContent);
     }
 
-    const auto& AchievementsData{ PatchData["Achievements"] };
-    for (const auto& achData : AchievementsData.GetArray())
+    if (response.Result == ApiResult::Success)
     {
-        auto& pAchievement = response.Achievements.emplace_back();
-        GetRequiredJsonField(pAchievement.Id, achData, "ID", response);
-        GetRequiredJsonField(pAchievement.Title, achData, "Title", response);
-        GetRequiredJsonField(pAchievement.Description, achData, "Description", response);
-        GetRequiredJsonField(pAchievement.CategoryId, achData, "Flags", response);
-        GetOptionalJsonField(pAchievement.Points, achData, "Points");
-        GetRequiredJsonField(pAchievement.Definition, achData, "MemAddr", response);
-        GetOptionalJsonField(pAchievement.Author, achData, "Author");
-        GetRequiredJsonField(pAchievement.BadgeName, achData, "BadgeName", response);
-
-        unsigned int time;
-        GetRequiredJsonField(time, achData, "Created", response);
-        pAchievement.Created = static_cast<time_t>(time);
-        GetRequiredJsonField(time, achData, "Modified", response);
-        pAchievement.Updated = static_cast<time_t>(time);
-    }
+        GameDataCache::CalculateDefinitionSizes(response);
+        GameDataCache::Write(request.GameId, sContentHash, response);
 
-    const auto& LeaderboardsData{ PatchData["Leaderboards"] };
-    for (const auto& lbData : LeaderboardsData.GetArray())
+        pLocalStorage.SetValidators(ra::services::StorageItemType::GameData, sGameId, httpResponse.GetValidators());
+    }
+    else
     {
-        auto& pLeaderboard = response.Leaderboards.emplace_back();
-        GetRequiredJsonField(pLeaderboard.Id, lbData, "ID", response);
-        GetRequiredJsonField(pLeaderboard.Title, lbData, "Title", response);
-        GetRequiredJsonField(pLeaderboard.Description, lbData, "Description", response);
-        GetRequiredJsonField(pLeaderboard.Definition, lbData, "Mem", response);
-        GetOptionalJsonField(pLeaderboard.Format, lbData, "Format", "VALUE");
+        // don't let the server think the incomplete copy is current
+        pLocalStorage.SetValidators(ra::services::StorageItemType::GameData, sGameId, {});
     }
+
+    return std::move(response);
 }
 
 FetchCodeNotes::Response ConnectedServer::FetchCodeNotes(const FetchCodeNotes::Request& request)
 {
     FetchCodeNotes::Response response;
-    rapidjson::Document document;
     std::string sPostData;
 
     AppendUrlParam(sPostData, "g", std::to_string(request.GameId));
 
-    if (DoRequest(m_sHost, FetchCodeNotes::Name(), "codenotes2", sPostData, response, document))
+    // if there's a cached copy, the server only has to send the notes if they've changed
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    const auto sGameId = std::to_wstring(request.GameId);
+    const auto pValidators = pLocalStorage.GetValidators(ra::services::StorageItemType::CodeNotes, sGameId);
+
+    const auto httpResponse = SendRequest(m_sHost, FetchCodeNotes::Name(), "codenotes2", sPostData, pValidators);
+    if (httpResponse.StatusCode() == ra::services::Http::StatusCode::NotModified && !pValidators.IsEmpty())
     {
-        if (!document.HasMember("CodeNotes"))
-        {
-            response.Result = ApiResult::Error;
-            response.ErrorMessage = ra::StringPrintf("%s not found in response", "CodeNotes");
-        }
-        else
-        {
-            response.Result = ApiResult::Success;
+        RA_LOG_INFO("-- %s: Not modified, using cached copy", FetchCodeNotes::Name());
+        auto pCachedResponse = OfflineServer().FetchCodeNotes(request);
+        if (pCachedResponse.Succeeded())
+            return pCachedResponse;
+
+        // the cached copy couldn't be used. forget it and ask for the full notes
+        pLocalStorage.SetValidators(ra::services::StorageItemType::CodeNotes, sGameId, {});
+        return FetchCodeNotes(request);
+    }
 
-            const auto& CodeNotes = document["CodeNotes"];
+    if (!CheckResponse(FetchCodeNotes::Name(), httpResponse, response))
+        return std::move(response);
 
-            // store a copy in the cache for offline mode
-            auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-            auto pData = pLocalStorage.WriteText(ra::services::StorageItemType::CodeNotes, std::to_wstring(request.GameId));
-            if (pData != nullptr)
-            {
-                rapidjson::Document codeNotes;
-                codeNotes.CopyFrom(CodeNotes, document.GetAllocator());
-                SaveDocument(codeNotes, *pData.get());
-            }
+    response.Result = ApiResult::Success;
 
-            // process it
-            ProcessCodeNotes(response, CodeNotes);
+    const auto& sContent = httpResponse.Content();
+    JsonResponseReader::Envelope pEnvelope;
+    if (!JsonResponseReader::ReadCodeNotes(sContent, response, pEnvelope))
+    {
+        // let the DOM parser build the error message
+        rapidjson::Document document;
+        if (ParseJson(FetchCodeNotes::Name(), httpResponse, response, document))
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = "JSON Parse Error";
         }
+
+        return std::move(response);
     }
 
-    return std::move(response);
-}
+    if (!CheckEnvelope(FetchCodeNotes::Name(), pEnvelope, "CodeNotes", response))
+        return std::move(response);
 
-void ConnectedServer::ProcessCodeNotes(ra::api::FetchCodeNotes::Response &response, const rapidjson::Value& CodeNotes)
-{
-    for (const auto& codeNote : CodeNotes.GetArray())
+    // store a copy in the cache for offline mode
     {
-        auto& pNote = response.Notes.emplace_back();
-        GetRequiredJsonField(pNote.Author, codeNote, "User", response);
-
-        std::string sAddress;
-        GetRequiredJsonField(sAddress, codeNote, "Address", response);
-        pNote.Address = ra::ByteAddressFromString(sAddress);
+        auto pData = pLocalStorage.WriteText(ra::services::StorageItemType::CodeNotes, sGameId);
+        if (pData != nullptr)
+            pData->Write(sContent);
+    }
 
-        GetRequiredJsonField(pNote.Note, codeNote, "Note", response);
+    pLocalStorage.SetValidators(ra::services::StorageItemType::CodeNotes, sGameId,
+                                response.Succeeded() ? httpResponse.GetValidators() : ra::services::Http::Validators{});
 
-        // empty notes were deleted on the server - don't bother including them in the response
-        if (pNote.Note.empty())
-            response.Notes.pop_back();
-    }
+    return std::move(response);
 }
 
 UpdateCodeNote::Response ConnectedServer::UpdateCodeNote(const UpdateCodeNote::Request& request)
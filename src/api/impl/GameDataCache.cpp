@@ -0,0 +1,275 @@
+#include "GameDataCache.hh"
+
+#include "RA_md5factory.h"
+#include "RA_StringUtils.h"
+
+#include "services\ILocalStorage.hh"
+#include "services\ServiceLocator.hh"
+
+namespace ra {
+namespace api {
+namespace impl {
+
+_CONSTANT_VAR CACHE_MAGIC = "RAGD";
+
+namespace {
+
+class CacheWriter
+{
+public:
+    void WriteUInt(unsigned int nValue)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            m_sBuffer.push_back(gsl::narrow_cast<char>(nValue & 0xFF));
+            nValue >>= 8;
+        }
+    }
+
+    void WriteString(const std::string& sValue)
+    {
+        WriteUInt(gsl::narrow<unsigned int>(sValue.length()));
+        m_sBuffer.append(sValue);
+    }
+
+    std::string& GetBuffer() noexcept { return m_sBuffer; }
+
+private:
+    std::string m_sBuffer;
+};
+
+class CacheReader
+{
+public:
+    CacheReader(const char* pData, size_t nSize) noexcept : m_pData(pData), m_nRemaining(nSize) {}
+
+    bool ReadUInt(unsigned int& nValue) noexcept
+    {
+        if (m_nRemaining < 4)
+            return false;
+
+        GSL_SUPPRESS(bounds.1) GSL_SUPPRESS(bounds.4)
+        nValue = static_cast<unsigned char>(m_pData[0]) | (static_cast<unsigned char>(m_pData[1]) << 8) |
+                 (static_cast<unsigned char>(m_pData[2]) << 16) | (static_cast<unsigned int>(
+                 static_cast<unsigned char>(m_pData[3])) << 24);
+        Skip(4);
+        return true;
+    }
+
+    bool ReadTime(time_t& tValue) noexcept
+    {
+        unsigned int nValue = 0;
+        if (!ReadUInt(nValue))
+            return false;
+
+        tValue = static_cast<time_t>(nValue);
+        return true;
+    }
+
+    bool ReadString(std::string& sValue)
+    {
+        unsigned int nLength = 0;
+        if (!ReadUInt(nLength) || nLength > m_nRemaining)
+            return false;
+
+        sValue.assign(m_pData, nLength);
+        Skip(nLength);
+        return true;
+    }
+
+    const char* GetData() const noexcept { return m_pData; }
+    size_t GetRemaining() const noexcept { return m_nRemaining; }
+
+private:
+    void Skip(size_t nBytes) noexcept
+    {
+        GSL_SUPPRESS(bounds.1) m_pData += nBytes;
+        m_nRemaining -= nBytes;
+    }
+
+    const char* m_pData;
+    size_t m_nRemaining;
+};
+
+} // namespace
+
+void GameDataCache::CalculateDefinitionSizes(FetchGameData::Response& response)
+{
+    for (auto& pAchievement : response.Achievements)
+    {
+        if (pAchievement.DefinitionSize == 0)
+            pAchievement.DefinitionSize = rc_trigger_size(pAchievement.Definition.c_str());
+    }
+
+    for (auto& pLeaderboard : response.Leaderboards)
+    {
+        if (pLeaderboard.DefinitionSize == 0)
+            pLeaderboard.DefinitionSize = rc_lboard_size(pLeaderboard.Definition.c_str());
+    }
+}
+
+bool GameDataCache::Write(unsigned int nGameId, const std::string& sContentHash,
+                          const FetchGameData::Response& response)
+{
+    CacheWriter pPayload;
+    pPayload.WriteString(ra::Narrow(response.Title));
+    pPayload.WriteUInt(response.ConsoleId);
+    pPayload.WriteUInt(response.ForumTopicId);
+    pPayload.WriteUInt(response.Flags);
+    pPayload.WriteString(response.ImageIcon);
+    pPayload.WriteString(response.RichPresence);
+
+    pPayload.WriteUInt(gsl::narrow<unsigned int>(response.Achievements.size()));
+    for (const auto& pAchievement : response.Achievements)
+    {
+        pPayload.WriteUInt(pAchievement.Id);
+        pPayload.WriteString(pAchievement.Title);
+        pPayload.WriteString(pAchievement.Description);
+        pPayload.WriteUInt(pAchievement.CategoryId);
+        pPayload.WriteUInt(pAchievement.Points);
+        pPayload.WriteString(pAchievement.Definition);
+        pPayload.WriteString(pAchievement.Author);
+        pPayload.WriteString(pAchievement.BadgeName);
+        pPayload.WriteUInt(gsl::narrow_cast<unsigned int>(pAchievement.Created));
+        pPayload.WriteUInt(gsl::narrow_cast<unsigned int>(pAchievement.Updated));
+    }
+
+    pPayload.WriteUInt(gsl::narrow<unsigned int>(response.Leaderboards.size()));
+    for (const auto& pLeaderboard : response.Leaderboards)
+    {
+        pPayload.WriteUInt(pLeaderboard.Id);
+        pPayload.WriteString(pLeaderboard.Title);
+        pPayload.WriteString(pLeaderboard.Description);
+        pPayload.WriteString(pLeaderboard.Definition);
+        pPayload.WriteString(pLeaderboard.Format);
+    }
+
+    const auto& sPayload = pPayload.GetBuffer();
+
+    CacheWriter pHeader;
+    pHeader.GetBuffer().append(CACHE_MAGIC);
+    pHeader.WriteUInt(Version);
+    pHeader.WriteUInt(nGameId);
+    pHeader.WriteString(sContentHash);
+    pHeader.WriteString(RAGenerateMD5(sPayload));
+    pHeader.WriteUInt(gsl::narrow<unsigned int>(sPayload.length()));
+
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.WriteText(ra::services::StorageItemType::GameDataCache, std::to_wstring(nGameId));
+    if (pFile == nullptr)
+        return false;
+
+    pFile->Write(pHeader.GetBuffer());
+    pFile->Write(sPayload);
+    return true;
+}
+
+static bool ReadFile(ra::services::TextReader& pReader, std::string& sContents)
+{
+    // read the whole file up front and decode from memory
+    constexpr size_t nChunkSize = 64 * 1024;
+    size_t nRead = 0;
+    do
+    {
+        const auto nOffset = sContents.length();
+        sContents.resize(nOffset + nChunkSize);
+        GSL_SUPPRESS(bounds.3) nRead = pReader.GetBytes(&sContents.at(nOffset), nChunkSize);
+        sContents.resize(nOffset + nRead);
+    } while (nRead == nChunkSize);
+
+    return !sContents.empty();
+}
+
+bool GameDataCache::Read(unsigned int nGameId, const std::string& sContentHash, FetchGameData::Response& response)
+{
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.ReadText(ra::services::StorageItemType::GameDataCache, std::to_wstring(nGameId));
+    if (pFile == nullptr)
+        return false;
+
+    std::string sContents;
+    if (!ReadFile(*pFile, sContents))
+        return false;
+
+    const size_t nMagicLength = strlen(CACHE_MAGIC);
+    if (sContents.compare(0, nMagicLength, CACHE_MAGIC) != 0)
+        return false;
+
+    GSL_SUPPRESS(bounds.1) CacheReader pReader(sContents.data() + nMagicLength, sContents.length() - nMagicLength);
+
+    unsigned int nValue = 0;
+    if (!pReader.ReadUInt(nValue) || nValue != Version)
+        return false;
+    if (!pReader.ReadUInt(nValue) || nValue != nGameId)
+        return false;
+
+    std::string sCachedHash;
+    if (!pReader.ReadString(sCachedHash) || (!sContentHash.empty() && sCachedHash != sContentHash))
+        return false;
+
+    std::string sPayloadHash;
+    if (!pReader.ReadString(sPayloadHash))
+        return false;
+    if (!pReader.ReadUInt(nValue) || nValue != pReader.GetRemaining())
+        return false;
+    if (RAGenerateMD5(std::string(pReader.GetData(), pReader.GetRemaining())) != sPayloadHash)
+        return false;
+
+    // the payload is known to be intact at this point, but still guard against reading past the end
+    FetchGameData::Response pCached;
+    std::string sTitle;
+    if (!pReader.ReadString(sTitle) || !pReader.ReadUInt(pCached.ConsoleId) ||
+        !pReader.ReadUInt(pCached.ForumTopicId) || !pReader.ReadUInt(pCached.Flags) ||
+        !pReader.ReadString(pCached.ImageIcon) || !pReader.ReadString(pCached.RichPresence))
+    {
+        return false;
+    }
+    pCached.Title = ra::Widen(sTitle);
+
+    unsigned int nCount = 0;
+    if (!pReader.ReadUInt(nCount))
+        return false;
+
+    pCached.Achievements.reserve(nCount);
+    while (nCount-- > 0)
+    {
+        auto& pAchievement = pCached.Achievements.emplace_back();
+        if (!pReader.ReadUInt(pAchievement.Id) || !pReader.ReadString(pAchievement.Title) ||
+            !pReader.ReadString(pAchievement.Description) || !pReader.ReadUInt(pAchievement.CategoryId) ||
+            !pReader.ReadUInt(pAchievement.Points) || !pReader.ReadString(pAchievement.Definition) ||
+            !pReader.ReadString(pAchievement.Author) || !pReader.ReadString(pAchievement.BadgeName) ||
+            !pReader.ReadTime(pAchievement.Created) || !pReader.ReadTime(pAchievement.Updated))
+        {
+            return false;
+        }
+    }
+
+    if (!pReader.ReadUInt(nCount))
+        return false;
+
+    pCached.Leaderboards.reserve(nCount);
+    while (nCount-- > 0)
+    {
+        auto& pLeaderboard = pCached.Leaderboards.emplace_back();
+        if (!pReader.ReadUInt(pLeaderboard.Id) || !pReader.ReadString(pLeaderboard.Title) ||
+            !pReader.ReadString(pLeaderboard.Description) || !pReader.ReadString(pLeaderboard.Definition) ||
+            !pReader.ReadString(pLeaderboard.Format))
+        {
+            return false;
+        }
+    }
+
+    response.Title = std::move(pCached.Title);
+    response.ConsoleId = pCached.ConsoleId;
+    response.ForumTopicId = pCached.ForumTopicId;
+    response.Flags = pCached.Flags;
+    response.ImageIcon = std::move(pCached.ImageIcon);
+    response.RichPresence = std::move(pCached.RichPresence);
+    response.Achievements = std::move(pCached.Achievements);
+    response.Leaderboards = std::move(pCached.Leaderboards);
+    return true;
+}
+
+} // namespace impl
+} // namespace api
+} // namespace ra
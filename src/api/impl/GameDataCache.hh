@@ -0,0 +1,58 @@
+#ifndef RA_API_IMPL_GAME_DATA_CACHE_HH
+#define RA_API_IMPL_GAME_DATA_CACHE_HH
+#pragma once
+
+#include "api\FetchGameData.hh"
+
+namespace ra {
+namespace api {
+namespace impl {
+
+/// <summary>
+/// Stores the decoded <see cref="FetchGameData::Response" /> for a game in a compact binary form alongside the
+/// cached patch data, so warm and offline loads don't have to decode the JSON again.
+/// </summary>
+/// <remarks>
+/// The file is tagged with the patch data hash it was built from, and a cache built from different patch data is
+/// ignored. The definition sizes are not stored: they're used to size the parse buffers, so they're always
+/// calculated by the running build rather than trusted from disk.
+/// </remarks>
+class GameDataCache
+{
+public:
+    static constexpr unsigned int Version = 2;
+
+    /// <summary>
+    /// Populates <c>DefinitionSize</c> for any achievement or leaderboard that doesn't have it yet.
+    /// </summary>
+    static void CalculateDefinitionSizes(FetchGameData::Response& response);
+
+    /// <summary>
+    /// Writes the binary cache for a game.
+    /// </summary>
+    /// <param name="nGameId">The game the data belongs to.</param>
+    /// <param name="sContentHash">The hash of the patch data <paramref name="response" /> was decoded from.</param>
+    /// <param name="response">The decoded patch data.</param>
+    /// <returns><c>true</c> if the cache was written.</returns>
+    static bool Write(unsigned int nGameId, const std::string& sContentHash, const FetchGameData::Response& response);
+
+    /// <summary>
+    /// Reads the binary cache for a game.
+    /// </summary>
+    /// <param name="nGameId">The game to read the data for.</param>
+    /// <param name="sContentHash">
+    /// The hash of the current patch data. If empty, the cache is accepted regardless of what it was built from.
+    /// </param>
+    /// <param name="response">Receives the decoded patch data. Not modified if the cache is unusable.</param>
+    /// <returns>
+    /// <c>true</c> if the cache exists, is intact, and matches <paramref name="sContentHash" />.
+    /// </returns>
+    /// <remarks><c>DefinitionSize</c> is left at <c>0</c> for every achievement and leaderboard.</remarks>
+    static bool Read(unsigned int nGameId, const std::string& sContentHash, FetchGameData::Response& response);
+};
+
+} // namespace impl
+} // namespace api
+} // namespace ra
+
+#endif // !RA_API_IMPL_GAME_DATA_CACHE_HH
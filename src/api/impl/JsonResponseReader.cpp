@@ -0,0 +1,560 @@
+#include "JsonResponseReader.hh"
+
+#include "RA_Defs.h"
+#include "RA_StringUtils.h"
+
+#include <rapidjson\reader.h>
+
+namespace ra {
+namespace api {
+namespace impl {
+
+namespace {
+
+enum class Scope
+{
+    None,
+    Root,
+    PatchData,
+    Achievements,
+    Achievement,
+    Leaderboards,
+    Leaderboard,
+    CodeNotes,
+    CodeNote,
+    Skip,
+};
+
+struct JsonValue
+{
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+    };
+
+    Type nType = Type::Null;
+    bool bValue = false;
+    bool bIsUint = false;
+    unsigned int nValue = 0U;
+    std::string_view sValue;
+};
+
+/// <summary>
+/// Tracks the nesting of the JSON and forwards each value to the derived class along with the scope it appears
+/// in and the name of its field. Anything in an unrecognized object or array is ignored.
+/// </summary>
+template<class TDerived>
+class ResponseHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, TDerived>
+{
+public:
+    ResponseHandler(ApiResponseBase& pResponse, JsonResponseReader::Envelope& pEnvelope) noexcept
+        : m_pResponse(pResponse), m_pEnvelope(pEnvelope)
+    {
+    }
+
+    bool Null() { return Value(JsonValue{}); }
+
+    bool Bool(bool bValue)
+    {
+        JsonValue pValue;
+        pValue.nType = JsonValue::Type::Bool;
+        pValue.bValue = bValue;
+        return Value(pValue);
+    }
+
+    bool Int(int nValue) { return Number(static_cast<unsigned int>(nValue), false); }
+    bool Uint(unsigned int nValue) { return Number(nValue, true); }
+    bool Int64(int64_t nValue) { return Number(static_cast<unsigned int>(nValue), false); }
+    bool Uint64(uint64_t nValue) { return Number(static_cast<unsigned int>(nValue), false); }
+    bool Double(double dValue) { return Number(static_cast<unsigned int>(dValue), false); }
+
+    bool String(const char* pValue, rapidjson::SizeType nLength, bool)
+    {
+        JsonValue pJsonValue;
+        pJsonValue.nType = JsonValue::Type::String;
+        pJsonValue.sValue = std::string_view(pValue, nLength);
+        return Value(pJsonValue);
+    }
+
+    bool Key(const char* pKey, rapidjson::SizeType nLength, bool)
+    {
+        m_sKey.assign(pKey, nLength);
+        return true;
+    }
+
+    bool StartObject()
+    {
+        if (m_vScopes.empty())
+            m_vScopes.push_back(Scope::Root);
+        else if (m_vScopes.back() == Scope::Skip)
+            m_vScopes.push_back(Scope::Skip);
+        else
+            m_vScopes.push_back(static_cast<TDerived*>(this)->EnterObject(m_vScopes.back(), m_sKey));
+
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+        static_cast<TDerived*>(this)->ExitObject(m_vScopes.back());
+        m_vScopes.pop_back();
+        return true;
+    }
+
+    bool StartArray()
+    {
+        if (m_vScopes.empty())
+            m_vScopes.push_back(static_cast<TDerived*>(this)->EnterArray(Scope::None, m_sKey));
+        else if (m_vScopes.back() == Scope::Skip)
+            m_vScopes.push_back(Scope::Skip);
+        else
+            m_vScopes.push_back(static_cast<TDerived*>(this)->EnterArray(m_vScopes.back(), m_sKey));
+
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        m_vScopes.pop_back();
+        return true;
+    }
+
+protected:
+    void MissingField(const char* sField)
+    {
+        m_pResponse.Result = ApiResult::Error;
+        if (m_pResponse.ErrorMessage.empty())
+            m_pResponse.ErrorMessage = ra::StringPrintf("%s not found in response", sField);
+    }
+
+    static void GetString(std::string& sValue, const JsonValue& pValue, const char* sDefaultValue = "")
+    {
+        if (pValue.nType == JsonValue::Type::String)
+            sValue.assign(pValue.sValue);
+        else
+            sValue = sDefaultValue;
+    }
+
+    static void GetString(std::wstring& sValue, const JsonValue& pValue)
+    {
+        if (pValue.nType == JsonValue::Type::String)
+            sValue = ra::Widen(std::string(pValue.sValue));
+        else
+            sValue.clear();
+    }
+
+    // matches GetRequiredJsonField - anything that's not an unsigned integer is 0
+    static unsigned int GetRequiredUInt(const JsonValue& pValue) noexcept { return pValue.bIsUint ? pValue.nValue : 0U; }
+
+    // matches GetOptionalJsonField - any number is accepted
+    static unsigned int GetOptionalUInt(const JsonValue& pValue) noexcept
+    {
+        return (pValue.nType == JsonValue::Type::Number) ? pValue.nValue : 0U;
+    }
+
+    ApiResponseBase& m_pResponse;
+    JsonResponseReader::Envelope& m_pEnvelope;
+
+private:
+    bool Number(unsigned int nValue, bool bIsUint)
+    {
+        JsonValue pValue;
+        pValue.nType = JsonValue::Type::Number;
+        pValue.nValue = nValue;
+        pValue.bIsUint = bIsUint;
+        return Value(pValue);
+    }
+
+    bool Value(const JsonValue& pValue)
+    {
+        if (m_vScopes.empty())
+            return true;
+
+        const auto nScope = m_vScopes.back();
+        if (nScope == Scope::Skip)
+            return true;
+
+        if (nScope == Scope::Root)
+        {
+            if (m_sKey == "Success")
+            {
+                if (pValue.nType == JsonValue::Type::Bool)
+                    m_pEnvelope.Success = pValue.bValue;
+                return true;
+            }
+
+            if (m_sKey == "Error")
+            {
+                if (pValue.nType == JsonValue::Type::String)
+                    m_pEnvelope.Error.assign(pValue.sValue);
+                return true;
+            }
+        }
+
+        static_cast<TDerived*>(this)->SetField(nScope, m_sKey, pValue);
+        return true;
+    }
+
+    std::vector<Scope> m_vScopes;
+    std::string m_sKey;
+};
+
+class GameDataHandler : public ResponseHandler<GameDataHandler>
+{
+public:
+    GameDataHandler(FetchGameData::Response& pResponse, JsonResponseReader::Envelope& pEnvelope) noexcept
+        : ResponseHandler(pResponse, pEnvelope), m_pGameData(pResponse)
+    {
+    }
+
+    Scope EnterObject(Scope nParent, const std::string& sKey)
+    {
+        switch (nParent)
+        {
+            case Scope::Root:
+                if (sKey == "PatchData")
+                {
+                    m_pEnvelope.HasPayload = true;
+                    return Scope::PatchData;
+                }
+                break;
+
+            case Scope::Achievements:
+                m_pGameData.Achievements.emplace_back();
+                m_nFields = 0;
+                return Scope::Achievement;
+
+            case Scope::Leaderboards:
+                m_pGameData.Leaderboards.emplace_back().Format = "VALUE";
+                m_nFields = 0;
+                return Scope::Leaderboard;
+        }
+
+        return Scope::Skip;
+    }
+
+    Scope EnterArray(Scope nParent, const std::string& sKey)
+    {
+        if (nParent == Scope::Root || nParent == Scope::PatchData)
+        {
+            if (sKey == "Achievements")
+            {
+                m_pEnvelope.HasPayload = true;
+                return Scope::Achievements;
+            }
+
+            if (sKey == "Leaderboards")
+            {
+                m_pEnvelope.HasPayload = true;
+                return Scope::Leaderboards;
+            }
+        }
+
+        return Scope::Skip;
+    }
+
+    void SetField(Scope nScope, const std::string& sKey, const JsonValue& pValue)
+    {
+        switch (nScope)
+        {
+            case Scope::Root:
+            case Scope::PatchData:
+                SetPatchDataField(sKey, pValue);
+                break;
+
+            case Scope::Achievement:
+                SetAchievementField(m_pGameData.Achievements.back(), sKey, pValue);
+                break;
+
+            case Scope::Leaderboard:
+                SetLeaderboardField(m_pGameData.Leaderboards.back(), sKey, pValue);
+                break;
+        }
+    }
+
+    void ExitObject(Scope nScope)
+    {
+        switch (nScope)
+        {
+            case Scope::Root:
+                // bare patch data (no envelope)
+                if (m_pEnvelope.HasPayload && !m_bPatchDataChecked)
+                    CheckPatchData();
+                break;
+
+            case Scope::PatchData:
+                CheckPatchData();
+                break;
+
+            case Scope::Achievement:
+                CheckRequired({"ID", "Title", "Description", "Flags", "MemAddr", "BadgeName", "Created", "Modified"});
+                break;
+
+            case Scope::Leaderboard:
+                CheckRequired({"ID", "Title", "Description", "Mem"});
+                break;
+        }
+    }
+
+private:
+    void SetPatchDataField(const std::string& sKey, const JsonValue& pValue)
+    {
+        if (sKey == "Title")
+        {
+            GetString(m_pGameData.Title, pValue);
+            m_nPatchDataFields |= 0x01;
+        }
+        else if (sKey == "ConsoleID")
+        {
+            m_pGameData.ConsoleId = GetRequiredUInt(pValue);
+            m_nPatchDataFields |= 0x02;
+        }
+        else if (sKey == "ForumTopicID")
+        {
+            m_pGameData.ForumTopicId = GetOptionalUInt(pValue);
+        }
+        else if (sKey == "Flags")
+        {
+            m_pGameData.Flags = GetOptionalUInt(pValue);
+        }
+        else if (sKey == "ImageIcon")
+        {
+            GetString(m_pGameData.ImageIcon, pValue);
+        }
+        else if (sKey == "RichPresencePatch")
+        {
+            GetString(m_pGameData.RichPresence, pValue);
+        }
+        else
+        {
+            return;
+        }
+
+        m_pEnvelope.HasPayload = true;
+    }
+
+    void SetAchievementField(FetchGameData::Response::Achievement& pAchievement, const std::string& sKey,
+                             const JsonValue& pValue)
+    {
+        if (sKey == "ID")
+        {
+            pAchievement.Id = GetRequiredUInt(pValue);
+            m_nFields |= 0x01;
+        }
+        else if (sKey == "Title")
+        {
+            GetString(pAchievement.Title, pValue);
+            m_nFields |= 0x02;
+        }
+        else if (sKey == "Description")
+        {
+            GetString(pAchievement.Description, pValue);
+            m_nFields |= 0x04;
+        }
+        else if (sKey == "Flags")
+        {
+            pAchievement.CategoryId = GetRequiredUInt(pValue);
+            m_nFields |= 0x08;
+        }
+        else if (sKey == "MemAddr")
+        {
+            GetString(pAchievement.Definition, pValue);
+            m_nFields |= 0x10;
+        }
+        else if (sKey == "BadgeName")
+        {
+            GetString(pAchievement.BadgeName, pValue);
+            m_nFields |= 0x20;
+        }
+        else if (sKey == "Created")
+        {
+            pAchievement.Created = static_cast<time_t>(GetRequiredUInt(pValue));
+            m_nFields |= 0x40;
+        }
+        else if (sKey == "Modified")
+        {
+            pAchievement.Updated = static_cast<time_t>(GetRequiredUInt(pValue));
+            m_nFields |= 0x80;
+        }
+        else if (sKey == "Points")
+        {
+            pAchievement.Points = GetOptionalUInt(pValue);
+        }
+        else if (sKey == "Author")
+        {
+            GetString(pAchievement.Author, pValue);
+        }
+    }
+
+    void SetLeaderboardField(FetchGameData::Response::Leaderboard& pLeaderboard, const std::string& sKey,
+                             const JsonValue& pValue)
+    {
+        if (sKey == "ID")
+        {
+            pLeaderboard.Id = GetRequiredUInt(pValue);
+            m_nFields |= 0x01;
+        }
+        else if (sKey == "Title")
+        {
+            GetString(pLeaderboard.Title, pValue);
+            m_nFields |= 0x02;
+        }
+        else if (sKey == "Description")
+        {
+            GetString(pLeaderboard.Description, pValue);
+            m_nFields |= 0x04;
+        }
+        else if (sKey == "Mem")
+        {
+            GetString(pLeaderboard.Definition, pValue);
+            m_nFields |= 0x08;
+        }
+        else if (sKey == "Format")
+        {
+            GetString(pLeaderboard.Format, pValue, "VALUE");
+        }
+    }
+
+    void CheckPatchData()
+    {
+        m_bPatchDataChecked = true;
+
+        if (!(m_nPatchDataFields & 0x01))
+            MissingField("Title");
+        if (!(m_nPatchDataFields & 0x02))
+            MissingField("ConsoleID");
+    }
+
+    void CheckRequired(std::initializer_list<const char*> vFields)
+    {
+        unsigned int nBit = 0x01;
+        for (const auto* sField : vFields)
+        {
+            if (!(m_nFields & nBit))
+                MissingField(sField);
+
+            nBit <<= 1;
+        }
+    }
+
+    FetchGameData::Response& m_pGameData;
+    unsigned int m_nPatchDataFields = 0; // required PatchData fields that have been seen
+    unsigned int m_nFields = 0;          // required fields of the current achievement or leaderboard that have been seen
+    bool m_bPatchDataChecked = false;
+};
+
+class CodeNotesHandler : public ResponseHandler<CodeNotesHandler>
+{
+public:
+    CodeNotesHandler(FetchCodeNotes::Response& pResponse, JsonResponseReader::Envelope& pEnvelope) noexcept
+        : ResponseHandler(pResponse, pEnvelope), m_pCodeNotes(pResponse)
+    {
+    }
+
+    Scope EnterObject(Scope nParent, const std::string&)
+    {
+        if (nParent != Scope::CodeNotes)
+            return Scope::Skip;
+
+        m_pCodeNotes.Notes.emplace_back();
+        m_nFields = 0;
+        return Scope::CodeNote;
+    }
+
+    Scope EnterArray(Scope nParent, const std::string& sKey)
+    {
+        // bare code notes (no envelope)
+        if (nParent == Scope::None || (nParent == Scope::Root && sKey == "CodeNotes"))
+        {
+            m_pEnvelope.HasPayload = true;
+            return Scope::CodeNotes;
+        }
+
+        return Scope::Skip;
+    }
+
+    void SetField(Scope nScope, const std::string& sKey, const JsonValue& pValue)
+    {
+        if (nScope != Scope::CodeNote)
+            return;
+
+        auto& pNote = m_pCodeNotes.Notes.back();
+        if (sKey == "User")
+        {
+            GetString(pNote.Author, pValue);
+            m_nFields |= 0x01;
+        }
+        else if (sKey == "Address")
+        {
+            std::string sAddress;
+            GetString(sAddress, pValue);
+            pNote.Address = ra::ByteAddressFromString(sAddress);
+            m_nFields |= 0x02;
+        }
+        else if (sKey == "Note")
+        {
+            GetString(pNote.Note, pValue);
+            m_nFields |= 0x04;
+        }
+    }
+
+    void ExitObject(Scope nScope)
+    {
+        if (nScope != Scope::CodeNote)
+            return;
+
+        if (!(m_nFields & 0x01))
+            MissingField("User");
+        if (!(m_nFields & 0x02))
+            MissingField("Address");
+        if (!(m_nFields & 0x04))
+            MissingField("Note");
+
+        // empty notes were deleted on the server - don't bother including them in the response
+        if (m_pCodeNotes.Notes.back().Note.empty())
+            m_pCodeNotes.Notes.pop_back();
+    }
+
+private:
+    FetchCodeNotes::Response& m_pCodeNotes;
+    unsigned int m_nFields = 0; // required fields of the current note that have been seen
+};
+
+} // namespace
+
+bool JsonResponseReader::ReadGameData(const std::string& sJson, FetchGameData::Response& response, Envelope& pEnvelope)
+{
+    GameDataHandler pHandler(response, pEnvelope);
+    rapidjson::Reader pReader;
+    rapidjson::StringStream pStream(sJson.c_str());
+    if (pReader.Parse(pStream, pHandler).IsError())
+        return false;
+
+    if (!response.ImageIcon.empty())
+    {
+        // ImageIcon value will be "/Images/001234.png" - extract the "001234"
+        auto nIndex = response.ImageIcon.find_last_of('/');
+        if (nIndex != std::string::npos)
+            response.ImageIcon.erase(0, nIndex + 1);
+        nIndex = response.ImageIcon.find_last_of('.');
+        if (nIndex != std::string::npos)
+            response.ImageIcon.erase(nIndex);
+    }
+
+    return true;
+}
+
+bool JsonResponseReader::ReadCodeNotes(const std::string& sJson, FetchCodeNotes::Response& response, Envelope& pEnvelope)
+{
+    CodeNotesHandler pHandler(response, pEnvelope);
+    rapidjson::Reader pReader;
+    rapidjson::StringStream pStream(sJson.c_str());
+    return !pReader.Parse(pStream, pHandler).IsError();
+}
+
+} // namespace impl
+} // namespace api
+} // namespace ra
@@ -0,0 +1,50 @@
+#ifndef RA_API_IMPL_JSON_RESPONSE_READER_HH
+#define RA_API_IMPL_JSON_RESPONSE_READER_HH
+#pragma once
+
+#include "api\FetchCodeNotes.hh"
+#include "api\FetchGameData.hh"
+
+namespace ra {
+namespace api {
+namespace impl {
+
+/// <summary>
+/// Decodes the larger API responses straight into their <c>Response</c> structures as the JSON is scanned,
+/// without building a DOM first.
+/// </summary>
+/// <remarks>
+/// Both the full server response (i.e. <c>{"Success":true,"PatchData":{...}}</c>) and the bare payload
+/// (i.e. <c>{...}</c>, as written to the cache by older versions) are accepted.
+/// </remarks>
+class JsonResponseReader
+{
+public:
+    /// <summary>
+    /// The status fields from the outermost object of a server response.
+    /// </summary>
+    struct Envelope
+    {
+        bool HasPayload = false; // the expected payload was found
+        bool Success = true;     // the value of the "Success" field, true if not present
+        std::string Error;       // the value of the "Error" field
+    };
+
+    /// <summary>
+    /// Decodes a <c>patch</c> response.
+    /// </summary>
+    /// <returns><c>false</c> if <paramref name="sJson" /> is not valid JSON.</returns>
+    static bool ReadGameData(const std::string& sJson, FetchGameData::Response& response, Envelope& pEnvelope);
+
+    /// <summary>
+    /// Decodes a <c>codenotes2</c> response.
+    /// </summary>
+    /// <returns><c>false</c> if <paramref name="sJson" /> is not valid JSON.</returns>
+    static bool ReadCodeNotes(const std::string& sJson, FetchCodeNotes::Response& response, Envelope& pEnvelope);
+};
+
+} // namespace impl
+} // namespace api
+} // namespace ra
+
+#endif // !RA_API_IMPL_JSON_RESPONSE_READER_HH
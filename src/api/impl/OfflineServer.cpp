@@ -1,8 +1,9 @@
 #include "OfflineServer.hh"
 
-#include "RA_Json.h"
+#include "RA_md5factory.h"
 
-#include "api\impl\ConnectedServer.hh"
+#include "api\impl\GameDataCache.hh"
+#include "api\impl\JsonResponseReader.hh"
 
 #include "services\ILocalStorage.hh"
 #include "services\ServiceLocator.hh"
@@ -11,6 +12,22 @@ namespace ra {
 namespace api {
 namespace impl {
 
+static std::string ReadAll(ra::services::TextReader& pReader)
+{
+    constexpr size_t nChunkSize = 16 * 1024;
+    std::string sContents;
+    size_t nRead = 0;
+    do
+    {
+        const auto nOffset = sContents.length();
+        sContents.resize(nOffset + nChunkSize);
+        GSL_SUPPRESS(bounds.3) nRead = pReader.GetBytes(&sContents.at(nOffset), nChunkSize);
+        sContents.resize(nOffset + nRead);
+    } while (nRead == nChunkSize);
+
+    return sContents;
+}
+
 Login::Response OfflineServer::Login(const Login::Request& request)
 {
     Login::Response response;
@@ -30,26 +47,47 @@ Logout::Response OfflineServer::Logout(const Logout::Request&)
 FetchGameData::Response OfflineServer::FetchGameData(const FetchGameData::Request& request)
 {
     FetchGameData::Response response;
-    rapidjson::Document document;
 
-    // see if the data is available in the cache
+    // the decoded copy can be used as long as the patch data hasn't been replaced since it was written
     auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-    auto pData = pLocalStorage.ReadText(ra::services::StorageItemType::GameData, std::to_wstring(request.GameId));
+    const auto sGameId = std::to_wstring(request.GameId);
+    if (pLocalStorage.GetLastModified(ra::services::StorageItemType::GameDataCache, sGameId) >=
+            pLocalStorage.GetLastModified(ra::services::StorageItemType::GameData, sGameId) &&
+        GameDataCache::Read(request.GameId, "", response))
+    {
+        response.Result = ApiResult::Success;
+        return std::move(response);
+    }
+
+    // see if the data is available in the cache
+    auto pData = pLocalStorage.ReadText(ra::services::StorageItemType::GameData, sGameId);
     if (pData == nullptr)
     {
         response.Result = ApiResult::Failed;
         response.ErrorMessage = ra::StringPrintf("Achievement data for game %u not found in cache", request.GameId);
     }
-    else if (!LoadDocument(document, *pData.get()))
-    {
-        response.Result = ApiResult::Error;
-        response.ErrorMessage =
-            ra::StringPrintf("%s (%zu)", GetParseError_En(document.GetParseError()), document.GetErrorOffset());
-    }
     else
     {
+        const auto sPatchData = ReadAll(*pData);
+        JsonResponseReader::Envelope pEnvelope;
+
         response.Result = ApiResult::Success;
-        ConnectedServer::ProcessGamePatchData(response, document);
+        if (!JsonResponseReader::ReadGameData(sPatchData, response, pEnvelope))
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = ra::StringPrintf("Achievement data for game %u is corrupt", request.GameId);
+        }
+        else if (!pEnvelope.HasPayload)
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = ra::StringPrintf("%s not found in response", "PatchData");
+        }
+        else if (response.Result == ApiResult::Success)
+        {
+            // rebuild the decoded copy so the next load can use it
+            GameDataCache::CalculateDefinitionSizes(response);
+            GameDataCache::Write(request.GameId, RAGenerateMD5(sPatchData), response);
+        }
     }
 
     return std::move(response);
@@ -58,7 +96,6 @@ FetchGameData::Response OfflineServer::FetchGameData(const FetchGameData::Reques
 FetchCodeNotes::Response OfflineServer::FetchCodeNotes(const FetchCodeNotes::Request& request)
 {
     FetchCodeNotes::Response response;
-    rapidjson::Document document;
 
     // see if the data is available in the cache
     auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
@@ -68,16 +105,21 @@ FetchCodeNotes::Response OfflineServer::FetchCodeNotes(const FetchCodeNotes::Req
         response.Result = ApiResult::Failed;
         response.ErrorMessage = ra::StringPrintf("Code notes for game %u not found in cache", request.GameId);
     }
-    else if (!LoadDocument(document, *pData.get()))
-    {
-        response.Result = ApiResult::Error;
-        response.ErrorMessage =
-            ra::StringPrintf("%s (%zu)", GetParseError_En(document.GetParseError()), document.GetErrorOffset());
-    }
     else
     {
+        JsonResponseReader::Envelope pEnvelope;
+
         response.Result = ApiResult::Success;
-        ConnectedServer::ProcessCodeNotes(response, document);
+        if (!JsonResponseReader::ReadCodeNotes(ReadAll(*pData), response, pEnvelope))
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = ra::StringPrintf("Code notes for game %u are corrupt", request.GameId);
+        }
+        else if (!pEnvelope.HasPayload)
+        {
+            response.Result = ApiResult::Error;
+            response.ErrorMessage = ra::StringPrintf("%s not found in response", "CodeNotes");
+        }
     }
 
     return std::move(response);
@@ -0,0 +1,235 @@
+#include "CodeNoteIndex.hh"
+
+namespace ra {
+namespace data {
+
+static bool StartsWithNoCase(const std::wstring& sText, size_t nIndex, const wchar_t* sPrefix) noexcept
+{
+    for (; *sPrefix; ++sPrefix, ++nIndex)
+    {
+        if (nIndex >= sText.length() || towlower(sText[nIndex]) != *sPrefix)
+            return false;
+    }
+
+    return true;
+}
+
+unsigned int CodeNoteIndex::GetNoteSize(const std::wstring& sNote)
+{
+    // look for the first number followed by "bit" or "byte": "[16-bit]", "(32 bit)", "[4 bytes]", "[0x20 bytes]"
+    for (size_t nIndex = 0; nIndex < sNote.length(); ++nIndex)
+    {
+        if (!iswdigit(sNote.at(nIndex)) || (nIndex > 0 && iswalnum(sNote.at(nIndex - 1))))
+            continue;
+
+        unsigned long long nValue = 0;
+        if (StartsWithNoCase(sNote, nIndex, L"0x"))
+        {
+            nIndex += 2;
+            while (nIndex < sNote.length() && iswxdigit(sNote.at(nIndex)) && nValue <= UINT_MAX)
+            {
+                const auto c = towlower(sNote.at(nIndex++));
+                nValue = nValue * 16 + ((c >= L'a') ? (c - L'a' + 10) : (c - L'0'));
+            }
+        }
+        else
+        {
+            while (nIndex < sNote.length() && iswdigit(sNote.at(nIndex)) && nValue <= UINT_MAX)
+                nValue = nValue * 10 + (sNote.at(nIndex++) - L'0');
+        }
+
+        const auto nEnd = nIndex;
+        if (nIndex < sNote.length() && (sNote.at(nIndex) == L'-' || sNote.at(nIndex) == L' '))
+            ++nIndex;
+
+        if (nValue > 0 && nValue <= UINT_MAX)
+        {
+            if (StartsWithNoCase(sNote, nIndex, L"bit"))
+                return std::max(gsl::narrow_cast<unsigned int>(nValue / 8), 1U);
+
+            if (StartsWithNoCase(sNote, nIndex, L"byte"))
+                return gsl::narrow_cast<unsigned int>(nValue);
+        }
+
+        // resume scanning right after the number
+        nIndex = nEnd - 1;
+    }
+
+    return 1;
+}
+
+void CodeNoteIndex::Set(ra::ByteAddress nAddress, unsigned int nSize)
+{
+    Expects(nSize > 0);
+    const auto nLast = (nSize - 1 > UINT_MAX - nAddress) ? UINT_MAX : nAddress + nSize - 1;
+
+    // the size may have changed enough to move the note to the other list
+    const bool bWasLong = !RemoveEntry(m_vEntries, nAddress) && RemoveEntry(m_vLongEntries, nAddress);
+    const bool bIsLong = (nSize > MaxShortNoteSize);
+    auto& vEntries = bIsLong ? m_vLongEntries : m_vEntries;
+
+    // notes are usually loaded in address order, which only ever appends
+    auto pIter = vEntries.end();
+    if (!vEntries.empty() && vEntries.back().nStart > nAddress)
+    {
+        pIter = std::lower_bound(vEntries.begin(), vEntries.end(), nAddress,
+                                 [](const Entry& pEntry, ra::ByteAddress nValue) noexcept { return pEntry.nStart < nValue; });
+    }
+
+    vEntries.insert(pIter, Entry{nAddress, nLast, nLast});
+
+    if (bWasLong || bIsLong)
+        UpdateMaxLast(0, m_vLongEntries.size());
+}
+
+void CodeNoteIndex::Remove(ra::ByteAddress nAddress)
+{
+    if (!RemoveEntry(m_vEntries, nAddress) && RemoveEntry(m_vLongEntries, nAddress))
+        UpdateMaxLast(0, m_vLongEntries.size());
+}
+
+bool CodeNoteIndex::RemoveEntry(std::vector<Entry>& vEntries, ra::ByteAddress nAddress)
+{
+    const auto pIter = std::lower_bound(vEntries.begin(), vEntries.end(), nAddress,
+                                        [](const Entry& pEntry, ra::ByteAddress nValue) noexcept { return pEntry.nStart < nValue; });
+    if (pIter == vEntries.end() || pIter->nStart != nAddress)
+        return false;
+
+    vEntries.erase(pIter);
+    return true;
+}
+
+GSL_SUPPRESS(bounds.4)
+ra::ByteAddress CodeNoteIndex::UpdateMaxLast(size_t nFirst, size_t nEnd) noexcept
+{
+    // only touches the long notes, of which there are usually few
+    if (nFirst >= nEnd)
+        return 0;
+
+    const auto nMiddle = nFirst + (nEnd - nFirst) / 2;
+    const auto nLeftMax = UpdateMaxLast(nFirst, nMiddle);
+    const auto nRightMax = UpdateMaxLast(nMiddle + 1, nEnd);
+
+    auto& pEntry = m_vLongEntries[nMiddle];
+    pEntry.nMaxLast = std::max({pEntry.nLast, nLeftMax, nRightMax});
+    return pEntry.nMaxLast;
+}
+
+GSL_SUPPRESS(bounds.4)
+const CodeNoteIndex::Entry* CodeNoteIndex::FindLongNote(size_t nFirst, size_t nEnd, ra::ByteAddress nAddress) const noexcept
+{
+    if (nFirst >= nEnd)
+        return nullptr;
+
+    const auto nMiddle = nFirst + (nEnd - nFirst) / 2;
+    const auto& pEntry = m_vLongEntries[nMiddle];
+    if (pEntry.nMaxLast < nAddress) // nothing in this subtree reaches nAddress
+        return nullptr;
+
+    if (pEntry.nStart <= nAddress)
+    {
+        // prefer the note starting closest to nAddress
+        const auto* pFound = FindLongNote(nMiddle + 1, nEnd, nAddress);
+        if (pFound != nullptr)
+            return pFound;
+
+        if (pEntry.nLast >= nAddress)
+            return &pEntry;
+    }
+
+    return FindLongNote(nFirst, nMiddle, nAddress);
+}
+
+GSL_SUPPRESS(bounds.4)
+void CodeNoteIndex::FindLongNotes(size_t nFirst, size_t nEnd, ra::ByteAddress nFirstAddress,
+                                  ra::ByteAddress nLastAddress, std::vector<const Entry*>& vNotes) const
+{
+    if (nFirst >= nEnd)
+        return;
+
+    const auto nMiddle = nFirst + (nEnd - nFirst) / 2;
+    const auto& pEntry = m_vLongEntries[nMiddle];
+    if (pEntry.nMaxLast < nFirstAddress)
+        return;
+
+    // in order, so the notes are collected in address order
+    FindLongNotes(nFirst, nMiddle, nFirstAddress, nLastAddress, vNotes);
+
+    if (pEntry.nStart <= nLastAddress)
+    {
+        if (pEntry.nLast >= nFirstAddress)
+            vNotes.push_back(&pEntry);
+
+        FindLongNotes(nMiddle + 1, nEnd, nFirstAddress, nLastAddress, vNotes);
+    }
+}
+
+bool CodeNoteIndex::FindNoteStart(ra::ByteAddress nAddress, ra::ByteAddress& nNoteAddress) const
+{
+    // a short note covering nAddress has to start within MaxShortNoteSize bytes of it
+    const auto nEarliestStart = (nAddress >= MaxShortNoteSize - 1) ? nAddress - (MaxShortNoteSize - 1) : 0U;
+    const auto pFirst = std::lower_bound(m_vEntries.begin(), m_vEntries.end(), nEarliestStart,
+                                         [](const Entry& pEntry, ra::ByteAddress nValue) noexcept { return pEntry.nStart < nValue; });
+    auto pIter = std::upper_bound(pFirst, m_vEntries.end(), nAddress,
+                                  [](ra::ByteAddress nValue, const Entry& pEntry) noexcept { return nValue < pEntry.nStart; });
+
+    // walk backwards from the last note starting at or before nAddress, the first one that reaches it is the closest
+    const Entry* pShort = nullptr;
+    while (pIter != pFirst)
+    {
+        --pIter;
+        if (pIter->nLast >= nAddress)
+        {
+            pShort = &*pIter;
+            break;
+        }
+    }
+
+    const auto* pLong = FindLongNote(0, m_vLongEntries.size(), nAddress);
+    if (pLong != nullptr && (pShort == nullptr || pLong->nStart > pShort->nStart))
+        pShort = pLong;
+
+    if (pShort == nullptr)
+    {
+        nNoteAddress = 0;
+        return false;
+    }
+
+    nNoteAddress = pShort->nStart;
+    return true;
+}
+
+void CodeNoteIndex::EnumerateNotes(ra::ByteAddress nFirstAddress, ra::ByteAddress nLastAddress,
+                                   std::function<bool(ra::ByteAddress nAddress, unsigned int nSize)> callback) const
+{
+    std::vector<const Entry*> vLongNotes;
+    FindLongNotes(0, m_vLongEntries.size(), nFirstAddress, nLastAddress, vLongNotes);
+    auto pLongIter = vLongNotes.begin();
+
+    const auto nEarliestStart = (nFirstAddress >= MaxShortNoteSize - 1) ? nFirstAddress - (MaxShortNoteSize - 1) : 0U;
+    const auto pEnd = std::upper_bound(m_vEntries.begin(), m_vEntries.end(), nLastAddress,
+                                       [](ra::ByteAddress nValue, const Entry& pEntry) noexcept { return nValue < pEntry.nStart; });
+    auto pIter = std::lower_bound(m_vEntries.begin(), pEnd, nEarliestStart,
+                                  [](const Entry& pEntry, ra::ByteAddress nValue) noexcept { return pEntry.nStart < nValue; });
+
+    // merge the short and long notes back into address order
+    do
+    {
+        while (pIter != pEnd && pIter->nLast < nFirstAddress)
+            ++pIter;
+
+        const Entry* pNote = nullptr;
+        if (pIter != pEnd && (pLongIter == vLongNotes.end() || pIter->nStart < (*pLongIter)->nStart))
+            pNote = &*pIter++;
+        else if (pLongIter != vLongNotes.end())
+            pNote = *pLongIter++;
+        else
+            break;
+
+        if (!callback(pNote->nStart, pNote->nLast - pNote->nStart + 1))
+            break;
+    } while (true);
+}
+
+} // namespace data
+} // namespace ra
@@ -0,0 +1,92 @@
+#ifndef RA_DATA_CODENOTEINDEX_HH
+#define RA_DATA_CODENOTEINDEX_HH
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace ra {
+namespace data {
+
+/// <summary>
+/// Tracks the range of memory each code note describes, so the note covering an arbitrary byte can be found
+/// without scanning every note.
+/// </summary>
+/// <remarks>
+/// Short notes can only cover an address if they start a few bytes before it, so they're found with a binary
+/// search over their start addresses. Longer notes (arrays, structures) are kept separately in an interval tree so
+/// a single large note doesn't make every lookup after it scan backwards.
+/// </remarks>
+class CodeNoteIndex
+{
+public:
+    /// <summary>
+    /// Determines how many bytes a note describes from a size hint in its text, like "[16-bit]" or "[32 bytes]".
+    /// </summary>
+    /// <returns>The number of bytes described by the note, <c>1</c> if the note doesn't specify a size.</returns>
+    static unsigned int GetNoteSize(const std::wstring& sNote);
+
+    /// <summary>
+    /// Adds or updates the note starting at <paramref name="nAddress" />.
+    /// </summary>
+    void Set(ra::ByteAddress nAddress, unsigned int nSize);
+
+    /// <summary>
+    /// Removes the note starting at <paramref name="nAddress" />.
+    /// </summary>
+    void Remove(ra::ByteAddress nAddress);
+
+    /// <summary>
+    /// Removes all notes.
+    /// </summary>
+    void Clear() noexcept
+    {
+        m_vEntries.clear();
+        m_vLongEntries.clear();
+    }
+
+    /// <summary>
+    /// Finds the note covering the specified address.
+    /// </summary>
+    /// <param name="nAddress">The address to look up.</param>
+    /// <param name="nNoteAddress">Receives the address the note starts at.</param>
+    /// <returns><c>true</c> if a note covers the address. If several do, the one starting closest to it.</returns>
+    bool FindNoteStart(ra::ByteAddress nAddress, _Out_ ra::ByteAddress& nNoteAddress) const;
+
+    /// <summary>
+    /// Enumerates the notes covering any part of a range of addresses.
+    /// </summary>
+    /// <remarks>
+    /// <paramref name="callback" /> is called with the start address and size of each note, in address order. If it
+    /// returns <c>false</c> enumeration stops.
+    /// </remarks>
+    void EnumerateNotes(ra::ByteAddress nFirstAddress, ra::ByteAddress nLastAddress,
+                        std::function<bool(ra::ByteAddress nAddress, unsigned int nSize)> callback) const;
+
+private:
+    // notes larger than this are kept in the interval tree
+    static constexpr unsigned int MaxShortNoteSize = 8;
+
+    struct Entry
+    {
+        ra::ByteAddress nStart;
+        ra::ByteAddress nLast;     // last byte covered by the note
+        ra::ByteAddress nMaxLast;  // long notes only: largest nLast in the subtree rooted at this entry
+    };
+
+    static bool RemoveEntry(std::vector<Entry>& vEntries, ra::ByteAddress nAddress);
+
+    // m_vLongEntries is an implicit balanced tree: the root of the range [nFirst, nEnd) is the entry in the middle
+    ra::ByteAddress UpdateMaxLast(size_t nFirst, size_t nEnd) noexcept;
+    const Entry* FindLongNote(size_t nFirst, size_t nEnd, ra::ByteAddress nAddress) const noexcept;
+    void FindLongNotes(size_t nFirst, size_t nEnd, ra::ByteAddress nFirstAddress, ra::ByteAddress nLastAddress,
+                       std::vector<const Entry*>& vNotes) const;
+
+    std::vector<Entry> m_vEntries;     // notes up to MaxShortNoteSize bytes, sorted by nStart
+    std::vector<Entry> m_vLongEntries; // larger notes, sorted by nStart
+};
+
+} // namespace data
+} // namespace ra
+
+#endif // !RA_DATA_CODENOTEINDEX_HH
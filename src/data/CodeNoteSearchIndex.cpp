@@ -0,0 +1,142 @@
+#include "CodeNoteSearchIndex.hh"
+
+namespace ra {
+namespace data {
+
+std::wstring CodeNoteSearchIndex::Fold(const std::wstring& sText)
+{
+    std::wstring sFolded = sText;
+    for (auto& c : sFolded)
+        c = towlower(c);
+
+    return sFolded;
+}
+
+std::vector<CodeNoteSearchIndex::Trigram> CodeNoteSearchIndex::GetTrigrams(const std::wstring& sFoldedText)
+{
+    std::vector<Trigram> vTrigrams;
+    if (sFoldedText.length() < 3)
+        return vTrigrams;
+
+    vTrigrams.reserve(sFoldedText.length() - 2);
+    for (size_t nIndex = 0; nIndex + 2 < sFoldedText.length(); ++nIndex)
+    {
+        vTrigrams.push_back((static_cast<Trigram>(sFoldedText.at(nIndex)) << 42) |
+                            (static_cast<Trigram>(sFoldedText.at(nIndex + 1)) << 21) |
+                            static_cast<Trigram>(sFoldedText.at(nIndex + 2)));
+    }
+
+    std::sort(vTrigrams.begin(), vTrigrams.end());
+    vTrigrams.erase(std::unique(vTrigrams.begin(), vTrigrams.end()), vTrigrams.end());
+    return vTrigrams;
+}
+
+void CodeNoteSearchIndex::Set(ra::ByteAddress nAddress, const std::wstring& sNote)
+{
+    Remove(nAddress);
+
+    auto sFolded = Fold(sNote);
+    for (const auto nTrigram : GetTrigrams(sFolded))
+    {
+        // notes are usually added in address order, which only ever appends
+        auto& vAddresses = m_mPostings[nTrigram];
+        if (vAddresses.empty() || vAddresses.back() < nAddress)
+            vAddresses.push_back(nAddress);
+        else
+            vAddresses.insert(std::lower_bound(vAddresses.begin(), vAddresses.end(), nAddress), nAddress);
+    }
+
+    m_mFoldedNotes.insert_or_assign(nAddress, std::move(sFolded));
+}
+
+void CodeNoteSearchIndex::Remove(ra::ByteAddress nAddress)
+{
+    const auto pNote = m_mFoldedNotes.find(nAddress);
+    if (pNote == m_mFoldedNotes.end())
+        return;
+
+    for (const auto nTrigram : GetTrigrams(pNote->second))
+    {
+        const auto pPosting = m_mPostings.find(nTrigram);
+        if (pPosting == m_mPostings.end())
+            continue;
+
+        auto& vAddresses = pPosting->second;
+        const auto pIter = std::lower_bound(vAddresses.begin(), vAddresses.end(), nAddress);
+        if (pIter != vAddresses.end() && *pIter == nAddress)
+            vAddresses.erase(pIter);
+
+        if (vAddresses.empty())
+            m_mPostings.erase(pPosting);
+    }
+
+    m_mFoldedNotes.erase(pNote);
+}
+
+void CodeNoteSearchIndex::Clear() noexcept
+{
+    m_mFoldedNotes.clear();
+    m_mPostings.clear();
+}
+
+std::vector<ra::ByteAddress> CodeNoteSearchIndex::Search(const std::wstring& sText) const
+{
+    std::vector<ra::ByteAddress> vMatches;
+    if (sText.empty())
+        return vMatches;
+
+    const auto sFolded = Fold(sText);
+    const auto vTrigrams = GetTrigrams(sFolded);
+    if (vTrigrams.empty())
+    {
+        // too short to use the index
+        for (const auto& pNote : m_mFoldedNotes)
+        {
+            if (pNote.second.find(sFolded) != std::wstring::npos)
+                vMatches.push_back(pNote.first);
+        }
+
+        std::sort(vMatches.begin(), vMatches.end());
+        return vMatches;
+    }
+
+    // start with the shortest list of candidates and narrow it down with the others
+    std::vector<const std::vector<ra::ByteAddress>*> vPostings;
+    vPostings.reserve(vTrigrams.size());
+    for (const auto nTrigram : vTrigrams)
+    {
+        const auto pPosting = m_mPostings.find(nTrigram);
+        if (pPosting == m_mPostings.end())
+            return vMatches;
+
+        vPostings.push_back(&pPosting->second);
+    }
+
+    std::sort(vPostings.begin(), vPostings.end(),
+              [](const std::vector<ra::ByteAddress>* pLeft, const std::vector<ra::ByteAddress>* pRight) noexcept
+              { return pLeft->size() < pRight->size(); });
+
+    std::vector<ra::ByteAddress> vCandidates = *vPostings.front();
+    std::vector<ra::ByteAddress> vNarrowed;
+    for (size_t nIndex = 1; nIndex < vPostings.size() && !vCandidates.empty(); ++nIndex)
+    {
+        vNarrowed.clear();
+        const auto* pPosting = vPostings.at(nIndex);
+        std::set_intersection(vCandidates.begin(), vCandidates.end(), pPosting->begin(), pPosting->end(),
+                              std::back_inserter(vNarrowed));
+        vCandidates.swap(vNarrowed);
+    }
+
+    // having all of the trigrams doesn't mean they're in the right order, so confirm each candidate
+    for (const auto nAddress : vCandidates)
+    {
+        const auto pNote = m_mFoldedNotes.find(nAddress);
+        if (pNote != m_mFoldedNotes.end() && pNote->second.find(sFolded) != std::wstring::npos)
+            vMatches.push_back(nAddress);
+    }
+
+    return vMatches;
+}
+
+} // namespace data
+} // namespace ra
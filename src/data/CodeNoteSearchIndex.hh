@@ -0,0 +1,56 @@
+#ifndef RA_DATA_CODENOTESEARCHINDEX_HH
+#define RA_DATA_CODENOTESEARCHINDEX_HH
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ra {
+namespace data {
+
+/// <summary>
+/// Case-insensitive substring search over code note text.
+/// </summary>
+/// <remarks>
+/// Every three character sequence in a note is mapped to the addresses of the notes containing it. A query only
+/// has to check the notes that contain all of its three character sequences.
+/// </remarks>
+class CodeNoteSearchIndex
+{
+public:
+    /// <summary>
+    /// Adds or replaces the text of the note at <paramref name="nAddress" />.
+    /// </summary>
+    void Set(ra::ByteAddress nAddress, const std::wstring& sNote);
+
+    /// <summary>
+    /// Removes the note at <paramref name="nAddress" />.
+    /// </summary>
+    void Remove(ra::ByteAddress nAddress);
+
+    /// <summary>
+    /// Removes all notes.
+    /// </summary>
+    void Clear() noexcept;
+
+    /// <summary>
+    /// Finds the notes containing <paramref name="sText" />, ignoring case.
+    /// </summary>
+    /// <returns>The addresses of the matching notes, in ascending order.</returns>
+    std::vector<ra::ByteAddress> Search(const std::wstring& sText) const;
+
+private:
+    using Trigram = unsigned long long;
+
+    static std::wstring Fold(const std::wstring& sText);
+    static std::vector<Trigram> GetTrigrams(const std::wstring& sFoldedText);
+
+    std::unordered_map<ra::ByteAddress, std::wstring> m_mFoldedNotes;
+    std::unordered_map<Trigram, std::vector<ra::ByteAddress>> m_mPostings; // each list in ascending order
+};
+
+} // namespace data
+} // namespace ra
+
+#endif // !RA_DATA_CODENOTESEARCHINDEX_HH
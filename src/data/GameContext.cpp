@@ -17,12 +17,15 @@
 #include "api\SubmitLeaderboardEntry.hh"
 #include "api\UpdateCodeNote.hh"
 
+#include "data\SubmissionJournal.hh"
 #include "data\UserContext.hh"
 
 #include "services\AchievementRuntime.hh"
+#include "services\CompiledTrigger.hh"
 #include "services\IAudioSystem.hh"
 #include "services\IConfiguration.hh"
 #include "services\ILocalStorage.hh"
+#include "services\WorkerGroup.hh"
 #include "services\impl\FileTextReader.hh"
 #include "services\impl\FileTextWriter.hh"
 #include "services\impl\StringTextReader.hh"
@@ -44,8 +47,8 @@ static void RefreshOverlay()
     pOverlayManager.RefreshOverlay();
 }
 
-static void CopyAchievementData(Achievement& pAchievement,
-                                const ra::api::FetchGameData::Response::Achievement& pAchievementData)
+static void CopyAchievementMetadata(Achievement& pAchievement,
+                                    const ra::api::FetchGameData::Response::Achievement& pAchievementData)
 {
     pAchievement.SetTitle(pAchievementData.Title);
     pAchievement.SetDescription(pAchievementData.Description);
@@ -54,9 +57,138 @@ static void CopyAchievementData(Achievement& pAchievement,
     pAchievement.SetCreatedDate(pAchievementData.Created);
     pAchievement.SetModifiedDate(pAchievementData.Updated);
     pAchievement.SetBadgeImage(pAchievementData.BadgeName);
+}
+
+static void CopyAchievementData(Achievement& pAchievement,
+                                const ra::api::FetchGameData::Response::Achievement& pAchievementData)
+{
+    CopyAchievementMetadata(pAchievement, pAchievementData);
     pAchievement.ParseTrigger(pAchievementData.Definition.c_str());
 }
 
+namespace {
+
+struct PendingDefinition
+{
+    const std::string* sDefinition;
+    Achievement* pAchievement;     // set for achievements
+    RA_Leaderboard* pLeaderboard;  // set for leaderboards
+    const std::string* sFormat;    // leaderboards only
+    int nSize;
+    void* pBuffer;
+    std::exception_ptr pError;     // thrown while parsing on a worker, rethrown on the loading thread
+};
+
+} // namespace
+
+GSL_SUPPRESS(bounds.4)
+static void SizeDefinition(size_t nIndex, void* pContext) noexcept
+{
+    // WorkerGroup only passes indices in range
+    auto& pDefinition = (*static_cast<std::vector<PendingDefinition>*>(pContext))[nIndex];
+    // already calculated by this build when the response was decoded. sizes are never read from disk.
+    if (pDefinition.nSize != 0)
+        return;
+
+    if (pDefinition.pAchievement != nullptr)
+        pDefinition.nSize = rc_trigger_size(pDefinition.sDefinition->c_str());
+    else
+        pDefinition.nSize = rc_lboard_size(pDefinition.sDefinition->c_str());
+}
+
+GSL_SUPPRESS(bounds.4)
+static void ParseDefinition(size_t nIndex, void* pContext) noexcept
+{
+    auto& pDefinition = (*static_cast<std::vector<PendingDefinition>*>(pContext))[nIndex];
+    if (pDefinition.pBuffer == nullptr)
+        return;
+
+    // handlers run on worker threads and must not throw. parsing allocates, so capture anything it throws and
+    // let the loading thread deal with it.
+    try
+    {
+        if (pDefinition.pAchievement != nullptr)
+        {
+            pDefinition.pAchievement->ParseTrigger(pDefinition.sDefinition->c_str(), pDefinition.pBuffer);
+        }
+        else
+        {
+            pDefinition.pLeaderboard->ParseFromString(pDefinition.sDefinition->c_str(), pDefinition.pBuffer,
+                                                      pDefinition.sFormat->c_str());
+        }
+    }
+    catch (...)
+    {
+        pDefinition.pError = std::current_exception();
+    }
+}
+
+/// <summary>
+/// Parses the triggers for a set of achievements and leaderboards, spreading the work across several threads
+/// for large sets.
+/// </summary>
+/// <remarks>
+/// None of the achievements or leaderboards may be active. An inactive object doesn't register anything with the
+/// runtime while it's parsed, so parsing only touches the object itself and its buffer, which is what allows
+/// different objects to be parsed on different threads.
+/// </remarks>
+static void ParseDefinitions(ra::services::ParseArena& pArena, std::unique_ptr<ra::services::WorkerGroup>& pWorkers,
+                             std::vector<PendingDefinition>& vDefinitions)
+{
+    // below this, handing the work to the other threads costs more than it saves
+    constexpr size_t ParallelParseThreshold = 64;
+
+    if (vDefinitions.size() < ParallelParseThreshold)
+    {
+        for (size_t nIndex = 0; nIndex < vDefinitions.size(); ++nIndex)
+            SizeDefinition(nIndex, &vDefinitions);
+    }
+    else
+    {
+        // the threads are kept for later loads rather than being started every time
+        if (pWorkers == nullptr)
+        {
+            const auto nWorkers = std::min(std::max(std::thread::hardware_concurrency(), 1U), 8U);
+            pWorkers = std::make_unique<ra::services::WorkerGroup>(nWorkers);
+        }
+
+        // sizing and parsing don't share any state, so they can be done in parallel. the buffers are allocated
+        // in between on this thread, which keeps them contiguous and in load order.
+        pWorkers->ForEach(vDefinitions.size(), SizeDefinition, &vDefinitions);
+    }
+
+    for (auto& pDefinition : vDefinitions)
+    {
+        if (pDefinition.nSize > 0)
+            pDefinition.pBuffer = pArena.Allocate(ra::to_unsigned(pDefinition.nSize));
+    }
+
+    if (vDefinitions.size() < ParallelParseThreshold)
+    {
+        for (size_t nIndex = 0; nIndex < vDefinitions.size(); ++nIndex)
+            ParseDefinition(nIndex, &vDefinitions);
+    }
+    else
+    {
+        pWorkers->ForEach(vDefinitions.size(), ParseDefinition, &vDefinitions);
+    }
+
+    // errors have to be reported on this thread
+    for (const auto& pDefinition : vDefinitions)
+    {
+        if (pDefinition.pError != nullptr)
+            std::rethrow_exception(pDefinition.pError);
+
+        if (pDefinition.nSize < 0)
+        {
+            if (pDefinition.pAchievement != nullptr)
+                pDefinition.pAchievement->SetTriggerParseError(pDefinition.nSize);
+            else
+                pDefinition.pLeaderboard->SetParseError(pDefinition.nSize);
+        }
+    }
+}
+
 void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
 {
     m_nGameId = nGameId;
@@ -64,8 +196,19 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
     m_sGameTitle.clear();
     m_pRichPresence = nullptr;
     m_mCodeNotes.clear();
+    m_pCodeNoteIndex.Clear();
+    m_pCodeNoteSearchIndex.Clear();
     m_nNextLocalId = GameContext::FirstLocalId;
 
+    unsigned int nLoadId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mLoadMutex);
+        nLoadId = ++m_nLoadId;
+        m_bDefinitionsLoaded = false;
+        m_bUnlocksReceived = false;
+        m_vPendingUnlocks.clear();
+    }
+
     if (!m_vAchievements.empty())
     {
         for (auto& pAchievement : m_vAchievements)
@@ -87,6 +230,9 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
         m_vLeaderboards.clear();
     }
 
+    // nothing references the parsed data for the previous game anymore
+    m_pParseArena.Reset();
+
     if (nGameId == 0)
     {
         m_sGameHash.clear();
@@ -94,6 +240,12 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
         return;
     }
 
+    // start the code notes and unlocks requests before waiting on the game data so the round trips overlap.
+    // neither depends on the game data, and the unlocks are held until the achievements have been created.
+    RefreshCodeNotes();
+    if (nMode != Mode::CompatibilityTest)
+        RequestUnlocksForLoad(nLoadId);
+
     ra::api::FetchGameData::Request request;
     request.GameId = nGameId;
 
@@ -105,12 +257,6 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
         return;
     }
 
-    RefreshCodeNotes();
-
-#ifndef RA_UTEST
-    auto& pImageRepository = ra::services::ServiceLocator::GetMutable<ra::ui::IImageRepository>();
-#endif
-
     // game properties
     m_sGameTitle = response.Title;
 
@@ -131,18 +277,18 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
     const bool bWasPaused = pRuntime.IsPaused();
     pRuntime.SetPaused(true);
 
+    std::vector<PendingDefinition> vDefinitions;
+    vDefinitions.reserve(response.Achievements.size() + response.Leaderboards.size());
+
     unsigned int nNumCoreAchievements = 0;
     unsigned int nTotalCoreAchievementPoints = 0;
     for (const auto& pAchievementData : response.Achievements)
     {
         auto& pAchievement = NewAchievement(ra::itoe<AchievementSet::Type>(pAchievementData.CategoryId));
         pAchievement.SetID(pAchievementData.Id);
-        CopyAchievementData(pAchievement, pAchievementData);
-
-#ifndef RA_UTEST
-        // prefetch the achievement image
-        pImageRepository.FetchImage(ra::ui::ImageType::Badge, pAchievementData.BadgeName);
-#endif
+        CopyAchievementMetadata(pAchievement, pAchievementData);
+        vDefinitions.push_back({&pAchievementData.Definition, &pAchievement, nullptr, nullptr,
+                                pAchievementData.DefinitionSize, nullptr});
 
         if (pAchievementData.CategoryId == ra::to_unsigned(ra::etoi(AchievementSet::Type::Core)))
         {
@@ -157,9 +303,13 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
         RA_Leaderboard& pLeaderboard = *m_vLeaderboards.emplace_back(std::make_unique<RA_Leaderboard>(pLeaderboardData.Id));
         pLeaderboard.SetTitle(pLeaderboardData.Title);
         pLeaderboard.SetDescription(pLeaderboardData.Description);
-        pLeaderboard.ParseFromString(pLeaderboardData.Definition.c_str(), pLeaderboardData.Format.c_str());
+        vDefinitions.push_back(
+            {&pLeaderboardData.Definition, nullptr, &pLeaderboard, &pLeaderboardData.Format,
+             pLeaderboardData.DefinitionSize, nullptr});
     }
 
+    ParseDefinitions(m_pParseArena, m_pParseWorkers, vDefinitions);
+
     ActivateLeaderboards();
 
     // merge local achievements
@@ -173,12 +323,76 @@ void GameContext::LoadGame(unsigned int nGameId, Mode nMode)
         ra::StringPrintf(L"%u achievements, %u points", nNumCoreAchievements, nTotalCoreAchievementPoints),
         ra::ui::ImageType::Icon, response.ImageIcon);
 
-    // get user unlocks asynchronously
-    RefreshUnlocks(!bWasPaused, nPopup);
+    // activate the achievements now if the unlocks have already arrived, otherwise when they do
+    ActivateAfterLoad(!bWasPaused, nPopup);
+
+#ifndef RA_UTEST
+    // prefetch the achievement images. queued last so they don't compete with anything needed to start playing
+    auto& pImageRepository = ra::services::ServiceLocator::GetMutable<ra::ui::IImageRepository>();
+    for (const auto& pAchievementData : response.Achievements)
+        pImageRepository.FetchImage(ra::ui::ImageType::Badge, pAchievementData.BadgeName);
+#endif
 
     RefreshOverlay();
 }
 
+void GameContext::RequestUnlocksForLoad(unsigned int nLoadId)
+{
+    const auto& pConfiguration = ra::services::ServiceLocator::Get<ra::services::IConfiguration>();
+
+    ra::api::FetchUserUnlocks::Request request;
+    request.GameId = m_nGameId;
+    request.Hardcore = pConfiguration.IsFeatureEnabled(ra::services::Feature::Hardcore);
+    request.CallAsync([this, nLoadId](const ra::api::FetchUserUnlocks::Response& response)
+    {
+        bool bUnpause = false;
+        int nPopup = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mLoadMutex);
+            if (nLoadId != m_nLoadId) // another game has been loaded since the request was made
+                return;
+
+            if (!m_bDefinitionsLoaded)
+            {
+                m_vPendingUnlocks = response.UnlockedAchievements;
+                m_bUnlocksReceived = true;
+                return;
+            }
+
+            bUnpause = m_bPendingUnpause;
+            nPopup = m_nPendingPopup;
+        }
+
+        UpdateUnlocks(response.UnlockedAchievements, bUnpause, nPopup);
+    });
+}
+
+void GameContext::ActivateAfterLoad(bool bUnpause, int nPopup)
+{
+    if (m_nMode == Mode::CompatibilityTest)
+    {
+        std::set<unsigned int> vUnlockedAchievements;
+        UpdateUnlocks(vUnlockedAchievements, bUnpause, nPopup);
+        return;
+    }
+
+    std::set<unsigned int> vUnlockedAchievements;
+    {
+        std::lock_guard<std::mutex> lock(m_mLoadMutex);
+        m_bDefinitionsLoaded = true;
+        if (!m_bUnlocksReceived)
+        {
+            m_bPendingUnpause = bUnpause;
+            m_nPendingPopup = nPopup;
+            return;
+        }
+
+        vUnlockedAchievements.swap(m_vPendingUnlocks);
+    }
+
+    UpdateUnlocks(vUnlockedAchievements, bUnpause, nPopup);
+}
+
 void GameContext::RefreshUnlocks(bool bUnpause, int nPopup)
 {
     if (m_nMode == Mode::CompatibilityTest)
@@ -271,178 +485,85 @@ void GameContext::UpdateUnlocks(const std::set<unsigned int>& vUnlockedAchieveme
     RefreshOverlay();
 }
 
-void GameContext::MergeLocalAchievements()
+static void ApplyLocalAchievement(Achievement& pAchievement, const LocalAchievementFile::Record& pRecord, bool bIsNew)
 {
-    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-    auto pData = pLocalStorage.ReadText(ra::services::StorageItemType::UserAchievements, std::to_wstring(m_nGameId));
-    if (pData == nullptr)
-        return;
+    if (pAchievement.Title() != pRecord.sTitle)
+    {
+        pAchievement.SetTitle(std::string(pRecord.sTitle));
+        pAchievement.SetModified(true);
+    }
+
+    if (pAchievement.Description() != pRecord.sDescription)
+    {
+        pAchievement.SetDescription(std::string(pRecord.sDescription));
+        pAchievement.SetModified(true);
+    }
 
-    std::string sLine;
-    pData->GetLine(sLine); // version used to create the file
-    pData->GetLine(sLine); // game title
+    if (bIsNew)
+        pAchievement.SetAuthor(std::string(pRecord.sAuthor));
 
-    while (pData->GetLine(sLine))
+    if (pAchievement.Points() != pRecord.nPoints)
     {
-        // achievement lines start with the achievement id
-        if (sLine.empty() || !isdigit(sLine.front()))
-            continue;
+        pAchievement.SetPoints(pRecord.nPoints);
+        pAchievement.SetModified(true);
+    }
 
-        // field 1: ID
-        ra::Tokenizer pTokenizer(sLine);
-        const auto nId = pTokenizer.ReadNumber();
-        if (!pTokenizer.Consume(':'))
-            continue;
+    if (bIsNew)
+        pAchievement.SetCreatedDate(pRecord.tCreated);
+
+    pAchievement.SetModifiedDate(pRecord.tModified);
+
+    if (pAchievement.BadgeImageURI() != pRecord.sBadge)
+    {
+        pAchievement.SetBadgeImage(std::string(pRecord.sBadge));
+        pAchievement.SetModified(true);
+    }
 
+    // sTrigger is null terminated
+    if (bIsNew)
+    {
+        pAchievement.ParseTrigger(pRecord.sTrigger.data());
+        pAchievement.SetModified(false);
+    }
+    else if (pAchievement.CreateMemString() != pRecord.sTrigger)
+    {
+        pAchievement.ParseTrigger(pRecord.sTrigger.data());
+        pAchievement.SetModified(true);
+    }
+}
+
+void GameContext::MergeLocalAchievements()
+{
+    m_mSavedLocalAchievements.clear();
+
+    if (!m_pLocalAchievementFile.Load(m_nGameId))
+        return;
+
+    for (const auto& pRecord : m_pLocalAchievementFile.Records())
+    {
         bool bIsNew = false;
         Achievement* pAchievement = nullptr;
-        if (nId != 0)
-            pAchievement = FindAchievement(nId);
+        if (pRecord.nId != 0)
+            pAchievement = FindAchievement(pRecord.nId);
         if (!pAchievement)
         {
             bIsNew = true;
 
-            if (nId >= m_nNextLocalId)
-                m_nNextLocalId = nId + 1;
+            if (pRecord.nId >= m_nNextLocalId)
+                m_nNextLocalId = pRecord.nId + 1;
 
             // append new local achievement to collection
             pAchievement = m_vAchievements.emplace_back(std::make_unique<Achievement>()).get();
             Ensures(pAchievement != nullptr);
             pAchievement->SetCategory(ra::etoi(AchievementSet::Type::Local));
-            pAchievement->SetID(nId);
+            pAchievement->SetID(pRecord.nId);
 
 #ifndef RA_UTEST
             g_pLocalAchievements->AddAchievement(pAchievement);
 #endif
         }
 
-        // field 2: trigger
-        std::string sTrigger;
-        if (pTokenizer.PeekChar() == '"')
-        {
-            sTrigger = pTokenizer.ReadQuotedString();
-        }
-        else
-        {
-            // unquoted trigger requires special parsing because flags also use colons
-            const char* pTrigger = pTokenizer.GetPointer(pTokenizer.CurrentPosition());
-            const char* pScan = pTrigger;
-            while (*pScan && (*pScan != ':' || strchr("ABCNPRabcnpr", pScan[-1]) != nullptr))
-                pScan++;
-
-            sTrigger.assign(pTrigger, pScan - pTrigger);
-            pTokenizer.Advance(sTrigger.length());
-        }
-
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 3: title
-        std::string sTitle;
-        if (pTokenizer.PeekChar() == '"')
-            sTitle = pTokenizer.ReadQuotedString();
-        else
-            sTitle = pTokenizer.ReadTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-        if (pAchievement->Title() != sTitle)
-        {
-            pAchievement->SetTitle(sTitle);
-            pAchievement->SetModified(true);
-        }
-
-        // field 4: description
-        std::string sDescription;
-        if (pTokenizer.PeekChar() == '"')
-            sDescription = pTokenizer.ReadQuotedString();
-        else
-            sDescription = pTokenizer.ReadTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-        if (pAchievement->Description() != sDescription)
-        {
-            pAchievement->SetDescription(sDescription);
-            pAchievement->SetModified(true);
-        }
-
-        // field 5: progress (unused)
-        pTokenizer.AdvanceTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 6: progress max (unused)
-        pTokenizer.AdvanceTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 7: progress format (unused)
-        pTokenizer.AdvanceTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 8: author
-        const std::string sAuthor = pTokenizer.ReadTo(':');
-        if (bIsNew)
-            pAchievement->SetAuthor(sAuthor);
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 9: points
-        const auto nPoints = pTokenizer.ReadNumber();
-        if (!pTokenizer.Consume(':'))
-            continue;
-        if (pAchievement->Points() != nPoints)
-        {
-            pAchievement->SetPoints(nPoints);
-            pAchievement->SetModified(true);
-        }
-
-        // field 10: created date
-        const auto nCreated = pTokenizer.ReadNumber();
-        if (bIsNew)
-            pAchievement->SetCreatedDate(nCreated);
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 11: modified date
-        const auto nModified = pTokenizer.ReadNumber();
-        pAchievement->SetModifiedDate(nModified);
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 12: up votes (unused)
-        pTokenizer.AdvanceTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 13: down votes (unused)
-        pTokenizer.AdvanceTo(':');
-        if (!pTokenizer.Consume(':'))
-            continue;
-
-        // field 14: badge
-        const auto sBadge = pTokenizer.ReadTo(':');
-        if (pAchievement->BadgeImageURI() != sBadge)
-        {
-            pAchievement->SetBadgeImage(sBadge);
-            pAchievement->SetModified(true);
-        }
-
-        // line is valid, parse the trigger
-        if (bIsNew)
-        {
-            pAchievement->ParseTrigger(sTrigger.c_str());
-            pAchievement->SetModified(false);
-        }
-        else
-        {
-            auto sExistingTrigger = pAchievement->CreateMemString();
-            if (sExistingTrigger != sTrigger)
-            {
-                pAchievement->ParseTrigger(sTrigger.c_str());
-                pAchievement->SetModified(true);
-            }
-        }
+        ApplyLocalAchievement(*pAchievement, pRecord, bIsNew);
     }
 
     // assign unique ids to any new achievements without one
@@ -453,42 +574,82 @@ void GameContext::MergeLocalAchievements()
     }
 }
 
-static void WriteEscaped(ra::services::TextWriter& pData, const std::string& sText)
+static void AppendEscaped(std::string& sLine, const std::string& sText)
 {
-    size_t nToEscape = 0;
-    for (auto c : sText)
-    {
-        if (c == ':' || c == '"' || c == '\\')
-            ++nToEscape;
-    }
-
-    if (nToEscape == 0)
+    if (sText.find_first_of(":\"\\") == std::string::npos)
     {
-        pData.Write(sText);
+        sLine.append(sText);
         return;
     }
 
-    std::string sEscaped;
-    sEscaped.reserve(sText.length() + nToEscape + 2);
-    sEscaped.push_back('"');
-    for (auto c : sText)
+    sLine.push_back('"');
+    size_t nStart = 0;
+    do
     {
-        if (c == '"' || c == '\\')
-            sEscaped.push_back('\\');
-        sEscaped.push_back(c);
-    }
-    sEscaped.push_back('"');
-    pData.Write(sEscaped);
+        const auto nIndex = sText.find_first_of("\"\\", nStart);
+        if (nIndex == std::string::npos)
+        {
+            sLine.append(sText, nStart, std::string::npos);
+            break;
+        }
+
+        sLine.append(sText, nStart, nIndex - nStart);
+        sLine.push_back('\\');
+        sLine.push_back(sText.at(nIndex));
+        nStart = nIndex + 1;
+    } while (nStart < sText.length());
+    sLine.push_back('"');
+}
+
+static void SerializeLocalAchievement(const Achievement& pAchievement, std::string& sLine)
+{
+    sLine.clear();
+
+    // field 1: ID
+    sLine.append(std::to_string(pAchievement.ID()));
+    // field 2: trigger
+    sLine.append(":\"");
+    sLine.append(pAchievement.CreateMemString());
+    sLine.append("\":");
+    // field 3: title
+    AppendEscaped(sLine, pAchievement.Title());
+    sLine.push_back(':');
+    // field 4: description
+    AppendEscaped(sLine, pAchievement.Description());
+    // field 5: progress
+    // field 6: progress max
+    // field 7: progress format
+    sLine.append("::::");
+    // field 8: author
+    sLine.append(pAchievement.Author());
+    sLine.push_back(':');
+    // field 9: points
+    sLine.append(std::to_string(pAchievement.Points()));
+    sLine.push_back(':');
+    // field 10: created date
+    sLine.append(std::to_string(pAchievement.CreatedDate()));
+    sLine.push_back(':');
+    // field 11: modified date
+    sLine.append(std::to_string(pAchievement.ModifiedDate()));
+    // field 12: up votes
+    // field 13: down votes
+    sLine.append(":::");
+    // field 14: badge
+    sLine.append(pAchievement.BadgeImageURI());
 }
 
 bool GameContext::SaveLocal() const
 {
-    // Commits local achievements to the file
+    // Commits local achievements to the file. The file is written in full each time, but the existing file is
+    // only replaced once the new one has been completely written.
     auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-    auto pData = pLocalStorage.WriteText(ra::services::StorageItemType::UserAchievements, std::to_wstring(GameId()));
+    auto pData = pLocalStorage.ReplaceText(ra::services::StorageItemType::UserAchievements, std::to_wstring(GameId()));
     if (pData == nullptr)
         return false;
 
+    // the file is being replaced, the next reload has to read it again
+    m_pLocalAchievementFile.Reset();
+
     pData->WriteLine(_RA_IntegrationVersion()); // version used to create the file
     pData->WriteLine(GameTitle());
 
@@ -497,40 +658,24 @@ bool GameContext::SaveLocal() const
         if (!pAchievement || pAchievement->Category() != ra::etoi(AchievementSet::Type::Local))
             continue;
 
-        // field 1: ID
-        pData->Write(std::to_string(pAchievement->ID()));
-        // field 2: trigger
-        pData->Write(":\"");
-        pData->Write(pAchievement->CreateMemString());
-        pData->Write("\":");
-        // field 3: title
-        WriteEscaped(*pData, pAchievement->Title());
-        pData->Write(":");
-        // field 4: description
-        WriteEscaped(*pData, pAchievement->Description());
-        // field 5: progress
-        // field 6: progress max
-        // field 7: progress format
-        pData->Write("::::");
-        // field 8: author
-        pData->Write(pAchievement->Author());
-        pData->Write(":");
-        // field 9: points
-        pData->Write(std::to_string(pAchievement->Points()));
-        pData->Write(":");
-        // field 10: created date
-        pData->Write(std::to_string(pAchievement->CreatedDate()));
-        pData->Write(":");
-        // field 11: modified date
-        pData->Write(std::to_string(pAchievement->ModifiedDate()));
-        // field 12: up votes
-        // field 13: down votes
-        pData->Write(":::");
-        // field 14: badge
-        pData->Write(pAchievement->BadgeImageURI());
+        // only serialize achievements that have been modified since they were last saved
+        auto& pSaved = m_mSavedLocalAchievements[pAchievement->ID()];
+        if (pSaved.pAchievement != pAchievement.get() || pAchievement->Modified() || pSaved.sLine.empty())
+        {
+            SerializeLocalAchievement(*pAchievement, pSaved.sLine);
+            pSaved.pAchievement = pAchievement.get();
+        }
+
+        pData->Write(pSaved.sLine);
         pData->WriteLine();
     }
 
+    if (!pData->Commit())
+    {
+        RA_LOG_ERR("Could not replace local achievements file for game %u", GameId());
+        return false;
+    }
+
     return true;
 }
 
@@ -587,6 +732,7 @@ bool GameContext::RemoveAchievement(ra::AchievementID nAchievementId)
             }
 #endif
 
+            m_mSavedLocalAchievements.erase(nAchievementId);
             m_vAchievements.erase(pIter);
             return true;
         }
@@ -674,7 +820,8 @@ void GameContext::AwardAchievement(ra::AchievementID nAchievementId) const
     request.AchievementId = nAchievementId;
     request.Hardcore = _RA_HardcoreModeIsActive();
     request.GameHash = GameHash();
-    request.CallAsyncWithRetry([nPopupId, nAchievementId](const ra::api::AwardAchievement::Response& response)
+    auto& pSubmissionJournal = ra::services::ServiceLocator::GetMutable<ra::data::SubmissionJournal>();
+    pSubmissionJournal.AwardAchievement(request, [nPopupId, nAchievementId](const ra::api::AwardAchievement::Response& response)
     {
         if (response.Succeeded())
         {
@@ -775,9 +922,29 @@ bool GameContext::ReloadAchievement(ra::AchievementID nAchievementId)
 
 bool GameContext::ReloadAchievement(Achievement& pAchievement)
 {
+    m_mSavedLocalAchievements.erase(pAchievement.ID());
+
     if (pAchievement.Category() == ra::etoi(AchievementSet::Type::Local))
     {
-        // TODO
+        // only re-read the file if it's changed since it was last read
+        auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+        const auto tLastModified = pLocalStorage.GetLastModified(ra::services::StorageItemType::UserAchievements,
+                                                                 std::to_wstring(m_nGameId));
+        if (m_pLocalAchievementFile.GameId() != m_nGameId || tLastModified == std::chrono::system_clock::time_point() ||
+            tLastModified != m_pLocalAchievementFile.GetLastModified())
+        {
+            if (!m_pLocalAchievementFile.Load(m_nGameId))
+                return false;
+        }
+
+        const auto* pRecord = m_pLocalAchievementFile.Find(pAchievement.ID());
+        if (pRecord == nullptr)
+            return false;
+
+        // discard any changes by treating the achievement as new
+        ApplyLocalAchievement(pAchievement, *pRecord, true);
+        pAchievement.SetDirtyFlag(Achievement::DirtyFlags::All);
+        return true;
     }
     else
     {
@@ -872,7 +1039,8 @@ void GameContext::SubmitLeaderboardEntry(ra::LeaderboardID nLeaderboardId, unsig
     request.LeaderboardId = pLeaderboard->ID();
     request.Score = nScore;
     request.GameHash = GameHash();
-    request.CallAsyncWithRetry([this, nLeaderboardId = pLeaderboard->ID()](const ra::api::SubmitLeaderboardEntry::Response& response)
+    auto& pSubmissionJournal = ra::services::ServiceLocator::GetMutable<ra::data::SubmissionJournal>();
+    pSubmissionJournal.SubmitLeaderboardEntry(request, [this, nLeaderboardId = pLeaderboard->ID()](const ra::api::SubmitLeaderboardEntry::Response& response)
     {
         const auto* pLeaderboard = FindLeaderboard(nLeaderboardId);
 
@@ -940,8 +1108,54 @@ void GameContext::SubmitLeaderboardEntry(ra::LeaderboardID nLeaderboardId, unsig
     });
 }
 
+static void FormatRichPresenceFragment(const rc_richpresence_display_part_t& pPart, unsigned int nValue,
+                                       std::string& sText)
+{
+    switch (pPart.display_type)
+    {
+        case RC_FORMAT_STRING:
+            sText = pPart.text;
+            break;
+
+        case RC_FORMAT_UNKNOWN_MACRO:
+            sText = "[Unknown macro]";
+            sText.append(pPart.text);
+            break;
+
+        case RC_FORMAT_LOOKUP:
+        {
+            // the parser always adds the fallback as the last item
+            const auto* pItem = pPart.first_lookup_item;
+            if (pItem == nullptr)
+            {
+                sText.clear();
+                break;
+            }
+
+            while (pItem->next_item != nullptr && pItem->value != nValue)
+                pItem = pItem->next_item;
+
+            sText = pItem->label;
+            break;
+        }
+
+        default:
+        {
+            std::array<char, 64> sBuffer{};
+            const auto nLength = rc_format_value(sBuffer.data(), gsl::narrow_cast<int>(sBuffer.size()), nValue,
+                                                 pPart.display_type);
+            sText.assign(sBuffer.data(), nLength > 0 ? ra::to_unsigned(nLength) : 0U);
+            break;
+        }
+    }
+}
+
 void GameContext::LoadRichPresenceScript(const std::string& sRichPresenceScript)
 {
+    std::lock_guard<std::mutex> lock(m_mRichPresenceMutex);
+    m_pRichPresenceDisplay = nullptr;
+    m_vRichPresenceFragments.clear();
+
     if (sRichPresenceScript.empty())
     {
         m_pRichPresence = nullptr;
@@ -959,16 +1173,16 @@ void GameContext::LoadRichPresenceScript(const std::string& sRichPresenceScript)
         const int nSize2 = rc_richpresence_size(sErrorRP.c_str());
         if (nSize2 > 0)
         {
-            m_pRichPresenceBuffer = std::make_shared<std::vector<unsigned char>>(nSize2);
-            auto* pRichPresence = rc_parse_richpresence(m_pRichPresenceBuffer->data(), sErrorRP.c_str(), nullptr, 0);
+            m_vRichPresenceBuffer.assign(ra::to_unsigned(nSize2), 0);
+            auto* pRichPresence = rc_parse_richpresence(m_vRichPresenceBuffer.data(), sErrorRP.c_str(), nullptr, 0);
             m_pRichPresence = pRichPresence;
         }
     }
     else
     {
         // allocate space and parse again
-        m_pRichPresenceBuffer = std::make_shared<std::vector<unsigned char>>(nSize);
-        auto* pRichPresence = rc_parse_richpresence(m_pRichPresenceBuffer->data(), sRichPresenceScript.c_str(), nullptr, 0);
+        m_vRichPresenceBuffer.assign(ra::to_unsigned(nSize), 0);
+        auto* pRichPresence = rc_parse_richpresence(m_vRichPresenceBuffer.data(), sRichPresenceScript.c_str(), nullptr, 0);
         m_pRichPresence = pRichPresence;
     }
 }
@@ -980,16 +1194,82 @@ bool GameContext::HasRichPresence() const noexcept
 
 std::wstring GameContext::GetRichPresenceDisplayString() const
 {
+    // called from the emulator thread, the rich presence monitor and the ping task
+    std::lock_guard<std::mutex> lock(m_mRichPresenceMutex);
+
     if (m_pRichPresence == nullptr)
         return std::wstring(L"No Rich Presence defined.");
 
-    auto pRichPresence = static_cast<rc_richpresence_t*>(m_pRichPresence);
-    std::string sRichPresence;
-    sRichPresence.resize(512);
-    const auto nLength = rc_evaluate_richpresence(pRichPresence, sRichPresence.data(), sRichPresence.capacity(), rc_peek_callback, nullptr, nullptr);
-    sRichPresence.resize(nLength);
+    // same steps as rc_evaluate_richpresence, except that each part of the display string is only formatted again
+    // when the value it reads changes, and the string is only rebuilt when one of its parts changes. the display
+    // conditions are evaluated every time so their hit counts advance the same way they would in rcheevos.
+    auto* pRichPresence = static_cast<rc_richpresence_t*>(m_pRichPresence);
+    for (auto* pMemRef = pRichPresence->memrefs; pMemRef != nullptr; pMemRef = pMemRef->next)
+        ra::services::CompiledTrigger::UpdateMemRef(*pMemRef, rc_peek_callback, nullptr);
+
+    auto* pDisplay = pRichPresence->first_display;
+    if (pDisplay == nullptr)
+        return std::wstring();
+
+    // the last display string is the default, and is used if none of the conditional ones match
+    while (pDisplay->next != nullptr && !rc_test_trigger(&pDisplay->trigger, rc_peek_callback, nullptr, nullptr))
+        pDisplay = pDisplay->next;
 
-    return ra::Widen(sRichPresence);
+    bool bChanged = false;
+    if (pDisplay != m_pRichPresenceDisplay)
+    {
+        m_pRichPresenceDisplay = pDisplay;
+        m_vRichPresenceFragments.clear();
+        bChanged = true;
+    }
+
+    size_t nIndex = 0;
+    for (auto* pPart = pDisplay->display; pPart != nullptr; pPart = pPart->next)
+    {
+        if (nIndex == m_vRichPresenceFragments.size())
+            m_vRichPresenceFragments.emplace_back();
+
+        auto& pFragment = m_vRichPresenceFragments.at(nIndex++);
+        switch (pPart->display_type)
+        {
+            case RC_FORMAT_STRING:
+            case RC_FORMAT_UNKNOWN_MACRO:
+                if (!pFragment.bFormatted)
+                {
+                    FormatRichPresenceFragment(*pPart, 0, pFragment.sText);
+                    pFragment.bFormatted = true;
+                }
+                break;
+
+            default:
+            {
+                const auto nValue = rc_evaluate_value(&pPart->value, rc_peek_callback, nullptr, nullptr);
+                if (!pFragment.bFormatted || nValue != pFragment.nValue)
+                {
+                    FormatRichPresenceFragment(*pPart, nValue, pFragment.sText);
+                    pFragment.nValue = nValue;
+                    pFragment.bFormatted = true;
+                    bChanged = true;
+                }
+                break;
+            }
+        }
+    }
+
+    if (bChanged)
+    {
+        m_sCachedRichPresence.clear();
+        for (const auto& pFragment : m_vRichPresenceFragments)
+            m_sCachedRichPresence.append(pFragment.sText);
+
+        // rc_evaluate_richpresence was called with a 512 byte buffer
+        if (m_sCachedRichPresence.length() > 511)
+            m_sCachedRichPresence.resize(511);
+
+        m_sCachedRichPresenceWide = ra::Widen(m_sCachedRichPresence);
+    }
+
+    return m_sCachedRichPresenceWide;
 }
 
 void GameContext::ReloadRichPresenceScript()
@@ -1013,6 +1293,8 @@ void GameContext::ReloadRichPresenceScript()
 void GameContext::RefreshCodeNotes()
 {
     m_mCodeNotes.clear();
+    m_pCodeNoteIndex.Clear();
+    m_pCodeNoteSearchIndex.Clear();
 
     if (m_nGameId == 0)
         return;
@@ -1031,6 +1313,13 @@ void GameContext::RefreshCodeNotes()
         for (const auto& pNote : response.Notes)
             m_mCodeNotes.insert_or_assign(pNote.Address, CodeNote{ pNote.Author, pNote.Note });
 
+        // the map is in address order, so the index is built by appending
+        for (const auto& pCodeNote : m_mCodeNotes)
+        {
+            m_pCodeNoteIndex.Set(pCodeNote.first, CodeNoteIndex::GetNoteSize(pCodeNote.second.Note));
+            m_pCodeNoteSearchIndex.Set(pCodeNote.first, pCodeNote.second.Note);
+        }
+
 #ifndef RA_UTEST
         g_MemoryDialog.RepopulateCodeNotes();
 #endif
@@ -1054,6 +1343,8 @@ bool GameContext::SetCodeNote(ra::ByteAddress nAddress, const std::wstring& sNot
         {
             const auto& pUserContext = ra::services::ServiceLocator::Get<ra::data::UserContext>();
             m_mCodeNotes.insert_or_assign(nAddress, CodeNote{ pUserContext.GetUsername(), sNote });
+            m_pCodeNoteIndex.Set(nAddress, CodeNoteIndex::GetNoteSize(sNote));
+            m_pCodeNoteSearchIndex.Set(nAddress, sNote);
             return true;
         }
 
@@ -1087,6 +1378,8 @@ bool GameContext::DeleteCodeNote(ra::ByteAddress nAddress)
         if (response.Succeeded())
         {
             m_mCodeNotes.erase(nAddress);
+            m_pCodeNoteIndex.Remove(nAddress);
+            m_pCodeNoteSearchIndex.Remove(nAddress);
             return true;
         }
 
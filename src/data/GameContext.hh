@@ -5,6 +5,13 @@
 #include "RA_AchievementSet.h"
 #include "RA_Leaderboard.h"
 
+#include "data\CodeNoteIndex.hh"
+#include "data\CodeNoteSearchIndex.hh"
+#include "data\LocalAchievementFile.hh"
+
+#include "services\ParseArena.hh"
+#include "services\WorkerGroup.hh"
+
 #include <string>
 
 namespace ra {
@@ -170,6 +177,9 @@ public:
     /// <summary>
     /// Gets the current rich presence display string.
     /// </summary>
+    /// <remarks>
+    /// The script is only re-evaluated if the memory it reads has changed since the last call.
+    /// </remarks>
     virtual std::wstring GetRichPresenceDisplayString() const;
     
     /// <summary>
@@ -220,6 +230,42 @@ public:
         return &pIter->second.Note;
     }
 
+    /// <summary>
+    /// Returns the note describing the specified address, which may be a multi-byte note starting before it.
+    /// </summary>
+    /// <param name="nAddress">The address to look up.</param>
+    /// <param name="nNoteAddress">Receives the address the note is associated to.</param>
+    /// <returns>The note covering the address, <c>nullptr</c> if no note covers the address.</returns>
+    const std::wstring* FindCodeNoteCovering(ra::ByteAddress nAddress, _Out_ ra::ByteAddress& nNoteAddress) const
+    {
+        if (!m_pCodeNoteIndex.FindNoteStart(nAddress, nNoteAddress))
+            return nullptr;
+
+        return FindCodeNote(nNoteAddress);
+    }
+
+    /// <summary>
+    /// Enumerates the code notes covering any part of a range of addresses.
+    /// </summary>
+    /// <remarks>
+    /// <paramref name="callback" /> is called with the address and size of each note, in address order. If it
+    /// returns <c>false</c> enumeration stops.
+    /// </remarks>
+    void EnumerateCodeNotes(ra::ByteAddress nFirstAddress, ra::ByteAddress nLastAddress,
+                            std::function<bool(ra::ByteAddress nAddress, unsigned int nSize)> callback) const
+    {
+        m_pCodeNoteIndex.EnumerateNotes(nFirstAddress, nLastAddress, callback);
+    }
+
+    /// <summary>
+    /// Finds the code notes containing the specified text, ignoring case.
+    /// </summary>
+    /// <returns>The addresses of the matching notes, in ascending order.</returns>
+    std::vector<ra::ByteAddress> SearchCodeNotes(const std::wstring& sText) const
+    {
+        return m_pCodeNoteSearchIndex.Search(sText);
+    }
+
     /// <summary>
     /// Enumerates the code notes
     /// </summary>
@@ -254,6 +300,8 @@ protected:
     void MergeLocalAchievements();
     bool ReloadAchievement(Achievement& pAchievement);
     void RefreshUnlocks(bool bUnpause, int nPopup);
+    void RequestUnlocksForLoad(unsigned int nLoadId);
+    void ActivateAfterLoad(bool bUnpause, int nPopup);
     void UpdateUnlocks(const std::set<unsigned int>& vUnlockedAchievements, bool bUnpause, int nPopup);
     void LoadRichPresenceScript(const std::string& sRichPresenceScript);
     void RefreshCodeNotes();
@@ -266,11 +314,52 @@ protected:
     ra::AchievementID m_nNextLocalId = 0;
     static const ra::AchievementID FirstLocalId = 111000001;
 
-    void* m_pRichPresence = nullptr;                                   // rc_richpresence_t
-    std::shared_ptr<std::vector<unsigned char>> m_pRichPresenceBuffer; // buffer for rc_richpresence_t
+    // the unlocks are requested alongside the game data, and whichever arrives second activates the achievements
+    std::mutex m_mLoadMutex;
+    unsigned int m_nLoadId = 0; // identifies the current LoadGame call so responses for an earlier one are ignored
+    bool m_bDefinitionsLoaded = false;
+    bool m_bUnlocksReceived = false;
+    std::set<unsigned int> m_vPendingUnlocks;
+    bool m_bPendingUnpause = false;
+    int m_nPendingPopup = 0;
+
+    // holds the definitions parsed by LoadGame, packed together in load order. only used on the thread that calls
+    // LoadGame. anything parsed later (editor changes, reloads) uses its own buffer so replaced definitions are freed.
+    // declared before anything that points into it so it's destroyed last
+    ra::services::ParseArena m_pParseArena;
+
+    // splits the parsing of large sets across threads. created by the first LoadGame that needs it and kept for
+    // later loads so the threads aren't started every time.
+    std::unique_ptr<ra::services::WorkerGroup> m_pParseWorkers;
+
+    void* m_pRichPresence = nullptr;                      // rc_richpresence_t
+    std::vector<unsigned char> m_vRichPresenceBuffer;     // buffer for rc_richpresence_t
+
+    // one part of the display string: literal text, or a value formatted by a macro
+    struct RichPresenceFragment
+    {
+        unsigned int nValue = 0;  // the value sText was formatted from
+        bool bFormatted = false;
+        std::string sText;
+    };
+
+    // guards m_pRichPresence and the evaluation cache
+    mutable std::mutex m_mRichPresenceMutex;
+    mutable const void* m_pRichPresenceDisplay = nullptr;              // rc_richpresence_display_t for the fragments
+    mutable std::vector<RichPresenceFragment> m_vRichPresenceFragments; // parts of the last display string
+    mutable std::string m_sCachedRichPresence;                         // fragments joined together
+    mutable std::wstring m_sCachedRichPresenceWide;                    // m_sCachedRichPresence widened
 
     std::vector<std::unique_ptr<Achievement>> m_vAchievements;
     std::vector<std::unique_ptr<RA_Leaderboard>> m_vLeaderboards;
+    mutable LocalAchievementFile m_pLocalAchievementFile; // last read contents of the local achievements file
+
+    struct SavedLocalAchievement
+    {
+        const Achievement* pAchievement = nullptr;
+        std::string sLine; // the achievement as it was last written to the local achievements file
+    };
+    mutable std::unordered_map<ra::AchievementID, SavedLocalAchievement> m_mSavedLocalAchievements;
 
     struct CodeNote
     {
@@ -278,6 +367,8 @@ protected:
         std::wstring Note;
     };
     std::map<ra::ByteAddress, CodeNote> m_mCodeNotes;
+    CodeNoteIndex m_pCodeNoteIndex; // address range described by each entry in m_mCodeNotes
+    CodeNoteSearchIndex m_pCodeNoteSearchIndex; // text of each entry in m_mCodeNotes
 };
 
 } // namespace data
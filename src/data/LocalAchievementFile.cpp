@@ -0,0 +1,265 @@
+#include "LocalAchievementFile.hh"
+
+#include "services\ILocalStorage.hh"
+#include "services\ServiceLocator.hh"
+
+namespace ra {
+namespace data {
+
+namespace {
+
+/// <summary>
+/// Walks the fields of a single line. Quoted fields are unescaped in place.
+/// </summary>
+class LineCursor
+{
+public:
+    LineCursor(char* pStart, char* pEnd) noexcept : m_pCurrent(pStart), m_pEnd(pEnd) {}
+
+    char Peek() const noexcept { return (m_pCurrent < m_pEnd) ? *m_pCurrent : '\0'; }
+    char* Current() const noexcept { return m_pCurrent; }
+
+    bool Consume(char c) noexcept
+    {
+        if (Peek() != c)
+            return false;
+
+        GSL_SUPPRESS(bounds.1) ++m_pCurrent;
+        return true;
+    }
+
+    void AdvanceTo(char cStop) noexcept
+    {
+        while (m_pCurrent < m_pEnd && *m_pCurrent != cStop)
+            GSL_SUPPRESS(bounds.1) ++m_pCurrent;
+    }
+
+    std::string_view ReadTo(char cStop) noexcept
+    {
+        char* pStart = m_pCurrent;
+        AdvanceTo(cStop);
+        return std::string_view(pStart, gsl::narrow_cast<size_t>(m_pCurrent - pStart));
+    }
+
+    GSL_SUPPRESS(bounds.1)
+    std::string_view ReadQuoted() noexcept
+    {
+        ++m_pCurrent; // opening quote
+        char* pStart = m_pCurrent;
+        char* pWrite = m_pCurrent;
+        while (m_pCurrent < m_pEnd)
+        {
+            char c = *m_pCurrent++;
+            if (c == '"')
+                break;
+
+            if (c == '\\')
+            {
+                if (m_pCurrent == m_pEnd)
+                    break;
+
+                c = *m_pCurrent++;
+                if (c == 'n')
+                    c = '\n';
+            }
+
+            *pWrite++ = c;
+        }
+
+        return std::string_view(pStart, gsl::narrow_cast<size_t>(pWrite - pStart));
+    }
+
+    std::string_view ReadField() noexcept { return (Peek() == '"') ? ReadQuoted() : ReadTo(':'); }
+
+    unsigned int ReadNumber() noexcept
+    {
+        unsigned int nValue = 0;
+        while (m_pCurrent < m_pEnd && isdigit(static_cast<unsigned char>(*m_pCurrent)))
+        {
+            nValue = nValue * 10 + (*m_pCurrent - '0');
+            GSL_SUPPRESS(bounds.1) ++m_pCurrent;
+        }
+
+        return nValue;
+    }
+
+    GSL_SUPPRESS(bounds.1)
+    std::string_view ReadUnquotedTrigger() noexcept
+    {
+        // flags also use colons (i.e. "R:0xH1234=1"), so only stop at a colon that doesn't follow a flag character
+        char* pStart = m_pCurrent;
+        while (m_pCurrent < m_pEnd && (*m_pCurrent != ':' || strchr("ABCNPRabcnpr", m_pCurrent[-1]) != nullptr))
+            ++m_pCurrent;
+
+        return std::string_view(pStart, gsl::narrow_cast<size_t>(m_pCurrent - pStart));
+    }
+
+private:
+    char* m_pCurrent;
+    char* m_pEnd;
+};
+
+} // namespace
+
+bool LocalAchievementFile::Load(unsigned int nGameId)
+{
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    const auto sKey = std::to_wstring(nGameId);
+    auto pData = pLocalStorage.ReadText(ra::services::StorageItemType::UserAchievements, sKey);
+    if (pData == nullptr)
+    {
+        Reset();
+        return false;
+    }
+
+    m_tLastModified = pLocalStorage.GetLastModified(ra::services::StorageItemType::UserAchievements, sKey);
+
+    // read the whole file up front and parse it from memory
+    constexpr size_t nChunkSize = 16 * 1024;
+    std::string sContents;
+    size_t nRead = 0;
+    do
+    {
+        const auto nOffset = sContents.length();
+        sContents.resize(nOffset + nChunkSize);
+        GSL_SUPPRESS(bounds.3) nRead = pData->GetBytes(&sContents.at(nOffset), nChunkSize);
+        sContents.resize(nOffset + nRead);
+    } while (nRead == nChunkSize);
+
+    Parse(std::move(sContents));
+    m_nGameId = nGameId;
+    return true;
+}
+
+void LocalAchievementFile::Reset() noexcept
+{
+    m_vRecords.clear();
+    m_mIndex.clear();
+    m_sContents.clear();
+    m_tLastModified = {};
+    m_nGameId = 0;
+}
+
+void LocalAchievementFile::Parse(std::string&& sContents)
+{
+    m_sContents = std::move(sContents);
+    m_vRecords.clear();
+    m_mIndex.clear();
+
+    // the records point into m_sContents, which must not be resized from here on
+    char* pScan = m_sContents.data();
+    GSL_SUPPRESS(bounds.1) char* const pEnd = pScan + m_sContents.length();
+
+    unsigned int nLine = 0;
+    while (pScan < pEnd)
+    {
+        char* pLineEnd = static_cast<char*>(memchr(pScan, '\n', gsl::narrow_cast<size_t>(pEnd - pScan)));
+        if (pLineEnd == nullptr)
+            pLineEnd = pEnd;
+
+        char* pNext = pLineEnd;
+        if (pNext < pEnd)
+            GSL_SUPPRESS(bounds.1) ++pNext;
+
+        GSL_SUPPRESS(bounds.1)
+        if (pLineEnd > pScan && pLineEnd[-1] == '\r')
+            --pLineEnd;
+
+        // the first two lines are the version used to create the file and the game title.
+        // achievement lines start with the achievement id
+        if (++nLine > 2 && pLineEnd > pScan && isdigit(static_cast<unsigned char>(*pScan)))
+        {
+            Record pRecord;
+            if (ParseLine(pScan, pLineEnd, pRecord))
+            {
+                if (pRecord.nId != 0)
+                    m_mIndex.insert_or_assign(pRecord.nId, m_vRecords.size());
+
+                m_vRecords.push_back(pRecord);
+            }
+        }
+
+        pScan = pNext;
+    }
+}
+
+bool LocalAchievementFile::ParseLine(char* pLine, char* pEnd, Record& pRecord)
+{
+    LineCursor pCursor(pLine, pEnd);
+
+    // field 1: ID
+    pRecord.nId = pCursor.ReadNumber();
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 2: trigger
+    pRecord.sTrigger = (pCursor.Peek() == '"') ? pCursor.ReadQuoted() : pCursor.ReadUnquotedTrigger();
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 3: title
+    pRecord.sTitle = pCursor.ReadField();
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 4: description
+    pRecord.sDescription = pCursor.ReadField();
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // fields 5-7: progress, progress max, progress format (unused)
+    for (int i = 0; i < 3; ++i)
+    {
+        pCursor.AdvanceTo(':');
+        if (!pCursor.Consume(':'))
+            return false;
+    }
+
+    // field 8: author
+    pRecord.sAuthor = pCursor.ReadTo(':');
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 9: points
+    pRecord.nPoints = pCursor.ReadNumber();
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 10: created date
+    pRecord.tCreated = static_cast<time_t>(pCursor.ReadNumber());
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // field 11: modified date
+    pRecord.tModified = static_cast<time_t>(pCursor.ReadNumber());
+    if (!pCursor.Consume(':'))
+        return false;
+
+    // fields 12-13: up votes, down votes (unused)
+    for (int i = 0; i < 2; ++i)
+    {
+        pCursor.AdvanceTo(':');
+        if (!pCursor.Consume(':'))
+            return false;
+    }
+
+    // field 14: badge
+    pRecord.sBadge = pCursor.ReadTo(':');
+
+    // the trigger is always followed by at least one more character (the closing quote or a separator), which
+    // can be replaced now that the line has been parsed
+    GSL_SUPPRESS(bounds.1) const_cast<char*>(pRecord.sTrigger.data())[pRecord.sTrigger.length()] = '\0';
+    return true;
+}
+
+const LocalAchievementFile::Record* LocalAchievementFile::Find(ra::AchievementID nId) const
+{
+    const auto pIter = m_mIndex.find(nId);
+    if (pIter == m_mIndex.end())
+        return nullptr;
+
+    return &m_vRecords.at(pIter->second);
+}
+
+} // namespace data
+} // namespace ra
@@ -0,0 +1,95 @@
+#ifndef RA_DATA_LOCALACHIEVEMENTFILE_HH
+#define RA_DATA_LOCALACHIEVEMENTFILE_HH
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ra {
+namespace data {
+
+/// <summary>
+/// The parsed contents of a local achievements file (<c>RACache\Data\&lt;id&gt;-User.txt</c>).
+/// </summary>
+/// <remarks>
+/// The file is read into a single buffer and every line is parsed in place. Quoted fields are unescaped where
+/// they are and all fields refer to the buffer, so nothing is copied until it's assigned to an achievement.
+/// </remarks>
+class LocalAchievementFile
+{
+public:
+    GSL_SUPPRESS_F6 LocalAchievementFile() = default;
+    ~LocalAchievementFile() noexcept = default;
+    // the records point into m_sContents, so the file can't be copied or moved
+    LocalAchievementFile(const LocalAchievementFile&) noexcept = delete;
+    LocalAchievementFile& operator=(const LocalAchievementFile&) noexcept = delete;
+    LocalAchievementFile(LocalAchievementFile&&) noexcept = delete;
+    LocalAchievementFile& operator=(LocalAchievementFile&&) noexcept = delete;
+
+    struct Record
+    {
+        ra::AchievementID nId{};
+        std::string_view sTrigger; // followed by a null terminator, so it can be passed to rcheevos as is
+        std::string_view sTitle;
+        std::string_view sDescription;
+        std::string_view sAuthor;
+        unsigned int nPoints{};
+        time_t tCreated{};
+        time_t tModified{};
+        std::string_view sBadge;
+    };
+
+    /// <summary>
+    /// Reads and parses the local achievements file for a game.
+    /// </summary>
+    /// <returns><c>false</c> if the game doesn't have a local achievements file.</returns>
+    bool Load(unsigned int nGameId);
+
+    /// <summary>
+    /// Discards the loaded file.
+    /// </summary>
+    void Reset() noexcept;
+
+    /// <summary>
+    /// Gets the unique identifier of the game whose file is loaded, 0 if no file is loaded.
+    /// </summary>
+    unsigned int GameId() const noexcept { return m_nGameId; }
+
+    /// <summary>
+    /// Parses the contents of a local achievements file.
+    /// </summary>
+    void Parse(std::string&& sContents);
+
+    /// <summary>
+    /// Gets the valid achievement lines, in the order they appear in the file.
+    /// </summary>
+    const std::vector<Record>& Records() const noexcept { return m_vRecords; }
+
+    /// <summary>
+    /// Finds the line for an achievement.
+    /// </summary>
+    /// <returns>The parsed line, <c>nullptr</c> if the file doesn't contain the achievement.</returns>
+    const Record* Find(ra::AchievementID nId) const;
+
+    /// <summary>
+    /// Gets when the file was last modified at the time it was loaded.
+    /// </summary>
+    std::chrono::system_clock::time_point GetLastModified() const noexcept { return m_tLastModified; }
+
+private:
+    bool ParseLine(char* pLine, char* pEnd, Record& pRecord);
+
+    std::string m_sContents;
+    std::vector<Record> m_vRecords;
+    std::unordered_map<ra::AchievementID, size_t> m_mIndex; // achievement id to index in m_vRecords
+    std::chrono::system_clock::time_point m_tLastModified;
+    unsigned int m_nGameId = 0;
+};
+
+} // namespace data
+} // namespace ra
+
+#endif // !RA_DATA_LOCALACHIEVEMENTFILE_HH
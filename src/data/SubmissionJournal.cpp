@@ -0,0 +1,350 @@
+#include "SubmissionJournal.hh"
+
+#include "RA_Log.h"
+#include "RA_md5factory.h"
+#include "RA_StringUtils.h"
+
+#include "services\ILocalStorage.hh"
+#include "services\ServiceLocator.hh"
+
+namespace ra {
+namespace data {
+
+// number of acknowledgements that can be appended before the journal is rewritten
+static constexpr unsigned int COMPACT_THRESHOLD = 64;
+
+void SubmissionJournal::Initialize(const std::string& sUsername)
+{
+    unsigned int nGeneration = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mMutex);
+        m_sUsername = ra::Widen(sUsername);
+        m_vPending.clear();
+        m_nNextSequence = 1;
+        m_nAcknowledged = 0;
+        m_bReplaying = false;
+        nGeneration = ++m_nGeneration;
+
+        const bool bHasJournal = LoadJournal();
+
+        for (const auto& pEntry : m_vPending)
+        {
+            if (pEntry.nSequence >= m_nNextSequence)
+                m_nNextSequence = pEntry.nSequence + 1;
+        }
+
+        // discard the acknowledged entries and anything that was only partially written
+        if (bHasJournal)
+            Compact();
+
+        if (!m_vPending.empty())
+            RA_LOG_INFO("Resubmitting %zu pending unlocks/leaderboard entries", m_vPending.size());
+    }
+
+    ResumeReplay(nGeneration);
+}
+
+bool SubmissionJournal::LoadJournal()
+{
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.ReadText(ra::services::StorageItemType::SubmissionJournal, m_sUsername);
+    if (pFile == nullptr)
+        return false;
+
+    // line format: A:<sequence>:<achievementid>:<hardcore>:<gamehash>:<checksum>
+    //              L:<sequence>:<leaderboardid>:<score>:<gamehash>:<checksum>
+    //              K:<sequence>:<checksum>
+    std::string sLine;
+    while (pFile->GetLine(sLine))
+    {
+        ra::Tokenizer pTokenizer(sLine);
+
+        Entry pEntry;
+        pEntry.cType = pTokenizer.PeekChar();
+        pTokenizer.Advance();
+        if (!pTokenizer.Consume(':'))
+            continue;
+
+        pEntry.nSequence = pTokenizer.ReadNumber();
+        if (!pTokenizer.Consume(':'))
+            continue;
+
+        if (pEntry.cType == 'A' || pEntry.cType == 'L')
+        {
+            pEntry.nId = pTokenizer.ReadNumber();
+            if (!pTokenizer.Consume(':'))
+                continue;
+
+            // scores are written signed
+            const bool bNegative = pTokenizer.Consume('-');
+            pEntry.nValue = pTokenizer.ReadNumber();
+            if (bNegative)
+                pEntry.nValue = 0U - pEntry.nValue;
+            if (!pTokenizer.Consume(':'))
+                continue;
+
+            pEntry.sGameHash = pTokenizer.ReadTo(':');
+            if (!pTokenizer.Consume(':'))
+                continue;
+        }
+        else if (pEntry.cType != 'K')
+        {
+            continue;
+        }
+
+        // a line that was only partially written won't match its checksum
+        const auto md5 = RAGenerateMD5(reinterpret_cast<const unsigned char*>(sLine.c_str()), pTokenizer.CurrentPosition());
+        if (!pTokenizer.Consume(md5.front()) || !pTokenizer.Consume(md5.back()))
+            continue;
+
+        if (pEntry.cType == 'K')
+        {
+            for (auto pIter = m_vPending.begin(); pIter != m_vPending.end(); ++pIter)
+            {
+                if (pIter->nSequence == pEntry.nSequence)
+                {
+                    m_vPending.erase(pIter);
+                    break;
+                }
+            }
+        }
+        else
+        {
+            m_vPending.push_back(std::move(pEntry));
+        }
+    }
+
+    return true;
+}
+
+void SubmissionJournal::AppendChecksum(std::string& sLine)
+{
+    const auto sMD5 = RAGenerateMD5(sLine);
+    sLine.push_back(sMD5.front());
+    sLine.push_back(sMD5.back());
+}
+
+std::string SubmissionJournal::Serialize(const Entry& pEntry)
+{
+    auto sLine = ra::StringPrintf("%c:%u:%u:%d:%s:", pEntry.cType, pEntry.nSequence, pEntry.nId,
+                                  static_cast<int>(pEntry.nValue), pEntry.sGameHash);
+    AppendChecksum(sLine);
+    return sLine;
+}
+
+void SubmissionJournal::Compact() const
+{
+    // the journal is replaced atomically, so a crash while compacting leaves the previous journal intact
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.ReplaceText(ra::services::StorageItemType::SubmissionJournal, m_sUsername);
+    if (pFile == nullptr)
+        return;
+
+    for (const auto& pEntry : m_vPending)
+        pFile->WriteLine(Serialize(pEntry));
+
+    if (!pFile->Commit())
+        RA_LOG_WARN("Could not compact submission journal");
+}
+
+bool SubmissionJournal::Record(char cType, unsigned int nId, unsigned int nValue, const std::string& sGameHash,
+                               unsigned int& nGeneration, unsigned int& nSequence)
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    if (m_sUsername.empty())
+        return false;
+
+    auto& pEntry = m_vPending.emplace_back();
+    pEntry.cType = cType;
+    pEntry.nSequence = m_nNextSequence++;
+    pEntry.nId = nId;
+    pEntry.nValue = nValue;
+    pEntry.sGameHash = sGameHash;
+    pEntry.bInFlight = true;
+
+    nGeneration = m_nGeneration;
+    nSequence = pEntry.nSequence;
+
+    // the entry is written (and the file closed) before the request is sent
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.AppendText(ra::services::StorageItemType::SubmissionJournal, m_sUsername);
+    if (pFile != nullptr)
+        pFile->WriteLine(Serialize(pEntry));
+
+    return true;
+}
+
+void SubmissionJournal::Acknowledge(unsigned int nGeneration, unsigned int nSequence, ra::api::ApiResult nResult)
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    if (nGeneration != m_nGeneration)
+        return;
+
+    auto pIter = m_vPending.begin();
+    while (pIter != m_vPending.end() && pIter->nSequence != nSequence)
+        ++pIter;
+
+    if (pIter == m_vPending.end())
+        return;
+
+    if (nResult == ra::api::ApiResult::Unsupported || nResult == ra::api::ApiResult::Incomplete)
+    {
+        // the server never saw the request. keep it until the server is available again
+        pIter->bInFlight = false;
+        return;
+    }
+
+    m_vPending.erase(pIter);
+
+    if (m_vPending.empty() || ++m_nAcknowledged >= COMPACT_THRESHOLD)
+    {
+        Compact();
+        m_nAcknowledged = 0;
+        return;
+    }
+
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pFile = pLocalStorage.AppendText(ra::services::StorageItemType::SubmissionJournal, m_sUsername);
+    if (pFile != nullptr)
+    {
+        auto sLine = ra::StringPrintf("K:%u:", nSequence);
+        AppendChecksum(sLine);
+        pFile->WriteLine(sLine);
+    }
+}
+
+void SubmissionJournal::ResumeReplay(unsigned int nGeneration)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mMutex);
+        if (nGeneration != m_nGeneration || m_bReplaying)
+            return;
+
+        m_bReplaying = true;
+    }
+
+    ReplayNext(nGeneration);
+}
+
+void SubmissionJournal::ReplayNext(unsigned int nGeneration)
+{
+    Entry pEntry;
+    {
+        std::lock_guard<std::mutex> lock(m_mMutex);
+        if (nGeneration != m_nGeneration)
+            return;
+
+        auto pIter = m_vPending.begin();
+        while (pIter != m_vPending.end() && pIter->bInFlight)
+            ++pIter;
+
+        if (pIter == m_vPending.end())
+        {
+            m_bReplaying = false;
+            return;
+        }
+
+        pIter->bInFlight = true;
+        pEntry = *pIter;
+    }
+
+    // entries are resubmitted one at a time so the server sees them in the order they occurred
+    const auto nSequence = pEntry.nSequence;
+    if (pEntry.cType == 'A')
+    {
+        ra::api::AwardAchievement::Request request;
+        request.AchievementId = pEntry.nId;
+        request.Hardcore = (pEntry.nValue != 0);
+        request.GameHash = pEntry.sGameHash;
+        request.CallAsyncWithRetry([this, nGeneration, nSequence, nId = pEntry.nId](const ra::api::AwardAchievement::Response& response)
+        {
+            RA_LOG_INFO("Resubmitted unlock for achievement %u: %s", nId,
+                        response.Succeeded() ? "OK" : response.ErrorMessage.c_str());
+
+            OnReplayed(nGeneration, nSequence, response.Result);
+        });
+    }
+    else
+    {
+        ra::api::SubmitLeaderboardEntry::Request request;
+        request.LeaderboardId = pEntry.nId;
+        request.Score = pEntry.nValue;
+        request.GameHash = pEntry.sGameHash;
+        request.CallAsyncWithRetry([this, nGeneration, nSequence, nId = pEntry.nId](const ra::api::SubmitLeaderboardEntry::Response& response)
+        {
+            RA_LOG_INFO("Resubmitted entry for leaderboard %u: %s", nId,
+                        response.Succeeded() ? "OK" : response.ErrorMessage.c_str());
+
+            OnReplayed(nGeneration, nSequence, response.Result);
+        });
+    }
+}
+
+void SubmissionJournal::OnReplayed(unsigned int nGeneration, unsigned int nSequence, ra::api::ApiResult nResult)
+{
+    Acknowledge(nGeneration, nSequence, nResult);
+
+    if (nResult != ra::api::ApiResult::Unsupported)
+    {
+        ReplayNext(nGeneration);
+        return;
+    }
+
+    // the server is unavailable again. wait for it to respond to something before trying the rest
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    if (nGeneration == m_nGeneration)
+        m_bReplaying = false;
+}
+
+void SubmissionJournal::AwardAchievement(const ra::api::AwardAchievement::Request& request,
+                                         ra::api::AwardAchievement::Request::Callback&& callback)
+{
+    unsigned int nGeneration = 0, nSequence = 0;
+    if (!Record('A', request.AchievementId, request.Hardcore ? 1 : 0, request.GameHash, nGeneration, nSequence))
+    {
+        request.CallAsyncWithRetry(std::move(callback));
+        return;
+    }
+
+    request.CallAsyncWithRetry([this, nGeneration, nSequence, callback = std::move(callback)](const ra::api::AwardAchievement::Response& response)
+    {
+        Acknowledge(nGeneration, nSequence, response.Result);
+
+        // if the server handled the request, it can handle anything left over from when it was unavailable
+        if (response.Result != ra::api::ApiResult::Unsupported)
+            ResumeReplay(nGeneration);
+
+        callback(response);
+    });
+}
+
+void SubmissionJournal::SubmitLeaderboardEntry(const ra::api::SubmitLeaderboardEntry::Request& request,
+                                               ra::api::SubmitLeaderboardEntry::Request::Callback&& callback)
+{
+    unsigned int nGeneration = 0, nSequence = 0;
+    if (!Record('L', request.LeaderboardId, request.Score, request.GameHash, nGeneration, nSequence))
+    {
+        request.CallAsyncWithRetry(std::move(callback));
+        return;
+    }
+
+    request.CallAsyncWithRetry([this, nGeneration, nSequence, callback = std::move(callback)](const ra::api::SubmitLeaderboardEntry::Response& response)
+    {
+        Acknowledge(nGeneration, nSequence, response.Result);
+
+        // if the server handled the request, it can handle anything left over from when it was unavailable
+        if (response.Result != ra::api::ApiResult::Unsupported)
+            ResumeReplay(nGeneration);
+
+        callback(response);
+    });
+}
+
+size_t SubmissionJournal::PendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    return m_vPending.size();
+}
+
+} // namespace data
+} // namespace ra
@@ -0,0 +1,106 @@
+#ifndef RA_DATA_SUBMISSIONJOURNAL_HH
+#define RA_DATA_SUBMISSIONJOURNAL_HH
+#pragma once
+
+#include "api\AwardAchievement.hh"
+#include "api\SubmitLeaderboardEntry.hh"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ra {
+namespace data {
+
+/// <summary>
+/// Keeps a record of unlocks and leaderboard submissions until the server has responded to them, so they can be
+/// sent again if the client is closed (or crashes) first.
+/// </summary>
+/// <remarks>
+/// Each submission is appended to the journal before it is sent, and an acknowledgement is appended when the
+/// server responds. Anything not acknowledged is resubmitted, in order, when the user logs in, and again when the
+/// server responds to a later submission after having been unavailable. The journal is rewritten without the
+/// acknowledged entries whenever it's loaded and whenever nothing is pending.
+/// </remarks>
+class SubmissionJournal
+{
+public:
+    GSL_SUPPRESS_F6 SubmissionJournal() = default;
+    virtual ~SubmissionJournal() noexcept = default;
+    SubmissionJournal(const SubmissionJournal&) noexcept = delete;
+    SubmissionJournal& operator=(const SubmissionJournal&) noexcept = delete;
+    SubmissionJournal(SubmissionJournal&&) noexcept = delete;
+    SubmissionJournal& operator=(SubmissionJournal&&) noexcept = delete;
+
+    /// <summary>
+    /// Loads the journal for the specified user and resubmits anything the server hasn't responded to.
+    /// </summary>
+    void Initialize(const std::string& sUsername);
+
+    /// <summary>
+    /// Records an unlock and submits it to the server.
+    /// </summary>
+    /// <remarks>
+    /// The request is retried while the server is unavailable. If no user has been initialized, the request is
+    /// submitted without being recorded.
+    /// </remarks>
+    void AwardAchievement(const ra::api::AwardAchievement::Request& request,
+                          ra::api::AwardAchievement::Request::Callback&& callback);
+
+    /// <summary>
+    /// Records a leaderboard entry and submits it to the server.
+    /// </summary>
+    /// <remarks>
+    /// The request is retried while the server is unavailable. If no user has been initialized, the request is
+    /// submitted without being recorded.
+    /// </remarks>
+    void SubmitLeaderboardEntry(const ra::api::SubmitLeaderboardEntry::Request& request,
+                                ra::api::SubmitLeaderboardEntry::Request::Callback&& callback);
+
+    /// <summary>
+    /// Gets the number of submissions the server hasn't responded to.
+    /// </summary>
+    size_t PendingCount() const;
+
+protected:
+    struct Entry
+    {
+        char cType{};                   // 'A' for an unlock, 'L' for a leaderboard entry
+        unsigned int nSequence{};
+        unsigned int nId{};             // achievement or leaderboard id
+        unsigned int nValue{};          // hardcore flag or score (scores may be negative)
+        std::string sGameHash;
+        bool bInFlight{};
+    };
+
+    /// <summary>
+    /// Reads the pending entries from the journal. Returns <c>false</c> if there is no journal.
+    /// </summary>
+    virtual bool LoadJournal();
+
+    std::wstring m_sUsername;
+    std::vector<Entry> m_vPending;
+
+private:
+    static std::string Serialize(const Entry& pEntry);
+    static void AppendChecksum(std::string& sLine);
+
+    bool Record(char cType, unsigned int nId, unsigned int nValue, const std::string& sGameHash,
+                unsigned int& nGeneration, unsigned int& nSequence);
+    void Acknowledge(unsigned int nGeneration, unsigned int nSequence, ra::api::ApiResult nResult);
+    void ResumeReplay(unsigned int nGeneration);
+    void ReplayNext(unsigned int nGeneration);
+    void OnReplayed(unsigned int nGeneration, unsigned int nSequence, ra::api::ApiResult nResult);
+    void Compact() const;
+
+    mutable std::mutex m_mMutex;
+    unsigned int m_nNextSequence = 1;
+    unsigned int m_nGeneration = 0;      // incremented when a different journal is loaded
+    unsigned int m_nAcknowledged = 0;    // acknowledgements appended since the journal was last compacted
+    bool m_bReplaying = false;           // only one pending entry is resubmitted at a time
+};
+
+} // namespace data
+} // namespace ra
+
+#endif // !RA_DATA_SUBMISSIONJOURNAL_HH
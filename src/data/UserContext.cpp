@@ -7,6 +7,7 @@
 #include "data\EmulatorContext.hh"
 
 #include "services\IConfiguration.hh"
+#include "services\RequestCoalescer.hh"
 
 #include "ui\viewmodels\MessageBoxViewModel.hh"
 #include "ui\viewmodels\OverlayManager.hh"
@@ -27,6 +28,10 @@ void UserContext::Logout()
         m_sApiToken.clear();
         m_nScore = 0U;
 
+        // cached responses may be specific to the user
+        if (ra::services::ServiceLocator::Exists<ra::services::RequestCoalescer>())
+            ra::services::ServiceLocator::GetMutable<ra::services::RequestCoalescer>().ClearCache();
+
         auto& pOverlayManager = ra::services::ServiceLocator::GetMutable<ra::ui::viewmodels::OverlayManager>();
         pOverlayManager.ClearPopups();
         pOverlayManager.HideOverlay();
@@ -11,6 +11,7 @@
 #include "data\UserContext.hh"
 
 #include "services\IFileSystem.hh"
+#include "services\ILocalStorage.hh"
 #include "services\ServiceLocator.hh"
 
 namespace ra {
@@ -23,16 +24,17 @@ void AchievementRuntime::ActivateAchievement(unsigned int nId, rc_trigger_t* pTr
         // If processing is paused, just queue the achievement. Once processing is unpaused, if the trigger
         // is not false, the achievement will be moved to the active list. This ensures achievements don't
         // trigger immediately upon loading the game due to uninitialized memory.
-        GSL_SUPPRESS_F6 AddEntry(m_vQueuedAchievements, nId, pTrigger);
+        GSL_SUPPRESS_F6 AddAchievementEntry(m_vQueuedAchievements, nId, pTrigger, nullptr);
         RemoveEntry(m_vActiveAchievements, nId);
     }
     else
     {
-        GSL_SUPPRESS_F6 AddEntry(m_vActiveAchievements, nId, pTrigger);
+        GSL_SUPPRESS_F6 AddAchievementEntry(m_vActiveAchievements, nId, pTrigger, nullptr);
         RemoveEntry(m_vQueuedAchievements, nId);
     }
 
     RemoveEntry(m_vActiveAchievementsMonitorReset, nId);
+    ++m_nActivations;
 }
 
 void AchievementRuntime::MonitorAchievementReset(unsigned int nId, rc_trigger_t* pTrigger) noexcept
@@ -42,17 +44,45 @@ void AchievementRuntime::MonitorAchievementReset(unsigned int nId, rc_trigger_t*
         // If processing is paused, just queue the achievement. Once processing is unpaused, if the trigger
         // is not false, the achievement will be moved to the active list. This ensures achievements don't
         // trigger immediately upon loading the game due to uninitialized memory.
-        GSL_SUPPRESS_F6 AddEntry(m_vQueuedAchievements, nId, pTrigger);
+        GSL_SUPPRESS_F6 AddAchievementEntry(m_vQueuedAchievements, nId, pTrigger, nullptr);
         m_vQueuedAchievements.back().bPauseOnReset = true;
         RemoveEntry(m_vActiveAchievementsMonitorReset, nId);
     }
     else
     {
-        GSL_SUPPRESS_F6 AddEntry(m_vActiveAchievementsMonitorReset, nId, pTrigger);
+        GSL_SUPPRESS_F6 AddAchievementEntry(m_vActiveAchievementsMonitorReset, nId, pTrigger, nullptr);
         RemoveEntry(m_vQueuedAchievements, nId);
     }
 
     RemoveEntry(m_vActiveAchievements, nId);
+    ++m_nActivations;
+}
+
+static void AppendMemRefs(std::vector<const rc_memref_value_t*>& vMemRefs, const rc_memref_value_t* pMemRef)
+{
+    for (; pMemRef != nullptr; pMemRef = pMemRef->next)
+        vMemRefs.push_back(pMemRef);
+}
+
+_Use_decl_annotations_
+void AchievementRuntime::GetMemRefs(std::vector<const rc_memref_value_t*>& vMemRefs) const
+{
+    for (const auto& pAchievement : m_vQueuedAchievements)
+        AppendMemRefs(vMemRefs, pAchievement.pTrigger->memrefs);
+    for (const auto& pAchievement : m_vActiveAchievements)
+        AppendMemRefs(vMemRefs, pAchievement.pTrigger->memrefs);
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+        AppendMemRefs(vMemRefs, pAchievement.pTrigger->memrefs);
+    for (const auto& pLeaderboard : m_vActiveLeaderboards)
+        AppendMemRefs(vMemRefs, pLeaderboard.pLeaderboard->memrefs);
+}
+
+static void ResetTrigger(rc_trigger_t* pTrigger, CompiledTrigger* pCompiledTrigger) noexcept
+{
+    if (pCompiledTrigger != nullptr)
+        pCompiledTrigger->Reset();
+    else
+        rc_reset_trigger(pTrigger);
 }
 
 void AchievementRuntime::ResetActiveAchievements()
@@ -61,8 +91,9 @@ void AchievementRuntime::ResetActiveAchievements()
     // trigger is active. This ensures they don't trigger while we're resetting.
     for (const auto& pAchievement : m_vActiveAchievements)
     {
-        rc_reset_trigger(pAchievement.pTrigger);
-        AddEntry(m_vQueuedAchievements, pAchievement.nId, pAchievement.pTrigger);
+        ResetTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
+        AddAchievementEntry(m_vQueuedAchievements, pAchievement.nId, pAchievement.pTrigger,
+                            pAchievement.pCompiledTrigger);
     }
 
     m_vActiveAchievements.clear();
@@ -70,8 +101,9 @@ void AchievementRuntime::ResetActiveAchievements()
     // make sure to also process the achievements being monitored
     for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
     {
-        rc_reset_trigger(pAchievement.pTrigger);
-        AddEntry(m_vQueuedAchievements, pAchievement.nId, pAchievement.pTrigger);
+        ResetTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
+        AddAchievementEntry(m_vQueuedAchievements, pAchievement.nId, pAchievement.pTrigger,
+                            pAchievement.pCompiledTrigger);
         m_vQueuedAchievements.back().bPauseOnReset = true;
     }
 
@@ -118,57 +150,370 @@ static constexpr bool HasHitCounts(const rc_trigger_t* pTrigger) noexcept
     return false;
 }
 
+static bool HasHitCounts(const rc_trigger_t* pTrigger, const CompiledTrigger* pCompiledTrigger) noexcept
+{
+    if (pCompiledTrigger != nullptr)
+        return pCompiledTrigger->HasHitCounts();
+
+    return HasHitCounts(pTrigger);
+}
+
+static bool TestTrigger(rc_trigger_t* pTrigger, CompiledTrigger* pCompiledTrigger)
+{
+    if (pCompiledTrigger != nullptr)
+        return pCompiledTrigger->Test(rc_peek_callback, nullptr);
+
+    return rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+}
+
+static bool AnyHitTargets(const rc_condset_t* pCondSet) noexcept
+{
+    for (; pCondSet != nullptr; pCondSet = pCondSet->next)
+    {
+        for (const auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+        {
+            if (pCondition->required_hits != 0)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool AchievementRuntime::HasHitTargets(const rc_trigger_t& pTrigger) noexcept
+{
+    if (pTrigger.requirement != nullptr && AnyHitTargets(pTrigger.requirement))
+        return true;
+
+    return AnyHitTargets(pTrigger.alternative);
+}
+
+static bool UpdateLeaderboardMemRefs(rc_memref_value_t* pMemRef) noexcept
+{
+    bool bChanged = false;
+    for (; pMemRef != nullptr; pMemRef = pMemRef->next)
+    {
+        // a pending delta changes the values seen by the triggers even if the memory hasn't changed
+        if (pMemRef->value != pMemRef->previous)
+            bChanged = true;
+
+        CompiledTrigger::UpdateMemRef(*pMemRef, rc_peek_callback, nullptr);
+
+        if (pMemRef->value != pMemRef->previous)
+            bChanged = true;
+    }
+
+    return bChanged;
+}
+
+void AchievementRuntime::PrepareLeaderboardTrigger(LeaderboardTrigger& pTrigger, bool bMemRefsChanged) noexcept
+{
+    if (pTrigger.bStateful)
+    {
+        pTrigger.bResult = rc_test_trigger(pTrigger.pTrigger, rc_peek_callback, nullptr, nullptr) != 0;
+        pTrigger.bResultValid = true;
+    }
+    else if (bMemRefsChanged)
+    {
+        pTrigger.bResultValid = false;
+    }
+}
+
+bool AchievementRuntime::TestLeaderboardTrigger(LeaderboardTrigger& pTrigger) noexcept
+{
+    if (!pTrigger.bResultValid)
+    {
+        pTrigger.bResult = rc_test_trigger(pTrigger.pTrigger, rc_peek_callback, nullptr, nullptr) != 0;
+        pTrigger.bResultValid = true;
+    }
+
+    return pTrigger.bResult;
+}
+
+int AchievementRuntime::EvaluateLeaderboard(ActiveLeaderboard& pLeaderboard, unsigned int& nValue) noexcept
+{
+    // equivalent to rc_evaluate_lboard. triggers with hit targets are evaluated every frame so their hit counts
+    // advance the same way, but the others (and the value) are only evaluated when they can affect the result, and
+    // only if something they read has changed since they were last evaluated.
+    auto* pLboard = pLeaderboard.pLeaderboard;
+    const bool bChanged = UpdateLeaderboardMemRefs(pLboard->memrefs);
+    PrepareLeaderboardTrigger(pLeaderboard.pStart, bChanged);
+    PrepareLeaderboardTrigger(pLeaderboard.pCancel, bChanged);
+    PrepareLeaderboardTrigger(pLeaderboard.pSubmit, bChanged);
+
+    int nResult = pLboard->started ? RC_LBOARD_ACTIVE : RC_LBOARD_INACTIVE;
+    if (pLboard->submitted)
+    {
+        // don't restart until the start trigger has been false for at least one frame
+        if (!TestLeaderboardTrigger(pLeaderboard.pStart))
+            pLboard->submitted = 0;
+    }
+    else if (!pLboard->started)
+    {
+        if (TestLeaderboardTrigger(pLeaderboard.pStart) && !TestLeaderboardTrigger(pLeaderboard.pCancel))
+        {
+            if (TestLeaderboardTrigger(pLeaderboard.pSubmit))
+            {
+                pLboard->submitted = 1;
+                nResult = RC_LBOARD_TRIGGERED;
+            }
+            else if (pLboard->start.requirement != nullptr || pLboard->start.alternative != nullptr)
+            {
+                pLboard->started = 1;
+                nResult = RC_LBOARD_STARTED;
+            }
+        }
+    }
+    else
+    {
+        if (TestLeaderboardTrigger(pLeaderboard.pCancel))
+        {
+            pLboard->started = 0;
+            pLboard->submitted = 1;
+            nResult = RC_LBOARD_CANCELED;
+        }
+        else if (TestLeaderboardTrigger(pLeaderboard.pSubmit))
+        {
+            pLboard->started = 0;
+            pLboard->submitted = 1;
+            nResult = RC_LBOARD_TRIGGERED;
+        }
+    }
+
+    switch (nResult)
+    {
+        case RC_LBOARD_STARTED:
+        case RC_LBOARD_ACTIVE:
+        case RC_LBOARD_TRIGGERED:
+            nValue = rc_evaluate_value(&pLboard->value, rc_peek_callback, nullptr, nullptr);
+            break;
+
+        default:
+            nValue = 0;
+            break;
+    }
+
+    return nResult;
+}
+
+void AchievementRuntime::SetParallelEvaluation(unsigned int nWorkers)
+{
+    if (nWorkers < 2)
+    {
+        m_pWorkerGroup.reset();
+    }
+    else if (m_pWorkerGroup == nullptr || m_pWorkerGroup->GetWorkerCount() != nWorkers)
+    {
+        m_pWorkerGroup.reset();
+        m_pWorkerGroup = std::make_unique<WorkerGroup>(nWorkers);
+
+        // force the snapshot regions to be rebuilt
+        m_nSnapshotActivations = m_nActivations - 1;
+    }
+}
+
+void AchievementRuntime::TestActiveAchievement(size_t nIndex, void* pRuntime) noexcept
+{
+    auto* pThis = static_cast<AchievementRuntime*>(pRuntime);
+    auto& pAchievement = pThis->m_vActiveAchievements.at(nIndex);
+
+    bool bResult;
+    if (pAchievement.pCompiledTrigger != nullptr)
+        bResult = pAchievement.pCompiledTrigger->Test(MemorySnapshot::Peek, &pThis->m_pSnapshot);
+    else
+        bResult = rc_test_trigger(pAchievement.pTrigger, MemorySnapshot::Peek, &pThis->m_pSnapshot, nullptr) != 0;
+
+    pThis->m_vParallelResults.at(nIndex) = bResult ? 1 : 0;
+}
+
+_Use_decl_annotations_
+void AchievementRuntime::ProcessActiveAchievementsParallel(std::vector<Change>& changes)
+{
+    // triggers only share the memory they read, so once it's been copied they can be evaluated independently.
+    // the regions only have to be rebuilt when something new is activated or the memory changes size.
+    const auto nMemorySize = gsl::narrow_cast<unsigned int>(g_MemManager.TotalBankSize());
+    if (m_nSnapshotActivations != m_nActivations || m_pSnapshot.GetMemorySize() != nMemorySize)
+    {
+        std::vector<const rc_memref_value_t*> vMemRefs;
+        GetMemRefs(vMemRefs);
+        m_pSnapshot.SetMemRefs(vMemRefs, nMemorySize);
+        m_nSnapshotActivations = m_nActivations;
+    }
+
+    m_pSnapshot.Capture();
+
+    m_vParallelResults.resize(m_vActiveAchievements.size());
+    m_pWorkerGroup->ForEach(m_vActiveAchievements.size(), TestActiveAchievement, this);
+
+    // report in list order so the results don't depend on how the work was split
+    for (size_t nIndex = 0; nIndex < m_vActiveAchievements.size(); ++nIndex)
+    {
+        if (m_vParallelResults.at(nIndex))
+            changes.emplace_back(Change{ChangeType::AchievementTriggered, m_vActiveAchievements.at(nIndex).nId, 0U});
+    }
+}
+
+void AchievementRuntime::SetTraced(unsigned int nId, bool bTraced)
+{
+    for (auto pIter = m_vTracedAchievements.begin(); pIter != m_vTracedAchievements.end(); ++pIter)
+    {
+        if (pIter->nId == nId)
+        {
+            if (!bTraced)
+                m_vTracedAchievements.erase(pIter);
+            return;
+        }
+    }
+
+    if (bTraced)
+        m_vTracedAchievements.push_back({nId, nullptr});
+}
+
+bool AchievementRuntime::IsTraced(unsigned int nId) const noexcept
+{
+    for (const auto& pTraced : m_vTracedAchievements)
+    {
+        if (pTraced.nId == nId)
+            return true;
+    }
+
+    return false;
+}
+
+const RuntimeTrace* AchievementRuntime::GetTrace(unsigned int nId) const noexcept
+{
+    for (const auto& pTraced : m_vTracedAchievements)
+    {
+        if (pTraced.nId == nId)
+            return pTraced.pTrace.get();
+    }
+
+    return nullptr;
+}
+
+template<class T>
+static rc_trigger_t* FindActiveTrigger(const std::vector<T>& vAchievements, unsigned int nId) noexcept
+{
+    for (const auto& pAchievement : vAchievements)
+    {
+        if (pAchievement.nId == nId)
+            return pAchievement.pTrigger;
+    }
+
+    return nullptr;
+}
+
+_Use_decl_annotations_
+void AchievementRuntime::RecordTraces(const std::vector<Change>& changes, size_t nFirstChange)
+{
+    for (auto& pTraced : m_vTracedAchievements)
+    {
+        // queued achievements are reset every frame, so there's nothing interesting to record for them
+        auto* pTrigger = FindActiveTrigger(m_vActiveAchievements, pTraced.nId);
+        if (pTrigger == nullptr)
+        {
+            pTrigger = FindActiveTrigger(m_vActiveAchievementsMonitorReset, pTraced.nId);
+            if (pTrigger == nullptr)
+                continue;
+        }
+
+        // DeactivateAchievement discards the history, so an existing trace always belongs to the current trigger
+        if (pTraced.pTrace == nullptr)
+            pTraced.pTrace = std::make_unique<RuntimeTrace>(pTraced.nId, *pTrigger);
+
+        pTraced.pTrace->Record(m_nFrame);
+
+        for (auto nIndex = nFirstChange; nIndex < changes.size(); ++nIndex)
+        {
+            const auto& pChange = changes.at(nIndex);
+            if (pChange.nId == pTraced.nId && pChange.nType == ChangeType::AchievementTriggered)
+            {
+                auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+                auto pWriter = pLocalStorage.WriteText(ra::services::StorageItemType::RuntimeTrace,
+                                                       std::to_wstring(pTraced.nId));
+                if (pWriter != nullptr)
+                {
+                    pTraced.pTrace->Write(*pWriter);
+                    RA_LOG("Wrote %u frames of history for achievement %u", pTraced.pTrace->GetFrameCount(),
+                           pTraced.nId);
+                }
+                break;
+            }
+        }
+    }
+}
+
 _Use_decl_annotations_ void AchievementRuntime::Process(std::vector<Change>& changes)
 {
     if (m_bPaused)
         return;
 
-    for (auto& pAchievement : m_vActiveAchievements)
+    ++m_nFrame;
+    const auto nFirstChange = changes.size();
+
+    if (m_pWorkerGroup != nullptr && m_vActiveAchievements.size() >= ParallelEvaluationThreshold)
     {
-        const bool bResult = rc_test_trigger(pAchievement.pTrigger, rc_peek_callback, nullptr, nullptr);
-        if (bResult)
-            changes.emplace_back(Change{ChangeType::AchievementTriggered, pAchievement.nId, 0U});
+        ProcessActiveAchievementsParallel(changes);
+    }
+    else
+    {
+        for (auto& pAchievement : m_vActiveAchievements)
+        {
+            const bool bResult = TestTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
+            if (bResult)
+                changes.emplace_back(Change{ChangeType::AchievementTriggered, pAchievement.nId, 0U});
+        }
     }
 
     for (auto& pAchievement : m_vActiveAchievementsMonitorReset)
     {
-        const bool bHasHits = HasHitCounts(pAchievement.pTrigger);
+        const bool bHasHits = HasHitCounts(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
 
-        const bool bResult = rc_test_trigger(pAchievement.pTrigger, rc_peek_callback, nullptr, nullptr);
+        const bool bResult = TestTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
         if (bResult)
             changes.emplace_back(Change{ChangeType::AchievementTriggered, pAchievement.nId, 0U});
-        else if (bHasHits && !HasHitCounts(pAchievement.pTrigger))
+        else if (bHasHits && !HasHitCounts(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get()))
             changes.emplace_back(Change{ChangeType::AchievementReset, pAchievement.nId, 0U});
     }
 
-    auto pIter = m_vQueuedAchievements.begin();
-    while (pIter != m_vQueuedAchievements.end())
+    size_t nIndex = 0;
+    while (nIndex < m_vQueuedAchievements.size())
     {
-        const bool bResult = rc_test_trigger(pIter->pTrigger, rc_peek_callback, nullptr, nullptr);
+        auto& pAchievement = m_vQueuedAchievements.at(nIndex);
+        const bool bResult = TestTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
+
+        // if the trigger is active, ignore the achievement for now. reset it so it can't pause itself.
+        // otherwise, reset the achievement and allow it to be triggered on future frames
+        ResetTrigger(pAchievement.pTrigger, pAchievement.pCompiledTrigger.get());
+
         if (bResult)
         {
-            // trigger is active, ignore the achievement for now. reset it so it can't pause itself.
-            rc_reset_trigger(pIter->pTrigger);
-            ++pIter;
+            ++nIndex;
+            continue;
         }
+
+        if (pAchievement.bPauseOnReset)
+            AddAchievementEntry(m_vActiveAchievementsMonitorReset, pAchievement.nId, pAchievement.pTrigger,
+                                pAchievement.pCompiledTrigger);
         else
-        {
-            // trigger is not active, reset the achievement and allow it to be triggered on future frames
-            rc_reset_trigger(pIter->pTrigger);
+            AddAchievementEntry(m_vActiveAchievements, pAchievement.nId, pAchievement.pTrigger,
+                                pAchievement.pCompiledTrigger);
 
-            if (pIter->bPauseOnReset)
-                AddEntry(m_vActiveAchievementsMonitorReset, pIter->nId, pIter->pTrigger);
-            else
-                AddEntry(m_vActiveAchievements, pIter->nId, pIter->pTrigger);
+        // order doesn't matter in the queue. move the last item into the vacated slot instead of shifting
+        // everything down, and evaluate it next.
+        if (nIndex + 1 < m_vQueuedAchievements.size())
+            pAchievement = std::move(m_vQueuedAchievements.back());
 
-            pIter = m_vQueuedAchievements.erase(pIter);
-        }
+        m_vQueuedAchievements.pop_back();
     }
 
+    if (!m_vTracedAchievements.empty())
+        RecordTraces(changes, nFirstChange);
+
     for (auto& pLeaderboard : m_vActiveLeaderboards)
     {
         unsigned int nValue;
-        const int nResult = rc_evaluate_lboard(pLeaderboard.pLeaderboard, &nValue, rc_peek_callback, nullptr, nullptr);
+        const int nResult = EvaluateLeaderboard(pLeaderboard, nValue);
         switch (nResult)
         {
             default:
@@ -661,6 +1006,7 @@ bool AchievementRuntime::LoadProgress(const char* sLoadStateFilename) const
             rc_reset_trigger(pActiveAchievement.pTrigger);
     }
 
+    SyncHitCounts();
     return true;
 }
 
@@ -773,5 +1119,568 @@ void AchievementRuntime::SaveProgress(const char* sSaveStateFilename) const
     }
 }
 
+// "RAST" - identifies a buffer populated by CaptureState
+static constexpr unsigned int StateMagic = 0x54534152;
+static constexpr unsigned int StateVersion = 1;
+
+static constexpr size_t StateHeaderSize = 5 * sizeof(unsigned int);           // magic, version, size, #ach, #lb
+static constexpr size_t StateAchievementHeaderSize = 4 * sizeof(unsigned int); // id, list, #memrefs, #conditions
+static constexpr size_t StateLeaderboardHeaderSize = 5 * sizeof(unsigned int); // id, flags, value, #memrefs, #conditions
+static constexpr size_t StateMemRefSize = 5 * sizeof(unsigned int);            // address, size, value, previous, prior
+static constexpr size_t StateConditionSize = sizeof(unsigned int);             // current_hits
+
+static constexpr unsigned int StateLeaderboardStarted = 0x01;
+static constexpr unsigned int StateLeaderboardSubmitted = 0x02;
+
+class StateWriter
+{
+public:
+    explicit StateWriter(unsigned char* pBuffer) noexcept : m_pCurrent(pBuffer) {}
+
+    void Write(unsigned int nValue) noexcept
+    {
+        memcpy(m_pCurrent, &nValue, sizeof(nValue));
+        GSL_SUPPRESS(bounds.1) m_pCurrent += sizeof(nValue);
+    }
+
+private:
+    unsigned char* m_pCurrent;
+};
+
+class StateReader
+{
+public:
+    explicit StateReader(const unsigned char* pBuffer, size_t nBufferSize) noexcept
+        : m_pCurrent(pBuffer), m_nRemaining(nBufferSize)
+    {
+    }
+
+    unsigned int Read() noexcept
+    {
+        unsigned int nValue = 0;
+        if (m_nRemaining >= sizeof(nValue))
+        {
+            memcpy(&nValue, m_pCurrent, sizeof(nValue));
+            GSL_SUPPRESS(bounds.1) m_pCurrent += sizeof(nValue);
+            m_nRemaining -= sizeof(nValue);
+        }
+        else
+        {
+            m_nRemaining = 0;
+            m_bOverflow = true;
+        }
+
+        return nValue;
+    }
+
+    void Skip(size_t nBytes) noexcept
+    {
+        if (nBytes > m_nRemaining)
+        {
+            m_nRemaining = 0;
+            m_bOverflow = true;
+        }
+        else
+        {
+            GSL_SUPPRESS(bounds.1) m_pCurrent += nBytes;
+            m_nRemaining -= nBytes;
+        }
+    }
+
+    void SkipEntries(unsigned int nNumMemRefs, unsigned int nNumConditions) noexcept
+    {
+        // the counts come from the buffer, so compute the size in 64 bits where it can't wrap around and
+        // pass the bounds check in a 32-bit build
+        const auto nBytes = uint64_t{nNumMemRefs} * StateMemRefSize + uint64_t{nNumConditions} * StateConditionSize;
+        if (nBytes > m_nRemaining)
+        {
+            m_nRemaining = 0;
+            m_bOverflow = true;
+        }
+        else
+        {
+            Skip(gsl::narrow_cast<size_t>(nBytes));
+        }
+    }
+
+    const unsigned char* Position() const noexcept { return m_pCurrent; }
+    void Seek(const unsigned char* pPosition, size_t nRemaining) noexcept
+    {
+        m_pCurrent = pPosition;
+        m_nRemaining = nRemaining;
+    }
+    size_t Remaining() const noexcept { return m_nRemaining; }
+    bool Overflow() const noexcept { return m_bOverflow; }
+
+private:
+    const unsigned char* m_pCurrent;
+    size_t m_nRemaining;
+    bool m_bOverflow = false;
+};
+
+static constexpr unsigned int CountMemRefs(const rc_memref_value_t* pMemRef) noexcept
+{
+    unsigned int nCount = 0;
+    for (; pMemRef != nullptr; pMemRef = pMemRef->next)
+        ++nCount;
+
+    return nCount;
+}
+
+static constexpr unsigned int CountConditions(const rc_condset_t* pCondSet) noexcept
+{
+    unsigned int nCount = 0;
+    if (pCondSet != nullptr)
+    {
+        for (const auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+            ++nCount;
+    }
+
+    return nCount;
+}
+
+static constexpr unsigned int CountConditions(const rc_trigger_t& pTrigger) noexcept
+{
+    unsigned int nCount = CountConditions(pTrigger.requirement);
+    for (const auto* pAlternate = pTrigger.alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+        nCount += CountConditions(pAlternate);
+
+    return nCount;
+}
+
+static constexpr unsigned int CountConditions(const rc_lboard_t& pLeaderboard) noexcept
+{
+    return CountConditions(pLeaderboard.start) + CountConditions(pLeaderboard.submit) +
+           CountConditions(pLeaderboard.cancel);
+}
+
+static void WriteMemRefs(StateWriter& pWriter, const rc_memref_value_t* pMemRef) noexcept
+{
+    for (; pMemRef != nullptr; pMemRef = pMemRef->next)
+    {
+        pWriter.Write(pMemRef->memref.address);
+        pWriter.Write(ra::to_unsigned(pMemRef->memref.size));
+        pWriter.Write(pMemRef->value);
+        pWriter.Write(pMemRef->previous);
+        pWriter.Write(pMemRef->prior);
+    }
+}
+
+static void WriteHits(StateWriter& pWriter, const rc_condset_t* pCondSet) noexcept
+{
+    if (pCondSet != nullptr)
+    {
+        for (const auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+            pWriter.Write(pCondition->current_hits);
+    }
+}
+
+static void WriteHits(StateWriter& pWriter, const rc_trigger_t& pTrigger) noexcept
+{
+    WriteHits(pWriter, pTrigger.requirement);
+    for (const auto* pAlternate = pTrigger.alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+        WriteHits(pWriter, pAlternate);
+}
+
+static bool ReadMemRefs(StateReader& pReader, rc_memref_value_t* pFirstMemRef, unsigned int nCount) noexcept
+{
+    // validate the memrefs before modifying anything so a mismatched definition doesn't get partially updated
+    const auto* pStart = pReader.Position();
+    const auto nRemaining = pReader.Remaining();
+    for (const auto* pMemRef = pFirstMemRef; pMemRef != nullptr; pMemRef = pMemRef->next)
+    {
+        const auto nAddress = pReader.Read();
+        const auto nSize = pReader.Read();
+        pReader.Skip(3 * sizeof(unsigned int));
+
+        if (nAddress != pMemRef->memref.address || nSize != ra::to_unsigned(pMemRef->memref.size))
+        {
+            pReader.Seek(pStart, nRemaining);
+            pReader.SkipEntries(nCount, 0);
+            return false;
+        }
+    }
+
+    if (pReader.Overflow())
+        return false;
+
+    pReader.Seek(pStart, nRemaining);
+    for (auto* pMemRef = pFirstMemRef; pMemRef != nullptr; pMemRef = pMemRef->next)
+    {
+        pReader.Skip(2 * sizeof(unsigned int));
+        pMemRef->value = pReader.Read();
+        pMemRef->previous = pReader.Read();
+        pMemRef->prior = pReader.Read();
+    }
+
+    return true;
+}
+
+static void ReadHits(StateReader& pReader, rc_condset_t* pCondSet) noexcept
+{
+    if (pCondSet != nullptr)
+    {
+        for (auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+            pCondition->current_hits = pReader.Read();
+    }
+}
+
+static void ReadHits(StateReader& pReader, rc_trigger_t& pTrigger) noexcept
+{
+    ReadHits(pReader, pTrigger.requirement);
+    for (auto* pAlternate = pTrigger.alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+        ReadHits(pReader, pAlternate);
+}
+
+size_t AchievementRuntime::GetStateSize() const noexcept
+{
+    size_t nSize = StateHeaderSize;
+
+    const auto AddAchievementSize = [&nSize](const rc_trigger_t* pTrigger) noexcept
+    {
+        nSize += StateAchievementHeaderSize;
+        nSize += CountMemRefs(pTrigger->memrefs) * StateMemRefSize;
+        nSize += CountConditions(*pTrigger) * StateConditionSize;
+    };
+
+    for (const auto& pAchievement : m_vActiveAchievements)
+        AddAchievementSize(pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+        AddAchievementSize(pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vQueuedAchievements)
+        AddAchievementSize(pAchievement.pTrigger);
+
+    for (const auto& pLeaderboard : m_vActiveLeaderboards)
+    {
+        nSize += StateLeaderboardHeaderSize;
+        nSize += CountMemRefs(pLeaderboard.pLeaderboard->memrefs) * StateMemRefSize;
+        nSize += CountConditions(*pLeaderboard.pLeaderboard) * StateConditionSize;
+    }
+
+    return nSize;
+}
+
+_Use_decl_annotations_
+size_t AchievementRuntime::CaptureState(unsigned char* pBuffer, size_t nBufferSize) const noexcept
+{
+    const auto nSize = GetStateSize();
+    if (pBuffer == nullptr || nBufferSize < nSize)
+        return 0U;
+
+    StateWriter pWriter(pBuffer);
+    pWriter.Write(StateMagic);
+    pWriter.Write(StateVersion);
+    pWriter.Write(gsl::narrow_cast<unsigned int>(nSize));
+    pWriter.Write(gsl::narrow_cast<unsigned int>(m_vActiveAchievements.size() +
+                                                 m_vActiveAchievementsMonitorReset.size() +
+                                                 m_vQueuedAchievements.size()));
+    pWriter.Write(gsl::narrow_cast<unsigned int>(m_vActiveLeaderboards.size()));
+
+    const auto WriteAchievement = [&pWriter](unsigned int nId, StateList nList, const rc_trigger_t* pTrigger) noexcept
+    {
+        pWriter.Write(nId);
+        pWriter.Write(ra::etoi(nList));
+        pWriter.Write(CountMemRefs(pTrigger->memrefs));
+        pWriter.Write(CountConditions(*pTrigger));
+        WriteMemRefs(pWriter, pTrigger->memrefs);
+        WriteHits(pWriter, *pTrigger);
+    };
+
+    for (const auto& pAchievement : m_vActiveAchievements)
+        WriteAchievement(pAchievement.nId, StateList::Active, pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+        WriteAchievement(pAchievement.nId, StateList::ActiveMonitorReset, pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vQueuedAchievements)
+    {
+        WriteAchievement(pAchievement.nId,
+                         pAchievement.bPauseOnReset ? StateList::QueuedMonitorReset : StateList::Queued,
+                         pAchievement.pTrigger);
+    }
+
+    for (const auto& pLeaderboard : m_vActiveLeaderboards)
+    {
+        const auto* pLboard = pLeaderboard.pLeaderboard;
+
+        unsigned int nFlags = 0;
+        if (pLboard->started)
+            nFlags |= StateLeaderboardStarted;
+        if (pLboard->submitted)
+            nFlags |= StateLeaderboardSubmitted;
+
+        pWriter.Write(pLeaderboard.nId);
+        pWriter.Write(nFlags);
+        pWriter.Write(pLeaderboard.nValue);
+        pWriter.Write(CountMemRefs(pLboard->memrefs));
+        pWriter.Write(CountConditions(*pLboard));
+        WriteMemRefs(pWriter, pLboard->memrefs);
+        WriteHits(pWriter, pLboard->start);
+        WriteHits(pWriter, pLboard->submit);
+        WriteHits(pWriter, pLboard->cancel);
+    }
+
+    return nSize;
+}
+
+_Use_decl_annotations_
+rc_trigger_t* AchievementRuntime::FindStateEntry(unsigned int nId, StateList nList, size_t nIndexHint,
+                                                 StateList& nFoundList) const noexcept
+{
+    // the buffer is written in list order, so unless the lists have changed since the state was captured,
+    // the entry will be at the hinted index
+    switch (nList)
+    {
+        case StateList::Active:
+            if (nIndexHint < m_vActiveAchievements.size() && m_vActiveAchievements.at(nIndexHint).nId == nId)
+            {
+                nFoundList = nList;
+                return m_vActiveAchievements.at(nIndexHint).pTrigger;
+            }
+            break;
+
+        case StateList::ActiveMonitorReset:
+            if (nIndexHint < m_vActiveAchievementsMonitorReset.size() &&
+                m_vActiveAchievementsMonitorReset.at(nIndexHint).nId == nId)
+            {
+                nFoundList = nList;
+                return m_vActiveAchievementsMonitorReset.at(nIndexHint).pTrigger;
+            }
+            break;
+
+        default:
+            if (nIndexHint < m_vQueuedAchievements.size() && m_vQueuedAchievements.at(nIndexHint).nId == nId)
+            {
+                const auto& pAchievement = m_vQueuedAchievements.at(nIndexHint);
+                nFoundList = pAchievement.bPauseOnReset ? StateList::QueuedMonitorReset : StateList::Queued;
+                return pAchievement.pTrigger;
+            }
+            break;
+    }
+
+    for (const auto& pAchievement : m_vActiveAchievements)
+    {
+        if (pAchievement.nId == nId)
+        {
+            nFoundList = StateList::Active;
+            return pAchievement.pTrigger;
+        }
+    }
+
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+    {
+        if (pAchievement.nId == nId)
+        {
+            nFoundList = StateList::ActiveMonitorReset;
+            return pAchievement.pTrigger;
+        }
+    }
+
+    for (const auto& pAchievement : m_vQueuedAchievements)
+    {
+        if (pAchievement.nId == nId)
+        {
+            nFoundList = pAchievement.bPauseOnReset ? StateList::QueuedMonitorReset : StateList::Queued;
+            return pAchievement.pTrigger;
+        }
+    }
+
+    nFoundList = nList;
+    return nullptr;
+}
+
+void AchievementRuntime::MoveStateEntry(unsigned int nId, rc_trigger_t* pTrigger, StateList nFromList, StateList nToList)
+{
+    switch (nFromList)
+    {
+        case StateList::Active:
+            RemoveEntry(m_vActiveAchievements, nId);
+            break;
+        case StateList::ActiveMonitorReset:
+            RemoveEntry(m_vActiveAchievementsMonitorReset, nId);
+            break;
+        default:
+            RemoveEntry(m_vQueuedAchievements, nId);
+            break;
+    }
+
+    switch (nToList)
+    {
+        case StateList::Active:
+            AddAchievementEntry(m_vActiveAchievements, nId, pTrigger, nullptr);
+            break;
+        case StateList::ActiveMonitorReset:
+            AddAchievementEntry(m_vActiveAchievementsMonitorReset, nId, pTrigger, nullptr);
+            break;
+        default:
+            AddAchievementEntry(m_vQueuedAchievements, nId, pTrigger, nullptr);
+            m_vQueuedAchievements.back().bPauseOnReset = (nToList == StateList::QueuedMonitorReset);
+            break;
+    }
+}
+
+_Use_decl_annotations_
+bool AchievementRuntime::RestoreState(const unsigned char* pBuffer, size_t nBufferSize)
+{
+    if (pBuffer == nullptr || nBufferSize < StateHeaderSize)
+        return false;
+
+    StateReader pReader(pBuffer, nBufferSize);
+    if (pReader.Read() != StateMagic || pReader.Read() != StateVersion)
+        return false;
+
+    const auto nSize = pReader.Read();
+    if (nSize > nBufferSize)
+        return false;
+
+    const auto nNumAchievements = pReader.Read();
+    const auto nNumLeaderboards = pReader.Read();
+
+    // reset everything first. anything not in the buffer (or not matching it) will remain reset.
+    for (const auto& pAchievement : m_vActiveAchievements)
+        rc_reset_trigger(pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+        rc_reset_trigger(pAchievement.pTrigger);
+    for (const auto& pAchievement : m_vQueuedAchievements)
+        rc_reset_trigger(pAchievement.pTrigger);
+    for (auto& pLeaderboard : m_vActiveLeaderboards)
+    {
+        rc_reset_lboard(pLeaderboard.pLeaderboard);
+
+        // the memrefs are about to be replaced, so the results from the last frame can't be reused
+        pLeaderboard.pStart.bResultValid = false;
+        pLeaderboard.pCancel.bResultValid = false;
+        pLeaderboard.pSubmit.bResultValid = false;
+    }
+
+    std::array<size_t, 4> nListIndex{};
+    for (unsigned int i = 0; i < nNumAchievements && !pReader.Overflow(); ++i)
+    {
+        const auto nId = pReader.Read();
+        auto nList = ra::itoe<StateList>(pReader.Read());
+        if (ra::etoi(nList) > ra::etoi(StateList::QueuedMonitorReset))
+            nList = StateList::Queued;
+        const auto nNumMemRefs = pReader.Read();
+        const auto nNumConditions = pReader.Read();
+
+        // both queued lists are written from the same collection, so they share an index
+        const auto nCollection = (nList == StateList::QueuedMonitorReset) ? StateList::Queued : nList;
+        auto& nIndex = nListIndex.at(gsl::narrow_cast<size_t>(ra::etoi(nCollection)));
+
+        StateList nCurrentList{};
+        auto* pTrigger = FindStateEntry(nId, nList, nIndex++, nCurrentList);
+        if (pTrigger == nullptr || nNumMemRefs != CountMemRefs(pTrigger->memrefs) ||
+            nNumConditions != CountConditions(*pTrigger))
+        {
+            // not active, or definition changed since captured
+            pReader.SkipEntries(nNumMemRefs, nNumConditions);
+            continue;
+        }
+
+        if (!ReadMemRefs(pReader, pTrigger->memrefs, nNumMemRefs))
+        {
+            pReader.SkipEntries(0, nNumConditions);
+            continue;
+        }
+
+        ReadHits(pReader, *pTrigger);
+
+        if (nCurrentList != nList)
+            MoveStateEntry(nId, pTrigger, nCurrentList, nList);
+    }
+
+    for (unsigned int i = 0; i < nNumLeaderboards && !pReader.Overflow(); ++i)
+    {
+        const auto nId = pReader.Read();
+        const auto nFlags = pReader.Read();
+        const auto nValue = pReader.Read();
+        const auto nNumMemRefs = pReader.Read();
+        const auto nNumConditions = pReader.Read();
+
+        ActiveLeaderboard* pLeaderboard = nullptr;
+        if (i < m_vActiveLeaderboards.size() && m_vActiveLeaderboards.at(i).nId == nId)
+        {
+            pLeaderboard = &m_vActiveLeaderboards.at(i);
+        }
+        else
+        {
+            for (auto& pActiveLeaderboard : m_vActiveLeaderboards)
+            {
+                if (pActiveLeaderboard.nId == nId)
+                {
+                    pLeaderboard = &pActiveLeaderboard;
+                    break;
+                }
+            }
+        }
+
+        if (pLeaderboard == nullptr || nNumMemRefs != CountMemRefs(pLeaderboard->pLeaderboard->memrefs) ||
+            nNumConditions != CountConditions(*pLeaderboard->pLeaderboard))
+        {
+            pReader.SkipEntries(nNumMemRefs, nNumConditions);
+            continue;
+        }
+
+        auto* pLboard = pLeaderboard->pLeaderboard;
+        if (!ReadMemRefs(pReader, pLboard->memrefs, nNumMemRefs))
+        {
+            pReader.SkipEntries(0, nNumConditions);
+            continue;
+        }
+
+        ReadHits(pReader, pLboard->start);
+        ReadHits(pReader, pLboard->submit);
+        ReadHits(pReader, pLboard->cancel);
+
+        pLboard->started = (nFlags & StateLeaderboardStarted) ? 1 : 0;
+        pLboard->submitted = (nFlags & StateLeaderboardSubmitted) ? 1 : 0;
+        pLeaderboard->nValue = nValue;
+    }
+
+    SyncHitCounts();
+    return !pReader.Overflow();
+}
+
+void AchievementRuntime::SyncHitCounts() const noexcept
+{
+    for (const auto& pAchievement : m_vActiveAchievements)
+    {
+        if (pAchievement.pCompiledTrigger)
+            pAchievement.pCompiledTrigger->SyncHitCounts();
+    }
+
+    for (const auto& pAchievement : m_vActiveAchievementsMonitorReset)
+    {
+        if (pAchievement.pCompiledTrigger)
+            pAchievement.pCompiledTrigger->SyncHitCounts();
+    }
+
+    for (const auto& pAchievement : m_vQueuedAchievements)
+    {
+        if (pAchievement.pCompiledTrigger)
+            pAchievement.pCompiledTrigger->SyncHitCounts();
+    }
+}
+
+void AchievementRuntime::SyncHitCounts(unsigned int nId) const noexcept
+{
+    const auto SyncEntry = [nId](const auto& vEntries) noexcept
+    {
+        for (const auto& pAchievement : vEntries)
+        {
+            if (pAchievement.nId == nId)
+            {
+                if (pAchievement.pCompiledTrigger)
+                    pAchievement.pCompiledTrigger->SyncHitCounts();
+
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    if (!SyncEntry(m_vActiveAchievements) && !SyncEntry(m_vActiveAchievementsMonitorReset))
+        SyncEntry(m_vQueuedAchievements);
+}
+
 } // namespace services
 } // namespace ra
@@ -4,7 +4,11 @@
 
 #include "RA_AchievementSet.h"
 
+#include "services\CompiledTrigger.hh"
+#include "services\MemorySnapshot.hh"
+#include "services\RuntimeTrace.hh"
 #include "services\TextReader.hh"
+#include "services\WorkerGroup.hh"
 
 #include <string>
 
@@ -36,11 +40,21 @@ public:
     /// <summary>
     /// Removes an achievement from the processing queue.
     /// </summary>
+    /// <remarks>
+    /// Also discards the condition history of the achievement. The trigger can only be replaced while the
+    /// achievement is inactive, so the history never outlives the conditions it points at.
+    /// </remarks>
     void DeactivateAchievement(unsigned int nId) noexcept
     {
         RemoveEntry(m_vQueuedAchievements, nId);
         RemoveEntry(m_vActiveAchievements, nId);
         RemoveEntry(m_vActiveAchievementsMonitorReset, nId);
+
+        for (auto& pTraced : m_vTracedAchievements)
+        {
+            if (pTraced.nId == nId)
+                pTraced.pTrace.reset();
+        }
     }
 
     /// <summary>
@@ -49,6 +63,7 @@ public:
     void ActivateLeaderboard(unsigned int nId, rc_lboard_t* pLeaderboard) noexcept
     {
         GSL_SUPPRESS_F6 AddEntry(m_vActiveLeaderboards, nId, pLeaderboard);
+        ++m_nActivations;
     }
 
     /// <summary>
@@ -82,6 +97,20 @@ public:
     /// </summary>
     virtual void Process(_Inout_ std::vector<Change>& changes);
 
+    /// <summary>
+    /// Processes all active achievements for the current frame.
+    /// </summary>
+    /// <returns>
+    /// The changes for the frame. The buffer is owned by the runtime and reused every frame, so it's only valid
+    /// until the next call.
+    /// </returns>
+    const std::vector<Change>& Process()
+    {
+        m_vChanges.clear();
+        Process(m_vChanges);
+        return m_vChanges;
+    }
+
     /// <summary>
     /// Loads HitCount data for active achievements from a save state file.
     /// </summary>
@@ -95,6 +124,41 @@ public:
     /// <param name="sLoadStateFilename">The name of the save state file.</param>
     void SaveProgress(const char* sSaveStateFilename) const;
 
+    /// <summary>
+    /// Gets the number of bytes required to capture the current runtime state.
+    /// </summary>
+    size_t GetStateSize() const noexcept;
+
+    /// <summary>
+    /// Writes the state of all active achievements and leaderboards into a caller-provided buffer.
+    /// </summary>
+    /// <param name="pBuffer">The buffer to write to.</param>
+    /// <param name="nBufferSize">The size of the buffer.</param>
+    /// <returns>The number of bytes written, <c>0</c> if the buffer is not large enough.</returns>
+    /// <remarks>
+    /// Does not allocate or touch the file system, so it can be called every frame (rewind, run-ahead).
+    /// </remarks>
+    size_t CaptureState(_Out_writes_bytes_(nBufferSize) unsigned char* pBuffer, size_t nBufferSize) const noexcept;
+
+    /// <summary>
+    /// Restores the state of all active achievements and leaderboards from a buffer populated by
+    /// <see cref="CaptureState" />.
+    /// </summary>
+    /// <param name="pBuffer">The buffer to read from.</param>
+    /// <param name="nBufferSize">The size of the buffer.</param>
+    /// <returns><c>true</c> if the state was restored, <c>false</c> if the buffer was not valid.</returns>
+    /// <remarks>
+    /// Any active achievement or leaderboard not found in the buffer, or whose definition does not match the
+    /// captured layout, is reset.
+    /// </remarks>
+    bool RestoreState(_In_reads_bytes_(nBufferSize) const unsigned char* pBuffer, size_t nBufferSize);
+
+    /// <summary>
+    /// Updates the cached hit count state for an achievement after its hit counts were modified outside of the
+    /// runtime (i.e. by the editor).
+    /// </summary>
+    void SyncHitCounts(unsigned int nId) const noexcept;
+
     /// <summary>
     /// Gets whether achievement processing is temporarily suspended.
     /// </summary>
@@ -110,6 +174,55 @@ public:
     /// </summary>
     void ResetActiveAchievements();
 
+    /// <summary>
+    /// The minimum number of active achievements before they are evaluated in parallel. Below this, the cost of
+    /// synchronizing the workers exceeds the cost of evaluating the triggers.
+    /// </summary>
+    static constexpr size_t ParallelEvaluationThreshold = 256;
+
+    /// <summary>
+    /// Enables evaluating the active achievements on multiple threads.
+    /// </summary>
+    /// <param name="nWorkers">The number of threads to use, including the emulator thread. 0 or 1 disables it.</param>
+    /// <remarks>
+    /// The memory used by the achievements is copied once per frame and all triggers are evaluated against the
+    /// copy. Changes are reported in the same order as serial evaluation.
+    /// </remarks>
+    void SetParallelEvaluation(unsigned int nWorkers);
+
+    /// <summary>
+    /// Gets the memory references of all active and queued achievements and leaderboards.
+    /// </summary>
+    /// <param name="vMemRefs">Populated with the memory references. May contain duplicate addresses.</param>
+    void GetMemRefs(_Inout_ std::vector<const rc_memref_value_t*>& vMemRefs) const;
+
+    /// <summary>
+    /// Gets a counter that is incremented whenever an achievement or leaderboard is activated, which may
+    /// introduce new memory references.
+    /// </summary>
+    unsigned int GetActivationCount() const noexcept { return m_nActivations; }
+
+    /// <summary>
+    /// Enables or disables recording the condition history of an achievement.
+    /// </summary>
+    /// <remarks>
+    /// The last <see cref="RuntimeTrace::DefaultFrameCount" /> frames are kept while the achievement is active.
+    /// When it triggers, they're written to the <see cref="StorageItemType::RuntimeTrace" /> for the achievement.
+    /// The history is discarded when the achievement is deactivated.
+    /// </remarks>
+    void SetTraced(unsigned int nId, bool bTraced);
+
+    /// <summary>
+    /// Determines whether the condition history of an achievement is being recorded.
+    /// </summary>
+    bool IsTraced(unsigned int nId) const noexcept;
+
+    /// <summary>
+    /// Gets the condition history of a traced achievement.
+    /// </summary>
+    /// <returns>The history, <c>nullptr</c> if the achievement is not traced or has not been evaluated yet.</returns>
+    const RuntimeTrace* GetTrace(unsigned int nId) const noexcept;
+
 protected:
     struct ActiveAchievement
     {
@@ -117,6 +230,7 @@ protected:
 
         rc_trigger_t* pTrigger;
         unsigned int nId;
+        std::shared_ptr<CompiledTrigger> pCompiledTrigger; // null if the trigger has to be evaluated by rcheevos
     };
 
     struct QueuedAchievement : ActiveAchievement
@@ -126,27 +240,68 @@ protected:
         bool bPauseOnReset = false;
     };
 
+    struct LeaderboardTrigger
+    {
+        explicit LeaderboardTrigger(rc_trigger_t& pTrigger) noexcept
+            : pTrigger(&pTrigger), bStateful(HasHitTargets(pTrigger))
+        {
+        }
+
+        rc_trigger_t* pTrigger;
+
+        // a trigger with hit targets has to be evaluated every frame, like rc_evaluate_lboard does, so its hit
+        // counts advance. any other trigger only depends on the leaderboard's memrefs, so it's only evaluated when
+        // its result is needed, and the result is reused until one of the memrefs changes.
+        bool bStateful;
+        bool bResult = false;
+        bool bResultValid = false;
+    };
+
     struct ActiveLeaderboard
     {
-        ActiveLeaderboard(rc_lboard_t* pLeaderboard, unsigned int nId) noexcept : pLeaderboard(pLeaderboard), nId(nId) {}
+        ActiveLeaderboard(rc_lboard_t* pLeaderboard, unsigned int nId) noexcept
+            : pLeaderboard(pLeaderboard), nId(nId), pStart(pLeaderboard->start), pCancel(pLeaderboard->cancel),
+              pSubmit(pLeaderboard->submit)
+        {
+        }
 
         rc_lboard_t* pLeaderboard;
         unsigned int nId;
         unsigned int nValue = 0;
+
+        LeaderboardTrigger pStart;
+        LeaderboardTrigger pCancel;
+        LeaderboardTrigger pSubmit;
     };
 
+    static bool HasHitTargets(const rc_trigger_t& pTrigger) noexcept;
+
     template<class TCollection, class TData>
-    static void AddEntry(std::vector<TCollection>& vEntries, unsigned int nId, TData* pData)
+    static TCollection& AddEntry(std::vector<TCollection>& vEntries, unsigned int nId, TData* pData)
     {
         Expects(pData != nullptr);
 
-        for (const auto& pAchievement : vEntries)
+        for (auto& pAchievement : vEntries)
         {
             if (pAchievement.nId == nId)
-                return;
+                return pAchievement;
         }
 
-        vEntries.emplace_back(pData, nId);
+        return vEntries.emplace_back(pData, nId);
+    }
+
+    /// <summary>
+    /// Adds an achievement to a processing list, compiling its trigger if a compiled version isn't provided.
+    /// </summary>
+    template<class TCollection>
+    static TCollection& AddAchievementEntry(std::vector<TCollection>& vEntries, unsigned int nId, rc_trigger_t* pTrigger,
+                                            const std::shared_ptr<CompiledTrigger>& pCompiledTrigger)
+    {
+        auto& pAchievement = AddEntry(vEntries, nId, pTrigger);
+        if (pAchievement.pCompiledTrigger == nullptr && pAchievement.pTrigger == pTrigger)
+            pAchievement.pCompiledTrigger = pCompiledTrigger ? pCompiledTrigger : CompiledTrigger::Compile(*pTrigger);
+
+        return pAchievement;
     }
 
     template<class T>
@@ -172,6 +327,42 @@ protected:
     bool m_bPaused = false;
 
 private:
+    static int EvaluateLeaderboard(ActiveLeaderboard& pLeaderboard, _Out_ unsigned int& nValue) noexcept;
+    static void PrepareLeaderboardTrigger(LeaderboardTrigger& pTrigger, bool bMemRefsChanged) noexcept;
+    static bool TestLeaderboardTrigger(LeaderboardTrigger& pTrigger) noexcept;
+    void ProcessActiveAchievementsParallel(_Inout_ std::vector<Change>& changes);
+    void RecordTraces(const std::vector<Change>& changes, size_t nFirstChange);
+    static void TestActiveAchievement(size_t nIndex, void* pRuntime) noexcept;
+
+    std::vector<Change> m_vChanges;
+    unsigned int m_nActivations = 0;
+
+    std::unique_ptr<WorkerGroup> m_pWorkerGroup;
+    MemorySnapshot m_pSnapshot;
+    unsigned int m_nSnapshotActivations = 0;
+    std::vector<unsigned char> m_vParallelResults; // not vector<bool> - each worker writes its own bytes
+
+    struct TracedAchievement
+    {
+        unsigned int nId;
+        std::unique_ptr<RuntimeTrace> pTrace; // created when first seen in an active list, reset when deactivated
+    };
+    std::vector<TracedAchievement> m_vTracedAchievements;
+    unsigned int m_nFrame = 0;
+
+    enum class StateList
+    {
+        Active = 0,
+        ActiveMonitorReset,
+        Queued,
+        QueuedMonitorReset,
+    };
+
+    rc_trigger_t* FindStateEntry(unsigned int nId, StateList nList, size_t nIndexHint, _Out_ StateList& nFoundList) const noexcept;
+    void MoveStateEntry(unsigned int nId, rc_trigger_t* pTrigger, StateList nFromList, StateList nToList);
+
+    void SyncHitCounts() const noexcept;
+
     bool LoadProgressV1(const std::string& sProgress, std::set<unsigned int>& vProcessedAchievementIds) const;
     bool LoadProgressV2(ra::services::TextReader& pFile, std::set<unsigned int>& vProcessedAchievementIds) const;
 };
@@ -0,0 +1,394 @@
+#include "CompiledTrigger.hh"
+
+namespace ra {
+namespace services {
+
+std::shared_ptr<CompiledTrigger> CompiledTrigger::Compile(rc_trigger_t& pTrigger)
+{
+    auto pCompiledTrigger = std::make_shared<CompiledTrigger>();
+    pCompiledTrigger->m_pTrigger = &pTrigger;
+
+    for (auto* pMemRef = pTrigger.memrefs; pMemRef != nullptr; pMemRef = pMemRef->next)
+    {
+        switch (pMemRef->memref.size)
+        {
+            case RC_MEMSIZE_BIT_0:
+            case RC_MEMSIZE_BIT_1:
+            case RC_MEMSIZE_BIT_2:
+            case RC_MEMSIZE_BIT_3:
+            case RC_MEMSIZE_BIT_4:
+            case RC_MEMSIZE_BIT_5:
+            case RC_MEMSIZE_BIT_6:
+            case RC_MEMSIZE_BIT_7:
+            case RC_MEMSIZE_LOW:
+            case RC_MEMSIZE_HIGH:
+            case RC_MEMSIZE_8_BITS:
+            case RC_MEMSIZE_16_BITS:
+            case RC_MEMSIZE_32_BITS:
+                pCompiledTrigger->m_vMemRefs.push_back(pMemRef);
+                break;
+
+            default:
+                return nullptr;
+        }
+    }
+
+    if (pTrigger.requirement != nullptr)
+    {
+        if (!pCompiledTrigger->CompileGroup(*pTrigger.requirement))
+            return nullptr;
+    }
+    else
+    {
+        // a missing core group is always true, just like an empty one
+        const auto nEnd = gsl::narrow_cast<unsigned int>(pCompiledTrigger->m_vInstructions.size());
+        pCompiledTrigger->m_vGroups.push_back({nEnd, nEnd, nEnd});
+    }
+
+    for (const auto* pAlternate = pTrigger.alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+    {
+        if (!pCompiledTrigger->CompileGroup(*pAlternate))
+            return nullptr;
+
+        pCompiledTrigger->m_bHasAlts = true;
+    }
+
+    pCompiledTrigger->SyncHitCounts();
+    return pCompiledTrigger;
+}
+
+static bool IsChainedCondition(char nType) noexcept
+{
+    return (nType == RC_CONDITION_ADD_SOURCE || nType == RC_CONDITION_SUB_SOURCE);
+}
+
+bool CompiledTrigger::CompileGroup(const rc_condset_t& pCondSet)
+{
+    std::vector<rc_condition_t*> vConditions;
+    for (auto* pCondition = pCondSet.conditions; pCondition != nullptr; pCondition = pCondition->next)
+    {
+        switch (pCondition->type)
+        {
+            case RC_CONDITION_STANDARD:
+            case RC_CONDITION_RESET_IF:
+            case RC_CONDITION_PAUSE_IF:
+            case RC_CONDITION_ADD_SOURCE:
+            case RC_CONDITION_SUB_SOURCE:
+                break;
+
+            default:
+                // AddHits and AndNext are left to rcheevos
+                return false;
+        }
+
+        switch (pCondition->oper)
+        {
+            case RC_CONDITION_EQ:
+            case RC_CONDITION_NE:
+            case RC_CONDITION_LT:
+            case RC_CONDITION_LE:
+            case RC_CONDITION_GT:
+            case RC_CONDITION_GE:
+                break;
+
+            default:
+                return false;
+        }
+
+        vConditions.push_back(pCondition);
+    }
+
+    // a PauseIf and the AddSource/SubSource conditions leading into it are evaluated in a separate pass before
+    // the rest of the group. walk backwards to identify the chains, then emit the pause pass first.
+    std::vector<bool> vPause(vConditions.size());
+    bool bInPause = false;
+    for (auto nIndex = vConditions.size(); nIndex > 0; --nIndex)
+    {
+        const auto nType = vConditions.at(nIndex - 1)->type;
+        if (nType == RC_CONDITION_PAUSE_IF)
+            bInPause = true;
+        else if (!IsChainedCondition(nType))
+            bInPause = false;
+
+        vPause.at(nIndex - 1) = bInPause;
+    }
+
+    Group pGroup{};
+    pGroup.nFirstPause = gsl::narrow_cast<unsigned int>(m_vInstructions.size());
+
+    for (int nPass = 0; nPass < 2; ++nPass)
+    {
+        if (nPass == 1)
+            pGroup.nFirstMain = gsl::narrow_cast<unsigned int>(m_vInstructions.size());
+
+        const bool bPausePass = (nPass == 0);
+        for (size_t nIndex = 0; nIndex < vConditions.size(); ++nIndex)
+        {
+            if (vPause.at(nIndex) != bPausePass)
+                continue;
+
+            auto& pCondition = *vConditions.at(nIndex);
+
+            Instruction pInstruction{};
+            switch (pCondition.type)
+            {
+                case RC_CONDITION_ADD_SOURCE: pInstruction.nOperation = Operation::AddSource; break;
+                case RC_CONDITION_SUB_SOURCE: pInstruction.nOperation = Operation::SubSource; break;
+                case RC_CONDITION_RESET_IF:   pInstruction.nOperation = Operation::ResetIf; break;
+                case RC_CONDITION_PAUSE_IF:   pInstruction.nOperation = Operation::PauseIf; break;
+                default:                      pInstruction.nOperation = Operation::Standard; break;
+            }
+
+            pInstruction.nOperator = pCondition.oper;
+            pInstruction.nRequiredHits = pCondition.required_hits;
+
+            if (!CompileOperand(pCondition.operand1, pInstruction.pOperand1) ||
+                !CompileOperand(pCondition.operand2, pInstruction.pOperand2))
+            {
+                return false;
+            }
+
+            pInstruction.nHitSlot = gsl::narrow_cast<unsigned int>(m_vHitSlots.size());
+            m_vHitSlots.push_back(&pCondition.current_hits);
+
+            m_vInstructions.push_back(pInstruction);
+        }
+    }
+
+    pGroup.nEnd = gsl::narrow_cast<unsigned int>(m_vInstructions.size());
+    m_vGroups.push_back(pGroup);
+    return true;
+}
+
+bool CompiledTrigger::CompileOperand(const rc_operand_t& pSource, Operand& pOperand)
+{
+    switch (pSource.type)
+    {
+        case RC_OPERAND_CONST:
+            pOperand.nType = OperandType::Constant;
+            pOperand.nValue = pSource.value.num;
+            return true;
+
+        case RC_OPERAND_ADDRESS:
+            pOperand.nType = OperandType::Value;
+            break;
+
+        case RC_OPERAND_DELTA:
+            pOperand.nType = OperandType::Delta;
+            break;
+
+        case RC_OPERAND_PRIOR:
+            pOperand.nType = OperandType::Prior;
+            break;
+
+        default:
+            // floating point and Lua operands are left to rcheevos
+            return false;
+    }
+
+    for (size_t nIndex = 0; nIndex < m_vMemRefs.size(); ++nIndex)
+    {
+        if (m_vMemRefs.at(nIndex) == pSource.value.memref)
+        {
+            pOperand.nValue = gsl::narrow_cast<unsigned int>(nIndex);
+            return true;
+        }
+    }
+
+    // memref not owned by the trigger
+    return false;
+}
+
+static unsigned int ReadMemRef(const rc_memref_t& pMemRef, rc_peek_t fPeek, void* pUserData) noexcept
+{
+    switch (pMemRef.size)
+    {
+        case RC_MEMSIZE_BIT_0:   return (fPeek(pMemRef.address, 1, pUserData) >> 0) & 1;
+        case RC_MEMSIZE_BIT_1:   return (fPeek(pMemRef.address, 1, pUserData) >> 1) & 1;
+        case RC_MEMSIZE_BIT_2:   return (fPeek(pMemRef.address, 1, pUserData) >> 2) & 1;
+        case RC_MEMSIZE_BIT_3:   return (fPeek(pMemRef.address, 1, pUserData) >> 3) & 1;
+        case RC_MEMSIZE_BIT_4:   return (fPeek(pMemRef.address, 1, pUserData) >> 4) & 1;
+        case RC_MEMSIZE_BIT_5:   return (fPeek(pMemRef.address, 1, pUserData) >> 5) & 1;
+        case RC_MEMSIZE_BIT_6:   return (fPeek(pMemRef.address, 1, pUserData) >> 6) & 1;
+        case RC_MEMSIZE_BIT_7:   return (fPeek(pMemRef.address, 1, pUserData) >> 7) & 1;
+        case RC_MEMSIZE_LOW:     return fPeek(pMemRef.address, 1, pUserData) & 0x0F;
+        case RC_MEMSIZE_HIGH:    return (fPeek(pMemRef.address, 1, pUserData) >> 4) & 0x0F;
+        case RC_MEMSIZE_8_BITS:  return fPeek(pMemRef.address, 1, pUserData);
+        case RC_MEMSIZE_16_BITS: return fPeek(pMemRef.address, 2, pUserData);
+        case RC_MEMSIZE_32_BITS: return fPeek(pMemRef.address, 4, pUserData);
+        default:                 return 0;
+    }
+}
+
+void CompiledTrigger::UpdateMemRef(rc_memref_value_t& pMemRef, rc_peek_t fPeek, void* pUserData) noexcept
+{
+    pMemRef.previous = pMemRef.value;
+    pMemRef.value = ReadMemRef(pMemRef.memref, fPeek, pUserData);
+    if (pMemRef.value != pMemRef.previous)
+        pMemRef.prior = pMemRef.previous;
+}
+
+void CompiledTrigger::UpdateMemRefs(rc_peek_t fPeek, void* pUserData) noexcept
+{
+    for (auto* pMemRef : m_vMemRefs)
+        UpdateMemRef(*pMemRef, fPeek, pUserData);
+}
+
+GSL_SUPPRESS(bounds.4)
+unsigned int CompiledTrigger::GetOperandValue(const Operand& pOperand) const noexcept
+{
+    switch (pOperand.nType)
+    {
+        case OperandType::Value: return m_vMemRefs[pOperand.nValue]->value;
+        case OperandType::Delta: return m_vMemRefs[pOperand.nValue]->previous;
+        case OperandType::Prior: return m_vMemRefs[pOperand.nValue]->prior;
+        default:                 return pOperand.nValue;
+    }
+}
+
+static constexpr bool Compare(unsigned int nLeft, char nOperator, unsigned int nRight) noexcept
+{
+    switch (nOperator)
+    {
+        case RC_CONDITION_EQ: return nLeft == nRight;
+        case RC_CONDITION_NE: return nLeft != nRight;
+        case RC_CONDITION_LT: return nLeft < nRight;
+        case RC_CONDITION_LE: return nLeft <= nRight;
+        case RC_CONDITION_GT: return nLeft > nRight;
+        case RC_CONDITION_GE: return nLeft >= nRight;
+        default:              return true;
+    }
+}
+
+GSL_SUPPRESS(bounds.4)
+bool CompiledTrigger::RunBlock(unsigned int nFirst, unsigned int nEnd, bool& bReset) noexcept
+{
+    bool bSetValid = true;
+    unsigned int nAddBuffer = 0;
+
+    for (auto nIndex = nFirst; nIndex < nEnd; ++nIndex)
+    {
+        const auto& pInstruction = m_vInstructions[nIndex];
+        switch (pInstruction.nOperation)
+        {
+            case Operation::AddSource:
+                nAddBuffer += GetOperandValue(pInstruction.pOperand1);
+                continue;
+
+            case Operation::SubSource:
+                nAddBuffer -= GetOperandValue(pInstruction.pOperand1);
+                continue;
+
+            default:
+                break;
+        }
+
+        bool bCondValid = Compare(GetOperandValue(pInstruction.pOperand1) + nAddBuffer, pInstruction.nOperator,
+                                  GetOperandValue(pInstruction.pOperand2));
+        nAddBuffer = 0;
+
+        auto& nCurrentHits = *m_vHitSlots[pInstruction.nHitSlot];
+        if (pInstruction.nRequiredHits == 0)
+        {
+            // no hit target, just accumulate hits
+            if (bCondValid && nCurrentHits++ == 0)
+                ++m_nConditionsWithHits;
+        }
+        else if (nCurrentHits < pInstruction.nRequiredHits)
+        {
+            if (bCondValid && nCurrentHits++ == 0)
+                ++m_nConditionsWithHits;
+
+            bCondValid = (nCurrentHits >= pInstruction.nRequiredHits);
+        }
+        else
+        {
+            // hit target already met
+            bCondValid = true;
+        }
+
+        switch (pInstruction.nOperation)
+        {
+            case Operation::PauseIf:
+                // as soon as a PauseIf is true, the rest of the group is not processed
+                if (bCondValid)
+                    return true;
+
+                bSetValid = false;
+                break;
+
+            case Operation::ResetIf:
+                if (bCondValid)
+                {
+                    bReset = true;
+                    bSetValid = false;
+                }
+                break;
+
+            default:
+                bSetValid &= bCondValid;
+                break;
+        }
+    }
+
+    return bSetValid;
+}
+
+bool CompiledTrigger::TestGroup(const Group& pGroup, bool& bReset) noexcept
+{
+    // an empty group is always true
+    if (pGroup.nFirstPause == pGroup.nEnd)
+        return true;
+
+    if (pGroup.nFirstPause != pGroup.nFirstMain && RunBlock(pGroup.nFirstPause, pGroup.nFirstMain, bReset))
+        return false;
+
+    return RunBlock(pGroup.nFirstMain, pGroup.nEnd, bReset);
+}
+
+bool CompiledTrigger::Test(rc_peek_t fPeek, void* pUserData)
+{
+    UpdateMemRefs(fPeek, pUserData);
+
+    bool bReset = false;
+    bool bResult = TestGroup(m_vGroups.front(), bReset);
+
+    if (m_bHasAlts)
+    {
+        // every alt group is evaluated so their hit counts stay in sync with rcheevos
+        bool bAltResult = false;
+        for (size_t nIndex = 1; nIndex < m_vGroups.size(); ++nIndex)
+            bAltResult |= TestGroup(m_vGroups.at(nIndex), bReset);
+
+        bResult &= bAltResult;
+    }
+
+    if (bReset)
+    {
+        Reset();
+
+        // a ResetIf in any group prevents the trigger from firing, even if another alt group is true
+        bResult = false;
+    }
+
+    return bResult;
+}
+
+void CompiledTrigger::Reset() noexcept
+{
+    rc_reset_trigger(m_pTrigger);
+    m_nConditionsWithHits = 0;
+}
+
+void CompiledTrigger::SyncHitCounts() noexcept
+{
+    m_nConditionsWithHits = 0;
+    for (const auto* pHits : m_vHitSlots)
+    {
+        if (*pHits)
+            ++m_nConditionsWithHits;
+    }
+}
+
+} // namespace services
+} // namespace ra
@@ -0,0 +1,130 @@
+#ifndef RA_SERVICES_COMPILED_TRIGGER_HH
+#define RA_SERVICES_COMPILED_TRIGGER_HH
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <rcheevos\include\rcheevos.h>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// A parsed trigger lowered into flat instruction arrays so it can be evaluated without walking the rcheevos
+/// condition lists.
+/// </summary>
+/// <remarks>
+/// Hit counts and memory reference values are still stored in the rcheevos structures, so anything inspecting
+/// the trigger (editor, progress files, state capture) sees the same data regardless of which path evaluated it.
+/// </remarks>
+class CompiledTrigger
+{
+public:
+    CompiledTrigger() noexcept = default;
+    ~CompiledTrigger() noexcept = default;
+    CompiledTrigger(const CompiledTrigger&) noexcept = delete;
+    CompiledTrigger& operator=(const CompiledTrigger&) noexcept = delete;
+    CompiledTrigger(CompiledTrigger&&) noexcept = delete;
+    CompiledTrigger& operator=(CompiledTrigger&&) noexcept = delete;
+
+    /// <summary>
+    /// Compiles a parsed trigger.
+    /// </summary>
+    /// <returns>
+    /// The compiled trigger, or <c>nullptr</c> if the trigger uses constructs the interpreter does not support,
+    /// in which case it should be evaluated with <c>rc_test_trigger</c>.
+    /// </returns>
+    static std::shared_ptr<CompiledTrigger> Compile(rc_trigger_t& pTrigger);
+
+    /// <summary>
+    /// Evaluates the trigger for the current frame. Behaves exactly like <c>rc_test_trigger</c>.
+    /// </summary>
+    /// <returns><c>true</c> if the trigger is true.</returns>
+    bool Test(rc_peek_t fPeek, void* pUserData);
+
+    /// <summary>
+    /// Determines whether any condition in the trigger has a non-zero hit count.
+    /// </summary>
+    /// <remarks>
+    /// Tracked incrementally by <see cref="Test" /> and <see cref="Reset" />. If the hit counts are modified by
+    /// anything else, <see cref="SyncHitCounts" /> must be called.
+    /// </remarks>
+    bool HasHitCounts() const noexcept { return m_nConditionsWithHits != 0; }
+
+    /// <summary>
+    /// Resets the hit counts for all conditions in the trigger.
+    /// </summary>
+    void Reset() noexcept;
+
+    /// <summary>
+    /// Recalculates the <see cref="HasHitCounts" /> state after the hit counts were modified externally.
+    /// </summary>
+    void SyncHitCounts() noexcept;
+
+    /// <summary>
+    /// Reads the current value for a memory reference, shifting the old value into the delta (and prior, if changed).
+    /// </summary>
+    static void UpdateMemRef(rc_memref_value_t& pMemRef, rc_peek_t fPeek, void* pUserData) noexcept;
+
+private:
+    enum class OperandType : unsigned char
+    {
+        Value = 0,
+        Delta,
+        Prior,
+        Constant,
+    };
+
+    enum class Operation : unsigned char
+    {
+        AddSource = 0,
+        SubSource,
+        Standard,
+        ResetIf,
+        PauseIf,
+    };
+
+    struct Operand
+    {
+        OperandType nType;
+        unsigned int nValue; // index into m_vMemRefs, or the constant
+    };
+
+    struct Instruction
+    {
+        Operation nOperation;
+        char nOperator;
+        Operand pOperand1;
+        Operand pOperand2;
+        unsigned int nRequiredHits;
+        unsigned int nHitSlot; // index into m_vHitSlots
+    };
+
+    struct Group
+    {
+        unsigned int nFirstPause; // pause instructions are stored first so they can be evaluated as a block
+        unsigned int nFirstMain;
+        unsigned int nEnd;
+    };
+
+    bool CompileGroup(const rc_condset_t& pCondSet);
+    bool CompileOperand(const rc_operand_t& pSource, Operand& pOperand);
+    unsigned int GetOperandValue(const Operand& pOperand) const noexcept;
+    bool RunBlock(unsigned int nFirst, unsigned int nEnd, bool& bReset) noexcept;
+    bool TestGroup(const Group& pGroup, bool& bReset) noexcept;
+    void UpdateMemRefs(rc_peek_t fPeek, void* pUserData) noexcept;
+
+    rc_trigger_t* m_pTrigger = nullptr;
+    std::vector<rc_memref_value_t*> m_vMemRefs;
+    std::vector<decltype(rc_condition_t::current_hits)*> m_vHitSlots;
+    std::vector<Instruction> m_vInstructions;
+    std::vector<Group> m_vGroups; // [0] is the core group, followed by the alt groups
+    unsigned int m_nConditionsWithHits = 0;
+    bool m_bHasAlts = false;
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_COMPILED_TRIGGER_HH
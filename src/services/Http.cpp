@@ -15,10 +15,11 @@ Http::Response Http::Request::Call() const
     std::string sResponse;
     ra::services::impl::StringTextWriter pWriter(sResponse);
 
+    Validators pValidators;
     const auto& pHttpRequester = ra::services::ServiceLocator::Get<ra::services::IHttpRequester>();
-    const auto nStatusCode = ra::itoe<Http::StatusCode>(pHttpRequester.Request(*this, pWriter));
+    const auto nStatusCode = ra::itoe<Http::StatusCode>(pHttpRequester.Request(*this, pWriter, pValidators));
 
-    return Response(nStatusCode, std::move(sResponse));
+    return Response(nStatusCode, std::move(sResponse), pValidators);
 }
 
 void Http::Request::CallAsync(Callback&& fCallback) const
@@ -32,20 +33,30 @@ void Http::Request::CallAsync(Callback&& fCallback) const
 
 Http::Response Http::Request::Download(const std::wstring& sFilename) const
 {
+    // download to a temporary file so an error (or a NotModified response) doesn't destroy the existing file
+    const auto sTempFilename = sFilename + L".tmp";
     auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
-    auto pFile = pFileSystem.CreateTextFile(sFilename);
+    auto pFile = pFileSystem.CreateTextFile(sTempFilename);
     Ensures(pFile != nullptr);
 
+    Validators pValidators;
     const auto& pHttpRequester = ra::services::ServiceLocator::Get<ra::services::IHttpRequester>();
-    const auto nStatusCode = ra::itoe<Http::StatusCode>(pHttpRequester.Request(*this, *pFile));
+    const auto nStatusCode = ra::itoe<Http::StatusCode>(pHttpRequester.Request(*this, *pFile, pValidators));
 
-    return Response(nStatusCode, "");
+    // flush and close the file before moving it
+    const bool bWritten = pFile->Commit();
+    pFile.reset();
+
+    if (nStatusCode != StatusCode::OK || !bWritten || !pFileSystem.ReplaceFile(sTempFilename, sFilename))
+        pFileSystem.DeleteFile(sTempFilename);
+
+    return Response(nStatusCode, "", pValidators);
 }
 
 void Http::Request::DownloadAsync(const std::wstring& sFilename, Callback&& fCallback) const
 {
     auto& pThreadPool = ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>();
-    pThreadPool.RunAsync([request = *this, sFilename, f = std::move(fCallback)]() {
+    pThreadPool.RunAsync(TaskPriority::Low, [request = *this, sFilename, f = std::move(fCallback)]() {
         auto response = request.Download(sFilename);
         f(response);
     });
@@ -13,9 +13,21 @@ public:
     enum class StatusCode
     {
         OK = 200,
+        NotModified = 304,
         NotFound = 404,
     };
 
+    /// <summary>
+    /// Identifies a version of a resource so it only has to be transferred again if it changes.
+    /// </summary>
+    struct Validators
+    {
+        std::string ETag;         // the ETag header, sent back as If-None-Match
+        std::string LastModified; // the Last-Modified header, sent back as If-Modified-Since
+
+        bool IsEmpty() const noexcept { return ETag.empty() && LastModified.empty(); }
+    };
+
     class Response
     {
     public:
@@ -24,6 +36,11 @@ public:
         {
         }
 
+        explicit Response(Http::StatusCode nStatusCode, const std::string& sResponse, const Validators& pValidators)
+            : m_nStatusCode(nStatusCode), m_sResponse(sResponse), m_pValidators(pValidators)
+        {
+        }
+
         ~Response() noexcept = default;
         Response(const Response&) noexcept = default;
         Response& operator=(const Response&) noexcept = delete;
@@ -40,9 +57,15 @@ public:
         /// </summary>
         const std::string& Content() const noexcept { return m_sResponse; }
 
+        /// <summary>
+        /// Gets the validators returned from the server for the content.
+        /// </summary>
+        const Validators& GetValidators() const noexcept { return m_pValidators; }
+
     private:
         Http::StatusCode m_nStatusCode{ 0 };
         std::string m_sResponse;
+        Validators m_pValidators;
     };
 
     class Request
@@ -114,6 +137,20 @@ public:
         /// </summary>
         const std::string& GetContentType() const noexcept { return m_sContentType; }
 
+        /// <summary>
+        /// Sets the validators of a previously downloaded copy of the resource.
+        /// </summary>
+        /// <remarks>
+        /// If the resource hasn't changed, the server will respond with <see cref="StatusCode::NotModified" />
+        /// and no content.
+        /// </remarks>
+        void SetValidators(const Validators& pValidators) { m_pValidators = pValidators; }
+
+        /// <summary>
+        /// Gets the validators of a previously downloaded copy of the resource.
+        /// </summary>
+        const Validators& GetValidators() const noexcept { return m_pValidators; }
+
         using Callback = std::function<void(const Response& response)>;
 
         /// <summary>
@@ -130,7 +167,10 @@ public:
         /// Calls this server and waits for the response.
         /// </summary>
         /// <param name="sFilename">The path to the file where the response should be written.</param>
-        /// <remarks>Response.Content() will be empty.</remarks>
+        /// <remarks>
+        /// Response.Content() will be empty. The file is only replaced if the server returns
+        /// <see cref="StatusCode::OK" />.
+        /// </remarks>
         Response Download(const std::wstring& sFilename) const;
 
         /// <summary>
@@ -145,6 +185,7 @@ public:
         std::string m_sQueryString;
         std::string m_sPostData;
         std::string m_sContentType{ "application/x-www-form-urlencoded" };
+        Validators m_pValidators;
     };
     
     /// <summary>
@@ -18,6 +18,7 @@ enum class Feature
     LeaderboardScoreboards,
     PreferDecimal,
     NonHardcoreWarning,
+    ParallelEvaluation,
 };
 
 class IConfiguration
@@ -55,6 +55,12 @@ public:
     /// <returns>Time the file was last modified, <c>0</c> if file doesn't exist.</returns>
     virtual std::chrono::system_clock::time_point GetLastModified(const std::wstring& sPath) const = 0;
 
+    /// <summary>
+    /// Sets the time the file was last modified without changing its contents.
+    /// </summary>
+    /// <returns><c>true</c> if successful, <c>false</c> if not.</returns>
+    virtual bool SetLastModified(const std::wstring& sPath, std::chrono::system_clock::time_point tLastModified) const = 0;
+
     /// <summary>
     /// Deletes the specified file.
     /// </summary>
@@ -68,6 +74,13 @@ public:
     /// <returns><c>true</c> if successful, <c>false</c> if not.</returns>
     virtual bool MoveFile(const std::wstring& sOldPath, const std::wstring& sNewPath) const = 0;
 
+    /// <summary>
+    /// Moves a file over another file, replacing it in a single step.
+    /// </summary>
+    /// <remarks>If the move fails, the file at <paramref name="sTargetPath" /> is left untouched.</remarks>
+    /// <returns><c>true</c> if successful, <c>false</c> if not.</returns>
+    virtual bool ReplaceFile(const std::wstring& sSourcePath, const std::wstring& sTargetPath) const = 0;
+
     /// <summary>
     /// Opens the specified file.
     /// </summary>
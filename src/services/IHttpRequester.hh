@@ -27,8 +27,10 @@ public:
     /// </summary>
     /// <param name="pRequest">The request to send.</param>
     /// <param name="pContentWriter">A writer to write the content to as its received.</param>
+    /// <param name="pValidators">Receives the validators returned from the server for the content.</param>
     /// <returns>The status code from the server, or an error code if the request failed before reaching the server.</returns>
-    virtual unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter) const = 0;
+    virtual unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter,
+                                 Http::Validators& pValidators) const = 0;
 
     /// <summary>
     /// Determines whether or not it would be reasonable to retry the request for the provided error code.
@@ -2,6 +2,7 @@
 #define RA_SERVICES_ILOCALSTORAGE_HH
 #pragma once
 
+#include "Http.hh"
 #include "TextReader.hh"
 #include "TextWriter.hh"
 
@@ -18,6 +19,9 @@ enum class StorageItemType
     Badge,
     UserPic,
     SessionStats,
+    RuntimeTrace,
+    GameDataCache,
+    SubmissionJournal,
 };
 
 class ILocalStorage
@@ -49,6 +53,19 @@ public:
     /// </returns>
     virtual std::unique_ptr<TextWriter> WriteText(StorageItemType nType, const std::wstring& sKey) = 0;
 
+    /// <summary>
+    ///   Begins replacing stored data for the specified <paramref name="nType" /> and <paramref name="sKey" />.
+    /// </summary>
+    /// <returns>
+    ///   <see cref="TextWriter" /> for writing the data, <c>nullptr</c> if the data cannot be written.
+    /// </returns>
+    /// <remarks>
+    ///   The existing data is only replaced when <see cref="TextWriter::Commit" /> is called, and only if everything
+    ///   was written successfully. Until then, readers see the existing data. If the writer is destroyed without
+    ///   being committed, the existing data is left as it was.
+    /// </remarks>
+    virtual std::unique_ptr<TextWriter> ReplaceText(StorageItemType nType, const std::wstring& sKey) = 0;
+
     /// <summary>
     ///   Begins appending stored data for the specified <paramref name="nType" /> and <paramref name="sKey" />.
     /// </summary>
@@ -57,6 +74,25 @@ public:
     /// </returns>
     virtual std::unique_ptr<TextWriter> AppendText(StorageItemType nType, const std::wstring& sKey) = 0;
 
+    /// <summary>
+    ///   Gets the HTTP validators recorded for the stored data for the specified <paramref name="nType" /> and
+    ///   <paramref name="sKey" />.
+    /// </summary>
+    /// <returns>
+    ///   The validators, empty if none were recorded or the stored data no longer exists.
+    /// </returns>
+    virtual Http::Validators GetValidators(StorageItemType nType, const std::wstring& sKey) = 0;
+
+    /// <summary>
+    ///   Records the HTTP validators for the stored data for the specified <paramref name="nType" /> and
+    ///   <paramref name="sKey" />. Empty validators discard the existing record.
+    /// </summary>
+    /// <remarks>
+    ///   Must be called after the stored data has been written, and again with empty validators whenever the
+    ///   stored data is written without them.
+    /// </remarks>
+    virtual void SetValidators(StorageItemType nType, const std::wstring& sKey, const Http::Validators& pValidators) = 0;
+
 protected:
     ILocalStorage() noexcept = default;
 };
@@ -5,6 +5,18 @@
 namespace ra {
 namespace services {
 
+/// <summary>
+/// Determines the order in which queued work is started. Lower values are started first.
+/// </summary>
+enum class TaskPriority
+{
+    Critical = 0,   // authentication
+    High,           // unlocks and leaderboard submissions
+    Normal,         // game data and other requests the user is waiting on
+    Low,            // image downloads
+    Idle,           // pings and other periodic work
+};
+
 class IThreadPool
 {
 public:
@@ -19,11 +31,21 @@ public:
     /// </summary>
     virtual void RunAsync(std::function<void()>&& f) = 0;
 
+    /// <summary>
+    /// Queues work for a background thread. Work with a higher priority is started before work with a lower priority.
+    /// </summary>
+    virtual void RunAsync(TaskPriority nPriority, std::function<void()>&& f) = 0;
+
     /// <summary>
     /// Queues work for a background thread to be run after a period of time
     /// </summary>
     virtual void ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f) = 0;
 
+    /// <summary>
+    /// Queues work for a background thread to be run after a period of time
+    /// </summary>
+    virtual void ScheduleAsync(std::chrono::milliseconds nDelay, TaskPriority nPriority, std::function<void()>&& f) = 0;
+
     /// <summary>
     /// Sets the <see ref="IsShutdownRequested" /> flag so threads can start winding down.
     /// </summary>
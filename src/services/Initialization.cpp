@@ -6,10 +6,12 @@
 #include "data\EmulatorContext.hh"
 #include "data\GameContext.hh"
 #include "data\SessionTracker.hh"
+#include "data\SubmissionJournal.hh"
 #include "data\UserContext.hh"
 
 #include "services\AchievementRuntime.hh"
 #include "services\GameIdentifier.hh"
+#include "services\RequestCoalescer.hh"
 #include "services\ServiceLocator.hh"
 #include "services\impl\Clock.hh"
 #include "services\impl\FileLocalStorage.hh"
@@ -111,7 +113,12 @@ void Initialization::RegisterServices(EmulatorID nEmulatorId)
     pThreadPool->Initialize(pConfiguration->GetNumBackgroundThreads());
     ra::services::ServiceLocator::Provide<ra::services::IThreadPool>(std::move(pThreadPool));
 
+    auto pRequestCoalescer = std::make_unique<ra::services::RequestCoalescer>();
+    ra::services::ServiceLocator::Provide<ra::services::RequestCoalescer>(std::move(pRequestCoalescer));
+
     auto pHttpRequester = std::make_unique<ra::services::impl::WindowsHttpRequester>();
+    // requests are made from the background threads, so each can have its own connection
+    pHttpRequester->SetMaxConnectionsPerServer(pConfiguration->GetNumBackgroundThreads());
     ra::services::ServiceLocator::Provide<ra::services::IHttpRequester>(std::move(pHttpRequester));
 
     auto pUserContext = std::make_unique<ra::data::UserContext>();
@@ -123,7 +130,12 @@ void Initialization::RegisterServices(EmulatorID nEmulatorId)
     auto pSessionTracker = std::make_unique<ra::data::SessionTracker>();
     ra::services::ServiceLocator::Provide<ra::data::SessionTracker>(std::move(pSessionTracker));
 
+    auto pSubmissionJournal = std::make_unique<ra::data::SubmissionJournal>();
+    ra::services::ServiceLocator::Provide<ra::data::SubmissionJournal>(std::move(pSubmissionJournal));
+
     auto pAchievementRuntime = std::make_unique<ra::services::AchievementRuntime>();
+    if (pConfiguration->IsFeatureEnabled(ra::services::Feature::ParallelEvaluation))
+        pAchievementRuntime->SetParallelEvaluation(std::min(std::thread::hardware_concurrency(), 4U));
     ra::services::ServiceLocator::Provide<ra::services::AchievementRuntime>(std::move(pAchievementRuntime));
 
     auto pGameIdentifier = std::make_unique<ra::services::GameIdentifier>();
@@ -0,0 +1,128 @@
+#include "MemorySnapshot.hh"
+
+#include "RA_MemManager.h"
+
+#include <algorithm>
+
+namespace ra {
+namespace services {
+
+unsigned int MemorySnapshot::GetMemRefBytes(char nSize) noexcept
+{
+    switch (nSize)
+    {
+        case RC_MEMSIZE_16_BITS:
+            return 2;
+
+        case RC_MEMSIZE_32_BITS:
+            return 4;
+
+        default: // bits, nibbles and bytes
+            return 1;
+    }
+}
+
+std::vector<MemorySnapshot::Region> MemorySnapshot::GetRegions(const std::vector<const rc_memref_value_t*>& vMemRefs,
+                                                               unsigned int nMemorySize)
+{
+    std::vector<std::pair<unsigned int, unsigned int>> vRanges; // [start, end)
+    vRanges.reserve(vMemRefs.size());
+    for (const auto* pMemRef : vMemRefs)
+    {
+        const auto nAddress = pMemRef->memref.address;
+        if (nAddress >= nMemorySize)
+            continue;
+
+        const auto nEnd = std::min(nAddress + GetMemRefBytes(pMemRef->memref.size), nMemorySize);
+        vRanges.emplace_back(nAddress, nEnd);
+    }
+
+    std::sort(vRanges.begin(), vRanges.end());
+
+    std::vector<Region> vRegions;
+    for (const auto& pRange : vRanges)
+    {
+        if (!vRegions.empty())
+        {
+            auto& pRegion = vRegions.back();
+            const auto nRegionEnd = pRegion.nAddress + pRegion.nLength;
+            if (pRange.first <= nRegionEnd)
+            {
+                if (pRange.second > nRegionEnd)
+                    pRegion.nLength = pRange.second - pRegion.nAddress;
+
+                continue;
+            }
+        }
+
+        vRegions.push_back({pRange.first, pRange.second - pRange.first});
+    }
+
+    return vRegions;
+}
+
+void MemorySnapshot::SetMemRefs(const std::vector<const rc_memref_value_t*>& vMemRefs, unsigned int nMemorySize)
+{
+    m_vRegions.clear();
+
+    unsigned int nOffset = 0;
+    for (const auto& pRegion : GetRegions(vMemRefs, nMemorySize))
+    {
+        m_vRegions.push_back({pRegion.nAddress, pRegion.nLength, nOffset});
+        nOffset += pRegion.nLength;
+    }
+
+    m_vMemory.assign(nOffset, 0);
+    m_nMemorySize = nMemorySize;
+}
+
+void MemorySnapshot::Capture()
+{
+    for (const auto& pRegion : m_vRegions)
+        g_MemManager.ActiveBankRAMRead(&m_vMemory.at(pRegion.nOffset), pRegion.nAddress, pRegion.nLength);
+}
+
+unsigned char MemorySnapshot::GetByte(unsigned int nAddress) const noexcept
+{
+    // find the last region starting at or before the address
+    auto pIter = std::upper_bound(m_vRegions.begin(), m_vRegions.end(), nAddress,
+                                  [](unsigned int nValue, const CapturedRegion& pRegion) noexcept {
+                                      return nValue < pRegion.nAddress;
+                                  });
+    if (pIter == m_vRegions.begin())
+        return 0;
+
+    --pIter;
+    const auto nIndex = nAddress - pIter->nAddress;
+    if (nIndex >= pIter->nLength)
+        return 0;
+
+    GSL_SUPPRESS(bounds.4) return m_vMemory[pIter->nOffset + nIndex];
+}
+
+unsigned int MemorySnapshot::Peek(unsigned int nAddress, unsigned int nBytes, void* pSnapshot) noexcept
+{
+    const auto* pThis = static_cast<const MemorySnapshot*>(pSnapshot);
+    if (nAddress >= pThis->m_nMemorySize)
+        return 0;
+
+    // regions are clamped to the memory size, so any part of the value past the end of the memory is read as 0
+    switch (nBytes)
+    {
+        case 1:
+            return pThis->GetByte(nAddress);
+
+        case 2:
+            return pThis->GetByte(nAddress) | (pThis->GetByte(nAddress + 1) << 8);
+
+        case 4:
+            return pThis->GetByte(nAddress) | (pThis->GetByte(nAddress + 1) << 8) |
+                   (pThis->GetByte(nAddress + 2) << 16) | (ra::to_unsigned(pThis->GetByte(nAddress + 3)) << 24);
+
+        default:
+            return 0;
+    }
+}
+
+} // namespace services
+} // namespace ra
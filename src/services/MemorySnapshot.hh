@@ -0,0 +1,83 @@
+#ifndef RA_SERVICES_MEMORY_SNAPSHOT_HH
+#define RA_SERVICES_MEMORY_SNAPSHOT_HH
+#pragma once
+
+#include <vector>
+
+#include <rcheevos\include\rcheevos.h>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// A copy of the emulated memory referenced by a set of triggers, captured once per frame so the triggers can be
+/// evaluated without calling back into the emulator.
+/// </summary>
+class MemorySnapshot
+{
+public:
+    struct Region
+    {
+        unsigned int nAddress;
+        unsigned int nLength;
+    };
+
+    /// <summary>
+    /// Gets the number of bytes that have to be read for a memory reference of the specified size.
+    /// </summary>
+    static unsigned int GetMemRefBytes(char nSize) noexcept;
+
+    /// <summary>
+    /// Converts a list of memory references into sorted, non-overlapping regions.
+    /// </summary>
+    /// <param name="vMemRefs">The memory references.</param>
+    /// <param name="nMemorySize">The size of the memory. Addresses outside the memory are ignored.</param>
+    static std::vector<Region> GetRegions(const std::vector<const rc_memref_value_t*>& vMemRefs,
+                                          unsigned int nMemorySize);
+
+    /// <summary>
+    /// Sets the memory to capture.
+    /// </summary>
+    /// <param name="vMemRefs">The memory references of the triggers that will read from the snapshot.</param>
+    /// <param name="nMemorySize">The size of the memory.</param>
+    void SetMemRefs(const std::vector<const rc_memref_value_t*>& vMemRefs, unsigned int nMemorySize);
+
+    /// <summary>
+    /// Gets the size of the memory the snapshot was configured for.
+    /// </summary>
+    unsigned int GetMemorySize() const noexcept { return m_nMemorySize; }
+
+    /// <summary>
+    /// Copies the referenced memory from the emulator into the snapshot.
+    /// </summary>
+    void Capture();
+
+    /// <summary>
+    /// An <c>rc_peek_t</c> that reads from a <see cref="MemorySnapshot" /> passed as the user data.
+    /// </summary>
+    /// <remarks>
+    /// Safe to call from multiple threads as long as <see cref="Capture" /> is not running. Bytes past the end of
+    /// the memory are read as 0, the same as <c>rc_peek_callback</c>. Only addresses of the memory references passed
+    /// to <see cref="SetMemRefs" /> are captured, anything else is also read as 0.
+    /// </remarks>
+    static unsigned int Peek(unsigned int nAddress, unsigned int nBytes, void* pSnapshot) noexcept;
+
+private:
+    struct CapturedRegion
+    {
+        unsigned int nAddress;
+        unsigned int nLength;
+        unsigned int nOffset; // into m_vMemory
+    };
+
+    unsigned char GetByte(unsigned int nAddress) const noexcept;
+
+    std::vector<CapturedRegion> m_vRegions;   // sorted by address
+    std::vector<unsigned char> m_vMemory;      // only the bytes in the regions, one after the other
+    unsigned int m_nMemorySize = 0;
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_MEMORY_SNAPSHOT_HH
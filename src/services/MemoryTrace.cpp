@@ -0,0 +1,203 @@
+#include "MemoryTrace.hh"
+
+#include "RA_MemManager.h"
+
+#include "services\MemorySnapshot.hh"
+
+namespace ra {
+namespace services {
+
+bool MemoryTraceReader::Read(unsigned int& nValue)
+{
+    std::array<char, 4> pBytes{};
+    if (m_pReader.GetBytes(pBytes.data(), pBytes.size()) != pBytes.size())
+        return false;
+
+    nValue = ra::to_unsigned(pBytes.at(0) & 0xFF) | (ra::to_unsigned(pBytes.at(1) & 0xFF) << 8) |
+             (ra::to_unsigned(pBytes.at(2) & 0xFF) << 16) | (ra::to_unsigned(pBytes.at(3) & 0xFF) << 24);
+    return true;
+}
+
+bool MemoryTraceReader::ReadHeader()
+{
+    unsigned int nMagic = 0, nVersion = 0;
+    if (!Read(nMagic) || !Read(nVersion) || !Read(m_nMemorySize) ||
+        nMagic != MemoryTrace::Magic || nVersion != MemoryTrace::Version)
+    {
+        m_bError = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool MemoryTraceReader::ReadRuns(gsl::span<unsigned char> pMemory)
+{
+    unsigned int nRuns = 0;
+    if (!Read(nRuns))
+        return false;
+
+    while (nRuns > 0)
+    {
+        unsigned int nAddress = 0, nLength = 0;
+        if (!Read(nAddress) || !Read(nLength))
+            return false;
+
+        if (nAddress > m_nMemorySize || nLength > m_nMemorySize - nAddress)
+            return false;
+
+        if (m_pReader.GetBytes(reinterpret_cast<char*>(pMemory.data()) + nAddress, nLength) != nLength)
+            return false;
+
+        --nRuns;
+    }
+
+    return true;
+}
+
+_Use_decl_annotations_
+bool MemoryTraceReader::ReadFrame(gsl::span<unsigned char> pMemory)
+{
+    if (m_bError)
+        return false;
+
+    Expects(ra::to_unsigned(pMemory.size()) >= m_nMemorySize);
+
+    char nType{};
+    if (m_pReader.GetBytes(&nType, 1) != 1)
+        return false; // end of trace
+
+    switch (nType)
+    {
+        case MemoryTrace::KeyFrame:
+            memset(pMemory.data(), 0, m_nMemorySize);
+            if (ReadRuns(pMemory))
+                return true;
+            break;
+
+        case MemoryTrace::DeltaFrame:
+            if (ReadRuns(pMemory))
+                return true;
+            break;
+
+        default:
+            break;
+    }
+
+    m_bError = true;
+    return false;
+}
+
+MemoryTraceWriter::MemoryTraceWriter(ra::services::TextWriter& pWriter, unsigned int nMemorySize,
+                                     unsigned int nKeyFrameInterval)
+    : m_pWriter(pWriter), m_nMemorySize(nMemorySize), m_nKeyFrameInterval(nKeyFrameInterval)
+{
+    Append(MemoryTrace::Magic);
+    Append(MemoryTrace::Version);
+    Append(m_nMemorySize);
+    m_pWriter.Write(m_sFrame);
+}
+
+void MemoryTraceWriter::SetMemRefs(const std::vector<const rc_memref_value_t*>& vMemRefs)
+{
+    m_vRegions.clear();
+
+    unsigned int nOffset = 0;
+    for (const auto& pRegion : MemorySnapshot::GetRegions(vMemRefs, m_nMemorySize))
+    {
+        m_vRegions.push_back({pRegion.nAddress, pRegion.nLength, nOffset});
+        nOffset += pRegion.nLength;
+    }
+
+    m_vCurrent.assign(nOffset, 0);
+    m_vPrevious.assign(nOffset, 0);
+    m_nFramesUntilKeyFrame = 0;
+}
+
+void MemoryTraceWriter::Append(unsigned int nValue)
+{
+    m_sFrame.push_back(static_cast<char>(nValue & 0xFF));
+    m_sFrame.push_back(static_cast<char>((nValue >> 8) & 0xFF));
+    m_sFrame.push_back(static_cast<char>((nValue >> 16) & 0xFF));
+    m_sFrame.push_back(static_cast<char>((nValue >> 24) & 0xFF));
+}
+
+GSL_SUPPRESS_TYPE1
+void MemoryTraceWriter::AppendRun(unsigned int nAddress, const unsigned char* pBytes, unsigned int nLength)
+{
+    Append(nAddress);
+    Append(nLength);
+    m_sFrame.append(reinterpret_cast<const char*>(pBytes), nLength);
+}
+
+GSL_SUPPRESS(bounds.1)
+void MemoryTraceWriter::WriteFrame()
+{
+    for (const auto& pRegion : m_vRegions)
+        g_MemManager.ActiveBankRAMRead(&m_vCurrent.at(pRegion.nOffset), pRegion.nAddress, pRegion.nLength);
+
+    m_sFrame.clear();
+    unsigned int nRuns = 0;
+
+    if (m_nFramesUntilKeyFrame == 0)
+    {
+        m_sFrame.push_back(MemoryTrace::KeyFrame);
+        Append(gsl::narrow_cast<unsigned int>(m_vRegions.size()));
+
+        for (const auto& pRegion : m_vRegions)
+            AppendRun(pRegion.nAddress, &m_vCurrent.at(pRegion.nOffset), pRegion.nLength);
+
+        m_nFramesUntilKeyFrame = m_nKeyFrameInterval;
+    }
+    else
+    {
+        m_sFrame.push_back(MemoryTrace::DeltaFrame);
+        Append(0); // run count, filled in below
+
+        // a run header is eight bytes, so unchanged gaps shorter than that are cheaper to resend
+        constexpr unsigned int nMaxGap = 8;
+
+        for (const auto& pRegion : m_vRegions)
+        {
+            const auto* pCurrent = &m_vCurrent.at(pRegion.nOffset);
+            const auto* pPrevious = &m_vPrevious.at(pRegion.nOffset);
+            if (memcmp(pCurrent, pPrevious, pRegion.nLength) == 0)
+                continue;
+
+            unsigned int nIndex = 0;
+            while (nIndex < pRegion.nLength)
+            {
+                if (pCurrent[nIndex] == pPrevious[nIndex])
+                {
+                    ++nIndex;
+                    continue;
+                }
+
+                const auto nStart = nIndex;
+                auto nEnd = ++nIndex;
+                while (nIndex < pRegion.nLength && nIndex - nEnd < nMaxGap)
+                {
+                    if (pCurrent[nIndex] != pPrevious[nIndex])
+                        nEnd = nIndex + 1;
+                    ++nIndex;
+                }
+
+                AppendRun(pRegion.nAddress + nStart, pCurrent + nStart, nEnd - nStart);
+                ++nRuns;
+                nIndex = nEnd;
+            }
+        }
+
+        for (int i = 0; i < 4; ++i)
+            m_sFrame.at(1 + i) = static_cast<char>((nRuns >> (i * 8)) & 0xFF);
+
+        --m_nFramesUntilKeyFrame;
+    }
+
+    m_pWriter.Write(m_sFrame);
+    m_vCurrent.swap(m_vPrevious);
+    ++m_nFrames;
+}
+
+} // namespace services
+} // namespace ra
@@ -0,0 +1,131 @@
+#ifndef RA_SERVICES_MEMORY_TRACE_HH
+#define RA_SERVICES_MEMORY_TRACE_HH
+#pragma once
+
+#include "services\TextReader.hh"
+#include "services\TextWriter.hh"
+
+#include <rcheevos\include\rcheevos.h>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// A recording of the emulated memory, one record per frame.
+/// </summary>
+/// <remarks>
+/// All values are little-endian.
+///   header:   uint32 magic ("RAMT"), uint32 version, uint32 memory size
+///   keyframe: uint8 'K', uint32 run count, and for each run: uint32 address, uint32 length, and the bytes
+///   delta:    uint8 'D', uint32 run count, and for each run: uint32 address, uint32 length, and the new bytes
+/// The first frame is always a keyframe. Any memory not covered by a keyframe's runs is zero, so replay can
+/// start from any keyframe. Delta frames only contain the bytes that changed since the previous frame.
+/// </remarks>
+namespace MemoryTrace {
+
+static constexpr unsigned int Magic = 0x544D4152; // "RAMT"
+static constexpr unsigned int Version = 1;
+
+static constexpr char KeyFrame = 'K';
+static constexpr char DeltaFrame = 'D';
+
+} // namespace MemoryTrace
+
+class MemoryTraceReader
+{
+public:
+    explicit MemoryTraceReader(ra::services::TextReader& pReader) noexcept : m_pReader(pReader) {}
+
+    /// <summary>
+    /// Reads and validates the trace header.
+    /// </summary>
+    /// <returns><c>true</c> if the header is valid.</returns>
+    bool ReadHeader();
+
+    /// <summary>
+    /// Gets the size of the memory captured by the trace.
+    /// </summary>
+    unsigned int GetMemorySize() const noexcept { return m_nMemorySize; }
+
+    /// <summary>
+    /// Applies the next frame of the trace to <paramref name="pMemory" />.
+    /// </summary>
+    /// <param name="pMemory">The memory to update. Must be at least <see cref="GetMemorySize" /> bytes.</param>
+    /// <returns><c>true</c> if a frame was read, <c>false</c> at the end of the trace or if it is corrupt.</returns>
+    bool ReadFrame(_Inout_ gsl::span<unsigned char> pMemory);
+
+    /// <summary>
+    /// Gets whether the trace was found to be corrupt.
+    /// </summary>
+    bool HasError() const noexcept { return m_bError; }
+
+private:
+    bool Read(unsigned int& nValue);
+    bool ReadRuns(gsl::span<unsigned char> pMemory);
+
+    ra::services::TextReader& m_pReader;
+    unsigned int m_nMemorySize = 0;
+    bool m_bError = false;
+};
+
+/// <summary>
+/// Records the emulated memory into a <see cref="MemoryTrace" />.
+/// </summary>
+/// <remarks>
+/// Only the addresses referenced by the loaded achievements and leaderboards are captured. Everything else is
+/// recorded as zero, which doesn't affect a replay of the same set.
+/// </remarks>
+class MemoryTraceWriter
+{
+public:
+    static constexpr unsigned int DefaultKeyFrameInterval = 600;
+
+    /// <summary>
+    /// Initializes a new <see cref="MemoryTraceWriter" /> and writes the trace header.
+    /// </summary>
+    GSL_SUPPRESS_F6 MemoryTraceWriter(ra::services::TextWriter& pWriter, unsigned int nMemorySize,
+                                      unsigned int nKeyFrameInterval = DefaultKeyFrameInterval);
+
+    /// <summary>
+    /// Sets the memory to capture. The next frame will be a keyframe.
+    /// </summary>
+    /// <param name="vMemRefs">The memory references of the loaded achievements and leaderboards.</param>
+    void SetMemRefs(const std::vector<const rc_memref_value_t*>& vMemRefs);
+
+    /// <summary>
+    /// Captures the current state of the memory and appends it to the trace.
+    /// </summary>
+    void WriteFrame();
+
+    /// <summary>
+    /// Gets the number of frames written to the trace.
+    /// </summary>
+    unsigned int GetFrameCount() const noexcept { return m_nFrames; }
+
+private:
+    struct Region
+    {
+        unsigned int nAddress;
+        unsigned int nLength;
+        unsigned int nOffset; // position of the region in the capture buffers
+    };
+
+    void Append(unsigned int nValue);
+    void AppendRun(unsigned int nAddress, const unsigned char* pBytes, unsigned int nLength);
+
+    ra::services::TextWriter& m_pWriter;
+    unsigned int m_nMemorySize;
+    unsigned int m_nKeyFrameInterval;
+    unsigned int m_nFramesUntilKeyFrame = 0;
+    unsigned int m_nFrames = 0;
+
+    std::vector<Region> m_vRegions;
+    std::vector<unsigned char> m_vCurrent;
+    std::vector<unsigned char> m_vPrevious;
+    std::string m_sFrame; // reused to build each frame so it can be written in a single call
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_MEMORY_TRACE_HH
@@ -0,0 +1,54 @@
+#include "ParseArena.hh"
+
+namespace ra {
+namespace services {
+
+void* ParseArena::Allocate(size_t nBytes)
+{
+    constexpr size_t nAlignment = alignof(std::max_align_t);
+    nBytes = (nBytes + nAlignment - 1) & ~(nAlignment - 1);
+
+    // use the remainder of the current chunk, or the next retained chunk that's big enough
+    while (m_nCurrentChunk < m_vChunks.size())
+    {
+        auto& pChunk = m_vChunks.at(m_nCurrentChunk);
+        if (pChunk.nSize - m_nOffset >= nBytes)
+        {
+            GSL_SUPPRESS(bounds.1) auto* pBuffer = pChunk.pMemory.get() + m_nOffset;
+            memset(pBuffer, 0, nBytes);
+            m_nOffset += nBytes;
+            m_nBytesUsed += nBytes;
+            return pBuffer;
+        }
+
+        ++m_nCurrentChunk;
+        m_nOffset = 0;
+    }
+
+    // oversized buffers get a chunk of their own
+    const auto nChunkSize = std::max(m_nChunkSize, nBytes);
+    auto& pChunk = m_vChunks.emplace_back(Chunk{std::make_unique<unsigned char[]>(nChunkSize), nChunkSize});
+    m_nCurrentChunk = m_vChunks.size() - 1;
+    m_nOffset = nBytes;
+    m_nBytesUsed += nBytes;
+    return pChunk.pMemory.get();
+}
+
+void ParseArena::Reset() noexcept
+{
+    m_nCurrentChunk = 0;
+    m_nOffset = 0;
+    m_nBytesUsed = 0;
+}
+
+size_t ParseArena::GetBytesReserved() const noexcept
+{
+    size_t nBytes = 0;
+    for (const auto& pChunk : m_vChunks)
+        nBytes += pChunk.nSize;
+
+    return nBytes;
+}
+
+} // namespace services
+} // namespace ra
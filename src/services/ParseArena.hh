@@ -0,0 +1,70 @@
+#ifndef RA_SERVICES_PARSE_ARENA_HH
+#define RA_SERVICES_PARSE_ARENA_HH
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// A bump allocator for buffers that share a lifetime, like the parsed rcheevos structures for a game.
+/// </summary>
+/// <remarks>
+/// Buffers are placed one after another in the order they're allocated, and are never freed individually.
+/// <see cref="Reset" /> releases everything at once and keeps the memory for the next set of allocations.
+/// Not thread-safe.
+/// </remarks>
+class ParseArena
+{
+public:
+    static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+    explicit ParseArena(size_t nChunkSize = DefaultChunkSize) noexcept : m_nChunkSize(nChunkSize) {}
+    ~ParseArena() noexcept = default;
+    ParseArena(const ParseArena&) noexcept = delete;
+    ParseArena& operator=(const ParseArena&) noexcept = delete;
+    ParseArena(ParseArena&&) noexcept = default;
+    ParseArena& operator=(ParseArena&&) noexcept = default;
+
+    /// <summary>
+    /// Allocates a zero-filled buffer suitably aligned for any rcheevos structure.
+    /// </summary>
+    /// <param name="nBytes">The size of the buffer.</param>
+    /// <returns>The buffer, which remains valid until <see cref="Reset" /> is called.</returns>
+    void* Allocate(size_t nBytes);
+
+    /// <summary>
+    /// Invalidates all buffers returned by <see cref="Allocate" />.
+    /// </summary>
+    void Reset() noexcept;
+
+    /// <summary>
+    /// Gets the number of bytes allocated since the last <see cref="Reset" />, including alignment padding.
+    /// </summary>
+    size_t GetBytesUsed() const noexcept { return m_nBytesUsed; }
+
+    /// <summary>
+    /// Gets the number of bytes held by the arena.
+    /// </summary>
+    size_t GetBytesReserved() const noexcept;
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<unsigned char[]> pMemory;
+        size_t nSize;
+    };
+
+    size_t m_nChunkSize;
+    std::vector<Chunk> m_vChunks;
+    size_t m_nCurrentChunk = 0;
+    size_t m_nOffset = 0; // next free byte in the current chunk
+    size_t m_nBytesUsed = 0;
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_PARSE_ARENA_HH
@@ -0,0 +1,80 @@
+#include "RequestCoalescer.hh"
+
+#include "services\IClock.hh"
+#include "services\ServiceLocator.hh"
+
+namespace ra {
+namespace services {
+
+RequestCoalescer::JoinResult RequestCoalescer::Join(const std::string& sKey, Callback&& fCallback,
+                                                    std::shared_ptr<const void>& pCachedResponse)
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+
+    const auto pCache = m_mCache.find(sKey);
+    if (pCache != m_mCache.end())
+    {
+        if (pCache->second.tExpires > ServiceLocator::Get<IClock>().UpTime())
+        {
+            pCachedResponse = pCache->second.pResponse;
+            return JoinResult::Cached;
+        }
+
+        m_mCache.erase(pCache);
+    }
+
+    auto pInFlight = m_mInFlight.find(sKey);
+    if (pInFlight != m_mInFlight.end())
+    {
+        pInFlight->second.push_back(std::move(fCallback));
+        return JoinResult::Pending;
+    }
+
+    m_mInFlight[sKey].push_back(std::move(fCallback));
+    return JoinResult::Send;
+}
+
+void RequestCoalescer::Complete(const std::string& sKey, std::shared_ptr<const void> pResponse,
+                                std::chrono::milliseconds tCacheDuration)
+{
+    std::vector<Callback> vCallbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_mMutex);
+
+        const auto pInFlight = m_mInFlight.find(sKey);
+        if (pInFlight != m_mInFlight.end())
+        {
+            vCallbacks.swap(pInFlight->second);
+            m_mInFlight.erase(pInFlight);
+        }
+
+        if (tCacheDuration.count() > 0)
+        {
+            const auto tNow = ServiceLocator::Get<IClock>().UpTime();
+
+            // discard anything that has expired so the cache doesn't grow indefinitely
+            for (auto pIter = m_mCache.begin(); pIter != m_mCache.end();)
+            {
+                if (pIter->second.tExpires <= tNow)
+                    pIter = m_mCache.erase(pIter);
+                else
+                    ++pIter;
+            }
+
+            m_mCache.insert_or_assign(sKey, CachedResponse{ pResponse, tNow + tCacheDuration });
+        }
+    }
+
+    // callbacks are called outside the lock so they can make new requests
+    for (const auto& fCallback : vCallbacks)
+        fCallback(pResponse);
+}
+
+void RequestCoalescer::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    m_mCache.clear();
+}
+
+} // namespace services
+} // namespace ra
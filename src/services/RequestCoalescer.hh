@@ -0,0 +1,82 @@
+#ifndef RA_SERVICES_REQUEST_COALESCER_HH
+#define RA_SERVICES_REQUEST_COALESCER_HH
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// Tracks requests that are in flight so identical requests made before the first one completes can share its
+/// response instead of sending another request.
+/// </summary>
+/// <remarks>
+/// Requests are identified by a key built from the endpoint and its parameters. Responses are type-erased so
+/// requests for different endpoints can share one instance. A completed response may also be kept for a short
+/// time so requests made shortly after it completes can use it.
+/// </remarks>
+class RequestCoalescer
+{
+public:
+    GSL_SUPPRESS_F6 RequestCoalescer() = default;
+    ~RequestCoalescer() noexcept = default;
+    RequestCoalescer(const RequestCoalescer&) noexcept = delete;
+    RequestCoalescer& operator=(const RequestCoalescer&) noexcept = delete;
+    RequestCoalescer(RequestCoalescer&&) noexcept = delete;
+    RequestCoalescer& operator=(RequestCoalescer&&) noexcept = delete;
+
+    using Callback = std::function<void(const std::shared_ptr<const void>& pResponse)>;
+
+    enum class JoinResult
+    {
+        Send,       // no matching request is in flight. the caller should send the request and call Complete
+        Pending,    // a matching request is in flight. the callback will be called when it completes
+        Cached,     // a recent response is available. the callback was not captured
+    };
+
+    /// <summary>
+    /// Registers interest in the response to the request identified by <paramref name="sKey" />.
+    /// </summary>
+    /// <param name="sKey">Identifies the endpoint and parameters of the request.</param>
+    /// <param name="fCallback">
+    /// Called with the response when the request completes. Not moved from if <see cref="JoinResult::Cached" /> is
+    /// returned.
+    /// </param>
+    /// <param name="pCachedResponse">Receives the cached response if <see cref="JoinResult::Cached" /> is returned.</param>
+    JoinResult Join(const std::string& sKey, Callback&& fCallback, std::shared_ptr<const void>& pCachedResponse);
+
+    /// <summary>
+    /// Provides the response for the request identified by <paramref name="sKey" /> to everything that joined it.
+    /// </summary>
+    /// <param name="tCacheDuration">How long the response may be provided to new requests. 0 to not cache it.</param>
+    void Complete(const std::string& sKey, std::shared_ptr<const void> pResponse,
+                  std::chrono::milliseconds tCacheDuration);
+
+    /// <summary>
+    /// Discards all cached responses.
+    /// </summary>
+    void ClearCache();
+
+private:
+    std::mutex m_mMutex;
+    std::unordered_map<std::string, std::vector<Callback>> m_mInFlight;
+
+    struct CachedResponse
+    {
+        std::shared_ptr<const void> pResponse;
+        std::chrono::steady_clock::time_point tExpires;
+    };
+    std::unordered_map<std::string, CachedResponse> m_mCache;
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_REQUEST_COALESCER_HH
@@ -0,0 +1,168 @@
+#include "RuntimeTrace.hh"
+
+#include "RA_StringUtils.h"
+
+namespace ra {
+namespace services {
+
+static void AddConditions(const rc_condset_t* pCondSet, std::vector<const rc_condition_t*>& vConditions)
+{
+    for (const auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+        vConditions.push_back(pCondition);
+}
+
+RuntimeTrace::RuntimeTrace(unsigned int nId, rc_trigger_t& pTrigger, unsigned int nFrameCount)
+    : m_nId(nId), m_nCapacity(nFrameCount)
+{
+    Expects(nFrameCount > 0);
+
+    if (pTrigger.requirement != nullptr)
+        AddConditions(pTrigger.requirement, m_vConditions);
+    for (const auto* pAlternate = pTrigger.alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+        AddConditions(pAlternate, m_vConditions);
+
+    m_nTruthBytes = (GetConditionCount() + 7) / 8;
+
+    m_vPreviousHits.resize(m_vConditions.size());
+    for (size_t nIndex = 0; nIndex < m_vConditions.size(); ++nIndex)
+        m_vPreviousHits.at(nIndex) = m_vConditions.at(nIndex)->current_hits;
+
+    m_vFrames.resize(m_nCapacity);
+    m_vTruth.resize(static_cast<size_t>(m_nCapacity) * m_nTruthBytes);
+    m_vHitDeltas.resize(static_cast<size_t>(m_nCapacity) * m_vConditions.size());
+}
+
+static unsigned int GetOperandValue(const rc_operand_t& pOperand) noexcept
+{
+    switch (pOperand.type)
+    {
+        case RC_OPERAND_CONST:   return pOperand.value.num;
+        case RC_OPERAND_ADDRESS: return pOperand.value.memref->value;
+        case RC_OPERAND_DELTA:   return pOperand.value.memref->previous;
+        case RC_OPERAND_PRIOR:   return pOperand.value.memref->prior;
+        default:                 return 0; // floating point and Lua operands aren't traced
+    }
+}
+
+static constexpr bool Compare(unsigned int nLeft, char nOperator, unsigned int nRight) noexcept
+{
+    switch (nOperator)
+    {
+        case RC_CONDITION_EQ: return nLeft == nRight;
+        case RC_CONDITION_NE: return nLeft != nRight;
+        case RC_CONDITION_LT: return nLeft < nRight;
+        case RC_CONDITION_LE: return nLeft <= nRight;
+        case RC_CONDITION_GT: return nLeft > nRight;
+        case RC_CONDITION_GE: return nLeft >= nRight;
+        default:              return true;
+    }
+}
+
+GSL_SUPPRESS(bounds.4)
+void RuntimeTrace::Record(unsigned int nFrame) noexcept
+{
+    // the memrefs have already been updated for the frame, so the comparisons see what the trigger saw
+    const size_t nSlot = m_nNext;
+    m_vFrames[nSlot] = nFrame;
+
+    auto* pTruth = &m_vTruth[nSlot * m_nTruthBytes];
+    memset(pTruth, 0, m_nTruthBytes);
+
+    auto* pHitDeltas = &m_vHitDeltas[nSlot * m_vConditions.size()];
+
+    unsigned int nAddBuffer = 0;
+    for (size_t nIndex = 0; nIndex < m_vConditions.size(); ++nIndex)
+    {
+        const auto& pCondition = *m_vConditions[nIndex];
+
+        const auto nValue = GetOperandValue(pCondition.operand1);
+        bool bTrue;
+        switch (pCondition.type)
+        {
+            case RC_CONDITION_ADD_SOURCE:
+                nAddBuffer += nValue;
+                bTrue = false;
+                break;
+
+            case RC_CONDITION_SUB_SOURCE:
+                nAddBuffer -= nValue;
+                bTrue = false;
+                break;
+
+            default:
+                bTrue = Compare(nValue + nAddBuffer, pCondition.oper, GetOperandValue(pCondition.operand2));
+                nAddBuffer = 0;
+                break;
+        }
+
+        if (bTrue)
+            pTruth[nIndex / 8] |= gsl::narrow_cast<unsigned char>(1 << (nIndex % 8));
+
+        const auto nDelta = static_cast<long long>(pCondition.current_hits) - m_vPreviousHits[nIndex];
+        pHitDeltas[nIndex] = gsl::narrow_cast<short>(std::clamp<long long>(nDelta, SHRT_MIN, SHRT_MAX));
+        m_vPreviousHits[nIndex] = pCondition.current_hits;
+    }
+
+    if (++m_nNext == m_nCapacity)
+        m_nNext = 0;
+    if (m_nCount < m_nCapacity)
+        ++m_nCount;
+}
+
+void RuntimeTrace::Clear() noexcept
+{
+    m_nNext = 0;
+    m_nCount = 0;
+}
+
+size_t RuntimeTrace::GetSlot(unsigned int nAge) const
+{
+    Expects(nAge < m_nCount);
+    return (static_cast<size_t>(m_nNext) + m_nCapacity - 1 - nAge) % m_nCapacity;
+}
+
+unsigned int RuntimeTrace::GetFrame(unsigned int nAge) const
+{
+    return m_vFrames.at(GetSlot(nAge));
+}
+
+bool RuntimeTrace::IsTrue(unsigned int nAge, unsigned int nCondition) const
+{
+    Expects(nCondition < GetConditionCount());
+    const auto nByte = m_vTruth.at(GetSlot(nAge) * m_nTruthBytes + nCondition / 8);
+    return (nByte & (1 << (nCondition % 8))) != 0;
+}
+
+int RuntimeTrace::GetHitDelta(unsigned int nAge, unsigned int nCondition) const
+{
+    Expects(nCondition < GetConditionCount());
+    return m_vHitDeltas.at(GetSlot(nAge) * m_vConditions.size() + nCondition);
+}
+
+void RuntimeTrace::Write(ra::services::TextWriter& pWriter) const
+{
+    pWriter.WriteLine(ra::StringPrintf("%u:%u:%u", m_nId, GetConditionCount(), m_nCount));
+
+    std::string sLine;
+    for (auto nAge = m_nCount; nAge > 0; --nAge)
+    {
+        sLine = std::to_string(GetFrame(nAge - 1));
+        sLine.push_back(':');
+
+        for (unsigned int nCondition = 0; nCondition < GetConditionCount(); ++nCondition)
+            sLine.push_back(IsTrue(nAge - 1, nCondition) ? '1' : '0');
+        sLine.push_back(':');
+
+        for (unsigned int nCondition = 0; nCondition < GetConditionCount(); ++nCondition)
+        {
+            if (nCondition > 0)
+                sLine.push_back(',');
+            sLine.append(std::to_string(GetHitDelta(nAge - 1, nCondition)));
+        }
+
+        pWriter.WriteLine(sLine);
+    }
+}
+
+} // namespace services
+} // namespace ra
@@ -0,0 +1,116 @@
+#ifndef RA_SERVICES_RUNTIME_TRACE_HH
+#define RA_SERVICES_RUNTIME_TRACE_HH
+#pragma once
+
+#include "services\TextWriter.hh"
+
+#include <vector>
+
+#include <rcheevos\include\rcheevos.h>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// Remembers which conditions of an achievement were true, and how their hit counts changed, over the most
+/// recent frames.
+/// </summary>
+/// <remarks>
+/// Conditions are numbered in the order they appear in the core group followed by each alt group. Truth values
+/// are the result of the comparison itself (including any AddSource/SubSource chain), ignoring hit targets.
+/// </remarks>
+class RuntimeTrace
+{
+public:
+    static constexpr unsigned int DefaultFrameCount = 600;
+
+    /// <summary>
+    /// Initializes a new <see cref="RuntimeTrace" /> for an achievement.
+    /// </summary>
+    /// <param name="nId">The unique identifier of the achievement.</param>
+    /// <param name="pTrigger">
+    /// The trigger to record. The trace keeps pointers to its conditions, so it must be discarded before the
+    /// trigger is released.
+    /// </param>
+    /// <param name="nFrameCount">The number of frames to keep.</param>
+    GSL_SUPPRESS_F6 RuntimeTrace(unsigned int nId, rc_trigger_t& pTrigger, unsigned int nFrameCount = DefaultFrameCount);
+
+    /// <summary>
+    /// Gets the unique identifier of the traced achievement.
+    /// </summary>
+    unsigned int GetId() const noexcept { return m_nId; }
+
+    /// <summary>
+    /// Records the state of the trigger after it has been evaluated for a frame, replacing the oldest frame if
+    /// the buffer is full.
+    /// </summary>
+    /// <param name="nFrame">The frame number to associate to the record.</param>
+    void Record(unsigned int nFrame) noexcept;
+
+    /// <summary>
+    /// Discards all recorded frames.
+    /// </summary>
+    void Clear() noexcept;
+
+    /// <summary>
+    /// Gets the number of conditions in the trigger.
+    /// </summary>
+    unsigned int GetConditionCount() const noexcept { return gsl::narrow_cast<unsigned int>(m_vConditions.size()); }
+
+    /// <summary>
+    /// Gets the number of frames currently held in the buffer.
+    /// </summary>
+    unsigned int GetFrameCount() const noexcept { return m_nCount; }
+
+    /// <summary>
+    /// Gets the frame number of a recorded frame.
+    /// </summary>
+    /// <param name="nAge">How many frames before the most recent one. <c>0</c> is the most recent.</param>
+    unsigned int GetFrame(unsigned int nAge) const;
+
+    /// <summary>
+    /// Gets whether a condition was true on a recorded frame.
+    /// </summary>
+    /// <param name="nAge">How many frames before the most recent one. <c>0</c> is the most recent.</param>
+    /// <param name="nCondition">The index of the condition.</param>
+    bool IsTrue(unsigned int nAge, unsigned int nCondition) const;
+
+    /// <summary>
+    /// Gets how much the hit count of a condition changed on a recorded frame.
+    /// </summary>
+    /// <param name="nAge">How many frames before the most recent one. <c>0</c> is the most recent.</param>
+    /// <param name="nCondition">The index of the condition.</param>
+    /// <remarks>Negative if the hit count was reset. Clamped to the range of a <c>short</c>.</remarks>
+    int GetHitDelta(unsigned int nAge, unsigned int nCondition) const;
+
+    /// <summary>
+    /// Writes the recorded frames, oldest first.
+    /// </summary>
+    /// <remarks>
+    /// The first line is "id:conditions:frames". Each frame is "frame:truth:deltas", where truth has a '1' or
+    /// '0' for each condition and deltas is a comma-separated list of hit count changes.
+    /// </remarks>
+    void Write(ra::services::TextWriter& pWriter) const;
+
+private:
+    size_t GetSlot(unsigned int nAge) const;
+
+    unsigned int m_nId;
+    std::vector<const rc_condition_t*> m_vConditions;
+    std::vector<unsigned int> m_vPreviousHits;
+
+    unsigned int m_nCapacity;
+    unsigned int m_nTruthBytes;
+    unsigned int m_nNext = 0;
+    unsigned int m_nCount = 0;
+
+    // preallocated so recording a frame never allocates
+    std::vector<unsigned int> m_vFrames;
+    std::vector<unsigned char> m_vTruth; // m_nTruthBytes per frame, one bit per condition
+    std::vector<short> m_vHitDeltas;     // one per condition per frame
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_RUNTIME_TRACE_HH
@@ -63,6 +63,13 @@ public:
     /// <param name="nNewPosition">The n new position.</param>
     virtual void SetPosition(std::streampos nNewPosition) = 0;
 
+    /// <summary>
+    /// Completes the output. Writers that defer updating the output until everything has been written apply the
+    /// changes here.
+    /// </summary>
+    /// <returns><c>true</c> if everything was written, <c>false</c> if not.</returns>
+    virtual bool Commit() { return true; }
+
 protected:
     TextWriter() noexcept = default;
 };
@@ -0,0 +1,90 @@
+#include "WorkerGroup.hh"
+
+namespace ra {
+namespace services {
+
+WorkerGroup::WorkerGroup(unsigned int nWorkers)
+    : m_nWorkers(nWorkers > 0 ? nWorkers : 1)
+{
+    // worker 0 is the thread calling ForEach
+    for (unsigned int nWorker = 1; nWorker < m_nWorkers; ++nWorker)
+        m_vThreads.emplace_back(&WorkerGroup::RunWorker, this, nWorker);
+}
+
+WorkerGroup::~WorkerGroup() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock(m_oMutex);
+        m_bShutdown = true;
+    }
+
+    m_cvStart.notify_all();
+
+    for (auto& pThread : m_vThreads)
+        pThread.join();
+}
+
+void WorkerGroup::ForEach(size_t nCount, Handler fHandler, void* pContext)
+{
+    if (m_vThreads.empty())
+    {
+        for (size_t nIndex = 0; nIndex < nCount; ++nIndex)
+            fHandler(nIndex, pContext);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_oMutex);
+        m_nCount = nCount;
+        m_fHandler = fHandler;
+        m_pContext = pContext;
+        m_nRemaining = gsl::narrow_cast<unsigned int>(m_vThreads.size());
+        ++m_nGeneration;
+    }
+
+    m_cvStart.notify_all();
+
+    RunPartition(0);
+
+    std::unique_lock<std::mutex> lock(m_oMutex);
+    m_cvDone.wait(lock, [this]() noexcept { return m_nRemaining == 0; });
+}
+
+void WorkerGroup::RunWorker(unsigned int nWorker)
+{
+    unsigned int nGeneration = 0;
+    do
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_oMutex);
+            m_cvStart.wait(lock, [this, nGeneration]() noexcept { return m_bShutdown || m_nGeneration != nGeneration; });
+            if (m_bShutdown)
+                break;
+
+            nGeneration = m_nGeneration;
+        }
+
+        RunPartition(nWorker);
+
+        bool bLast = false;
+        {
+            std::unique_lock<std::mutex> lock(m_oMutex);
+            bLast = (--m_nRemaining == 0);
+        }
+
+        if (bLast)
+            m_cvDone.notify_one();
+    } while (true);
+}
+
+void WorkerGroup::RunPartition(unsigned int nWorker) noexcept
+{
+    const size_t nFirst = m_nCount * nWorker / m_nWorkers;
+    const size_t nEnd = m_nCount * (nWorker + 1) / m_nWorkers;
+
+    for (size_t nIndex = nFirst; nIndex < nEnd; ++nIndex)
+        m_fHandler(nIndex, m_pContext);
+}
+
+} // namespace services
+} // namespace ra
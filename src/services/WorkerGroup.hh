@@ -0,0 +1,71 @@
+#ifndef RA_SERVICES_WORKER_GROUP_HH
+#define RA_SERVICES_WORKER_GROUP_HH
+#pragma once
+
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// A small set of persistent threads that split a range of work items between them and wait for each other
+/// before returning.
+/// </summary>
+/// <remarks>
+/// Unlike <see cref="IThreadPool" />, work is dispatched without queuing or allocating, so it can be used every frame.
+/// </remarks>
+class WorkerGroup
+{
+public:
+    using Handler = void (*)(size_t nIndex, void* pContext);
+
+    /// <summary>
+    /// Initializes a new <see cref="WorkerGroup" />.
+    /// </summary>
+    /// <param name="nWorkers">
+    /// The number of workers, including the thread calling <see cref="ForEach" />, so one less thread is created.
+    /// </param>
+    GSL_SUPPRESS_F6 explicit WorkerGroup(unsigned int nWorkers);
+    ~WorkerGroup() noexcept;
+    WorkerGroup(const WorkerGroup&) noexcept = delete;
+    WorkerGroup& operator=(const WorkerGroup&) noexcept = delete;
+    WorkerGroup(WorkerGroup&&) noexcept = delete;
+    WorkerGroup& operator=(WorkerGroup&&) noexcept = delete;
+
+    /// <summary>
+    /// Gets the number of workers, including the calling thread.
+    /// </summary>
+    unsigned int GetWorkerCount() const noexcept { return m_nWorkers; }
+
+    /// <summary>
+    /// Calls <paramref name="fHandler" /> for every index in [0, <paramref name="nCount" />). Each worker is given
+    /// a contiguous range of indices. Returns once all of them have been processed.
+    /// </summary>
+    /// <remarks><paramref name="fHandler" /> must not throw.</remarks>
+    void ForEach(size_t nCount, Handler fHandler, void* pContext);
+
+private:
+    void RunWorker(unsigned int nWorker);
+    void RunPartition(unsigned int nWorker) noexcept;
+
+    std::vector<std::thread> m_vThreads;
+    unsigned int m_nWorkers;
+
+    std::mutex m_oMutex;
+    std::condition_variable m_cvStart;
+    std::condition_variable m_cvDone;
+    unsigned int m_nGeneration = 0;
+    unsigned int m_nRemaining = 0;
+    bool m_bShutdown = false;
+
+    size_t m_nCount = 0;
+    Handler m_fHandler = nullptr;
+    void* m_pContext = nullptr;
+};
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_WORKER_GROUP_HH
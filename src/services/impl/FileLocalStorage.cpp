@@ -111,6 +111,24 @@ std::wstring FileLocalStorage::GetPath(StorageItemType nType, const std::wstring
             sPath.append(L"-history.txt");
             break;
 
+        case StorageItemType::RuntimeTrace:
+            sPath.append(RA_DIR_DATA);
+            sPath.append(sKey);
+            sPath.append(L"-Trace.txt");
+            break;
+
+        case StorageItemType::GameDataCache:
+            sPath.append(RA_DIR_DATA);
+            sPath.append(sKey);
+            sPath.append(L".bin");
+            break;
+
+        case StorageItemType::SubmissionJournal:
+            sPath.append(RA_DIR_BASE);
+            sPath.append(sKey);
+            sPath.append(L"-pending.txt");
+            break;
+
         default:
             assert(!"unhandled StorageItemType");
             sPath.append(RA_DIR_DATA);
@@ -141,11 +159,127 @@ std::unique_ptr<TextWriter> FileLocalStorage::WriteText(StorageItemType nType, c
     return m_pFileSystem.CreateTextFile(GetPath(nType, sKey));
 }
 
+namespace {
+
+/// <summary>
+/// Writes to a temporary file, which is moved over the target file when the writer is committed. If the writer is
+/// destroyed without being committed, the temporary file is discarded.
+/// </summary>
+class ReplacingTextWriter : public TextWriter
+{
+public:
+    ReplacingTextWriter(const IFileSystem& pFileSystem, std::unique_ptr<TextWriter> pWriter,
+                        const std::wstring& sTempPath, const std::wstring& sTargetPath) noexcept
+        : m_pFileSystem(pFileSystem),
+          m_pWriter(std::move(pWriter)),
+          m_sTempPath(sTempPath),
+          m_sTargetPath(sTargetPath)
+    {
+    }
+
+    GSL_SUPPRESS_F6 ~ReplacingTextWriter() noexcept
+    {
+        if (m_pWriter != nullptr)
+        {
+            m_pWriter.reset();
+            m_pFileSystem.DeleteFile(m_sTempPath);
+        }
+    }
+
+    ReplacingTextWriter(const ReplacingTextWriter&) noexcept = delete;
+    ReplacingTextWriter& operator=(const ReplacingTextWriter&) noexcept = delete;
+    ReplacingTextWriter(ReplacingTextWriter&&) noexcept = delete;
+    ReplacingTextWriter& operator=(ReplacingTextWriter&&) noexcept = delete;
+
+    void Write(_In_ const std::string& sText) override { m_pWriter->Write(sText); }
+    void Write(_In_ const std::wstring& sText) override { m_pWriter->Write(sText); }
+    void WriteLine() override { m_pWriter->WriteLine(); }
+
+    std::streampos GetPosition() const override { return m_pWriter->GetPosition(); }
+    void SetPosition(std::streampos nNewPosition) override { m_pWriter->SetPosition(nNewPosition); }
+
+    bool Commit() override
+    {
+        if (m_pWriter == nullptr)
+            return false;
+
+        // flushes and closes the temporary file, reporting any error writing it
+        const bool bSucceeded = m_pWriter->Commit();
+        m_pWriter.reset();
+
+        // if anything went wrong, the target file is left as it was
+        if (bSucceeded && m_pFileSystem.ReplaceFile(m_sTempPath, m_sTargetPath))
+            return true;
+
+        m_pFileSystem.DeleteFile(m_sTempPath);
+        return false;
+    }
+
+private:
+    const IFileSystem& m_pFileSystem;
+    std::unique_ptr<TextWriter> m_pWriter;
+    std::wstring m_sTempPath;
+    std::wstring m_sTargetPath;
+};
+
+} // namespace
+
+std::unique_ptr<TextWriter> FileLocalStorage::ReplaceText(StorageItemType nType, const std::wstring& sKey)
+{
+    const auto sPath = GetPath(nType, sKey);
+    const auto sTempPath = sPath + L".tmp";
+
+    auto pWriter = m_pFileSystem.CreateTextFile(sTempPath);
+    if (pWriter == nullptr)
+        return std::unique_ptr<TextWriter>();
+
+    return std::make_unique<ReplacingTextWriter>(m_pFileSystem, std::move(pWriter), sTempPath, sPath);
+}
+
 std::unique_ptr<TextWriter> FileLocalStorage::AppendText(StorageItemType nType, const std::wstring& sKey)
 {
     return m_pFileSystem.AppendTextFile(GetPath(nType, sKey));
 }
 
+// the validators are stored next to the data file, one per line: ETag, then Last-Modified
+_CONSTANT_VAR VALIDATORS_SUFFIX = L".etag";
+
+Http::Validators FileLocalStorage::GetValidators(StorageItemType nType, const std::wstring& sKey)
+{
+    Http::Validators pValidators;
+
+    // validators for data that has been deleted (i.e. expired) are meaningless
+    const auto sPath = GetPath(nType, sKey);
+    if (m_pFileSystem.GetFileSize(sPath) <= 0)
+        return pValidators;
+
+    auto pReader = m_pFileSystem.OpenTextFile(sPath + VALIDATORS_SUFFIX);
+    if (pReader != nullptr && pReader->GetLine(pValidators.ETag))
+    {
+        if (!pReader->GetLine(pValidators.LastModified))
+            pValidators.LastModified.clear();
+    }
+
+    return pValidators;
+}
+
+void FileLocalStorage::SetValidators(StorageItemType nType, const std::wstring& sKey, const Http::Validators& pValidators)
+{
+    const auto sPath = GetPath(nType, sKey) + VALIDATORS_SUFFIX;
+    if (pValidators.IsEmpty())
+    {
+        m_pFileSystem.DeleteFile(sPath);
+        return;
+    }
+
+    auto pWriter = m_pFileSystem.CreateTextFile(sPath);
+    if (pWriter != nullptr)
+    {
+        pWriter->WriteLine(pValidators.ETag);
+        pWriter->WriteLine(pValidators.LastModified);
+    }
+}
+
 } // namespace impl
 } // namespace services
 } // namespace ra
@@ -18,8 +18,12 @@ public:
 
     std::unique_ptr<TextReader> ReadText(StorageItemType nType, const std::wstring& sKey) override;
     std::unique_ptr<TextWriter> WriteText(StorageItemType nType, const std::wstring& sKey) override;
+    std::unique_ptr<TextWriter> ReplaceText(StorageItemType nType, const std::wstring& sKey) override;
     std::unique_ptr<TextWriter> AppendText(StorageItemType nType, const std::wstring& sKey) override;
 
+    Http::Validators GetValidators(StorageItemType nType, const std::wstring& sKey) override;
+    void SetValidators(StorageItemType nType, const std::wstring& sKey, const Http::Validators& pValidators) override;
+
     std::wstring GetPath(StorageItemType nType, const std::wstring& sKey) const;
 
 private:
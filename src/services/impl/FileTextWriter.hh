@@ -48,6 +48,15 @@ public:
         m_oStream.seekp(nNewPosition);
     }
 
+    bool Commit() override
+    {
+        // make sure everything buffered reached the file, and that closing it didn't fail either
+        m_oStream.flush();
+        const bool bSucceeded = m_oStream.good();
+        m_oStream.close();
+        return bSucceeded && !m_oStream.fail();
+    }
+
     std::ofstream& GetFStream() noexcept { return m_oStream; }
 
 private:
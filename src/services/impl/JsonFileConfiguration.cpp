@@ -63,6 +63,9 @@ bool JsonFileConfiguration::Load(const std::wstring& sFilename)
     if (doc.HasMember("Prefer Decimal"))
         SetFeatureEnabled(Feature::PreferDecimal, doc["Prefer Decimal"].GetBool());
 
+    if (doc.HasMember("Parallel Evaluation"))
+        SetFeatureEnabled(Feature::ParallelEvaluation, doc["Parallel Evaluation"].GetBool());
+
     if (doc.HasMember("Num Background Threads"))
         m_nBackgroundThreads = doc["Num Background Threads"].GetUint();
     if (doc.HasMember("ROM Directory"))
@@ -117,6 +120,7 @@ void JsonFileConfiguration::Save() const
     doc.AddMember("Leaderboard Counter Display", IsFeatureEnabled(Feature::LeaderboardCounters), a);
     doc.AddMember("Leaderboard Scoreboard Display", IsFeatureEnabled(Feature::LeaderboardScoreboards), a);
     doc.AddMember("Prefer Decimal", IsFeatureEnabled(Feature::PreferDecimal), a);
+    doc.AddMember("Parallel Evaluation", IsFeatureEnabled(Feature::ParallelEvaluation), a);
     doc.AddMember("Num Background Threads", m_nBackgroundThreads, a);
 
     if (!m_sRomDirectory.empty())
@@ -6,6 +6,12 @@ namespace ra {
 namespace services {
 namespace impl {
 
+// a lower priority task that has waited this long is started ahead of other non-critical work
+static constexpr auto STARVATION_THRESHOLD = std::chrono::seconds(2);
+
+// a critical or high priority task that has waited this long is logged
+static constexpr auto SLOW_START_THRESHOLD = std::chrono::milliseconds(100);
+
 ThreadPool::~ThreadPool() noexcept
 {
     Shutdown(true);
@@ -15,14 +21,35 @@ void ThreadPool::Initialize(size_t nThreads) noexcept
 {
     assert(m_vThreads.empty());
 
+    SetThreadCount(nThreads);
+
+    RA_LOG_INFO("Initializing %zu worker threads", m_nThreads);
+
+    for (size_t i = 0; i < m_nThreads; ++i)
+        m_vThreads.emplace_back(&ThreadPool::RunThread, this);
+}
+
+void ThreadPool::SetThreadCount(size_t nThreads) noexcept
+{
     // require at least two threads. that way if one thread is reserved for processing timed events, another is still available to execute them.
     if (nThreads < 2)
-        nThreads = 2; 
+        nThreads = 2;
 
-    RA_LOG_INFO("Initializing %zu worker threads", nThreads);
+    m_nThreads = nThreads;
 
-    for (size_t i = 0; i < nThreads; ++i)
-        m_vThreads.emplace_back(&ThreadPool::RunThread, this);
+    // critical and high priority work may use every thread. lower priority work is limited so a burst of it (i.e.
+    // badge downloads while loading a game) can't crowd out other work. see also CanStart.
+    m_vLimits.at(ra::etoi(TaskPriority::Critical)) = nThreads;
+    m_vLimits.at(ra::etoi(TaskPriority::High)) = nThreads;
+    m_vLimits.at(ra::etoi(TaskPriority::Normal)) = nThreads - 1;
+    m_vLimits.at(ra::etoi(TaskPriority::Low)) = std::max(nThreads / 2, size_t{ 1 });
+    m_vLimits.at(ra::etoi(TaskPriority::Idle)) = 1;
+}
+
+void ThreadPool::Enqueue(TaskPriority nPriority, std::function<void()>&& f)
+{
+    const auto tNow = ServiceLocator::Get<IClock>().UpTime();
+    m_vQueues.at(ra::etoi(nPriority)).emplace_back(tNow, std::move(f));
 }
 
 void ThreadPool::RunThread()
@@ -32,41 +59,151 @@ void ThreadPool::RunThread()
         // check for work
         do
         {
-            std::function<void()> pNext;
+            QueuedTask pNext;
+            size_t nPriority = 0;
             {
                 std::unique_lock<std::mutex> lock(m_oMutex);
-                if (m_vQueue.empty())
+                if (!TakeNextTask(pNext, nPriority))
                     break;
-
-                pNext = std::move(m_vQueue.front());
-                m_vQueue.pop_front();
             }
 
             // do work
             try
             {
-                pNext();
+                pNext.fTask();
             }
             catch (const std::exception& ex)
             {
                 RA_LOG_ERR("Exception on background thread: %s", ex.what());
             }
+
+            {
+                std::unique_lock<std::mutex> lock(m_oMutex);
+                CompleteTask(nPriority);
+            }
         } while (!m_bShutdownInitiated);
 
         // wait for work
         if (!m_bShutdownInitiated)
         {
             std::unique_lock<std::mutex> lock(m_oMutex);
-            m_cvWork.wait(lock);
+            if (!HasStartableTask())
+                m_cvWork.wait(lock);
         }
     } while (!m_bShutdownInitiated);
 }
 
+void ThreadPool::CompleteTask(size_t nPriority) noexcept
+{
+    GSL_SUPPRESS(bounds.4) --m_vRunning[nPriority];
+}
+
+GSL_SUPPRESS(bounds.4)
+bool ThreadPool::CanStart(size_t nPriority) const noexcept
+{
+    if (m_vQueues[nPriority].empty() || m_vRunning[nPriority] >= m_vLimits[nPriority])
+        return false;
+
+    if (nPriority <= ra::etoi(TaskPriority::High))
+        return true;
+
+    // lower priority work must leave a thread free for critical and high priority work. the thread processing
+    // delayed tasks can't run anything else, so it's not counted. if that leaves only one thread, it's shared.
+    size_t nRunning = 0;
+    for (const auto nCount : m_vRunning)
+        nRunning += nCount;
+
+    size_t nAvailable = m_nThreads;
+    if (m_bProcessingDelayedTasks)
+    {
+        --nRunning;
+        --nAvailable;
+    }
+
+    const size_t nCapacity = (nAvailable > 1) ? nAvailable - 1 : 1;
+    return (nRunning < nCapacity);
+}
+
+bool ThreadPool::HasStartableTask() const noexcept
+{
+    for (size_t nPriority = 0; nPriority < NumPriorities; ++nPriority)
+    {
+        if (CanStart(nPriority))
+            return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::TakeNextTask(QueuedTask& pTask, size_t& nPriority)
+{
+    const auto tNow = ServiceLocator::Get<IClock>().UpTime();
+
+    nPriority = NumPriorities;
+    for (size_t i = 0; i < NumPriorities; ++i)
+    {
+        if (!CanStart(i))
+            continue;
+
+        const auto& vQueue = m_vQueues.at(i);
+
+        if (nPriority == NumPriorities)
+        {
+            nPriority = i;
+
+            // critical and high priority work is always started first
+            if (i <= ra::etoi(TaskPriority::High))
+                break;
+        }
+        else if (tNow - vQueue.front().tQueued >= STARVATION_THRESHOLD &&
+                 vQueue.front().tQueued < m_vQueues.at(nPriority).front().tQueued)
+        {
+            // this task has been waiting longer than the higher priority one. start it first so a steady stream
+            // of higher priority work can't keep it from ever running
+            nPriority = i;
+        }
+    }
+
+    if (nPriority == NumPriorities)
+        return false;
+
+    auto& vQueue = m_vQueues.at(nPriority);
+    pTask = std::move(vQueue.front());
+    vQueue.pop_front();
+    ++m_vRunning.at(nPriority);
+
+    const auto tWait = std::chrono::duration_cast<std::chrono::milliseconds>(tNow - pTask.tQueued);
+    if (tWait.count() > 0)
+    {
+        auto& pStatistics = m_vStatistics.at(nPriority);
+        pStatistics.tTotalWait += tWait;
+        if (tWait > pStatistics.tMaxWait)
+            pStatistics.tMaxWait = tWait;
+
+        if (nPriority <= ra::etoi(TaskPriority::High) && tWait >= SLOW_START_THRESHOLD)
+            RA_LOG_WARN("Priority %zu task waited %lldms to start", nPriority, tWait.count());
+    }
+    ++m_vStatistics.at(nPriority).nTasks;
+
+    return true;
+}
+
+ThreadPool::QueueStatistics ThreadPool::GetQueueStatistics(TaskPriority nPriority) const
+{
+    std::unique_lock<std::mutex> lock(m_oMutex);
+    return m_vStatistics.at(ra::etoi(nPriority));
+}
+
 void ThreadPool::ProcessDelayedTasks()
 {
     auto& pClock = ServiceLocator::Get<IClock>();
     constexpr auto tZeroMilliseconds = std::chrono::milliseconds(0);
 
+    {
+        std::unique_lock<std::mutex> lock(m_oMutex);
+        m_bProcessingDelayedTasks = true;
+    }
+
     // check for work
     while (!m_bShutdownInitiated)
     {
@@ -78,7 +215,9 @@ void ThreadPool::ProcessDelayedTasks()
             const auto tNow = pClock.UpTime();
             while (!m_vDelayedTasks.empty() && m_vDelayedTasks.front().tWhen <= tNow)
             {
-                m_vQueue.emplace_front(std::move(m_vDelayedTasks.front().fTask));
+                // the task has already waited for its delay, put it at the front of its queue
+                auto& pTask = m_vDelayedTasks.front();
+                m_vQueues.at(ra::etoi(pTask.nPriority)).emplace_front(pTask.tWhen, std::move(pTask.fTask));
                 m_vDelayedTasks.pop_front();
 
                 ++nReadyTasks;
@@ -107,13 +246,19 @@ void ThreadPool::ProcessDelayedTasks()
 
             // no more delayed tasks, free up the thread for other work
             if (m_vDelayedTasks.empty())
-                break;
+            {
+                m_bProcessingDelayedTasks = false;
+                return;
+            }
 
             const auto tNext = m_vDelayedTasks.front().tWhen - pClock.UpTime();
             if (tNext > tZeroMilliseconds)
                 m_cvDelayedWork.wait_for(lock, tNext);
         }
     }
+
+    std::unique_lock<std::mutex> lock(m_oMutex);
+    m_bProcessingDelayedTasks = false;
 }
 
 void ThreadPool::Shutdown(bool bWait) noexcept
@@ -131,6 +276,17 @@ void ThreadPool::Shutdown(bool bWait) noexcept
 
         RA_LOG_INFO("Background threads finished");
 
+        for (size_t nPriority = 0; nPriority < NumPriorities; ++nPriority)
+        {
+            GSL_SUPPRESS(bounds.4) const auto& pStatistics = m_vStatistics[nPriority];
+            if (pStatistics.nTasks > 0)
+            {
+                RA_LOG_INFO("Priority %zu: %zu tasks, average wait %lldms, max wait %lldms", nPriority,
+                            pStatistics.nTasks, pStatistics.tTotalWait.count() / gsl::narrow_cast<long long>(pStatistics.nTasks),
+                            pStatistics.tMaxWait.count());
+            }
+        }
+
         m_vThreads.clear();
     }
 
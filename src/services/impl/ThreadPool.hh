@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ra_fwd.h"
+#include "ra_utility.h"
 
 #include "services\IClock.hh"
 #include "services\IThreadPool.hh"
@@ -30,6 +31,11 @@ public:
     GSL_SUPPRESS_F6 void Initialize(size_t nThreads) noexcept;
 
     void RunAsync(std::function<void()>&& f) override
+    {
+        RunAsync(TaskPriority::Normal, std::move(f));
+    }
+
+    void RunAsync(TaskPriority nPriority, std::function<void()>&& f) override
     {
         if (m_bShutdownInitiated)
             return;
@@ -38,20 +44,26 @@ public:
 
         {
             std::unique_lock<std::mutex> lock(m_oMutex);
-            m_vQueue.push_back(std::move(f));
+            Enqueue(nPriority, std::move(f));
         }
 
         m_cvWork.notify_one();
     }
 
     void ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f) override
+    {
+        ScheduleAsync(nDelay, TaskPriority::Normal, std::move(f));
+    }
+
+    void ScheduleAsync(std::chrono::milliseconds nDelay, TaskPriority nPriority, std::function<void()>&& f) override
     {
         if (m_bShutdownInitiated)
             return;
 
         assert(!m_vThreads.empty());
 
-        const auto tWhen = ServiceLocator::Get<IClock>().UpTime() + nDelay;
+        const auto tNow = ServiceLocator::Get<IClock>().UpTime();
+        const auto tWhen = tNow + nDelay;
 
         bool bStartScheduler = false;
         bool bNewPriority    = false;
@@ -63,7 +75,7 @@ public:
             if (m_vDelayedTasks.empty())
             {
                 // first scheduled task - dedicate one of the background threads to timed events
-                m_vQueue.push_front([this]() { ProcessDelayedTasks(); });
+                m_vQueues.at(ra::etoi(TaskPriority::Critical)).emplace_front(tNow, [this]() { ProcessDelayedTasks(); });
                 bStartScheduler = true;
             }
             else if (tWhen < iter->tWhen)
@@ -81,7 +93,7 @@ public:
                 } while (iter != m_vDelayedTasks.end() && iter->tWhen < tWhen);
             }
 
-            m_vDelayedTasks.emplace(iter, tWhen, std::move(f));
+            m_vDelayedTasks.emplace(iter, tWhen, nPriority, std::move(f));
         }
 
         if (bStartScheduler)
@@ -101,27 +113,75 @@ public:
 
     bool IsShutdownRequested() const noexcept override { return m_bShutdownInitiated; }
 
+    struct QueueStatistics
+    {
+        size_t nTasks{ 0U };                        // number of tasks started
+        std::chrono::milliseconds tTotalWait{};     // total time tasks spent waiting to be started
+        std::chrono::milliseconds tMaxWait{};       // longest time a task spent waiting to be started
+    };
+
+    /// <summary>
+    /// Gets information about how long tasks of the specified priority have waited to be started.
+    /// </summary>
+    QueueStatistics GetQueueStatistics(TaskPriority nPriority) const;
+
+protected:
+    // calculates the limits for each priority. called by Initialize
+    void SetThreadCount(size_t nThreads) noexcept;
+
+    struct QueuedTask
+    {
+        QueuedTask() noexcept = default;
+        QueuedTask(std::chrono::steady_clock::time_point tQueued, std::function<void()> fTask) :
+            tQueued(tQueued),
+            fTask(fTask){};
+
+        std::chrono::steady_clock::time_point tQueued;
+        std::function<void()> fTask;
+    };
+
+    // the following must be called while holding m_oMutex
+
+    void Enqueue(TaskPriority nPriority, std::function<void()>&& f);
+
+    // selects the next task that can be started
+    bool TakeNextTask(QueuedTask& pTask, size_t& nPriority);
+
+    // releases the slot held by a task returned from TakeNextTask
+    void CompleteTask(size_t nPriority) noexcept;
+
 private:
     void RunThread();
     void ProcessDelayedTasks();
 
+    bool CanStart(size_t nPriority) const noexcept;
+    bool HasStartableTask() const noexcept;
+
     std::vector<std::thread> m_vThreads;
     size_t m_nThreads{0U};
     bool m_bShutdownInitiated{false};
 
     struct DelayedTask
     {
-        DelayedTask(std::chrono::steady_clock::time_point tWhen, std::function<void()> fTask) :
+        DelayedTask(std::chrono::steady_clock::time_point tWhen, TaskPriority nPriority, std::function<void()> fTask) :
             tWhen(tWhen),
+            nPriority(nPriority),
             fTask(fTask){};
 
         std::chrono::steady_clock::time_point tWhen;
+        TaskPriority nPriority;
         std::function<void()> fTask;
     };
     std::deque<DelayedTask> m_vDelayedTasks;
 
-    std::deque<std::function<void()>> m_vQueue;
-    std::mutex m_oMutex;
+    static constexpr size_t NumPriorities = ra::etoi(TaskPriority::Idle) + 1;
+
+    std::array<std::deque<QueuedTask>, NumPriorities> m_vQueues;
+    std::array<size_t, NumPriorities> m_vRunning{};         // number of tasks of each priority currently running
+    std::array<size_t, NumPriorities> m_vLimits{};          // maximum number of tasks of each priority that may run at once
+    bool m_bProcessingDelayedTasks{false};                  // a thread is occupied by ProcessDelayedTasks
+    std::array<QueueStatistics, NumPriorities> m_vStatistics;
+    mutable std::mutex m_oMutex;
     std::condition_variable m_cvWork;
     std::condition_variable m_cvDelayedWork;
 };
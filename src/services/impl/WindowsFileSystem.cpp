@@ -90,6 +90,29 @@ bool WindowsFileSystem::MoveFile(const std::wstring& sOldPath, const std::wstrin
     return (MoveFileW(sAbsolutePathOld.c_str(), sAbsolutePathNew.c_str()) != 0);
 }
 
+bool WindowsFileSystem::ReplaceFile(const std::wstring& sSourcePath, const std::wstring& sTargetPath) const noexcept
+{
+    std::wstring sBufferSource, sBufferTarget;
+    const auto& sAbsolutePathSource = MakeAbsolute(sBufferSource, sSourcePath);
+    const auto& sAbsolutePathTarget = MakeAbsolute(sBufferTarget, sTargetPath);
+
+    // make sure the new contents are on disk before the old file is replaced, otherwise a crash could leave the
+    // target pointing at a file whose data was never written
+    HANDLE hFile = CreateFileW(sAbsolutePathSource.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    const bool bFlushed = (FlushFileBuffers(hFile) != 0);
+    CloseHandle(hFile);
+    if (!bFlushed)
+        return false;
+
+    // within a volume, this is a rename of the directory entry, so the target is either the old file or the new one
+    return (MoveFileExW(sAbsolutePathSource.c_str(), sAbsolutePathTarget.c_str(),
+                        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+}
+
 int64_t WindowsFileSystem::GetFileSize(const std::wstring& sPath) const
 {
     std::wstring sBuffer;
@@ -141,6 +164,30 @@ std::chrono::system_clock::time_point WindowsFileSystem::GetLastModified(const s
     return std::chrono::system_clock::from_time_t(tFileTime);
 }
 
+bool WindowsFileSystem::SetLastModified(const std::wstring& sPath, std::chrono::system_clock::time_point tLastModified) const
+{
+    std::wstring sBuffer;
+    const auto& sAbsolutePath = MakeAbsolute(sBuffer, sPath);
+
+    HANDLE hFile = CreateFileW(sAbsolutePath.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        RA_LOG_ERR("Error %d setting last modified for file: %s", GetLastError(), ra::Narrow(sPath).c_str());
+        return false;
+    }
+
+    // the reverse of the conversion in GetLastModified
+    const auto tFileTime = std::chrono::system_clock::to_time_t(tLastModified);
+    ULARGE_INTEGER nFileTime;
+    nFileTime.QuadPart = (ra::to_unsigned(tFileTime) + 11644473600ULL) * 10000000ULL;
+    const FILETIME ftLastWriteTime{ nFileTime.LowPart, nFileTime.HighPart };
+
+    const bool bResult = (SetFileTime(hFile, nullptr, nullptr, &ftLastWriteTime) != 0);
+    CloseHandle(hFile);
+    return bResult;
+}
+
 std::unique_ptr<TextReader> WindowsFileSystem::OpenTextFile(const std::wstring& sPath) const
 {
     std::wstring sBuffer;
@@ -26,8 +26,10 @@ public:
                                _Inout_ std::vector<std::wstring>& vResults) const override;
     bool DeleteFile(const std::wstring& sPath) const noexcept override;
     bool MoveFile(const std::wstring& sOldPath, const std::wstring& sNewPath) const noexcept override;
+    bool ReplaceFile(const std::wstring& sSourcePath, const std::wstring& sTargetPath) const noexcept override;
     int64_t GetFileSize(const std::wstring& sPath) const override;
     std::chrono::system_clock::time_point GetLastModified(const std::wstring& sPath) const override;
+    bool SetLastModified(const std::wstring& sPath, std::chrono::system_clock::time_point tLastModified) const override;
     std::unique_ptr<TextReader> OpenTextFile(const std::wstring& sPath) const override;
     std::unique_ptr<TextWriter> CreateTextFile(const std::wstring& sPath) const override;
     std::unique_ptr<TextWriter> AppendTextFile(const std::wstring& sPath) const override;
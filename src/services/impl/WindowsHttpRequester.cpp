@@ -5,6 +5,9 @@
 #include "RA_Log.h"
 #include "RA_StringUtils.h"
 
+#include "services\IClock.hh"
+#include "services\ServiceLocator.hh"
+
 #include "services\impl\StringTextWriter.hh"
 
 #include <winhttp.h>
@@ -57,6 +60,26 @@ static bool ReadIntoString(const HINTERNET hRequest, std::string& sBuffer, DWORD
     return true;
 }
 
+static std::string QueryHeader(const HINTERNET hRequest, DWORD nInfoLevel)
+{
+    // first call gets the size of the header value (in bytes)
+    DWORD dwSize = 0;
+    GSL_SUPPRESS_ES47 WinHttpQueryHeaders(hRequest, nInfoLevel, WINHTTP_HEADER_NAME_BY_INDEX, WINHTTP_NO_OUTPUT_BUFFER,
+                                          &dwSize, WINHTTP_NO_HEADER_INDEX);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || dwSize == 0)
+        return std::string();
+
+    std::wstring sValue;
+    sValue.resize(dwSize / sizeof(wchar_t));
+    GSL_SUPPRESS_ES47
+    if (!WinHttpQueryHeaders(hRequest, nInfoLevel, WINHTTP_HEADER_NAME_BY_INDEX, sValue.data(), &dwSize,
+                             WINHTTP_NO_HEADER_INDEX))
+        return std::string();
+
+    sValue.resize(dwSize / sizeof(wchar_t));
+    return ra::Narrow(sValue);
+}
+
 static void ReadIntoWriter(const HINTERNET hRequest, ra::services::TextWriter& pContentWriter, DWORD& nStatusCode)
 {
     DWORD nAvailableBytes = 0;
@@ -88,143 +111,288 @@ static void ReadIntoWriter(const HINTERNET hRequest, ra::services::TextWriter& p
     }
 }
 
-unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWriter& pContentWriter) const
+WindowsHttpRequester::Transport::Handle WindowsHttpRequester::Transport::OpenSession(const std::wstring& sUserAgent,
+                                                                                     unsigned int& nStatusCode) const
 {
-    DWORD nStatusCode = 0;
-
-    // obtain a session handle.
 #pragma warning(push)
 #pragma warning(disable: 26477)
-    GSL_SUPPRESS_ES47 HINTERNET hSession = WinHttpOpen(m_sUserAgent.c_str(), WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+    GSL_SUPPRESS_ES47 HINTERNET hSession = WinHttpOpen(sUserAgent.c_str(), WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
                                                        WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
 #pragma warning(pop)
 
     if (hSession == nullptr)
+        nStatusCode = GetLastError();
+
+    return hSession;
+}
+
+void WindowsHttpRequester::Transport::SetMaxConnectionsPerServer(Handle hSession,
+                                                                 unsigned int nMaxConnections) const noexcept
+{
+    DWORD nValue = nMaxConnections;
+    WinHttpSetOption(hSession, WINHTTP_OPTION_MAX_CONNS_PER_SERVER, &nValue, sizeof(nValue));
+    WinHttpSetOption(hSession, WINHTTP_OPTION_MAX_CONNS_PER_1_0_SERVER, &nValue, sizeof(nValue));
+}
+
+WindowsHttpRequester::Transport::Handle WindowsHttpRequester::Transport::Connect(Handle hSession,
+                                                                                 const std::wstring& sHostName,
+                                                                                 unsigned int& nStatusCode) const
+{
+    HINTERNET hConnect = WinHttpConnect(hSession, sHostName.c_str(), INTERNET_DEFAULT_HTTP_PORT, 0);
+    if (hConnect == nullptr)
+        nStatusCode = GetLastError();
+
+    return hConnect;
+}
+
+unsigned int WindowsHttpRequester::Transport::Send(Handle hConnect, const std::wstring& sPath,
+                                                   const Http::Request& pRequest, TextWriter& pContentWriter,
+                                                   Http::Validators& pValidators) const
+{
+    DWORD nStatusCode = 0;
+    auto sPostData = pRequest.GetPostData();
+
+    // open the request
+    HINTERNET hRequest = WinHttpOpenRequest(hConnect,
+        sPostData.empty() ? L"GET" : L"POST",
+        sPath.c_str(),
+        nullptr,
+        WINHTTP_NO_REFERER,
+        WINHTTP_DEFAULT_ACCEPT_TYPES,
+        0);
+
+    if (hRequest == nullptr)
+        return GetLastError();
+
+    std::wstring sHeaders;
+    sHeaders += L"Content-Type: ";
+    sHeaders += ra::Widen(pRequest.GetContentType());
+
+    // ask the server to only send the content if it's changed
+    const auto& pRequestValidators = pRequest.GetValidators();
+    if (!pRequestValidators.ETag.empty())
+    {
+        sHeaders += L"\r\nIf-None-Match: ";
+        sHeaders += ra::Widen(pRequestValidators.ETag);
+    }
+    if (!pRequestValidators.LastModified.empty())
+    {
+        sHeaders += L"\r\nIf-Modified-Since: ";
+        sHeaders += ra::Widen(pRequestValidators.LastModified);
+    }
+
+    BOOL bResults{};
+
+    // send the request
+    if (sPostData.empty())
+    {
+        bResults = WinHttpSendRequest(hRequest,
+            sHeaders.c_str(), sHeaders.length(),
+            WINHTTP_NO_REQUEST_DATA,
+            0, 0,
+            0);
+    }
+    else
+    {
+        bResults = WinHttpSendRequest(hRequest,
+            sHeaders.c_str(), sHeaders.length(),
+            static_cast<LPVOID>(sPostData.data()),
+            sPostData.length(), sPostData.length(),
+            0);
+    }
+
+    if (!bResults || !WinHttpReceiveResponse(hRequest, nullptr))
     {
         nStatusCode = GetLastError();
     }
     else
     {
-        INTERNET_PORT nPort = INTERNET_DEFAULT_HTTP_PORT;
+        // get the http status code
+        DWORD dwSize = sizeof(DWORD);
 
-        auto sUrl = pRequest.GetUrl();
-        if (_strnicmp(sUrl.c_str(), "http://", 7) == 0)
+        GSL_SUPPRESS_ES47 WinHttpQueryHeaders(
+            hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, WINHTTP_HEADER_NAME_BY_INDEX,
+            &nStatusCode, &dwSize, WINHTTP_NO_HEADER_INDEX);
+
+        pValidators.ETag = QueryHeader(hRequest, WINHTTP_QUERY_ETAG);
+        pValidators.LastModified = QueryHeader(hRequest, WINHTTP_QUERY_LAST_MODIFIED);
+
+        // read the response
+        auto* pStringWriter = dynamic_cast<StringTextWriter*>(&pContentWriter);
+        if (pStringWriter != nullptr)
         {
-            sUrl.erase(0, 7);
+            // optimized path for writing to string buffer
+            if (!ReadIntoString(hRequest, pStringWriter->GetString(), nStatusCode))
+            {
+                // could not use optimization, fall back to buffered reader
+                ReadIntoWriter(hRequest, pContentWriter, nStatusCode);
+            }
         }
-        else if (_strnicmp(sUrl.c_str(), "https://", 8) == 0)
+        else
         {
-            sUrl.erase(0, 8);
-            nPort = INTERNET_DEFAULT_HTTPS_PORT;
+            ReadIntoWriter(hRequest, pContentWriter, nStatusCode);
         }
+    }
 
-        std::string sPath;
-        const auto nIndex = sUrl.find('/');
-        if (nIndex != std::string::npos)
-        {
-            sPath.assign(sUrl, nIndex + 1, std::string::npos);
-            sUrl.resize(nIndex);
-        }
+    WinHttpCloseHandle(hRequest);
+    return nStatusCode;
+}
 
-        // specify the server
-        auto sHostName = ra::Widen(sUrl);
-        HINTERNET hConnect = WinHttpConnect(hSession, sHostName.c_str(), INTERNET_DEFAULT_HTTP_PORT, 0);
+void WindowsHttpRequester::Transport::Close(Handle hHandle) const noexcept
+{
+    WinHttpCloseHandle(hHandle);
+}
 
-        if (hConnect == nullptr)
-        {
-            nStatusCode = GetLastError();
-        }
-        else
-        {
-            // merge query parameters onto sPath.
-            std::string sQueryString = pRequest.GetQueryString();
-            if (!sQueryString.empty())
-            {
-                sPath.push_back('?');
-                sPath += sQueryString;
-            }
+class WindowsHttpRequester::Session
+{
+public:
+    explicit Session(std::shared_ptr<const Transport> pTransport, Transport::Handle hSession) noexcept
+        : m_pTransport(std::move(pTransport)), m_hSession(hSession)
+    {
+    }
 
-            auto sPostData = pRequest.GetPostData();
+    ~Session() noexcept
+    {
+        for (auto& pConnection : m_mConnections)
+            m_pTransport->Close(pConnection.second);
 
-            // open the connection
-            auto sPathWide = ra::Widen(sPath);
-            HINTERNET hRequest = WinHttpOpenRequest(hConnect,
-                sPostData.empty() ? L"GET" : L"POST",
-                sPathWide.c_str(),
-                nullptr,
-                WINHTTP_NO_REFERER,
-                WINHTTP_DEFAULT_ACCEPT_TYPES,
-                0);
+        m_pTransport->Close(m_hSession);
+    }
 
-            if (hRequest == nullptr)
-            {
-                nStatusCode = GetLastError();
-            }
-            else
-            {
-                std::wstring sHeaders;
-                sHeaders += L"Content-Type: ";
-                sHeaders += ra::Widen(pRequest.GetContentType());
-
-                BOOL bResults{};
-
-                // send the request
-                if (sPostData.empty())
-                {
-                    bResults = WinHttpSendRequest(hRequest,
-                        sHeaders.c_str(), sHeaders.length(),
-                        WINHTTP_NO_REQUEST_DATA,
-                        0, 0,
-                        0);
-                }
-                else
-                {
-                    bResults = WinHttpSendRequest(hRequest,
-                        sHeaders.c_str(), sHeaders.length(),
-                        static_cast<LPVOID>(sPostData.data()),
-                        sPostData.length(), sPostData.length(),
-                        0);
-                }
-
-                if (!bResults || !WinHttpReceiveResponse(hRequest, nullptr))
-                {
-                    nStatusCode = GetLastError();
-                }
-                else
-                {
-                    // get the http status code
-                    DWORD dwSize = sizeof(DWORD);
-                    
-                    GSL_SUPPRESS_ES47 WinHttpQueryHeaders(
-                        hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, WINHTTP_HEADER_NAME_BY_INDEX,
-                        &nStatusCode, &dwSize, WINHTTP_NO_HEADER_INDEX);
-
-                    // read the response
-                    auto* pStringWriter = dynamic_cast<StringTextWriter*>(&pContentWriter);
-                    if (pStringWriter != nullptr)
-                    {
-                        // optimized path for writing to string buffer
-                        if (!ReadIntoString(hRequest, pStringWriter->GetString(), nStatusCode))
-                        {
-                            // could not use optimization, fall back to buffered reader
-                            ReadIntoWriter(hRequest, pContentWriter, nStatusCode);
-                        }
-                    }
-                    else
-                    {
-                        ReadIntoWriter(hRequest, pContentWriter, nStatusCode);
-                    }
-                }
-
-                WinHttpCloseHandle(hRequest);
-            }
+    Session(const Session&) noexcept = delete;
+    Session& operator=(const Session&) noexcept = delete;
+    Session(Session&&) noexcept = delete;
+    Session& operator=(Session&&) noexcept = delete;
+
+    void SetMaxConnectionsPerServer(unsigned int nMaxConnections) noexcept
+    {
+        m_pTransport->SetMaxConnectionsPerServer(m_hSession, nMaxConnections);
+    }
+
+    /// <summary>
+    /// Gets the connection handle for a server, creating it the first time the server is used. A connection that
+    /// couldn't be opened isn't remembered, so the next request to the server tries again.
+    /// </summary>
+    Transport::Handle GetConnection(const std::wstring& sHostName, unsigned int& nStatusCode)
+    {
+        std::lock_guard<std::mutex> lock(m_mMutex);
+
+        const auto pIter = m_mConnections.find(sHostName);
+        if (pIter != m_mConnections.end())
+            return pIter->second;
+
+        auto hConnect = m_pTransport->Connect(m_hSession, sHostName, nStatusCode);
+        if (hConnect != nullptr)
+            m_mConnections.emplace(sHostName, hConnect);
+
+        return hConnect;
+    }
+
+private:
+    std::shared_ptr<const Transport> m_pTransport;
+    Transport::Handle m_hSession;
+
+    std::mutex m_mMutex;
+    std::map<std::wstring, Transport::Handle> m_mConnections;
+};
+
+void WindowsHttpRequester::SetUserAgent(const std::string& sUserAgent)
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    m_sUserAgent = ra::Widen(sUserAgent);
+
+    // the user agent is associated to the session, start a new one for the next request
+    m_pSession.reset();
+}
+
+void WindowsHttpRequester::SetMaxConnectionsPerServer(unsigned int nMaxConnections)
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    m_nMaxConnectionsPerServer = nMaxConnections;
+
+    if (m_pSession != nullptr)
+        m_pSession->SetMaxConnectionsPerServer(nMaxConnections);
+}
 
-            WinHttpCloseHandle(hConnect);
+std::shared_ptr<WindowsHttpRequester::Session> WindowsHttpRequester::GetSession(unsigned int& nStatusCode) const
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+
+    // if the pooled connections haven't been used for a while, the server has probably closed them. discard them
+    // rather than finding out when the next request fails. requests still using the old session keep it alive
+    // until they complete.
+    const auto tNow = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+    if (m_pSession != nullptr && m_nActiveRequests == 0 && tNow - m_tLastRequest > m_nIdleTimeout)
+        m_pSession.reset();
+
+    if (m_pSession == nullptr)
+    {
+        auto hSession = m_pTransport->OpenSession(m_sUserAgent, nStatusCode);
+        if (hSession == nullptr)
+            return nullptr;
+
+        m_pSession = std::make_shared<Session>(m_pTransport, hSession);
+        m_pSession->SetMaxConnectionsPerServer(m_nMaxConnectionsPerServer);
+    }
+
+    ++m_nActiveRequests;
+    return m_pSession;
+}
+
+void WindowsHttpRequester::ReleaseSession() const
+{
+    std::lock_guard<std::mutex> lock(m_mMutex);
+    --m_nActiveRequests;
+    m_tLastRequest = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+}
+
+unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWriter& pContentWriter,
+                                           Http::Validators& pValidators) const
+{
+    unsigned int nStatusCode = 0;
+
+    // obtain a session handle.
+    const auto pSession = GetSession(nStatusCode);
+    if (pSession == nullptr)
+        return nStatusCode;
+
+    INTERNET_PORT nPort = INTERNET_DEFAULT_HTTP_PORT;
+
+    auto sUrl = pRequest.GetUrl();
+    if (_strnicmp(sUrl.c_str(), "http://", 7) == 0)
+    {
+        sUrl.erase(0, 7);
+    }
+    else if (_strnicmp(sUrl.c_str(), "https://", 8) == 0)
+    {
+        sUrl.erase(0, 8);
+        nPort = INTERNET_DEFAULT_HTTPS_PORT;
+    }
+
+    std::string sPath;
+    const auto nIndex = sUrl.find('/');
+    if (nIndex != std::string::npos)
+    {
+        sPath.assign(sUrl, nIndex + 1, std::string::npos);
+        sUrl.resize(nIndex);
+    }
+
+    // specify the server. the connection handle is owned by the session and reused for later requests
+    const auto hConnect = pSession->GetConnection(ra::Widen(sUrl), nStatusCode);
+    if (hConnect != nullptr)
+    {
+        // merge query parameters onto sPath.
+        std::string sQueryString = pRequest.GetQueryString();
+        if (!sQueryString.empty())
+        {
+            sPath.push_back('?');
+            sPath += sQueryString;
         }
 
-        WinHttpCloseHandle(hSession);
+        nStatusCode = m_pTransport->Send(hConnect, ra::Widen(sPath), pRequest, pContentWriter, pValidators);
     }
 
+    ReleaseSession();
     return nStatusCode;
 }
 
@@ -12,17 +12,108 @@ namespace impl {
 
 #undef CreateDirectory
 
+/// <summary>
+/// Sends requests through WinHTTP.
+/// </summary>
+/// <remarks>
+/// A single WinHTTP session is shared by all requests, so connections (and their TLS state) are kept alive and
+/// reused between calls to the same server. A session that has been idle for longer than the idle timeout is
+/// replaced by the next request, which closes any pooled connections.
+/// </remarks>
 class WindowsHttpRequester : public IHttpRequester
 {
 public:
-    void SetUserAgent(const std::string& sUserAgent) override { m_sUserAgent = ra::Widen(sUserAgent); }
+    /// <summary>
+    /// Makes the WinHTTP calls that open and close handles and send the requests.
+    /// </summary>
+    /// <remarks>
+    /// Can be replaced so the session and connection handling can be tested without a network.
+    /// </remarks>
+    class Transport
+    {
+    public:
+        using Handle = void*; // HINTERNET
 
-    unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter) const override;
+        GSL_SUPPRESS_F6 Transport() = default;
+        virtual ~Transport() noexcept = default;
+        Transport(const Transport&) noexcept = delete;
+        Transport& operator=(const Transport&) noexcept = delete;
+        Transport(Transport&&) noexcept = delete;
+        Transport& operator=(Transport&&) noexcept = delete;
+
+        /// <summary>
+        /// Opens a session. Returns <c>nullptr</c> and sets <paramref name="nStatusCode" /> on failure.
+        /// </summary>
+        virtual Handle OpenSession(const std::wstring& sUserAgent, unsigned int& nStatusCode) const;
+
+        /// <summary>
+        /// Sets the maximum number of simultaneous connections a session will make to a single server.
+        /// </summary>
+        virtual void SetMaxConnectionsPerServer(Handle hSession, unsigned int nMaxConnections) const noexcept;
+
+        /// <summary>
+        /// Opens a connection to a server. Returns <c>nullptr</c> and sets <paramref name="nStatusCode" /> on
+        /// failure.
+        /// </summary>
+        virtual Handle Connect(Handle hSession, const std::wstring& sHostName, unsigned int& nStatusCode) const;
+
+        /// <summary>
+        /// Sends a request over a connection and reads the response.
+        /// </summary>
+        /// <returns>The HTTP status code, or the WinHTTP error code if the request could not be completed.</returns>
+        virtual unsigned int Send(Handle hConnect, const std::wstring& sPath, const Http::Request& pRequest,
+                                  TextWriter& pContentWriter, Http::Validators& pValidators) const;
+
+        /// <summary>
+        /// Closes a session or connection handle.
+        /// </summary>
+        virtual void Close(Handle hHandle) const noexcept;
+    };
+
+    GSL_SUPPRESS_F6 WindowsHttpRequester() : m_pTransport(std::make_shared<Transport>()) {}
+    explicit WindowsHttpRequester(std::shared_ptr<const Transport> pTransport) noexcept
+        : m_pTransport(std::move(pTransport))
+    {
+    }
+    ~WindowsHttpRequester() noexcept = default;
+    WindowsHttpRequester(const WindowsHttpRequester&) noexcept = delete;
+    WindowsHttpRequester& operator=(const WindowsHttpRequester&) noexcept = delete;
+    WindowsHttpRequester(WindowsHttpRequester&&) noexcept = delete;
+    WindowsHttpRequester& operator=(WindowsHttpRequester&&) noexcept = delete;
+
+    void SetUserAgent(const std::string& sUserAgent) override;
+
+    /// <summary>
+    /// Sets the maximum number of simultaneous connections to a single server.
+    /// </summary>
+    void SetMaxConnectionsPerServer(unsigned int nMaxConnections);
+
+    /// <summary>
+    /// Sets how long the pooled connections are kept after the last request completes.
+    /// </summary>
+    void SetIdleTimeout(std::chrono::milliseconds nIdleTimeout) noexcept { m_nIdleTimeout = nIdleTimeout; }
+
+    unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter,
+                         Http::Validators& pValidators) const override;
 
     bool IsRetryable(unsigned int nStatusCode) const noexcept override;
 
 private:
+    class Session;
+
+    std::shared_ptr<Session> GetSession(unsigned int& nStatusCode) const;
+    void ReleaseSession() const;
+
+    std::shared_ptr<const Transport> m_pTransport;
+
     std::wstring m_sUserAgent;
+    unsigned int m_nMaxConnectionsPerServer = 4;
+    std::chrono::milliseconds m_nIdleTimeout = std::chrono::seconds(60);
+
+    mutable std::mutex m_mMutex;
+    mutable std::shared_ptr<Session> m_pSession;
+    mutable unsigned int m_nActiveRequests = 0;
+    mutable std::chrono::steady_clock::time_point m_tLastRequest;
 };
 
 } // namespace impl
@@ -3,7 +3,9 @@
 #include "RA_Core.h"
 
 #include "services\Http.hh"
+#include "services\IClock.hh"
 #include "services\IFileSystem.hh"
+#include "services\ILocalStorage.hh"
 #include "services\IThreadPool.hh"
 #include "services\ServiceLocator.hh"
 
@@ -99,6 +101,28 @@ std::wstring ImageRepository::GetFilename(ImageType nType, const std::string& sN
     return sFilename;
 }
 
+bool ImageRepository::GetStorageItem(ImageType nType, const std::string& sName,
+                                     ra::services::StorageItemType& nStorageType, std::wstring& sKey)
+{
+    switch (nType)
+    {
+        case ImageType::Badge:
+            nStorageType = ra::services::StorageItemType::Badge;
+            sKey = ra::Widen(sName);
+            return true;
+        case ImageType::Icon:
+            nStorageType = ra::services::StorageItemType::Badge;
+            sKey = L"i" + ra::Widen(sName);
+            return true;
+        case ImageType::UserPic:
+            nStorageType = ra::services::StorageItemType::UserPic;
+            sKey = ra::Widen(sName);
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool ImageRepository::IsImageAvailable(ImageType nType, const std::string& sName) const
 {
     if (sName.empty())
@@ -126,12 +150,36 @@ void ImageRepository::FetchImage(ImageType nType, const std::string& sName)
         return;
 
     std::wstring sFilename = GetFilename(nType, sName);
+    ra::services::StorageItemType nStorageType = ra::services::StorageItemType::None;
+    std::wstring sKey;
+    const bool bHasStorageItem = GetStorageItem(nType, sName, nStorageType, sKey);
+
+    ra::services::Http::Validators pValidators;
     const auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
     if (pFileSystem.GetFileSize(sFilename) > 0)
-        return;
+    {
+        // the local copy is used as is. if it's been a while since it was downloaded, ask the server (once per
+        // session) whether it's been replaced - usually that only transfers the headers
+        if (!bHasStorageItem)
+            return;
+
+        const auto& pClock = ra::services::ServiceLocator::Get<ra::services::IClock>();
+        if (pFileSystem.GetLastModified(sFilename) > pClock.Now() - std::chrono::hours(24))
+            return;
+
+        pValidators = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>().GetValidators(nStorageType, sKey);
+        if (pValidators.IsEmpty())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_oMutex);
+        if (m_vRevalidatedImages.find(sFilename) != m_vRevalidatedImages.end())
+            return;
 
-    // check to see if it's already queued
+        m_vRevalidatedImages.emplace(sFilename);
+    }
+    else
     {
+        // check to see if it's already queued
         std::lock_guard<std::mutex> lock(m_oMutex);
         if (m_vRequestedImages.find(sFilename) != m_vRequestedImages.end())
             return;
@@ -163,12 +211,29 @@ void ImageRepository::FetchImage(ImageType nType, const std::string& sName)
     RA_LOG_INFO("Downloading %s", sUrl.c_str());
 
     ra::services::Http::Request request(sUrl);
-    request.DownloadAsync(sFilename, [this,sFilename,sUrl,nType,sName](const ra::services::Http::Response& response)
+    request.SetValidators(pValidators);
+    request.DownloadAsync(sFilename, [this, sFilename, sUrl, nType, sName, nStorageType, sKey, bHasStorageItem](
+                                         const ra::services::Http::Response& response)
     {
         if (response.StatusCode() == ra::services::Http::StatusCode::OK)
         {
             auto nFileSize = ra::services::ServiceLocator::Get<ra::services::IFileSystem>().GetFileSize(sFilename);
             RA_LOG_INFO("Wrote %lu bytes to %s", nFileSize, ra::Narrow(sFilename).c_str());
+
+            if (bHasStorageItem)
+            {
+                auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+                pLocalStorage.SetValidators(nStorageType, sKey, response.GetValidators());
+            }
+        }
+        else if (response.StatusCode() == ra::services::Http::StatusCode::NotModified)
+        {
+            // the local copy is still current. mark it as checked so it isn't revalidated again for another day
+            RA_LOG_INFO("%s not modified", sUrl.c_str());
+
+            const auto& pClock = ra::services::ServiceLocator::Get<ra::services::IClock>();
+            ra::services::ServiceLocator::Get<ra::services::IFileSystem>().SetLastModified(sFilename, pClock.Now());
+            return;
         }
         else
         {
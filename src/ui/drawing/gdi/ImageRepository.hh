@@ -2,6 +2,8 @@
 #define RA_UI_DRAWING_GDI_IMAGEREPOSITORY_HH
 #pragma once
 
+#include "services\ILocalStorage.hh"
+
 #include "ui\ImageReference.hh"
 
 namespace ra {
@@ -48,6 +50,8 @@ public:
 
 private:
     static std::wstring GetFilename(ImageType nType, const std::string& sName);
+    static bool GetStorageItem(ImageType nType, const std::string& sName,
+                               ra::services::StorageItemType& nStorageType, std::wstring& sKey);
     static HBITMAP LoadLocalPNG(const std::wstring& sFilename, size_t nWidth, size_t nHeight);
 
     HBITMAP GetImage(ImageType nType, const std::string& sName);
@@ -62,6 +66,7 @@ private:
 
     std::mutex m_oMutex;
     std::set<std::wstring> m_vRequestedImages;
+    std::set<std::wstring> m_vRevalidatedImages; // existing images that have been checked against the server
     bool m_bShutdownCOM = false;
 };
 
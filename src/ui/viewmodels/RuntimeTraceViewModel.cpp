@@ -0,0 +1,105 @@
+#include "RuntimeTraceViewModel.hh"
+
+#include "RA_StringUtils.h"
+
+#include "services\AchievementRuntime.hh"
+#include "services\ILocalStorage.hh"
+#include "services\ServiceLocator.hh"
+#include "services\impl\StringTextReader.hh"
+#include "services\impl\StringTextWriter.hh"
+
+namespace ra {
+namespace ui {
+namespace viewmodels {
+
+const StringModelProperty RuntimeTraceViewModel::HistoryProperty("RuntimeTraceViewModel", "History",
+                                                                 L"No history has been recorded for this achievement.");
+
+RuntimeTraceViewModel::RuntimeTraceViewModel() noexcept
+{
+    GSL_SUPPRESS_F6 SetWindowTitle(L"Achievement History");
+}
+
+void RuntimeTraceViewModel::Load(unsigned int nId)
+{
+    SetWindowTitle(ra::StringPrintf(L"Achievement History - %u", nId));
+
+    const auto& pRuntime = ra::services::ServiceLocator::Get<ra::services::AchievementRuntime>();
+    const auto* pTrace = pRuntime.GetTrace(nId);
+    if (pTrace != nullptr && pTrace->GetFrameCount() > 0)
+    {
+        // format a copy so the view doesn't depend on the trace, which is discarded when the achievement is deactivated
+        std::string sTrace;
+        ra::services::impl::StringTextWriter pWriter(sTrace);
+        pTrace->Write(pWriter);
+
+        ra::services::impl::StringTextReader pReader(sTrace);
+        SetHistory(FormatHistory(pReader));
+        return;
+    }
+
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pReader = pLocalStorage.ReadText(ra::services::StorageItemType::RuntimeTrace, std::to_wstring(nId));
+    if (pReader != nullptr)
+        SetHistory(FormatHistory(*pReader));
+    else
+        SetValue(HistoryProperty, HistoryProperty.GetDefaultValue());
+}
+
+std::wstring RuntimeTraceViewModel::FormatHistory(ra::services::TextReader& pReader)
+{
+    // see RuntimeTrace::Write for the format
+    std::string sLine;
+    if (!pReader.GetLine(sLine))
+        return HistoryProperty.GetDefaultValue();
+
+    std::wstring sHistory = L"Conditions are numbered through the core group followed by each alt group.\r\n"
+                            L"T = true, . = false, n:+x = hit count of condition n changed by x\r\n\r\n";
+
+    while (pReader.GetLine(sLine))
+    {
+        const auto nTruthIndex = sLine.find(':');
+        if (nTruthIndex == std::string::npos)
+            break;
+
+        const auto nDeltasIndex = sLine.find(':', nTruthIndex + 1);
+        if (nDeltasIndex == std::string::npos)
+            break;
+
+        // right align the frame numbers
+        constexpr size_t nFrameWidth = 10;
+        std::string sFormatted;
+        if (nTruthIndex < nFrameWidth)
+            sFormatted.assign(nFrameWidth - nTruthIndex, ' ');
+        sFormatted.append(sLine, 0, nTruthIndex);
+        sFormatted.append("  ");
+
+        for (auto nIndex = nTruthIndex + 1; nIndex < nDeltasIndex; ++nIndex)
+            sFormatted.push_back(sLine.at(nIndex) == '1' ? 'T' : '.');
+
+        unsigned int nCondition = 1;
+        size_t nStart = nDeltasIndex + 1;
+        while (nStart < sLine.length())
+        {
+            auto nEnd = sLine.find(',', nStart);
+            if (nEnd == std::string::npos)
+                nEnd = sLine.length();
+
+            const auto sDelta = sLine.substr(nStart, nEnd - nStart);
+            if (!sDelta.empty() && sDelta != "0")
+                sFormatted.append(ra::StringPrintf("  %u:%s%s", nCondition, sDelta.front() == '-' ? "" : "+", sDelta));
+
+            ++nCondition;
+            nStart = nEnd + 1;
+        }
+
+        sHistory.append(ra::Widen(sFormatted));
+        sHistory.append(L"\r\n");
+    }
+
+    return sHistory;
+}
+
+} // namespace viewmodels
+} // namespace ui
+} // namespace ra
@@ -0,0 +1,51 @@
+#ifndef RA_UI_RUNTIMETRACEVIEWMODEL_H
+#define RA_UI_RUNTIMETRACEVIEWMODEL_H
+#pragma once
+
+#include "ui/WindowViewModelBase.hh"
+
+#include "services/TextReader.hh"
+
+namespace ra {
+namespace ui {
+namespace viewmodels {
+
+class RuntimeTraceViewModel : public WindowViewModelBase
+{
+public:
+    GSL_SUPPRESS_F6 RuntimeTraceViewModel() noexcept;
+
+    /// <summary>
+    /// The <see cref="ModelProperty" /> for the formatted history.
+    /// </summary>
+    static const StringModelProperty HistoryProperty;
+
+    /// <summary>
+    /// Gets the formatted history.
+    /// </summary>
+    const std::wstring& GetHistory() const { return GetValue(HistoryProperty); }
+
+    /// <summary>
+    /// Loads the condition history of an achievement.
+    /// </summary>
+    /// <remarks>
+    /// Uses the frames currently being recorded if the achievement is active, otherwise the history that was
+    /// written when it last triggered.
+    /// </remarks>
+    void Load(unsigned int nId);
+
+protected:
+    /// <summary>
+    /// Sets the formatted history.
+    /// </summary>
+    void SetHistory(const std::wstring& sValue) { SetValue(HistoryProperty, sValue); }
+
+private:
+    static std::wstring FormatHistory(ra::services::TextReader& pReader);
+};
+
+} // namespace viewmodels
+} // namespace ui
+} // namespace ra
+
+#endif !RA_UI_RUNTIMETRACEVIEWMODEL_H
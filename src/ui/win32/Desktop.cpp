@@ -9,6 +9,7 @@
 #include "ui/win32/LoginDialog.hh"
 #include "ui/win32/MessageBoxDialog.hh"
 #include "ui/win32/RichPresenceDialog.hh"
+#include "ui/win32/RuntimeTraceDialog.hh"
 #include "ui/win32/UnknownGameDialog.hh"
 
 #include "RA_Log.h"
@@ -26,6 +27,7 @@ Desktop::Desktop() noexcept
     m_vDialogPresenters.emplace_back(new (std::nothrow) LoginDialog::Presenter);
     m_vDialogPresenters.emplace_back(new (std::nothrow) BrokenAchievementsDialog::Presenter);
     m_vDialogPresenters.emplace_back(new (std::nothrow) UnknownGameDialog::Presenter);
+    m_vDialogPresenters.emplace_back(new (std::nothrow) RuntimeTraceDialog::Presenter);
 }
 
 void Desktop::ShowWindow(WindowViewModelBase& vmViewModel) const
@@ -0,0 +1,54 @@
+#include "RuntimeTraceDialog.hh"
+
+#include "RA_Core.h"
+#include "RA_Resource.h"
+
+namespace ra {
+namespace ui {
+namespace win32 {
+
+bool RuntimeTraceDialog::Presenter::IsSupported(const ra::ui::WindowViewModelBase& vmViewModel) noexcept
+{
+    return (dynamic_cast<const ra::ui::viewmodels::RuntimeTraceViewModel*>(&vmViewModel) != nullptr);
+}
+
+void RuntimeTraceDialog::Presenter::ShowModal(ra::ui::WindowViewModelBase& vmViewModel, HWND hParentWnd)
+{
+    auto& vmRuntimeTrace = reinterpret_cast<ra::ui::viewmodels::RuntimeTraceViewModel&>(vmViewModel);
+
+    RuntimeTraceDialog oDialog(vmRuntimeTrace);
+    oDialog.CreateModalWindow(MAKEINTRESOURCE(IDD_RA_RUNTIMETRACE), this, hParentWnd);
+}
+
+void RuntimeTraceDialog::Presenter::ShowWindow(ra::ui::WindowViewModelBase& oViewModel)
+{
+    ShowModal(oViewModel, nullptr);
+}
+
+// ------------------------------------
+
+_Use_decl_annotations_
+RuntimeTraceDialog::RuntimeTraceDialog(ra::ui::viewmodels::RuntimeTraceViewModel& vmRuntimeTrace)
+    : DialogBase(vmRuntimeTrace)
+{
+    // the truth columns only line up in a fixed width font
+    m_hFont = CreateFont(14, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, CLEARTYPE_QUALITY, FIXED_PITCH | FF_MODERN, nullptr);
+
+    m_bindWindow.SetInitialPosition(RelativePosition::Center, RelativePosition::Center);
+    m_bindWindow.BindLabel(IDC_RA_RUNTIMETRACETEXT, ra::ui::viewmodels::RuntimeTraceViewModel::HistoryProperty);
+}
+
+RuntimeTraceDialog::~RuntimeTraceDialog() noexcept
+{
+    DeleteFont(m_hFont);
+}
+
+BOOL RuntimeTraceDialog::OnInitDialog()
+{
+    SetWindowFont(::GetDlgItem(GetHWND(), IDC_RA_RUNTIMETRACETEXT), m_hFont, FALSE);
+    return DialogBase::OnInitDialog();
+}
+
+} // namespace win32
+} // namespace ui
+} // namespace ra
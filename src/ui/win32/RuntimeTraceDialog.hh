@@ -0,0 +1,42 @@
+#ifndef RA_UI_WIN32_DLG_RUNTIMETRACE_H
+#define RA_UI_WIN32_DLG_RUNTIMETRACE_H
+#pragma once
+
+#include "ui/viewmodels/RuntimeTraceViewModel.hh"
+#include "ui/win32/DialogBase.hh"
+#include "ui/win32/IDialogPresenter.hh"
+
+namespace ra {
+namespace ui {
+namespace win32 {
+
+class RuntimeTraceDialog : public DialogBase
+{
+public:
+    explicit RuntimeTraceDialog(_Inout_ ra::ui::viewmodels::RuntimeTraceViewModel& vmRuntimeTrace);
+    virtual ~RuntimeTraceDialog() noexcept;
+    RuntimeTraceDialog(const RuntimeTraceDialog&) noexcept = delete;
+    RuntimeTraceDialog& operator=(const RuntimeTraceDialog&) noexcept = delete;
+    RuntimeTraceDialog(RuntimeTraceDialog&&) noexcept = delete;
+    RuntimeTraceDialog& operator=(RuntimeTraceDialog&&) noexcept = delete;
+
+    class Presenter : public IDialogPresenter
+    {
+    public:
+        bool IsSupported(const ra::ui::WindowViewModelBase& viewModel) noexcept override;
+        void ShowWindow(ra::ui::WindowViewModelBase& viewModel) override;
+        void ShowModal(ra::ui::WindowViewModelBase& viewModel, HWND hParentWnd) override;
+    };
+
+protected:
+    BOOL OnInitDialog() override;
+
+private:
+    HFONT m_hFont = nullptr;
+};
+
+} // namespace win32
+} // namespace ui
+} // namespace ra
+
+#endif // !RA_UI_WIN32_DLG_RUNTIMETRACE_H
@@ -13,6 +13,7 @@
 #include "tests\mocks\MockOverlayTheme.hh"
 #include "tests\mocks\MockServer.hh"
 #include "tests\mocks\MockSessionTracker.hh"
+#include "tests\mocks\MockSubmissionJournal.hh"
 #include "tests\mocks\MockSurface.hh"
 #include "tests\mocks\MockThreadPool.hh"
 #include "tests\mocks\MockUserContext.hh"
@@ -31,6 +32,7 @@ using ra::api::mocks::MockServer;
 using ra::data::mocks::MockEmulatorContext;
 using ra::data::mocks::MockGameContext;
 using ra::data::mocks::MockSessionTracker;
+using ra::data::mocks::MockSubmissionJournal;
 using ra::data::mocks::MockUserContext;
 using ra::services::mocks::MockAudioSystem;
 using ra::services::mocks::MockConfiguration;
@@ -81,6 +83,7 @@ private:
     public:
         MockUserContext mockUserContext;
         MockSessionTracker mockSessionTracker;
+        MockSubmissionJournal mockSubmissionJournal;
         MockConfiguration mockConfiguration;
         MockAudioSystem mockAudioSystem;
         MockServer mockServer;
@@ -157,6 +160,7 @@ public:
 
         // session context
         Assert::AreEqual(std::wstring(L"User"), harness.mockSessionTracker.GetUsername());
+        Assert::AreEqual(std::wstring(L"User"), harness.mockSubmissionJournal.GetUsername());
 
         // popup notification and sound
         Assert::IsTrue(harness.mockAudioSystem.WasAudioFilePlayed(L"Overlay\\login.wav"));
@@ -404,6 +408,7 @@ private:
         MockThreadPool mockThreadPool;
         MockServer mockServer;
         MockUserContext mockUserContext;
+        MockSubmissionJournal mockSubmissionJournal;
 
         std::set<unsigned int> m_vUnlockedAchievements;
         std::map<ra::LeaderboardID, unsigned int> m_vSubmittedLeaderboardEntries;
@@ -477,6 +482,32 @@ public:
         Assert::IsTrue(bWasPaused);
     }
 
+    TEST_METHOD(TestDoAchievementsFrameReentrant)
+    {
+        DoAchievementsFrameHarness harness;
+        harness.MockAchievement(1U);
+        harness.MockAchievement(2U);
+        harness.MockAchievement(3U);
+        harness.mockGameContext.FindAchievement(1U)->SetPauseOnTrigger(true);
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::AchievementTriggered, 1U);
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::AchievementTriggered, 2U);
+
+        // the message box pumps messages, which can cause the emulator to process another frame
+        harness.mockDesktop.ExpectWindow<ra::ui::viewmodels::MessageBoxViewModel>([&harness](ra::ui::viewmodels::MessageBoxViewModel&)
+        {
+            harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::AchievementTriggered, 3U);
+            _RA_DoAchievementsFrame();
+            return ra::ui::DialogResult::OK;
+        });
+
+        _RA_DoAchievementsFrame();
+
+        // the nested frame should not have affected the changes from the outer frame
+        Assert::IsTrue(harness.WasUnlocked(1U));
+        Assert::IsTrue(harness.WasUnlocked(3U));
+        Assert::IsTrue(harness.WasUnlocked(2U));
+    }
+
     TEST_METHOD(TestDoAchievementsFramePauseOnReset)
     {
         DoAchievementsFrameHarness harness;
@@ -641,6 +672,55 @@ public:
         Ensures(pScore4 != nullptr);
         Assert::AreEqual(std::wstring(L"5678"), pScore4->GetDisplayText());
     }
+
+    TEST_METHOD(TestDoAchievementsFrameBatchedLeaderboardUpdated)
+    {
+        DoAchievementsFrameHarness harness;
+        harness.mockGameContext.NewLeaderboard(1U);
+        harness.mockOverlayManager.AddScoreTracker(1U);
+        harness.mockOverlayManager.GetScoreTracker(1U)->SetDisplayText(L"0");
+
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated, 1U, 1235U);
+        _RA_DoAchievementsFrameBatched();
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated, 1U, 1236U);
+        _RA_DoAchievementsFrameBatched();
+
+        // updates are deferred until the next rendered frame
+        const auto* pScore = harness.mockOverlayManager.GetScoreTracker(1U);
+        Assert::IsNotNull(pScore);
+        Ensures(pScore != nullptr);
+        Assert::AreEqual(std::wstring(L"0"), pScore->GetDisplayText());
+
+        _RA_DoAchievementsFrame();
+        Assert::AreEqual(std::wstring(L"1236"), pScore->GetDisplayText());
+    }
+
+    TEST_METHOD(TestDoAchievementsFrameBatchedLeaderboardUpdatedThenTriggered)
+    {
+        DoAchievementsFrameHarness harness;
+        harness.mockConfiguration.SetFeatureEnabled(ra::services::Feature::Hardcore, true);
+        harness.mockGameContext.NewLeaderboard(1U);
+        harness.mockOverlayManager.AddScoreTracker(1U);
+
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::LeaderboardUpdated, 1U, 1235U);
+        _RA_DoAchievementsFrameBatched();
+        harness.mockRuntime.QueueChange(ra::services::AchievementRuntime::ChangeType::LeaderboardTriggered, 1U, 1236U);
+        _RA_DoAchievementsFrameBatched();
+
+        // submissions are not deferred
+        Assert::AreEqual(1236U, harness.GetSubmittedScore(1U));
+        Assert::IsNull(harness.mockOverlayManager.GetScoreTracker(1U));
+
+        // the pending update was discarded and should not recreate the score tracker
+        _RA_DoAchievementsFrame();
+        Assert::IsNull(harness.mockOverlayManager.GetScoreTracker(1U));
+    }
+
+    TEST_METHOD(TestStartMemoryTraceNoFilename)
+    {
+        Assert::AreEqual(0, _RA_StartMemoryTrace(nullptr));
+        Assert::AreEqual(0, _RA_StartMemoryTrace(""));
+    }
 };
 
 } // namespace tests
@@ -89,8 +89,13 @@ public:
         Assert::IsNotNull((const void*)_RA_SetPaused);
         Assert::IsNotNull((const void*)_RA_OnLoadState);
         Assert::IsNotNull((const void*)_RA_OnSaveState);
+        Assert::IsNotNull((const void*)_RA_CaptureState);
+        Assert::IsNotNull((const void*)_RA_RestoreState);
         Assert::IsNotNull((const void*)_RA_OnReset);
         Assert::IsNotNull((const void*)_RA_DoAchievementsFrame);
+        Assert::IsNotNull((const void*)_RA_DoAchievementsFrameBatched);
+        Assert::IsNotNull((const void*)_RA_StartMemoryTrace);
+        Assert::IsNotNull((const void*)_RA_StopMemoryTrace);
         Assert::IsNotNull((const void*)_RA_SetConsoleID);
         Assert::IsNotNull((const void*)_RA_HardcoreModeIsActive);
         Assert::IsNotNull((const void*)_RA_WarnDisableHardcore);
@@ -122,8 +127,13 @@ public:
         Assert::IsNull((const void*)_RA_SetPaused);
         Assert::IsNull((const void*)_RA_OnLoadState);
         Assert::IsNull((const void*)_RA_OnSaveState);
+        Assert::IsNull((const void*)_RA_CaptureState);
+        Assert::IsNull((const void*)_RA_RestoreState);
         Assert::IsNull((const void*)_RA_OnReset);
         Assert::IsNull((const void*)_RA_DoAchievementsFrame);
+        Assert::IsNull((const void*)_RA_DoAchievementsFrameBatched);
+        Assert::IsNull((const void*)_RA_StartMemoryTrace);
+        Assert::IsNull((const void*)_RA_StopMemoryTrace);
         Assert::IsNull((const void*)_RA_SetConsoleID);
         Assert::IsNull((const void*)_RA_HardcoreModeIsActive);
         Assert::IsNull((const void*)_RA_WarnDisableHardcore);
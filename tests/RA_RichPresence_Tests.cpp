@@ -453,6 +453,91 @@ public:
         memory.at(0) = 3; // this clears the hit count on the second, so the default is shown
         Assert::AreEqual("Default", rp.GetRichPresenceString().c_str());
     }
+
+    TEST_METHOD(TestHitTargetWhileMemoryUnchanged)
+    {
+        std::array<unsigned char, 5> memory{0x01, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        RichPresenceInterpreterHarness rp;
+        rp.LoadTest("Display:\n?0xh00=1.3.?Three\nDefault");
+
+        // the memory doesn't change, but each evaluation should still advance the hit count
+        Assert::AreEqual("Default", rp.GetRichPresenceString().c_str());
+        Assert::AreEqual("Default", rp.GetRichPresenceString().c_str());
+        Assert::AreEqual("Three", rp.GetRichPresenceString().c_str());
+    }
+
+    TEST_METHOD(TestUnreferencedMemoryChange)
+    {
+        std::array<unsigned char, 5> memory{0x00, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        RichPresenceInterpreterHarness rp;
+        rp.LoadTest("Format:Points\nFormatType=VALUE\n\nDisplay:\n@Points(0xH0001) Points");
+        Assert::AreEqual("18 Points", rp.GetRichPresenceString().c_str());
+
+        memory.at(2) = 0;
+        Assert::AreEqual("18 Points", rp.GetRichPresenceString().c_str());
+
+        memory.at(1) = 0;
+        Assert::AreEqual("0 Points", rp.GetRichPresenceString().c_str());
+    }
+
+    TEST_METHOD(TestDeltaAfterMemoryStopsChanging)
+    {
+        std::array<unsigned char, 5> memory{0x00, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        RichPresenceInterpreterHarness rp;
+        rp.LoadTest("Format:Points\nFormatType=VALUE\n\nDisplay:\n@Points(d0xH0001) Points");
+        rp.GetRichPresenceString();
+        Assert::AreEqual("18 Points", rp.GetRichPresenceString().c_str());
+
+        // the delta still reports the old value, so the next evaluation must not be skipped even though the
+        // memory doesn't change again
+        memory.at(1) = 20;
+        Assert::AreEqual("18 Points", rp.GetRichPresenceString().c_str());
+        Assert::AreEqual("20 Points", rp.GetRichPresenceString().c_str());
+        Assert::AreEqual("20 Points", rp.GetRichPresenceString().c_str());
+    }
+
+    TEST_METHOD(TestOnlyChangedFragmentUpdated)
+    {
+        std::array<unsigned char, 5> memory{0x00, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        RichPresenceInterpreterHarness rp;
+        rp.LoadTest("Format:Points\nFormatType=VALUE\n\nLookup:Location\n0=Zero\n1=One\n\n"
+                    "Display:\n?0xH0004=0?Paused\n@Location(0xH0000): @Points(0xH0001) and @Points(0xH0002)");
+        Assert::AreEqual("Zero: 18 and 52", rp.GetRichPresenceString().c_str());
+
+        memory.at(2) = 0;
+        Assert::AreEqual("Zero: 18 and 0", rp.GetRichPresenceString().c_str());
+
+        memory.at(0) = 1;
+        Assert::AreEqual("One: 18 and 0", rp.GetRichPresenceString().c_str());
+
+        // switching to another display string and back formats everything again
+        memory.at(4) = 0;
+        Assert::AreEqual("Paused", rp.GetRichPresenceString().c_str());
+        memory.at(1) = 3;
+        memory.at(4) = 1;
+        Assert::AreEqual("One: 3 and 0", rp.GetRichPresenceString().c_str());
+    }
+
+    TEST_METHOD(TestReloadScript)
+    {
+        std::array<unsigned char, 5> memory{0x00, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        RichPresenceInterpreterHarness rp;
+        rp.LoadTest("Display:\nFirst");
+        Assert::AreEqual("First", rp.GetRichPresenceString().c_str());
+
+        rp.LoadTest("Display:\nSecond");
+        Assert::AreEqual("Second", rp.GetRichPresenceString().c_str());
+    }
 };
 
 } // namespace tests
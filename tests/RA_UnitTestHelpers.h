@@ -148,6 +148,26 @@ std::wstring ToString<ra::api::ApiResult>(const ra::api::ApiResult& result)
     }
 }
 
+template<>
+std::wstring ToString<ra::services::TaskPriority>(const ra::services::TaskPriority& nPriority)
+{
+    switch (nPriority)
+    {
+        case ra::services::TaskPriority::Critical:
+            return L"Critical";
+        case ra::services::TaskPriority::High:
+            return L"High";
+        case ra::services::TaskPriority::Normal:
+            return L"Normal";
+        case ra::services::TaskPriority::Low:
+            return L"Low";
+        case ra::services::TaskPriority::Idle:
+            return L"Idle";
+        default:
+            return std::to_wstring(ra::etoi(nPriority));
+    }
+}
+
 template<> std::wstring ToString<ra::ui::ImageType>(const ra::ui::ImageType& type)
 {
     switch (type)
@@ -6,6 +6,7 @@
 
 #include "tests\RA_UnitTestHelpers.h"
 #include "tests\mocks\MockHttpRequester.hh"
+#include "tests\mocks\MockLocalStorage.hh"
 #include "tests\mocks\MockServer.hh"
 #include "tests\mocks\MockThreadPool.hh"
 
@@ -14,6 +15,7 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using ra::api::impl::ConnectedServer;
 using ra::api::mocks::MockServer;
 using ra::services::mocks::MockHttpRequester;
+using ra::services::mocks::MockLocalStorage;
 using ra::services::mocks::MockThreadPool;
 using ra::services::Http;
 
@@ -23,6 +25,16 @@ namespace tests {
 
 TEST_CLASS(ConnectedServer_Tests)
 {
+private:
+    static constexpr const char* PatchData =
+        "{\"Success\":true,\"PatchData\":{\"ID\":3,\"Title\":\"Game\",\"ConsoleID\":7,\"ImageIcon\":\"/Images/012345.png\","
+        "\"Achievements\":[{\"ID\":55,\"MemAddr\":\"0xH0000=1\",\"Title\":\"Ach1\",\"Description\":\"Desc1\","
+        "\"Points\":10,\"Author\":\"Auth1\",\"Modified\":1234599999,\"Created\":1234567890,"
+        "\"BadgeName\":\"00111\",\"Flags\":3}],\"Leaderboards\":[]}}";
+
+    static constexpr const char* CodeNotes =
+        "{\"Success\":true,\"CodeNotes\":[{\"User\":\"Author1\",\"Address\":\"0x001234\",\"Note\":\"Note1\"}]}";
+
 public:
     // ConnectedServer manages converting the Http error codes to Incomplete responses, this just tests the handling
     // of Incomplete responses by the ApiRequestBase.
@@ -386,6 +398,132 @@ public:
         Assert::AreEqual(0U, response.NumUnreadMessages);
     }
 
+    // ====================================================
+    // FetchGameData
+
+    TEST_METHOD(TestFetchGameDataNotModified)
+    {
+        MockLocalStorage mockStorage;
+        mockStorage.MockStoredData(ra::services::StorageItemType::GameData, L"3", PatchData);
+        mockStorage.SetValidators(ra::services::StorageItemType::GameData, L"3", {"\"abc\"", ""});
+
+        int nRequests = 0;
+        MockHttpRequester mockHttp([&nRequests](const Http::Request& request)
+        {
+            ++nRequests;
+            Assert::AreEqual(std::string("host.com/dorequest.php"), request.GetUrl());
+            Assert::AreEqual(std::string("\"abc\""), request.GetValidators().ETag);
+            return Http::Response(Http::StatusCode::NotModified, "");
+        });
+
+        ConnectedServer server("host.com");
+
+        FetchGameData::Request request;
+        request.GameId = 3U;
+        const auto response = server.FetchGameData(request);
+
+        Assert::AreEqual(1, nRequests);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(std::wstring(L"Game"), response.Title);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Achievements.size()));
+        Assert::AreEqual(55U, response.Achievements.at(0).Id);
+
+        // the validators are kept for the next request
+        Assert::AreEqual(std::string("\"abc\""), mockStorage.GetValidators(ra::services::StorageItemType::GameData, L"3").ETag);
+    }
+
+    TEST_METHOD(TestFetchGameDataNotModifiedCacheUnusable)
+    {
+        MockLocalStorage mockStorage;
+        mockStorage.MockStoredData(ra::services::StorageItemType::GameData, L"3", "{\"Success\":true,\"PatchData\":{\"ID\":3,");
+        mockStorage.SetValidators(ra::services::StorageItemType::GameData, L"3", {"\"abc\"", ""});
+
+        int nRequests = 0;
+        MockHttpRequester mockHttp([&nRequests](const Http::Request& request)
+        {
+            ++nRequests;
+            if (!request.GetValidators().IsEmpty())
+                return Http::Response(Http::StatusCode::NotModified, "");
+
+            return Http::Response(Http::StatusCode::OK, PatchData, {"\"def\"", ""});
+        });
+
+        ConnectedServer server("host.com");
+
+        FetchGameData::Request request;
+        request.GameId = 3U;
+        const auto response = server.FetchGameData(request);
+
+        // the corrupt copy is discarded and the full patch data is requested
+        Assert::AreEqual(2, nRequests);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(std::wstring(L"Game"), response.Title);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Achievements.size()));
+
+        Assert::AreEqual(std::string(PatchData), mockStorage.GetStoredData(ra::services::StorageItemType::GameData, L"3"));
+        Assert::AreEqual(std::string("\"def\""), mockStorage.GetValidators(ra::services::StorageItemType::GameData, L"3").ETag);
+    }
+
+    // ====================================================
+    // FetchCodeNotes
+
+    TEST_METHOD(TestFetchCodeNotesNotModified)
+    {
+        MockLocalStorage mockStorage;
+        mockStorage.MockStoredData(ra::services::StorageItemType::CodeNotes, L"3", CodeNotes);
+        mockStorage.SetValidators(ra::services::StorageItemType::CodeNotes, L"3", {"", "Wed, 21 Oct 2015 07:28:00 GMT"});
+
+        int nRequests = 0;
+        MockHttpRequester mockHttp([&nRequests](const Http::Request& request)
+        {
+            ++nRequests;
+            Assert::AreEqual(std::string("Wed, 21 Oct 2015 07:28:00 GMT"), request.GetValidators().LastModified);
+            return Http::Response(Http::StatusCode::NotModified, "");
+        });
+
+        ConnectedServer server("host.com");
+
+        FetchCodeNotes::Request request;
+        request.GameId = 3U;
+        const auto response = server.FetchCodeNotes(request);
+
+        Assert::AreEqual(1, nRequests);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Notes.size()));
+        Assert::AreEqual(0x1234U, response.Notes.at(0).Address);
+        Assert::AreEqual(std::wstring(L"Note1"), response.Notes.at(0).Note);
+    }
+
+    TEST_METHOD(TestFetchCodeNotesNotModifiedCacheUnusable)
+    {
+        MockLocalStorage mockStorage;
+        mockStorage.MockStoredData(ra::services::StorageItemType::CodeNotes, L"3", "{\"Success\":true,\"CodeNotes\":[{\"User\":");
+        mockStorage.SetValidators(ra::services::StorageItemType::CodeNotes, L"3", {"\"abc\"", ""});
+
+        int nRequests = 0;
+        MockHttpRequester mockHttp([&nRequests](const Http::Request& request)
+        {
+            ++nRequests;
+            if (!request.GetValidators().IsEmpty())
+                return Http::Response(Http::StatusCode::NotModified, "");
+
+            return Http::Response(Http::StatusCode::OK, CodeNotes, {"\"def\"", ""});
+        });
+
+        ConnectedServer server("host.com");
+
+        FetchCodeNotes::Request request;
+        request.GameId = 3U;
+        const auto response = server.FetchCodeNotes(request);
+
+        // the corrupt copy is discarded and the notes are requested again
+        Assert::AreEqual(2, nRequests);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Notes.size()));
+        Assert::AreEqual(std::wstring(L"Note1"), response.Notes.at(0).Note);
+        Assert::AreEqual(std::string("\"def\""), mockStorage.GetValidators(ra::services::StorageItemType::CodeNotes, L"3").ETag);
+    }
+
     // ====================================================
     // Logout
 
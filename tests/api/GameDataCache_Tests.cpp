@@ -0,0 +1,186 @@
+#include "CppUnitTest.h"
+
+#include "api\impl\GameDataCache.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+#include "tests\mocks\MockLocalStorage.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using ra::services::StorageItemType;
+
+namespace ra {
+namespace api {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(GameDataCache_Tests)
+{
+private:
+    static FetchGameData::Response CreateResponse()
+    {
+        FetchGameData::Response response;
+        response.Title = L"Game Title";
+        response.ConsoleId = 7U;
+        response.ForumTopicId = 1234U;
+        response.Flags = 3U;
+        response.ImageIcon = "012345";
+        response.RichPresence = "Display:\nHello";
+
+        auto& pAchievement = response.Achievements.emplace_back();
+        pAchievement.Id = 55U;
+        pAchievement.Title = "Ach1";
+        pAchievement.Description = "Desc1";
+        pAchievement.CategoryId = 3U;
+        pAchievement.Points = 10U;
+        pAchievement.Definition = "0xH0000=1";
+        pAchievement.Author = "Auth1";
+        pAchievement.BadgeName = "00111";
+        pAchievement.Created = 1234567890;
+        pAchievement.Updated = 1234599999;
+
+        auto& pLeaderboard = response.Leaderboards.emplace_back();
+        pLeaderboard.Id = 77U;
+        pLeaderboard.Title = "LB1";
+        pLeaderboard.Description = "LBDesc1";
+        pLeaderboard.Definition = "STA:0xH0000=1::CAN:0xH0000=2::SUB:0xH0000=3::VAL:0xH0001";
+        pLeaderboard.Format = "SCORE";
+
+        GameDataCache::CalculateDefinitionSizes(response);
+        return response;
+    }
+
+public:
+    TEST_METHOD(TestCalculateDefinitionSizes)
+    {
+        const auto response = CreateResponse();
+        Assert::AreEqual(rc_trigger_size("0xH0000=1"), response.Achievements.at(0).DefinitionSize);
+        Assert::AreEqual(rc_lboard_size(response.Leaderboards.at(0).Definition.c_str()),
+                         response.Leaderboards.at(0).DefinitionSize);
+    }
+
+    TEST_METHOD(TestRoundTrip)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        const auto original = CreateResponse();
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", original));
+        Assert::IsTrue(mockStorage.HasStoredData(StorageItemType::GameDataCache, L"1"));
+
+        FetchGameData::Response response;
+        Assert::IsTrue(GameDataCache::Read(1U, "HASH", response));
+        Assert::AreEqual(std::wstring(L"Game Title"), response.Title);
+        Assert::AreEqual(7U, response.ConsoleId);
+        Assert::AreEqual(1234U, response.ForumTopicId);
+        Assert::AreEqual(3U, response.Flags);
+        Assert::AreEqual(std::string("012345"), response.ImageIcon);
+        Assert::AreEqual(std::string("Display:\nHello"), response.RichPresence);
+
+        Assert::AreEqual(1U, response.Achievements.size());
+        const auto& pAchievement = response.Achievements.at(0);
+        Assert::AreEqual(55U, pAchievement.Id);
+        Assert::AreEqual(std::string("Ach1"), pAchievement.Title);
+        Assert::AreEqual(std::string("Desc1"), pAchievement.Description);
+        Assert::AreEqual(3U, pAchievement.CategoryId);
+        Assert::AreEqual(10U, pAchievement.Points);
+        Assert::AreEqual(std::string("0xH0000=1"), pAchievement.Definition);
+        Assert::AreEqual(std::string("Auth1"), pAchievement.Author);
+        Assert::AreEqual(std::string("00111"), pAchievement.BadgeName);
+        Assert::AreEqual(1234567890, static_cast<int>(pAchievement.Created));
+        Assert::AreEqual(1234599999, static_cast<int>(pAchievement.Updated));
+        Assert::AreEqual(0, pAchievement.DefinitionSize); // never trusted from disk
+
+        Assert::AreEqual(1U, response.Leaderboards.size());
+        const auto& pLeaderboard = response.Leaderboards.at(0);
+        Assert::AreEqual(77U, pLeaderboard.Id);
+        Assert::AreEqual(std::string("LB1"), pLeaderboard.Title);
+        Assert::AreEqual(std::string("LBDesc1"), pLeaderboard.Description);
+        Assert::AreEqual(original.Leaderboards.at(0).Definition, pLeaderboard.Definition);
+        Assert::AreEqual(std::string("SCORE"), pLeaderboard.Format);
+        Assert::AreEqual(0, pLeaderboard.DefinitionSize);
+    }
+
+    TEST_METHOD(TestReadAnyHash)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+
+        FetchGameData::Response response;
+        Assert::IsTrue(GameDataCache::Read(1U, "", response));
+        Assert::AreEqual(1U, response.Achievements.size());
+    }
+
+    TEST_METHOD(TestReadHashMismatch)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(1U, "HASH2", response));
+        Assert::AreEqual(0U, response.Achievements.size());
+    }
+
+    TEST_METHOD(TestReadGameMismatch)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+        mockStorage.MockStoredData(StorageItemType::GameDataCache, L"2",
+                                   mockStorage.GetStoredData(StorageItemType::GameDataCache, L"1"));
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(2U, "HASH", response));
+    }
+
+    TEST_METHOD(TestReadMissing)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(1U, "", response));
+    }
+
+    TEST_METHOD(TestReadVersionMismatch)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+
+        // version immediately follows the four byte magic number
+        std::string sContents = mockStorage.GetStoredData(StorageItemType::GameDataCache, L"1");
+        sContents.at(4) = gsl::narrow_cast<char>(GameDataCache::Version + 1);
+        mockStorage.MockStoredData(StorageItemType::GameDataCache, L"1", sContents);
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(1U, "HASH", response));
+    }
+
+    TEST_METHOD(TestReadCorruptPayload)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+
+        std::string sContents = mockStorage.GetStoredData(StorageItemType::GameDataCache, L"1");
+        sContents.back() ^= 0x01;
+        mockStorage.MockStoredData(StorageItemType::GameDataCache, L"1", sContents);
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(1U, "HASH", response));
+        Assert::AreEqual(std::wstring(), response.Title);
+    }
+
+    TEST_METHOD(TestReadTruncated)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        Assert::IsTrue(GameDataCache::Write(1U, "HASH", CreateResponse()));
+
+        std::string sContents = mockStorage.GetStoredData(StorageItemType::GameDataCache, L"1");
+        sContents.resize(sContents.length() - 10);
+        mockStorage.MockStoredData(StorageItemType::GameDataCache, L"1", sContents);
+
+        FetchGameData::Response response;
+        Assert::IsFalse(GameDataCache::Read(1U, "HASH", response));
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace api
+} // namespace ra
@@ -0,0 +1,223 @@
+#include "CppUnitTest.h"
+
+#include "api\impl\JsonResponseReader.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace api {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(JsonResponseReader_Tests)
+{
+private:
+    static constexpr const char* PatchData =
+        "{\"ID\":3,\"Title\":\"Game\",\"ConsoleID\":7,\"ForumTopicID\":1234,\"Flags\":0,"
+        "\"ImageIcon\":\"/Images/012345.png\",\"RichPresencePatch\":\"Display:\\nHello\","
+        "\"Achievements\":[{\"ID\":55,\"MemAddr\":\"0xH0000=1\",\"Title\":\"Ach1\",\"Description\":\"Desc1\","
+        "\"Points\":10,\"Author\":\"Auth1\",\"Modified\":1234599999,\"Created\":1234567890,"
+        "\"BadgeName\":\"00111\",\"Flags\":3}],"
+        "\"Leaderboards\":[{\"ID\":77,\"Mem\":\"STA:1=1::CAN:1=1::SUB:1=1::VAL:1\",\"Format\":\"TIME\","
+        "\"Title\":\"LB1\",\"Description\":\"LBDesc1\"},"
+        "{\"ID\":78,\"Mem\":\"STA:1=1::CAN:1=1::SUB:1=1::VAL:2\",\"Title\":\"LB2\",\"Description\":\"LBDesc2\"}]}";
+
+    static void AssertPatchData(const FetchGameData::Response& response)
+    {
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(std::string(), response.ErrorMessage);
+        Assert::AreEqual(std::wstring(L"Game"), response.Title);
+        Assert::AreEqual(7U, response.ConsoleId);
+        Assert::AreEqual(1234U, response.ForumTopicId);
+        Assert::AreEqual(0U, response.Flags);
+        Assert::AreEqual(std::string("012345"), response.ImageIcon);
+        Assert::AreEqual(std::string("Display:\nHello"), response.RichPresence);
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Achievements.size()));
+        const auto& pAchievement = response.Achievements.front();
+        Assert::AreEqual(55U, pAchievement.Id);
+        Assert::AreEqual(std::string("Ach1"), pAchievement.Title);
+        Assert::AreEqual(std::string("Desc1"), pAchievement.Description);
+        Assert::AreEqual(3U, pAchievement.CategoryId);
+        Assert::AreEqual(10U, pAchievement.Points);
+        Assert::AreEqual(std::string("0xH0000=1"), pAchievement.Definition);
+        Assert::AreEqual(std::string("Auth1"), pAchievement.Author);
+        Assert::AreEqual(std::string("00111"), pAchievement.BadgeName);
+        Assert::AreEqual(1234567890, static_cast<int>(pAchievement.Created));
+        Assert::AreEqual(1234599999, static_cast<int>(pAchievement.Updated));
+
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(response.Leaderboards.size()));
+        const auto& pLeaderboard1 = response.Leaderboards.at(0);
+        Assert::AreEqual(77U, pLeaderboard1.Id);
+        Assert::AreEqual(std::string("LB1"), pLeaderboard1.Title);
+        Assert::AreEqual(std::string("LBDesc1"), pLeaderboard1.Description);
+        Assert::AreEqual(std::string("STA:1=1::CAN:1=1::SUB:1=1::VAL:1"), pLeaderboard1.Definition);
+        Assert::AreEqual(std::string("TIME"), pLeaderboard1.Format);
+
+        const auto& pLeaderboard2 = response.Leaderboards.at(1);
+        Assert::AreEqual(78U, pLeaderboard2.Id);
+        Assert::AreEqual(std::string("VALUE"), pLeaderboard2.Format);
+    }
+
+public:
+    TEST_METHOD(TestReadGameData)
+    {
+        const auto sJson = std::string("{\"Success\":true,\"PatchData\":") + PatchData + "}";
+
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(sJson, response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        Assert::IsTrue(pEnvelope.Success);
+        Assert::AreEqual(std::string(), pEnvelope.Error);
+        AssertPatchData(response);
+    }
+
+    TEST_METHOD(TestReadGameDataBare)
+    {
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(PatchData, response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        AssertPatchData(response);
+    }
+
+    TEST_METHOD(TestReadGameDataIgnoresUnknownFields)
+    {
+        const auto sJson = std::string("{\"Extra\":{\"Title\":\"Other\",\"Achievements\":[{\"ID\":9}]},"
+                                       "\"Success\":true,\"PatchData\":") + PatchData + ",\"More\":[1,[2],{\"a\":3}]}";
+
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(sJson, response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        AssertPatchData(response);
+    }
+
+    TEST_METHOD(TestReadGameDataMissingRequiredField)
+    {
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(
+            "{\"Success\":true,\"PatchData\":{\"Title\":\"Game\",\"ConsoleID\":7,\"Achievements\":["
+            "{\"ID\":55,\"Title\":\"Ach1\",\"Description\":\"Desc1\",\"Flags\":3,\"BadgeName\":\"00111\","
+            "\"Created\":1234567890,\"Modified\":1234599999}],\"Leaderboards\":[]}}",
+            response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        Assert::AreEqual(ApiResult::Error, response.Result);
+        Assert::AreEqual(std::string("MemAddr not found in response"), response.ErrorMessage);
+    }
+
+    TEST_METHOD(TestReadGameDataMissingTitle)
+    {
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(
+            "{\"ConsoleID\":7,\"Achievements\":[],\"Leaderboards\":[]}", response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        Assert::AreEqual(ApiResult::Error, response.Result);
+        Assert::AreEqual(std::string("Title not found in response"), response.ErrorMessage);
+    }
+
+    TEST_METHOD(TestReadGameDataError)
+    {
+        FetchGameData::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadGameData(
+            "{\"Success\":false,\"Error\":\"Unknown game\"}", response, pEnvelope));
+
+        Assert::IsFalse(pEnvelope.HasPayload);
+        Assert::IsFalse(pEnvelope.Success);
+        Assert::AreEqual(std::string("Unknown game"), pEnvelope.Error);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+    }
+
+    TEST_METHOD(TestReadGameDataInvalidJson)
+    {
+        FetchGameData::Response response;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsFalse(JsonResponseReader::ReadGameData("{\"Success\":true,\"PatchData\":{", response, pEnvelope));
+        Assert::IsFalse(JsonResponseReader::ReadGameData("<html></html>", response, pEnvelope));
+    }
+
+    TEST_METHOD(TestReadCodeNotes)
+    {
+        FetchCodeNotes::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadCodeNotes(
+            "{\"Success\":true,\"CodeNotes\":["
+            "{\"User\":\"Author1\",\"Address\":\"0x001234\",\"Note\":\"Note1\"},"
+            "{\"User\":\"Author2\",\"Address\":\"0x002345\",\"Note\":\"\"},"
+            "{\"User\":\"Author3\",\"Address\":\"0x003456\",\"Note\":\"Line1\\r\\nLine2\"}]}",
+            response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+
+        // empty notes are dropped
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(response.Notes.size()));
+        Assert::AreEqual(std::string("Author1"), response.Notes.at(0).Author);
+        Assert::AreEqual(0x1234U, response.Notes.at(0).Address);
+        Assert::AreEqual(std::wstring(L"Note1"), response.Notes.at(0).Note);
+        Assert::AreEqual(std::string("Author3"), response.Notes.at(1).Author);
+        Assert::AreEqual(0x3456U, response.Notes.at(1).Address);
+        Assert::AreEqual(std::wstring(L"Line1\r\nLine2"), response.Notes.at(1).Note);
+    }
+
+    TEST_METHOD(TestReadCodeNotesBare)
+    {
+        FetchCodeNotes::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadCodeNotes(
+            "[{\"User\":\"Author1\",\"Address\":\"0x001234\",\"Note\":\"Note1\"}]", response, pEnvelope));
+
+        Assert::IsTrue(pEnvelope.HasPayload);
+        Assert::AreEqual(ApiResult::Success, response.Result);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(response.Notes.size()));
+        Assert::AreEqual(0x1234U, response.Notes.at(0).Address);
+    }
+
+    TEST_METHOD(TestReadCodeNotesMissingPayload)
+    {
+        FetchCodeNotes::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadCodeNotes("{\"Success\":true}", response, pEnvelope));
+
+        Assert::IsFalse(pEnvelope.HasPayload);
+        Assert::IsTrue(pEnvelope.Success);
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(response.Notes.size()));
+    }
+
+    TEST_METHOD(TestReadCodeNotesMissingRequiredField)
+    {
+        FetchCodeNotes::Response response;
+        response.Result = ApiResult::Success;
+        JsonResponseReader::Envelope pEnvelope;
+        Assert::IsTrue(JsonResponseReader::ReadCodeNotes(
+            "{\"CodeNotes\":[{\"User\":\"Author1\",\"Note\":\"Note1\"}]}", response, pEnvelope));
+
+        Assert::AreEqual(ApiResult::Error, response.Result);
+        Assert::AreEqual(std::string("Address not found in response"), response.ErrorMessage);
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace api
+} // namespace ra
@@ -0,0 +1,248 @@
+#include "CppUnitTest.h"
+
+#include "data\CodeNoteIndex.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace data {
+namespace tests {
+
+TEST_CLASS(CodeNoteIndex_Tests)
+{
+private:
+    static std::vector<ra::ByteAddress> GetNotes(const CodeNoteIndex& pIndex, ra::ByteAddress nFirst, ra::ByteAddress nLast)
+    {
+        std::vector<ra::ByteAddress> vNotes;
+        pIndex.EnumerateNotes(nFirst, nLast, [&vNotes](ra::ByteAddress nAddress, unsigned int)
+        {
+            vNotes.push_back(nAddress);
+            return true;
+        });
+        return vNotes;
+    }
+
+public:
+    TEST_METHOD(TestGetNoteSize)
+    {
+        Assert::AreEqual(1U, CodeNoteIndex::GetNoteSize(L"Lives"));
+        Assert::AreEqual(1U, CodeNoteIndex::GetNoteSize(L"[8-bit] Lives"));
+        Assert::AreEqual(2U, CodeNoteIndex::GetNoteSize(L"[16-bit] Score"));
+        Assert::AreEqual(3U, CodeNoteIndex::GetNoteSize(L"[24-bit] Score"));
+        Assert::AreEqual(4U, CodeNoteIndex::GetNoteSize(L"Timer (32 bit)"));
+        Assert::AreEqual(4U, CodeNoteIndex::GetNoteSize(L"[32-BIT BE] Timer"));
+        Assert::AreEqual(32U, CodeNoteIndex::GetNoteSize(L"[32 bytes] Inventory"));
+        Assert::AreEqual(1U, CodeNoteIndex::GetNoteSize(L"[1 byte] Flags"));
+        Assert::AreEqual(0x20U, CodeNoteIndex::GetNoteSize(L"Party [0x20 Bytes]"));
+        Assert::AreEqual(1U, CodeNoteIndex::GetNoteSize(L"Stage 16\n0=start"));
+        Assert::AreEqual(2U, CodeNoteIndex::GetNoteSize(L"Level 3\n[16-bit] experience"));
+        Assert::AreEqual(1U, CodeNoteIndex::GetNoteSize(L"Bit0=sword\nBit1=shield")); // no number before "bit"
+    }
+
+    TEST_METHOD(TestFindNoteStart)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x10, 1);
+        pIndex.Set(0x20, 4);
+        pIndex.Set(0x30, 2);
+
+        ra::ByteAddress nNoteAddress = 0;
+        Assert::IsTrue(pIndex.FindNoteStart(0x10, nNoteAddress));
+        Assert::AreEqual(0x10U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x11, nNoteAddress));
+        Assert::IsFalse(pIndex.FindNoteStart(0x1F, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x20, nNoteAddress));
+        Assert::AreEqual(0x20U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x23, nNoteAddress));
+        Assert::AreEqual(0x20U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x24, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x31, nNoteAddress));
+        Assert::AreEqual(0x30U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x05, nNoteAddress));
+        Assert::IsFalse(pIndex.FindNoteStart(0x40, nNoteAddress));
+    }
+
+    TEST_METHOD(TestFindNoteStartNested)
+    {
+        // an array note with notes for individual elements inside it
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x100, 0x40);
+        pIndex.Set(0x110, 2);
+        pIndex.Set(0x120, 1);
+
+        ra::ByteAddress nNoteAddress = 0;
+        Assert::IsTrue(pIndex.FindNoteStart(0x111, nNoteAddress));
+        Assert::AreEqual(0x110U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x112, nNoteAddress));
+        Assert::AreEqual(0x100U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x13F, nNoteAddress));
+        Assert::AreEqual(0x100U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x140, nNoteAddress));
+    }
+
+    TEST_METHOD(TestFindNoteStartOverlappingLongNotes)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x000, 0x1000); // covers everything below
+        for (ra::ByteAddress nAddress = 0x100; nAddress < 0x200; nAddress += 2)
+            pIndex.Set(nAddress, 1);
+        pIndex.Set(0x300, 0x100);
+        pIndex.Set(0x340, 0x20);
+        pIndex.Set(0x2000, 0x10);
+
+        ra::ByteAddress nNoteAddress = 0;
+        Assert::IsTrue(pIndex.FindNoteStart(0x180, nNoteAddress));
+        Assert::AreEqual(0x180U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x181, nNoteAddress));
+        Assert::AreEqual(0x000U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x350, nNoteAddress));
+        Assert::AreEqual(0x340U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x360, nNoteAddress));
+        Assert::AreEqual(0x300U, nNoteAddress);
+        Assert::IsTrue(pIndex.FindNoteStart(0x400, nNoteAddress));
+        Assert::AreEqual(0x000U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x1000, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x200F, nNoteAddress));
+        Assert::AreEqual(0x2000U, nNoteAddress);
+        Assert::IsFalse(pIndex.FindNoteStart(0x2010, nNoteAddress));
+
+        // shrinking the large note moves it out of the interval tree
+        pIndex.Set(0x000, 1);
+        Assert::IsFalse(pIndex.FindNoteStart(0x181, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x360, nNoteAddress));
+        Assert::AreEqual(0x300U, nNoteAddress);
+
+        // and growing a small one moves it in
+        pIndex.Set(0x1FE, 0x10);
+        Assert::IsTrue(pIndex.FindNoteStart(0x20D, nNoteAddress));
+        Assert::AreEqual(0x1FEU, nNoteAddress);
+
+        pIndex.Remove(0x300);
+        Assert::IsFalse(pIndex.FindNoteStart(0x360, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x350, nNoteAddress));
+        Assert::AreEqual(0x340U, nNoteAddress);
+    }
+
+    TEST_METHOD(TestSetOutOfOrderAndUpdate)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x30, 1);
+        pIndex.Set(0x10, 1);
+        pIndex.Set(0x20, 1);
+
+        ra::ByteAddress nNoteAddress = 0;
+        Assert::IsFalse(pIndex.FindNoteStart(0x12, nNoteAddress));
+
+        // resize an existing note
+        pIndex.Set(0x10, 4);
+        Assert::IsTrue(pIndex.FindNoteStart(0x12, nNoteAddress));
+        Assert::AreEqual(0x10U, nNoteAddress);
+
+        pIndex.Set(0x10, 1);
+        Assert::IsFalse(pIndex.FindNoteStart(0x12, nNoteAddress));
+    }
+
+    TEST_METHOD(TestRemove)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x10, 0x20);
+        pIndex.Set(0x18, 1);
+
+        ra::ByteAddress nNoteAddress = 0;
+        Assert::IsTrue(pIndex.FindNoteStart(0x1C, nNoteAddress));
+        Assert::AreEqual(0x10U, nNoteAddress);
+
+        pIndex.Remove(0x10);
+        Assert::IsFalse(pIndex.FindNoteStart(0x1C, nNoteAddress));
+        Assert::IsTrue(pIndex.FindNoteStart(0x18, nNoteAddress));
+
+        pIndex.Remove(0x44); // not present
+        Assert::IsTrue(pIndex.FindNoteStart(0x18, nNoteAddress));
+
+        pIndex.Clear();
+        Assert::IsFalse(pIndex.FindNoteStart(0x18, nNoteAddress));
+    }
+
+    TEST_METHOD(TestEnumerateNotes)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x08, 0x10); // covers 0x08-0x17
+        pIndex.Set(0x0C, 1);
+        pIndex.Set(0x12, 4);    // covers 0x12-0x15
+        pIndex.Set(0x1F, 2);    // covers 0x1F-0x20
+        pIndex.Set(0x24, 1);
+
+        auto vNotes = GetNotes(pIndex, 0x10, 0x1F);
+        Assert::AreEqual(3U, vNotes.size());
+        Assert::AreEqual(0x08U, vNotes.at(0));
+        Assert::AreEqual(0x12U, vNotes.at(1));
+        Assert::AreEqual(0x1FU, vNotes.at(2));
+
+        vNotes = GetNotes(pIndex, 0x20, 0x2F);
+        Assert::AreEqual(2U, vNotes.size());
+        Assert::AreEqual(0x1FU, vNotes.at(0));
+        Assert::AreEqual(0x24U, vNotes.at(1));
+
+        vNotes = GetNotes(pIndex, 0x30, 0x3F);
+        Assert::AreEqual(0U, vNotes.size());
+    }
+
+    TEST_METHOD(TestEnumerateNotesLongAndShort)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x40, 0x40); // covers 0x40-0x7F
+        pIndex.Set(0x00, 0x60); // covers 0x00-0x5F
+        pIndex.Set(0x3E, 4);    // covers 0x3E-0x41
+        pIndex.Set(0x50, 1);
+        pIndex.Set(0x58, 0x20); // covers 0x58-0x77
+        pIndex.Set(0x80, 1);
+
+        auto vNotes = GetNotes(pIndex, 0x41, 0x58);
+        Assert::AreEqual(5U, vNotes.size());
+        Assert::AreEqual(0x00U, vNotes.at(0));
+        Assert::AreEqual(0x3EU, vNotes.at(1));
+        Assert::AreEqual(0x40U, vNotes.at(2));
+        Assert::AreEqual(0x50U, vNotes.at(3));
+        Assert::AreEqual(0x58U, vNotes.at(4));
+
+        vNotes = GetNotes(pIndex, 0x78, 0x90);
+        Assert::AreEqual(2U, vNotes.size());
+        Assert::AreEqual(0x40U, vNotes.at(0));
+        Assert::AreEqual(0x80U, vNotes.at(1));
+    }
+
+    TEST_METHOD(TestEnumerateNotesStop)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x10, 1);
+        pIndex.Set(0x11, 1);
+        pIndex.Set(0x12, 1);
+
+        int nCount = 0;
+        pIndex.EnumerateNotes(0x00, 0xFF, [&nCount](ra::ByteAddress, unsigned int)
+        {
+            return (++nCount < 2);
+        });
+        Assert::AreEqual(2, nCount);
+    }
+
+    TEST_METHOD(TestEnumerateNotesSize)
+    {
+        CodeNoteIndex pIndex;
+        pIndex.Set(0x10, 4);
+
+        unsigned int nSize = 0;
+        pIndex.EnumerateNotes(0x12, 0x12, [&nSize](ra::ByteAddress, unsigned int nNoteSize)
+        {
+            nSize = nNoteSize;
+            return true;
+        });
+        Assert::AreEqual(4U, nSize);
+    }
+};
+
+} // namespace tests
+} // namespace data
+} // namespace ra
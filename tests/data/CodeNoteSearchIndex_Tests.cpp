@@ -0,0 +1,121 @@
+#include "CppUnitTest.h"
+
+#include "data\CodeNoteSearchIndex.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace data {
+namespace tests {
+
+TEST_CLASS(CodeNoteSearchIndex_Tests)
+{
+private:
+    static void AssertMatches(const std::vector<ra::ByteAddress>& vExpected, const std::vector<ra::ByteAddress>& vActual)
+    {
+        Assert::AreEqual(vExpected.size(), vActual.size());
+        for (size_t nIndex = 0; nIndex < vExpected.size(); ++nIndex)
+            Assert::AreEqual(vExpected.at(nIndex), vActual.at(nIndex));
+    }
+
+    static void PopulateIndex(CodeNoteSearchIndex& pIndex)
+    {
+        pIndex.Set(0x0010, L"Player HP");
+        pIndex.Set(0x0020, L"Player Max HP");
+        pIndex.Set(0x0030, L"Boss HP\n[16-bit]");
+        pIndex.Set(0x0040, L"Boss ID");
+        pIndex.Set(0x0050, L"Stage");
+    }
+
+public:
+    TEST_METHOD(TestSearchIgnoresCase)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        AssertMatches({0x0030, 0x0040}, pIndex.Search(L"boss"));
+        AssertMatches({0x0030, 0x0040}, pIndex.Search(L"BOSS"));
+        AssertMatches({0x0010, 0x0020}, pIndex.Search(L"player"));
+    }
+
+    TEST_METHOD(TestSearchSubstring)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        AssertMatches({0x0020}, pIndex.Search(L"yer max"));
+        AssertMatches({0x0030}, pIndex.Search(L"16-bit"));
+        AssertMatches({0x0050}, pIndex.Search(L"tag"));
+    }
+
+    TEST_METHOD(TestSearchShortText)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        // too short for the index, but still searched
+        AssertMatches({0x0010, 0x0020, 0x0030}, pIndex.Search(L"hp"));
+        AssertMatches({0x0040}, pIndex.Search(L"ID"));
+    }
+
+    TEST_METHOD(TestSearchTrigramsOutOfOrder)
+    {
+        CodeNoteSearchIndex pIndex;
+        pIndex.Set(0x0010, L"abcd bcde");
+
+        // every trigram of "abcde" appears in the note, but "abcde" doesn't
+        AssertMatches({}, pIndex.Search(L"abcde"));
+        AssertMatches({0x0010}, pIndex.Search(L"bcde"));
+    }
+
+    TEST_METHOD(TestSearchNoMatch)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        AssertMatches({}, pIndex.Search(L"inventory"));
+        AssertMatches({}, pIndex.Search(L""));
+    }
+
+    TEST_METHOD(TestSetReplacesText)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        pIndex.Set(0x0040, L"Enemy ID");
+        AssertMatches({0x0030}, pIndex.Search(L"boss"));
+        AssertMatches({0x0040}, pIndex.Search(L"enemy"));
+    }
+
+    TEST_METHOD(TestSetOutOfOrder)
+    {
+        CodeNoteSearchIndex pIndex;
+        pIndex.Set(0x0030, L"Boss HP");
+        pIndex.Set(0x0010, L"Player HP");
+        pIndex.Set(0x0020, L"Ally HP");
+
+        AssertMatches({0x0010, 0x0020, 0x0030}, pIndex.Search(L" hp"));
+    }
+
+    TEST_METHOD(TestRemove)
+    {
+        CodeNoteSearchIndex pIndex;
+        PopulateIndex(pIndex);
+
+        pIndex.Remove(0x0030);
+        AssertMatches({0x0040}, pIndex.Search(L"boss"));
+        AssertMatches({0x0010, 0x0020}, pIndex.Search(L"hp"));
+
+        pIndex.Remove(0x1234); // not present
+        AssertMatches({0x0040}, pIndex.Search(L"boss"));
+
+        pIndex.Clear();
+        AssertMatches({}, pIndex.Search(L"player"));
+    }
+};
+
+} // namespace tests
+} // namespace data
+} // namespace ra
@@ -11,6 +11,7 @@
 #include "tests\mocks\MockLocalStorage.hh"
 #include "tests\mocks\MockOverlayManager.hh"
 #include "tests\mocks\MockServer.hh"
+#include "tests\mocks\MockSubmissionJournal.hh"
 #include "tests\mocks\MockThreadPool.hh"
 #include "tests\mocks\MockUserContext.hh"
 
@@ -47,6 +48,7 @@ public:
         ra::services::mocks::MockAudioSystem mockAudioSystem;
         ra::ui::viewmodels::mocks::MockOverlayManager mockOverlayManager;
         ra::data::mocks::MockUserContext mockUser;
+        ra::data::mocks::MockSubmissionJournal mockSubmissionJournal;
         ra::services::AchievementRuntime runtime;
 
         static const unsigned int FirstLocalId = GameContext::FirstLocalId;
@@ -206,6 +208,46 @@ public:
         Assert::AreEqual(std::string("1=1"), pAch2->CreateMemString());
     }
 
+    TEST_METHOD(TestLoadGameManyAchievements)
+    {
+        // enough definitions to be parsed on multiple threads
+        GameContextHarness game;
+        game.mockServer.HandleRequest<ra::api::FetchGameData>([](const ra::api::FetchGameData::Request&, ra::api::FetchGameData::Response& response)
+        {
+            for (unsigned int i = 1; i <= 200; ++i)
+            {
+                auto& ach = response.Achievements.emplace_back();
+                ach.Id = i;
+                ach.Title = ra::StringPrintf("Ach%u", i);
+                ach.CategoryId = 3;
+                ach.Definition = ra::StringPrintf("0xH%04x=%u_0xH0000=1", i, i % 256);
+            }
+
+            auto& lb = response.Leaderboards.emplace_back();
+            lb.Id = 7U;
+            lb.Title = "LB1";
+            lb.Definition = "STA:0xH0001=1::CAN:0xH0002=1::SUB:0xH0003=1::VAL:0xH0004";
+            lb.Format = "SECS";
+            return true;
+        });
+
+        game.LoadGame(1U);
+
+        for (unsigned int i = 1; i <= 200; ++i)
+        {
+            const auto* pAch = game.FindAchievement(i);
+            Assert::IsNotNull(pAch);
+            Ensures(pAch != nullptr);
+            Assert::AreEqual(ra::StringPrintf("Ach%u", i), pAch->Title());
+            Assert::AreEqual(ra::StringPrintf("0xH%04x=%u_0xH0000=1", i, i % 256), pAch->CreateMemString());
+        }
+
+        const auto* pLb = game.FindLeaderboard(7U);
+        Assert::IsNotNull(pLb);
+        Ensures(pLb != nullptr);
+        Assert::AreEqual(std::string("LB1"), pLb->Title());
+    }
+
     TEST_METHOD(TestLoadGameMergeLocalAchievements)
     {
         GameContextHarness game;
@@ -370,6 +412,60 @@ public:
         Assert::AreEqual(999000004U, pAch2.ID());
     }
 
+    TEST_METHOD(TestReloadLocalAchievement)
+    {
+        GameContextHarness game;
+        game.mockServer.HandleRequest<ra::api::FetchGameData>([](const ra::api::FetchGameData::Request&, ra::api::FetchGameData::Response&)
+        {
+            return true;
+        });
+
+        game.mockStorage.MockStoredData(ra::services::StorageItemType::UserAchievements, L"1",
+            "Version\n"
+            "Game\n"
+            "999000001:1=1:Ach3:Desc3::::Auth3:20:1234511111:1234500000:::555\n"
+            "999000003:R:1=1:Ach4:Desc4::::Auth4:10:1234511111:1234500000:::556\n"
+        );
+
+        game.LoadGame(1U);
+
+        auto* pAch = game.FindAchievement(999000003U);
+        Assert::IsNotNull(pAch);
+        Ensures(pAch != nullptr);
+        pAch->SetTitle("Modified");
+        pAch->SetPoints(50);
+        pAch->ParseTrigger("1=2");
+        pAch->SetModified(true);
+
+        Assert::IsTrue(game.ReloadAchievement(999000003U));
+        pAch = game.FindAchievement(999000003U);
+        Assert::IsNotNull(pAch);
+        Ensures(pAch != nullptr);
+        Assert::AreEqual(std::string("Ach4"), pAch->Title());
+        Assert::AreEqual(std::string("Desc4"), pAch->Description());
+        Assert::AreEqual(10U, pAch->Points());
+        Assert::AreEqual(std::string("R:1=1"), pAch->CreateMemString());
+        Assert::IsFalse(pAch->Modified());
+
+        // changes to the file are seen by the next reload
+        game.mockStorage.MockStoredData(ra::services::StorageItemType::UserAchievements, L"1",
+            "Version\n"
+            "Game\n"
+            "999000001:1=1:Ach3b:Desc3b::::Auth3:25:1234511111:1234500000:::555\n"
+        );
+
+        Assert::IsTrue(game.ReloadAchievement(999000001U));
+        pAch = game.FindAchievement(999000001U);
+        Assert::IsNotNull(pAch);
+        Ensures(pAch != nullptr);
+        Assert::AreEqual(std::string("Ach3b"), pAch->Title());
+        Assert::AreEqual(25U, pAch->Points());
+
+        // no longer in the file, achievement is discarded
+        Assert::IsFalse(game.ReloadAchievement(999000003U));
+        Assert::IsNull(game.FindAchievement(999000003U));
+    }
+
     TEST_METHOD(TestLoadGameLeaderboards)
     {
         GameContextHarness game;
@@ -489,6 +585,65 @@ public:
         Assert::AreEqual(ra::StringPrintf("GameTitle\n%u:\"2=2\":\"Ach:2\":\"Desc \\\"2\\\"\"::::Auth2:15:1234567891:1234599998:::54321\n", game.FirstLocalId), sContents);
     }
 
+    TEST_METHOD(TestSaveLocalOnlyModified)
+    {
+        GameContextHarness game;
+        game.mockServer.HandleRequest<ra::api::FetchGameData>([](const ra::api::FetchGameData::Request&, ra::api::FetchGameData::Response& response)
+        {
+            response.Title = L"GameTitle";
+            response.Result = ra::api::ApiResult::Success;
+            return true;
+        });
+        game.LoadGame(1U);
+
+        auto& ach1 = game.NewAchievement(AchievementSet::Type::Local);
+        ach1.SetTitle("Ach1");
+        ach1.SetDescription("Desc1");
+        ach1.SetAuthor("Auth1");
+        ach1.SetBadgeImage("12345");
+        ach1.SetCreatedDate(1234567890);
+        ach1.SetModifiedDate(1234599999);
+        ach1.ParseTrigger("1=1");
+        ach1.SetPoints(5);
+
+        auto& ach2 = game.NewAchievement(AchievementSet::Type::Local);
+        ach2.SetTitle("Ach2");
+        ach2.SetDescription("Desc2");
+        ach2.SetAuthor("Auth2");
+        ach2.SetBadgeImage("54321");
+        ach2.SetCreatedDate(1234567891);
+        ach2.SetModifiedDate(1234599998);
+        ach2.ParseTrigger("2=2");
+        ach2.SetPoints(15);
+
+        Assert::IsTrue(game.SaveLocal());
+        ach1.SetModified(false);
+        ach2.SetModified(false);
+
+        // ach1 is flagged as modified and will be written again. ach2 isn't, so the previously written
+        // line is reused
+        ach1.SetTitle("Ach1b");
+        ach1.SetModified(true);
+        ach2.SetTitle("Ach2b");
+
+        Assert::IsTrue(game.SaveLocal());
+        auto sContents = game.mockStorage.GetStoredData(ra::services::StorageItemType::UserAchievements, L"1");
+        RemoveFirstLine(sContents);
+        Assert::AreEqual(ra::StringPrintf("GameTitle\n"
+            "%u:\"1=1\":Ach1b:Desc1::::Auth1:5:1234567890:1234599999:::12345\n"
+            "%u:\"2=2\":Ach2:Desc2::::Auth2:15:1234567891:1234599998:::54321\n",
+            game.FirstLocalId, game.FirstLocalId + 1), sContents);
+
+        // removed achievements are no longer written
+        game.RemoveAchievement(game.FirstLocalId);
+        Assert::IsTrue(game.SaveLocal());
+        sContents = game.mockStorage.GetStoredData(ra::services::StorageItemType::UserAchievements, L"1");
+        RemoveFirstLine(sContents);
+        Assert::AreEqual(ra::StringPrintf("GameTitle\n"
+            "%u:\"2=2\":Ach2:Desc2::::Auth2:15:1234567891:1234599998:::54321\n",
+            game.FirstLocalId + 1), sContents);
+    }
+
     TEST_METHOD(TestLoadGameUserUnlocks)
     {
         GameContextHarness game;
@@ -533,6 +688,52 @@ public:
         Assert::IsFalse(pAch2->Active());
     }
 
+    TEST_METHOD(TestLoadGameUserUnlocksBeforeGameData)
+    {
+        GameContextHarness game;
+        game.mockServer.HandleRequest<ra::api::FetchGameData>([&game](const ra::api::FetchGameData::Request&, ra::api::FetchGameData::Response& response)
+        {
+            // the unlocks and code notes are requested first, let them complete before the game data
+            game.mockThreadPool.ExecuteNextTask();
+            game.mockThreadPool.ExecuteNextTask();
+
+            auto& ach1 = response.Achievements.emplace_back();
+            ach1.Id = 5;
+            ach1.CategoryId = ra::etoi(AchievementSet::Type::Core);
+
+            auto& ach2 = response.Achievements.emplace_back();
+            ach2.Id = 7;
+            ach2.CategoryId = ra::etoi(AchievementSet::Type::Core);
+            return true;
+        });
+
+        game.mockServer.HandleRequest<ra::api::FetchUserUnlocks>([](const ra::api::FetchUserUnlocks::Request&, ra::api::FetchUserUnlocks::Response& response)
+        {
+            response.UnlockedAchievements.insert(7U);
+            return true;
+        });
+
+        game.mockServer.HandleRequest<ra::api::FetchCodeNotes>([](const ra::api::FetchCodeNotes::Request&, ra::api::FetchCodeNotes::Response&)
+        {
+            return true;
+        });
+
+        game.LoadGame(1U);
+
+        // the held unlocks are applied as soon as the achievements are loaded
+        const auto* pAch1 = game.FindAchievement(5U);
+        Assert::IsNotNull(pAch1);
+        Ensures(pAch1 != nullptr);
+        Assert::IsTrue(pAch1->Active());
+
+        const auto* pAch2 = game.FindAchievement(7U);
+        Assert::IsNotNull(pAch2);
+        Ensures(pAch2 != nullptr);
+        Assert::IsFalse(pAch2->Active());
+
+        Assert::IsFalse(game.runtime.IsPaused());
+    }
+
     TEST_METHOD(TestLoadGameUserUnlocksCompatibilityMode)
     {
         GameContextHarness game;
@@ -1301,6 +1502,49 @@ public:
         Assert::IsNull(pNote5);
     }
 
+    TEST_METHOD(TestFindCodeNoteCovering)
+    {
+        GameContextHarness game;
+        game.mockServer.HandleRequest<ra::api::FetchGameData>([](const ra::api::FetchGameData::Request&, ra::api::FetchGameData::Response&)
+        {
+            return true;
+        });
+
+        game.mockServer.HandleRequest<ra::api::FetchUserUnlocks>([](const ra::api::FetchUserUnlocks::Request&, ra::api::FetchUserUnlocks::Response&)
+        {
+            return true;
+        });
+
+        game.mockServer.HandleRequest<ra::api::FetchCodeNotes>([](const ra::api::FetchCodeNotes::Request&, ra::api::FetchCodeNotes::Response& response)
+        {
+            response.Notes.emplace_back(ra::api::FetchCodeNotes::Response::CodeNote{ 1234, L"[32-bit] Score", "Author" });
+            response.Notes.emplace_back(ra::api::FetchCodeNotes::Response::CodeNote{ 2345, L"Lives", "Author" });
+            return true;
+        });
+
+        game.LoadGame(1U);
+        game.mockThreadPool.ExecuteNextTask(); // FetchUserUnlocks and FetchCodeNotes are async
+        game.mockThreadPool.ExecuteNextTask();
+
+        ra::ByteAddress nNoteAddress = 0;
+        const auto* pNote = game.FindCodeNoteCovering(1237U, nNoteAddress);
+        Assert::IsNotNull(pNote);
+        Ensures(pNote != nullptr);
+        Assert::AreEqual(std::wstring(L"[32-bit] Score"), *pNote);
+        Assert::AreEqual(1234U, nNoteAddress);
+
+        Assert::IsNull(game.FindCodeNoteCovering(1238U, nNoteAddress));
+        Assert::IsNull(game.FindCodeNoteCovering(2346U, nNoteAddress));
+
+        unsigned int nCount = 0;
+        game.EnumerateCodeNotes(1230U, 2350U, [&nCount](ra::ByteAddress, unsigned int)
+        {
+            ++nCount;
+            return true;
+        });
+        Assert::AreEqual(2U, nCount);
+    }
+
     TEST_METHOD(TestSetCodeNote)
     {
         GameContextHarness game;
@@ -1389,9 +1633,16 @@ public:
         Ensures(pNote1 != nullptr);
         Assert::AreEqual(std::wstring(L"Note1"), *pNote1);
 
+        auto vMatches = game.SearchCodeNotes(L"note");
+        Assert::AreEqual(1U, vMatches.size());
+        Assert::AreEqual(1234U, vMatches.at(0));
+
         Assert::IsTrue(game.DeleteCodeNote(1234));
         const auto* pNote1b = game.FindCodeNote(1234U);
         Assert::IsNull(pNote1b);
+
+        vMatches = game.SearchCodeNotes(L"note");
+        Assert::AreEqual(0U, vMatches.size());
     }
 
     TEST_METHOD(TestDeleteCodeNoteNonExistant)
@@ -0,0 +1,175 @@
+#include "CppUnitTest.h"
+
+#include "data\LocalAchievementFile.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include "tests\mocks\MockLocalStorage.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace data {
+namespace tests {
+
+TEST_CLASS(LocalAchievementFile_Tests)
+{
+private:
+    static std::string Str(std::string_view sView) { return std::string(sView); }
+
+public:
+    TEST_METHOD(TestParseUnquoted)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\nGame\n7:0xH1234=1:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\n");
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        const auto& pRecord = pFile.Records().front();
+        Assert::AreEqual(7U, pRecord.nId);
+        Assert::AreEqual(std::string("0xH1234=1"), Str(pRecord.sTrigger));
+        Assert::AreEqual(std::string("Ach1"), Str(pRecord.sTitle));
+        Assert::AreEqual(std::string("Desc1"), Str(pRecord.sDescription));
+        Assert::AreEqual(std::string("Auth1"), Str(pRecord.sAuthor));
+        Assert::AreEqual(25U, pRecord.nPoints);
+        Assert::AreEqual(1234554321, static_cast<int>(pRecord.tCreated));
+        Assert::AreEqual(1234555555, static_cast<int>(pRecord.tModified));
+        Assert::AreEqual(std::string("54321"), Str(pRecord.sBadge));
+    }
+
+    TEST_METHOD(TestParseUnquotedTriggerWithFlags)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\nGame\n7:R:0xH1234=1_P:0xH2345=2:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\n");
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        const auto& pRecord = pFile.Records().front();
+        Assert::AreEqual(std::string("R:0xH1234=1_P:0xH2345=2"), Str(pRecord.sTrigger));
+        Assert::AreEqual(std::string("Ach1"), Str(pRecord.sTitle));
+    }
+
+    TEST_METHOD(TestParseQuoted)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\nGame\n"
+                    "7:\"0xH1234=1\":\"Ach: \\\"One\\\"\":\"Line1\\nLine2\"::::Auth1:25:1234554321:1234555555:::54321\n");
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        const auto& pRecord = pFile.Records().front();
+        Assert::AreEqual(std::string("0xH1234=1"), Str(pRecord.sTrigger));
+        Assert::AreEqual(std::string("Ach: \"One\""), Str(pRecord.sTitle));
+        Assert::AreEqual(std::string("Line1\nLine2"), Str(pRecord.sDescription));
+        Assert::AreEqual(std::string("Auth1"), Str(pRecord.sAuthor));
+        Assert::AreEqual(std::string("54321"), Str(pRecord.sBadge));
+    }
+
+    TEST_METHOD(TestParseTriggerIsNullTerminated)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\nGame\n"
+                    "7:0xH1234=1:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\n"
+                    "8:\"0xH1234=2\":Ach2:Desc2::::Auth1:25:1234554321:1234555555:::54321\n");
+
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        Assert::AreEqual(std::string("0xH1234=1"), std::string(pFile.Records().at(0).sTrigger.data()));
+        Assert::AreEqual(std::string("0xH1234=2"), std::string(pFile.Records().at(1).sTrigger.data()));
+    }
+
+    TEST_METHOD(TestParseSkipsHeaderAndInvalidLines)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("1:1=1:Version::::A:5:1:2:::3\n"
+                    "2:1=1:Game::::A:5:1:2:::3\n"
+                    "\n"
+                    "// comment\n"
+                    "3:1=1:Truncated\n"
+                    "4:1=1:Ach4:Desc4::::Auth4:10:1234511111:1234500000:::556\n");
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        Assert::AreEqual(4U, pFile.Records().front().nId);
+        Assert::IsNull(pFile.Find(1U));
+        Assert::IsNull(pFile.Find(3U));
+    }
+
+    TEST_METHOD(TestParseWindowsLineEndings)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\r\nGame\r\n"
+                    "7:1=1:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\r\n"
+                    "8:1=1:Ach2:Desc2::::Auth2:10:1234554321:1234555555:::12345");
+
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+        Assert::AreEqual(std::string("54321"), Str(pFile.Records().at(0).sBadge));
+        Assert::AreEqual(std::string("12345"), Str(pFile.Records().at(1).sBadge));
+    }
+
+    TEST_METHOD(TestFind)
+    {
+        LocalAchievementFile pFile;
+        pFile.Parse("0.077\nGame\n"
+                    "7:1=1:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\n"
+                    "0:1=1:Ach2:Desc2::::Auth2:10:1234554321:1234555555:::12345\n"
+                    "9:1=1:Ach3:Desc3::::Auth3:5:1234554321:1234555555:::11111\n");
+
+        Assert::AreEqual(3U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+
+        const auto* pRecord = pFile.Find(9U);
+        Assert::IsNotNull(pRecord);
+        Ensures(pRecord != nullptr);
+        Assert::AreEqual(std::string("Ach3"), Str(pRecord->sTitle));
+
+        pRecord = pFile.Find(7U);
+        Assert::IsNotNull(pRecord);
+        Ensures(pRecord != nullptr);
+        Assert::AreEqual(std::string("Ach1"), Str(pRecord->sTitle));
+
+        // achievements without an id can't be found
+        Assert::IsNull(pFile.Find(0U));
+        Assert::IsNull(pFile.Find(8U));
+    }
+
+    TEST_METHOD(TestLoad)
+    {
+        ra::services::mocks::MockLocalStorage mockStorage;
+        LocalAchievementFile pFile;
+
+        Assert::IsFalse(pFile.Load(1U));
+        Assert::AreEqual(0U, pFile.GameId());
+
+        mockStorage.MockStoredData(ra::services::StorageItemType::UserAchievements, L"1",
+            "0.077\nGame\n7:1=1:Ach1:Desc1::::Auth1:25:1234554321:1234555555:::54321\n");
+        Assert::IsTrue(pFile.Load(1U));
+        Assert::AreEqual(1U, pFile.GameId());
+        Assert::IsNotNull(pFile.Find(7U));
+
+        pFile.Reset();
+        Assert::AreEqual(0U, pFile.GameId());
+        Assert::IsNull(pFile.Find(7U));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+    }
+
+    TEST_METHOD(TestLoadLargeFile)
+    {
+        // larger than a single read
+        std::string sContents = "0.077\nGame\n";
+        for (unsigned int i = 1; i <= 1000; ++i)
+            sContents += ra::StringPrintf("%u:0xH%04x=1:Ach%u:Desc%u::::Auth:5:1234554321:1234555555:::%05u\n", i, i, i, i, i);
+
+        ra::services::mocks::MockLocalStorage mockStorage;
+        mockStorage.MockStoredData(ra::services::StorageItemType::UserAchievements, L"1", sContents);
+
+        LocalAchievementFile pFile;
+        Assert::IsTrue(pFile.Load(1U));
+        Assert::AreEqual(1000U, gsl::narrow_cast<unsigned int>(pFile.Records().size()));
+
+        const auto* pRecord = pFile.Find(777U);
+        Assert::IsNotNull(pRecord);
+        Ensures(pRecord != nullptr);
+        Assert::AreEqual(std::string("0xH0309=1"), Str(pRecord->sTrigger));
+        Assert::AreEqual(std::string("Ach777"), Str(pRecord->sTitle));
+        Assert::AreEqual(std::string("00777"), Str(pRecord->sBadge));
+    }
+};
+
+} // namespace tests
+} // namespace data
+} // namespace ra
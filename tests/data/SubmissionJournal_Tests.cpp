@@ -0,0 +1,289 @@
+#include "CppUnitTest.h"
+
+#include "data\SubmissionJournal.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include "tests\mocks\MockLocalStorage.hh"
+#include "tests\mocks\MockServer.hh"
+#include "tests\mocks\MockThreadPool.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using ra::services::StorageItemType;
+
+namespace ra {
+namespace data {
+namespace tests {
+
+TEST_CLASS(SubmissionJournal_Tests)
+{
+private:
+    class SubmissionJournalHarness : public SubmissionJournal
+    {
+    public:
+        ra::api::mocks::MockServer mockServer;
+        ra::services::mocks::MockLocalStorage mockStorage;
+        ra::services::mocks::MockThreadPool mockThreadPool;
+
+        bool HasStoredData() const
+        {
+            return mockStorage.HasStoredData(StorageItemType::SubmissionJournal, L"User");
+        }
+
+        const std::string& GetStoredData() const
+        {
+            return mockStorage.GetStoredData(StorageItemType::SubmissionJournal, L"User");
+        }
+
+        void MockStoredData(const std::string& sContents)
+        {
+            mockStorage.MockStoredData(StorageItemType::SubmissionJournal, L"User", sContents);
+        }
+
+        void AwardAchievement(unsigned int nAchievementId, bool* pCalled)
+        {
+            ra::api::AwardAchievement::Request request;
+            request.AchievementId = nAchievementId;
+            request.Hardcore = true;
+            request.GameHash = "HASH";
+            SubmissionJournal::AwardAchievement(request, [pCalled](const ra::api::AwardAchievement::Response&)
+            {
+                *pCalled = true;
+            });
+        }
+
+        void SubmitLeaderboardEntry(unsigned int nLeaderboardId, unsigned int nScore, bool* pCalled)
+        {
+            ra::api::SubmitLeaderboardEntry::Request request;
+            request.LeaderboardId = nLeaderboardId;
+            request.Score = nScore;
+            request.GameHash = "HASH";
+            SubmissionJournal::SubmitLeaderboardEntry(request, [pCalled](const ra::api::SubmitLeaderboardEntry::Response&)
+            {
+                *pCalled = true;
+            });
+        }
+
+        void HandleSubmissions(std::vector<unsigned int>& vSubmitted)
+        {
+            mockServer.HandleRequest<ra::api::AwardAchievement>([&vSubmitted](const ra::api::AwardAchievement::Request& request, ra::api::AwardAchievement::Response& response)
+            {
+                vSubmitted.push_back(request.AchievementId);
+                response.Result = ra::api::ApiResult::Success;
+                return true;
+            });
+
+            mockServer.HandleRequest<ra::api::SubmitLeaderboardEntry>([&vSubmitted](const ra::api::SubmitLeaderboardEntry::Request& request, ra::api::SubmitLeaderboardEntry::Response& response)
+            {
+                vSubmitted.push_back(request.LeaderboardId);
+                response.Result = ra::api::ApiResult::Success;
+                return true;
+            });
+        }
+    };
+
+public:
+    TEST_METHOD(TestAwardAchievementNoUser)
+    {
+        SubmissionJournalHarness journal;
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+
+        bool bCalled = false;
+        journal.AwardAchievement(55U, &bCalled);
+        Assert::IsFalse(journal.HasStoredData());
+
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+    }
+
+    TEST_METHOD(TestAwardAchievementRecordedBeforeSend)
+    {
+        SubmissionJournalHarness journal;
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+        journal.Initialize("User");
+        Assert::IsFalse(journal.HasStoredData());
+
+        bool bCalled = false;
+        journal.AwardAchievement(55U, &bCalled);
+        Assert::AreEqual(std::string("A:1:55:1:HASH:8b\n"), journal.GetStoredData());
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+        Assert::IsTrue(vSubmitted.empty());
+        Assert::AreEqual(ra::services::TaskPriority::High, journal.mockThreadPool.NextTaskPriority());
+
+        // once the server responds, there's nothing left to keep
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(std::string(), journal.GetStoredData());
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+    }
+
+    TEST_METHOD(TestAcknowledgeAppendedWhileOthersPending)
+    {
+        SubmissionJournalHarness journal;
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+        journal.Initialize("User");
+
+        bool bCalled1 = false, bCalled2 = false;
+        journal.AwardAchievement(55U, &bCalled1);
+        journal.SubmitLeaderboardEntry(77U, 1234U, &bCalled2);
+        Assert::AreEqual(std::string("A:1:55:1:HASH:8b\nL:2:77:1234:HASH:45\n"), journal.GetStoredData());
+
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled1);
+        Assert::IsFalse(bCalled2);
+        Assert::AreEqual(std::string("A:1:55:1:HASH:8b\nL:2:77:1234:HASH:45\nK:1:ba\n"), journal.GetStoredData());
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled2);
+        Assert::AreEqual(std::string(), journal.GetStoredData());
+    }
+
+    TEST_METHOD(TestErrorResponseAcknowledged)
+    {
+        SubmissionJournalHarness journal;
+        journal.mockServer.HandleRequest<ra::api::AwardAchievement>([](const ra::api::AwardAchievement::Request&, ra::api::AwardAchievement::Response& response)
+        {
+            response.Result = ra::api::ApiResult::Error;
+            response.ErrorMessage = "User already has this achievement awarded.";
+            return true;
+        });
+        journal.Initialize("User");
+
+        bool bCalled = false;
+        journal.AwardAchievement(55U, &bCalled);
+        journal.mockThreadPool.ExecuteNextTask();
+
+        // the server saw the request, so it shouldn't be sent again
+        Assert::IsTrue(bCalled);
+        Assert::AreEqual(std::string(), journal.GetStoredData());
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+    }
+
+    TEST_METHOD(TestUnsupportedResponseKept)
+    {
+        SubmissionJournalHarness journal;
+        journal.Initialize("User");
+
+        bool bCalled = false;
+        journal.AwardAchievement(55U, &bCalled);
+        journal.mockThreadPool.ExecuteNextTask();
+
+        // the server never saw the request, so it should be resubmitted next time
+        Assert::IsTrue(bCalled);
+        Assert::AreEqual(std::string("A:1:55:1:HASH:8b\n"), journal.GetStoredData());
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+    }
+
+    TEST_METHOD(TestUnsupportedResubmittedWhenServerAvailable)
+    {
+        SubmissionJournalHarness journal;
+        journal.Initialize("User");
+
+        bool bCalled1 = false, bCalled2 = false;
+        journal.AwardAchievement(55U, &bCalled1);
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled1);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.mockThreadPool.PendingTasks()));
+
+        // once the server handles a submission, the one it missed is sent again
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+        journal.AwardAchievement(56U, &bCalled2);
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::IsTrue(bCalled2);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(56U, vSubmitted.at(0));
+
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.mockThreadPool.PendingTasks()));
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(55U, vSubmitted.at(1));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+        Assert::AreEqual(std::string(), journal.GetStoredData());
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.mockThreadPool.PendingTasks()));
+    }
+
+    TEST_METHOD(TestNegativeScoreRoundTrip)
+    {
+        SubmissionJournalHarness journal;
+        journal.Initialize("User");
+
+        bool bCalled = false;
+        journal.SubmitLeaderboardEntry(77U, static_cast<unsigned int>(-5), &bCalled);
+        Assert::AreEqual(std::string("L:1:77:-5:HASH:7a\n"), journal.GetStoredData());
+        journal.mockThreadPool.ExecuteNextTask();
+
+        unsigned int nScore = 0;
+        journal.mockServer.HandleRequest<ra::api::SubmitLeaderboardEntry>([&nScore](const ra::api::SubmitLeaderboardEntry::Request& request, ra::api::SubmitLeaderboardEntry::Response& response)
+        {
+            nScore = request.Score;
+            response.Result = ra::api::ApiResult::Success;
+            return true;
+        });
+
+        journal.Initialize("User");
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(static_cast<unsigned int>(-5), nScore);
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+    }
+
+    TEST_METHOD(TestInitializeResubmitsInOrder)
+    {
+        SubmissionJournalHarness journal;
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+        journal.MockStoredData("A:1:55:1:HASH:8b\nL:2:77:1234:HASH:45\n");
+
+        journal.Initialize("User");
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+
+        // only one entry is resubmitted at a time
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.mockThreadPool.PendingTasks()));
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(55U, vSubmitted.at(0));
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+
+        journal.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(vSubmitted.size()));
+        Assert::AreEqual(77U, vSubmitted.at(1));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+        Assert::AreEqual(std::string(), journal.GetStoredData());
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(journal.mockThreadPool.PendingTasks()));
+    }
+
+    TEST_METHOD(TestInitializeSkipsAcknowledgedAndCorruptEntries)
+    {
+        SubmissionJournalHarness journal;
+        std::vector<unsigned int> vSubmitted;
+        journal.HandleSubmissions(vSubmitted);
+        journal.MockStoredData(
+            "A:1:55:1:HASH:8b\n"      // acknowledged
+            "L:2:77:1234:HASH:45\n"   // pending
+            "K:1:ba\n"
+            "A:3:56:0:HASH:00\n"      // bad checksum
+            "A:4:57:1:HA");           // partially written
+
+        journal.Initialize("User");
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(journal.PendingCount()));
+        Assert::AreEqual(std::string("L:2:77:1234:HASH:45\n"), journal.GetStoredData());
+
+        // new entries should not reuse the sequence of a pending entry
+        bool bCalled = false;
+        journal.AwardAchievement(56U, &bCalled);
+        Assert::AreEqual(std::string("L:2:77:1234:HASH:45\nA:3:56:1:HASH:"), journal.GetStoredData().substr(0, 34));
+    }
+};
+
+} // namespace tests
+} // namespace data
+} // namespace ra
@@ -116,6 +116,15 @@ public:
         m_mFileModifiedTimes.insert_or_assign(sPath, tLastModified);
     }
 
+    bool SetLastModified(const std::wstring& sPath, std::chrono::system_clock::time_point tLastModified) const override
+    {
+        if (m_mFileContents.find(sPath) == m_mFileContents.end())
+            return false;
+
+        m_mFileModifiedTimes.insert_or_assign(sPath, tLastModified);
+        return true;
+    }
+
     bool DeleteFile(const std::wstring& sPath) const override
     {
         m_mFileSizes.erase(sPath);
@@ -142,6 +151,22 @@ public:
         return true;
     }
 
+    bool ReplaceFile(const std::wstring& sSourcePath, const std::wstring& sTargetPath) const override
+    {
+        const auto pIter = m_mFileContents.find(sSourcePath);
+        if (pIter == m_mFileContents.end())
+            return false;
+
+        std::string sContents = std::move(pIter->second);
+        m_mFileContents.erase(pIter);
+        m_mFileContents.insert_or_assign(sTargetPath, std::move(sContents));
+        m_mFileSizes.erase(sSourcePath);
+        m_mFileSizes.erase(sTargetPath);
+        m_mFileModifiedTimes.erase(sSourcePath);
+        m_mFileModifiedTimes.erase(sTargetPath);
+        return true;
+    }
+
     std::unique_ptr<TextReader> OpenTextFile(const std::wstring& sPath) const override
     {
         auto pIter = m_mFileContents.find(sPath);
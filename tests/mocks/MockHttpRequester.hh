@@ -19,10 +19,12 @@ public:
 
     void SetUserAgent([[maybe_unused]] const std::string& /*sUserAgent*/) noexcept override {}
 
-    unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter) const override
+    unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter,
+                         Http::Validators& pValidators) const override
     {
         auto response = m_fHandler(pRequest);
         pContentWriter.Write(response.Content());
+        pValidators = response.GetValidators();
         return ra::etoi(response.StatusCode());
     }
 
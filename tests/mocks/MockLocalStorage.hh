@@ -62,6 +62,12 @@ public:
         return std::unique_ptr<TextWriter>(pWriter.release());
     }
 
+    std::unique_ptr<TextWriter> ReplaceText(StorageItemType nType, const std::wstring& sKey) override
+    {
+        // the stored data is replaced immediately, there's nothing to interrupt the write
+        return WriteText(nType, sKey);
+    }
+
     std::unique_ptr<TextWriter> AppendText(StorageItemType nType, const std::wstring& sKey) override
     {
         const gsl::not_null<std::string*> pText{gsl::make_not_null(GetText(nType, sKey, true))};
@@ -69,6 +75,30 @@ public:
         return std::unique_ptr<TextWriter>(pWriter.release());
     }
 
+    Http::Validators GetValidators(StorageItemType nType, const std::wstring& sKey) override
+    {
+        if (GetText(nType, sKey, false) == nullptr)
+            return {};
+
+        const auto pMap = m_mValidators.find(nType);
+        if (pMap == m_mValidators.end())
+            return {};
+
+        const auto pIter = pMap->second.find(sKey);
+        if (pIter == pMap->second.end())
+            return {};
+
+        return pIter->second;
+    }
+
+    void SetValidators(StorageItemType nType, const std::wstring& sKey, const Http::Validators& pValidators) override
+    {
+        if (pValidators.IsEmpty())
+            m_mValidators[nType].erase(sKey);
+        else
+            m_mValidators[nType].insert_or_assign(sKey, pValidators);
+    }
+
 private:
     std::string* GetText(StorageItemType nType, const std::wstring& sKey, bool bCreateIfMissing) const
     {
@@ -97,6 +127,7 @@ private:
 
     ra::services::ServiceLocator::ServiceOverride<ra::services::ILocalStorage> m_Override;
     mutable std::unordered_map<StorageItemType, std::unordered_map<std::wstring, std::string>> m_mStoredData;
+    std::unordered_map<StorageItemType, std::unordered_map<std::wstring, Http::Validators>> m_mValidators;
 };
 
 } // namespace mocks
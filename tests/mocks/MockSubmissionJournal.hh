@@ -0,0 +1,36 @@
+#ifndef RA_DATA_MOCK_SUBMISSION_JOURNAL_HH
+#define RA_DATA_MOCK_SUBMISSION_JOURNAL_HH
+#pragma once
+
+#include "data\SubmissionJournal.hh"
+
+#include "services\ServiceLocator.hh"
+
+namespace ra {
+namespace data {
+namespace mocks {
+
+class MockSubmissionJournal : public SubmissionJournal
+{
+public:
+    MockSubmissionJournal() noexcept
+        : m_Override(this)
+    {
+    }
+
+    bool LoadJournal() noexcept override
+    {
+        return false;
+    }
+
+    const std::wstring& GetUsername() const noexcept { return m_sUsername; }
+
+private:
+    ra::services::ServiceLocator::ServiceOverride<ra::data::SubmissionJournal> m_Override;
+};
+
+} // namespace mocks
+} // namespace data
+} // namespace ra
+
+#endif // !RA_DATA_MOCK_SUBMISSION_JOURNAL_HH
@@ -21,7 +21,14 @@ public:
 
     void RunAsync(std::function<void()>&& f) override
     {
+        RunAsync(TaskPriority::Normal, std::move(f));
+    }
+
+    void RunAsync(TaskPriority nPriority, std::function<void()>&& f) override
+    {
+        // tasks are executed in the order they were queued so tests can control the sequence of events
         m_vTasks.emplace(f);
+        m_vPriorities.emplace(nPriority);
     }
 
     void ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f) override
@@ -29,6 +36,11 @@ public:
         m_vDelayedTasks.emplace_back(nDelay, f);
     }
 
+    void ScheduleAsync(std::chrono::milliseconds nDelay, _UNUSED TaskPriority nPriority, std::function<void()>&& f) override
+    {
+        m_vDelayedTasks.emplace_back(nDelay, f);
+    }
+
     void AdvanceTime(std::chrono::milliseconds nDuration)
     {
         std::vector<std::function<void()>> vTasks;
@@ -71,6 +83,15 @@ public:
     /// </summary>
     size_t PendingTasks() const { return m_vTasks.size() + m_vDelayedTasks.size(); }
 
+    /// <summary>
+    /// Gets the priority the next outstanding task was queued with.
+    /// </summary>
+    TaskPriority NextTaskPriority() const
+    {
+        Expects(!m_vPriorities.empty());
+        return m_vPriorities.front();
+    }
+
     /// <summary>
     /// Executes the next outstanding task.
     /// </summary>
@@ -81,6 +102,7 @@ public:
 
         auto fTask = m_vTasks.front();
         m_vTasks.pop();
+        m_vPriorities.pop();
         fTask();
     }
 
@@ -92,6 +114,7 @@ private:
     ra::services::ServiceLocator::ServiceOverride<ra::services::IThreadPool> m_Override;
 
     std::queue<std::function<void()>> m_vTasks;
+    std::queue<TaskPriority> m_vPriorities;
 
     struct DelayedTask
     {
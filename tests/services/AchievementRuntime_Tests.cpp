@@ -3,10 +3,58 @@
 #include "tests\RA_UnitTestHelpers.h"
 #include "tests\mocks\MockFileSystem.hh"
 #include "tests\mocks\MockGameContext.hh"
+#include "tests\mocks\MockLocalStorage.hh"
 #include "tests\mocks\MockUserContext.hh"
 
+#include <crtdbg.h>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
+#ifdef _DEBUG
+// counts heap allocations made by the current thread while in scope so tests can verify the per-frame path
+// doesn't allocate. the allocation hook is only called by the debug CRT.
+class AllocationCounter
+{
+public:
+    AllocationCounter() noexcept
+    {
+        s_nAllocations = 0U;
+        s_bCounting = true;
+        m_pPreviousHook = _CrtSetAllocHook(AllocHook);
+    }
+
+    ~AllocationCounter() noexcept
+    {
+        _CrtSetAllocHook(m_pPreviousHook);
+        s_bCounting = false;
+    }
+
+    AllocationCounter(const AllocationCounter&) noexcept = delete;
+    AllocationCounter& operator=(const AllocationCounter&) noexcept = delete;
+    AllocationCounter(AllocationCounter&&) noexcept = delete;
+    AllocationCounter& operator=(AllocationCounter&&) noexcept = delete;
+
+    size_t Count() const noexcept { return s_nAllocations; }
+
+private:
+    static int __cdecl AllocHook(int nAllocType, void*, size_t, int, long, const unsigned char*, int) noexcept
+    {
+        if (s_bCounting && nAllocType != _HOOK_FREE)
+            ++s_nAllocations;
+
+        return TRUE;
+    }
+
+    _CRT_ALLOC_HOOK m_pPreviousHook = nullptr;
+
+    static thread_local bool s_bCounting;
+    static thread_local size_t s_nAllocations;
+};
+
+thread_local bool AllocationCounter::s_bCounting = false;
+thread_local size_t AllocationCounter::s_nAllocations = 0U;
+#endif
+
 namespace Microsoft {
 namespace VisualStudio {
 namespace CppUnitTestFramework {
@@ -698,6 +746,366 @@ public:
         runtime.Process(vChanges);
         Assert::AreEqual(0U, vChanges.size());
     }
+
+    TEST_METHOD(TestCaptureRestoreState)
+    {
+        std::array<unsigned char, 5> memory{ 0x00, 0x12, 0x34, 0xAB, 0x56 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pTrigger = ParseTrigger("0xH0000=0.10._0xH0001=18");
+        runtime.ActivateAchievement(6U, pTrigger);
+
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        runtime.Process(vChanges);
+        runtime.Process(vChanges);
+        Assert::AreEqual(3U, pTrigger->requirement->conditions->current_hits);
+
+        std::array<unsigned char, 256> pState{};
+        const auto nSize = runtime.GetStateSize();
+        Assert::IsTrue(nSize <= pState.size());
+
+        // buffer too small, nothing written
+        Assert::AreEqual(0U, runtime.CaptureState(pState.data(), nSize - 1));
+        Assert::AreEqual(nSize, runtime.CaptureState(pState.data(), pState.size()));
+
+        // advance the state
+        memory.at(1) = 0x13;
+        runtime.Process(vChanges);
+        runtime.Process(vChanges);
+        Assert::AreEqual(5U, pTrigger->requirement->conditions->current_hits);
+        Assert::AreEqual(0x13U, pTrigger->memrefs->next->value);
+
+        // restore should put the hits and memory references back
+        Assert::IsTrue(runtime.RestoreState(pState.data(), nSize));
+        Assert::AreEqual(3U, pTrigger->requirement->conditions->current_hits);
+        Assert::AreEqual(0x12U, pTrigger->memrefs->next->value);
+        Assert::AreEqual(0x12U, pTrigger->memrefs->next->previous);
+
+        // corrupt buffer should be rejected without modifying anything
+        pState.at(0) = 0;
+        runtime.Process(vChanges);
+        Assert::IsFalse(runtime.RestoreState(pState.data(), nSize));
+        Assert::AreEqual(4U, pTrigger->requirement->conditions->current_hits);
+        Assert::AreEqual(0U, vChanges.size());
+    }
+
+    TEST_METHOD(TestRestoreStateCorruptedCounts)
+    {
+        std::array<unsigned char, 5> memory{ 0x00, 0x12, 0x34, 0xAB, 0x56 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pTrigger = ParseTrigger("0xH0000=0.10._0xH0001=18");
+        runtime.ActivateAchievement(6U, pTrigger);
+
+        std::array<unsigned char, 256> pState{};
+        const auto nSize = runtime.CaptureState(pState.data(), pState.size());
+        Assert::AreNotEqual(0U, nSize);
+
+        // memref count that wraps around to 4 bytes if the skip size is computed in 32 bits
+        constexpr unsigned int nNumMemRefs = 0x0CCCCCCD;
+        memcpy(&pState.at(5 * sizeof(unsigned int) + 2 * sizeof(unsigned int)), &nNumMemRefs, sizeof(nNumMemRefs));
+        Assert::IsFalse(runtime.RestoreState(pState.data(), nSize));
+
+        // condition count past the end of the buffer
+        runtime.CaptureState(pState.data(), pState.size());
+        constexpr unsigned int nNumConditions = 0xFFFFFFFF;
+        memcpy(&pState.at(5 * sizeof(unsigned int) + 3 * sizeof(unsigned int)), &nNumConditions, sizeof(nNumConditions));
+        Assert::IsFalse(runtime.RestoreState(pState.data(), nSize));
+    }
+
+    TEST_METHOD(TestTraceWrittenOnTrigger)
+    {
+        std::array<unsigned char, 2> memory{};
+        InitializeMemory(memory);
+
+        ra::services::mocks::MockLocalStorage mockLocalStorage;
+        AchievementRuntime runtime;
+        std::array<unsigned char, 256> sBuffer1{}, sBuffer2{};
+        runtime.ActivateAchievement(6U, ParseTrigger("0xH0000=1_0xH0001=1", sBuffer1.data(), sBuffer1.size()));
+        runtime.ActivateAchievement(7U, ParseTrigger("0xH0000=1", sBuffer2.data(), sBuffer2.size()));
+        runtime.SetTraced(6U, true);
+        Assert::IsTrue(runtime.IsTraced(6U));
+        Assert::IsFalse(runtime.IsTraced(7U));
+        Assert::IsNull(runtime.GetTrace(6U));
+        Assert::IsNull(runtime.GetTrace(7U));
+
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+
+        // untraced achievement triggering should not write anything
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(7U, vChanges.front().nId);
+        Assert::IsFalse(mockLocalStorage.HasStoredData(StorageItemType::RuntimeTrace, L"7"));
+        Assert::IsFalse(mockLocalStorage.HasStoredData(StorageItemType::RuntimeTrace, L"6"));
+        runtime.DeactivateAchievement(7U);
+
+        const auto* pTrace = runtime.GetTrace(6U);
+        Expects(pTrace != nullptr);
+        Assert::AreEqual(2U, pTrace->GetFrameCount());
+
+        vChanges.clear();
+        memory.at(1) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(6U, vChanges.front().nId);
+        Assert::AreEqual(std::string("6:2:3\n1:00:0,0\n2:10:1,0\n3:11:1,1\n"),
+                         mockLocalStorage.GetStoredData(StorageItemType::RuntimeTrace, L"6"));
+
+        runtime.SetTraced(6U, false);
+        Assert::IsFalse(runtime.IsTraced(6U));
+        Assert::IsNull(runtime.GetTrace(6U));
+    }
+
+    TEST_METHOD(TestTraceDiscardedOnDeactivate)
+    {
+        std::array<unsigned char, 2> memory{};
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        std::array<unsigned char, 256> sBuffer1{}, sBuffer2{};
+        runtime.ActivateAchievement(6U, ParseTrigger("0xH0000=1_0xH0001=1", sBuffer1.data(), sBuffer1.size()));
+        runtime.SetTraced(6U, true);
+
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        runtime.Process(vChanges);
+        Assert::IsNotNull(runtime.GetTrace(6U));
+
+        // the trace points at the conditions of the old trigger, so it can't survive the trigger being replaced
+        runtime.DeactivateAchievement(6U);
+        Assert::IsNull(runtime.GetTrace(6U));
+        Assert::IsTrue(runtime.IsTraced(6U));
+
+        runtime.ActivateAchievement(6U, ParseTrigger("0xH0000=1", sBuffer2.data(), sBuffer2.size()));
+        runtime.Process(vChanges);
+
+        const auto* pTrace = runtime.GetTrace(6U);
+        Expects(pTrace != nullptr);
+        Assert::AreEqual(1U, pTrace->GetConditionCount());
+        Assert::AreEqual(1U, pTrace->GetFrameCount());
+    }
+
+    TEST_METHOD(TestLeaderboardStartHitTargetUnchangedMemory)
+    {
+        std::array<unsigned char, 3> memory{ 0x01, 0x00, 0x34 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pLeaderboard = ParseLeaderboard("STA:0xH00=1.3.::CAN:0xH00=2::SUB:0xH00=3::VAL:0xH02");
+        runtime.ActivateLeaderboard(6U, pLeaderboard);
+
+        // memory doesn't change, but the start trigger still has to be evaluated to accumulate hits
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+        runtime.Process(vChanges);
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(AchievementRuntime::ChangeType::LeaderboardStarted, vChanges.front().nType);
+        Assert::AreEqual(52U, vChanges.front().nValue);
+    }
+
+    TEST_METHOD(TestLeaderboardCancelHitTargetWhileInactive)
+    {
+        std::array<unsigned char, 3> memory{ 0x00, 0x01, 0x34 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pLeaderboard = ParseLeaderboard("STA:0xH00=1::CAN:0xH01=1.2.::SUB:0xH00=3::VAL:0xH02");
+        runtime.ActivateLeaderboard(6U, pLeaderboard);
+
+        // the cancel trigger accumulates hits even though the leaderboard hasn't started, like rc_evaluate_lboard
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+        Assert::AreEqual(2U, pLeaderboard->cancel.requirement->conditions->current_hits);
+
+        // cancel is already true, so the leaderboard can't start
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+    }
+
+    TEST_METHOD(TestLeaderboardStartDeltaUnchangedMemory)
+    {
+        std::array<unsigned char, 3> memory{ 0x00, 0x00, 0x34 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pLeaderboard = ParseLeaderboard("STA:d0xH00=0_0xH00=1::CAN:0xH01=1::SUB:0xH00=3::VAL:0xH02");
+        runtime.ActivateLeaderboard(6U, pLeaderboard);
+
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+
+        // start and cancel true in the same frame - not started
+        memory.at(0) = 1;
+        memory.at(1) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+
+        // memory unchanged, but the delta has caught up, so the start trigger is no longer true
+        memory.at(1) = 0;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+
+        // transition again
+        memory.at(0) = 0;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(AchievementRuntime::ChangeType::LeaderboardStarted, vChanges.front().nType);
+    }
+
+    TEST_METHOD(TestCaptureRestoreStateQueuedAndLeaderboard)
+    {
+        std::array<unsigned char, 5> memory{ 0x00, 0x12, 0x34, 0xAB, 0x56 };
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        auto* pTrigger = ParseTrigger("0xH0000=0");
+        runtime.SetPaused(true);
+        runtime.ActivateAchievement(6U, pTrigger);
+        runtime.SetPaused(false);
+
+        std::array<unsigned char, 1024> sLeaderboardBuffer{};
+        auto* pLeaderboard = ParseLeaderboard("STA:0xH00=1::CAN:0xH00=2::SUB:0xH00=3::VAL:0xH02",
+                                              sLeaderboardBuffer.data(), sLeaderboardBuffer.size());
+        runtime.ActivateLeaderboard(7U, pLeaderboard);
+
+        // achievement is queued because it's true. capture that.
+        std::vector<AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+
+        std::array<unsigned char, 512> pState{};
+        const auto nSize = runtime.CaptureState(pState.data(), pState.size());
+        Assert::AreNotEqual(0U, nSize);
+
+        // make achievement false (promotes to active) and start the leaderboard
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(AchievementRuntime::ChangeType::LeaderboardStarted, vChanges.front().nType);
+        vChanges.clear();
+
+        // restore - achievement should be queued again, and leaderboard should no longer be started
+        memory.at(0) = 0;
+        Assert::IsTrue(runtime.RestoreState(pState.data(), nSize));
+        runtime.Process(vChanges);
+        Assert::AreEqual(0U, vChanges.size());
+
+        // make sure the leaderboard can be started again
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+        Assert::AreEqual(1U, vChanges.size());
+        Assert::AreEqual(7U, vChanges.front().nId);
+        Assert::AreEqual(AchievementRuntime::ChangeType::LeaderboardStarted, vChanges.front().nType);
+    }
+
+#ifdef _DEBUG
+    TEST_METHOD(TestProcessDoesNotAllocate)
+    {
+        std::array<unsigned char, 5> memory{0x00, 0x12, 0x34, 0xAB, 0x56};
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        std::array<unsigned char, 1024> sTriggerBuffer2{}, sTriggerBuffer3{}, sTriggerBuffer4{}, sLeaderboardBuffer{};
+
+        // queued achievement that remains queued because its trigger is true
+        runtime.SetPaused(true);
+        runtime.ActivateAchievement(1U, ParseTrigger("0xH0001=18"));
+        runtime.SetPaused(false);
+
+        // compiled achievement, monitored achievement accumulating hits, and achievement evaluated by rcheevos
+        runtime.ActivateAchievement(2U, ParseTrigger("0xH0000=1_0xH0001=18", sTriggerBuffer2.data(), sizeof(sTriggerBuffer2)));
+        runtime.MonitorAchievementReset(3U, ParseTrigger("0xH0000=0.100._R:0xH0002=1", sTriggerBuffer3.data(), sizeof(sTriggerBuffer3)));
+        runtime.ActivateAchievement(4U, ParseTrigger("C:0xH0001=18_0xH0000=1.100.", sTriggerBuffer4.data(), sizeof(sTriggerBuffer4)));
+
+        // inactive leaderboard
+        runtime.ActivateLeaderboard(5U, ParseLeaderboard("STA:0xH0000=1::CAN:0xH0000=2::SUB:0xH0000=3::VAL:0xH0002",
+                                                         sLeaderboardBuffer.data(), sizeof(sLeaderboardBuffer)));
+
+        runtime.Process();
+
+        size_t nChanges = 0U;
+        size_t nAllocations = 0U;
+        {
+            AllocationCounter pCounter;
+            for (int i = 0; i < 10; ++i)
+                nChanges += runtime.Process().size();
+
+            nAllocations = pCounter.Count();
+        }
+
+        Assert::AreEqual(0U, nChanges);
+        Assert::AreEqual(0U, nAllocations);
+    }
+#endif
+
+    TEST_METHOD(TestParallelEvaluation)
+    {
+        std::array<unsigned char, 32> memory{};
+        InitializeMemory(memory);
+
+        AchievementRuntime runtime;
+        runtime.SetParallelEvaluation(4U);
+
+        // enough achievements to exceed the threshold, alternating between compiled and rcheevos-evaluated triggers
+        constexpr unsigned int nAchievements = gsl::narrow_cast<unsigned int>(AchievementRuntime::ParallelEvaluationThreshold) + 44;
+        std::vector<std::vector<unsigned char>> vBuffers(nAchievements);
+        for (unsigned int nId = 1; nId <= nAchievements; ++nId)
+        {
+            const auto sTrigger = (nId & 1) ?
+                ra::StringPrintf("0xH%04x=1_0xH001f=0", nId % 16) :
+                ra::StringPrintf("N:0xH001f=0_0xH%04x=1", nId % 16);
+
+            auto& pBuffer = vBuffers.at(nId - 1);
+            pBuffer.resize(ra::to_unsigned(rc_trigger_size(sTrigger.c_str())));
+            runtime.ActivateAchievement(nId, rc_parse_trigger(pBuffer.data(), sTrigger.c_str(), nullptr, 0));
+        }
+
+        Assert::AreEqual(0U, runtime.Process().size());
+
+        // triggers must be reported in activation order, regardless of which worker evaluated them
+        memory.at(3) = 1;
+        const auto& vChanges = runtime.Process();
+        Assert::AreEqual(gsl::narrow_cast<size_t>((nAchievements + 12) / 16), vChanges.size());
+        unsigned int nExpectedId = 3;
+        for (const auto& pChange : vChanges)
+        {
+            Assert::AreEqual(AchievementRuntime::ChangeType::AchievementTriggered, pChange.nType);
+            Assert::AreEqual(nExpectedId, pChange.nId);
+            nExpectedId += 16;
+        }
+
+        // the snapshot must be refreshed every frame
+        memory.at(3) = 0;
+        memory.at(5) = 1;
+        const auto& vChanges2 = runtime.Process();
+        Assert::AreEqual(gsl::narrow_cast<size_t>((nAchievements + 10) / 16), vChanges2.size());
+        Assert::AreEqual(5U, vChanges2.front().nId);
+
+        // below the threshold, evaluation is serial and gives the same results
+        for (unsigned int nId = 1; nId <= 100; ++nId)
+            runtime.DeactivateAchievement(nId);
+
+        const auto& vChanges3 = runtime.Process();
+        Assert::AreEqual(gsl::narrow_cast<size_t>((nAchievements + 10) / 16 - 6), vChanges3.size());
+        Assert::AreEqual(101U, vChanges3.front().nId);
+    }
 };
 
 } // namespace tests
@@ -0,0 +1,217 @@
+#include "services\CompiledTrigger.hh"
+
+#include "RA_MemManager.h"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(CompiledTrigger_Tests)
+{
+private:
+    static rc_trigger_t* ParseTrigger(const char* sTrigger, std::vector<unsigned char>& pBuffer)
+    {
+        Expects(sTrigger != nullptr);
+
+        const auto nSize = rc_trigger_size(sTrigger);
+        Expects(nSize > 0);
+        pBuffer.resize(to_unsigned(nSize));
+
+        return rc_parse_trigger(pBuffer.data(), sTrigger, nullptr, 0);
+    }
+
+    static void GetHitCounts(const rc_condset_t* pCondSet, std::vector<unsigned int>& vHits)
+    {
+        for (const auto* pCondition = pCondSet->conditions; pCondition != nullptr; pCondition = pCondition->next)
+            vHits.push_back(pCondition->current_hits);
+    }
+
+    static std::vector<unsigned int> GetHitCounts(const rc_trigger_t* pTrigger)
+    {
+        std::vector<unsigned int> vHits;
+        if (pTrigger->requirement)
+            GetHitCounts(pTrigger->requirement, vHits);
+
+        for (const auto* pAlternate = pTrigger->alternative; pAlternate != nullptr; pAlternate = pAlternate->next)
+            GetHitCounts(pAlternate, vHits);
+
+        return vHits;
+    }
+
+    // evaluates the trigger with both rcheevos and the compiled interpreter for each memory state and
+    // ensures they agree on the result and the hit counts
+    template<size_t N>
+    static void AssertSameAsRcheevos(const char* sTrigger, std::array<unsigned char, N>& memory,
+                                     const std::vector<std::array<unsigned char, N>>& vFrames)
+    {
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pExpectedBuffer, pActualBuffer;
+        auto* pExpectedTrigger = ParseTrigger(sTrigger, pExpectedBuffer);
+        auto* pActualTrigger = ParseTrigger(sTrigger, pActualBuffer);
+
+        const auto pCompiledTrigger = CompiledTrigger::Compile(*pActualTrigger);
+        Assert::IsNotNull(pCompiledTrigger.get(), ra::Widen(sTrigger).c_str());
+
+        for (size_t nFrame = 0; nFrame < vFrames.size(); ++nFrame)
+        {
+            memory = vFrames.at(nFrame);
+
+            const auto sMessage = ra::StringPrintf(L"%s frame %zu", sTrigger, nFrame);
+            const bool bExpected = rc_test_trigger(pExpectedTrigger, rc_peek_callback, nullptr, nullptr) != 0;
+            const bool bActual = pCompiledTrigger->Test(rc_peek_callback, nullptr);
+            Assert::AreEqual(bExpected, bActual, sMessage.c_str());
+
+            const auto vExpectedHits = GetHitCounts(pExpectedTrigger);
+            const auto vActualHits = GetHitCounts(pActualTrigger);
+            Assert::AreEqual(vExpectedHits.size(), vActualHits.size(), sMessage.c_str());
+            for (size_t nIndex = 0; nIndex < vExpectedHits.size(); ++nIndex)
+                Assert::AreEqual(vExpectedHits.at(nIndex), vActualHits.at(nIndex), sMessage.c_str());
+
+            bool bExpectedHasHits = false;
+            for (const auto nHits : vExpectedHits)
+                bExpectedHasHits |= (nHits != 0);
+            Assert::AreEqual(bExpectedHasHits, pCompiledTrigger->HasHitCounts(), sMessage.c_str());
+        }
+    }
+
+public:
+    TEST_METHOD(TestCompileUnsupported)
+    {
+        std::vector<unsigned char> pBuffer;
+        Assert::IsNull(CompiledTrigger::Compile(*ParseTrigger("C:0xH0000=1_0xH0001=1.2.", pBuffer)).get());
+        Assert::IsNull(CompiledTrigger::Compile(*ParseTrigger("N:0xH0000=1_0xH0001=1", pBuffer)).get());
+
+        Assert::IsNotNull(CompiledTrigger::Compile(*ParseTrigger("0xH0000=1_d0xH0001<p0xH0002", pBuffer)).get());
+    }
+
+    TEST_METHOD(TestCompareOperators)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("0xH0000=0xH0001_0xH0000!=2_0xH0000<3_0xH0000<=3_0xH0001>0_0xH0001>=1", memory,
+                             {{{0, 0}}, {{1, 1}}, {{2, 2}}, {{3, 3}}, {{1, 1}}, {{3, 4}}});
+    }
+
+    TEST_METHOD(TestSizes)
+    {
+        std::array<unsigned char, 4> memory{};
+        AssertSameAsRcheevos("0xM0000=1_0xT0000=1_0xL0001=2_0xU0001=3_0x 0002=4660_0xX0000!=0", memory,
+                             {{{0x81, 0x32, 0x34, 0x12}}, {{0x80, 0x32, 0x34, 0x12}}, {{0x81, 0x23, 0x34, 0x12}}});
+    }
+
+    TEST_METHOD(TestDeltaPrior)
+    {
+        std::array<unsigned char, 1> memory{};
+        AssertSameAsRcheevos("d0xH0000=1_0xH0000=2_p0xH0000=1", memory,
+                             {{{1}}, {{1}}, {{2}}, {{2}}, {{3}}, {{1}}, {{2}}});
+    }
+
+    TEST_METHOD(TestHitTargets)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("0xH0000=1.3._0xH0001=1", memory,
+                             {{{1, 0}}, {{0, 0}}, {{1, 0}}, {{0, 1}}, {{1, 1}}, {{0, 1}}, {{0, 0}}});
+    }
+
+    TEST_METHOD(TestResetIf)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("0xH0000=1.3._R:0xH0001=1", memory,
+                             {{{1, 0}}, {{1, 0}}, {{1, 1}}, {{1, 0}}, {{1, 0}}, {{1, 0}}, {{1, 1}}, {{1, 0}}});
+    }
+
+    TEST_METHOD(TestPauseIf)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("0xH0000=1.3._P:0xH0001=1_R:0xH0001=2", memory,
+                             {{{1, 0}}, {{1, 1}}, {{1, 2}}, {{1, 1}}, {{1, 0}}, {{1, 0}}, {{1, 0}}});
+    }
+
+    TEST_METHOD(TestPauseIfHitTarget)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("0xH0000=1.5._P:0xH0001=1.2.", memory,
+                             {{{1, 0}}, {{1, 1}}, {{1, 0}}, {{1, 1}}, {{1, 0}}, {{1, 0}}, {{1, 0}}});
+    }
+
+    TEST_METHOD(TestAddSourceSubSource)
+    {
+        std::array<unsigned char, 3> memory{};
+        AssertSameAsRcheevos("A:0xH0000=0_B:0xH0001=0_0xH0002=4_A:0xH0000=0_P:0xH0001=9", memory,
+                             {{{2, 1, 3}}, {{5, 1, 4}}, {{5, 4, 4}}, {{8, 1, 7}}, {{8, 3, 7}}, {{0, 0, 0}}});
+    }
+
+    TEST_METHOD(TestAlts)
+    {
+        std::array<unsigned char, 3> memory{};
+        AssertSameAsRcheevos("0xH0000=1S0xH0001=1.2.S0xH0002=1_R:0xH0001=2", memory,
+                             {{{0, 1, 0}}, {{1, 1, 0}}, {{1, 0, 1}}, {{1, 2, 1}}, {{1, 0, 0}}, {{0, 0, 1}}});
+    }
+
+    TEST_METHOD(TestResetIfInAlt)
+    {
+        std::array<unsigned char, 3> memory{};
+        AssertSameAsRcheevos("0xH0000=1S0xH0001=1S0xH0002=1_R:0xH0002=2", memory,
+                             {{{1, 1, 0}}, {{1, 1, 2}}, {{1, 1, 0}}, {{1, 0, 2}}, {{1, 0, 1}}});
+
+        // the first alt is true, but the ResetIf in the second alt should keep the trigger from firing
+        InitializeMemory(memory);
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1S0xH0001=1.2.S0xH0002=1_R:0xH0002=2", pBuffer);
+        const auto pCompiledTrigger = CompiledTrigger::Compile(*pTrigger);
+        Expects(pCompiledTrigger != nullptr);
+
+        memory = {{1, 1, 0}};
+        Assert::IsFalse(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+        Assert::IsTrue(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+
+        memory = {{1, 1, 2}};
+        Assert::IsFalse(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+        Assert::IsFalse(pCompiledTrigger->HasHitCounts());
+
+        // hit count was reset, so the first alt has to be true for two more frames
+        memory = {{1, 1, 0}};
+        Assert::IsFalse(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+        Assert::IsTrue(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+    }
+
+    TEST_METHOD(TestEmptyCore)
+    {
+        std::array<unsigned char, 2> memory{};
+        AssertSameAsRcheevos("S0xH0000=1S0xH0001=1", memory, {{{0, 0}}, {{1, 0}}, {{0, 1}}, {{1, 1}}});
+    }
+
+    TEST_METHOD(TestHasHitCountsExternalChanges)
+    {
+        std::array<unsigned char, 1> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1.3.", pBuffer);
+        const auto pCompiledTrigger = CompiledTrigger::Compile(*pTrigger);
+        Expects(pCompiledTrigger != nullptr);
+        Assert::IsFalse(pCompiledTrigger->HasHitCounts());
+
+        // modifications outside of the interpreter aren't seen until synced
+        pTrigger->requirement->conditions->current_hits = 2;
+        Assert::IsFalse(pCompiledTrigger->HasHitCounts());
+        pCompiledTrigger->SyncHitCounts();
+        Assert::IsTrue(pCompiledTrigger->HasHitCounts());
+
+        pCompiledTrigger->Reset();
+        Assert::AreEqual(0U, pTrigger->requirement->conditions->current_hits);
+        Assert::IsFalse(pCompiledTrigger->HasHitCounts());
+
+        memory.at(0) = 1;
+        Assert::IsFalse(pCompiledTrigger->Test(rc_peek_callback, nullptr));
+        Assert::IsTrue(pCompiledTrigger->HasHitCounts());
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
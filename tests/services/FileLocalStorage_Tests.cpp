@@ -16,6 +16,25 @@ namespace tests {
 
 TEST_CLASS(FileLocalStorage_Tests)
 {
+private:
+    // a file system where every file created reports an error when it's closed (i.e. the disk is full)
+    class MockFileSystemWriteFails : public MockFileSystem
+    {
+    public:
+        std::unique_ptr<TextWriter> CreateTextFile(const std::wstring& sPath) const override
+        {
+            MockFileSystem::CreateTextFile(sPath);
+            return std::make_unique<FailingTextWriter>();
+        }
+
+    private:
+        class FailingTextWriter : public StringTextWriter
+        {
+        public:
+            bool Commit() noexcept override { return false; }
+        };
+    };
+
 public:
     TEST_METHOD(TestDirectories)
     {
@@ -116,6 +135,9 @@ public:
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::UserAchievements, L"12345"), std::wstring(L".\\RACache\\Data\\12345-User.txt"));
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::Badge, L"12345"), std::wstring(L".\\RACache\\Badge\\12345.png"));
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::UserPic, L"12345"), std::wstring(L".\\RACache\\UserPic\\12345.png"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::RuntimeTrace, L"12345"), std::wstring(L".\\RACache\\Data\\12345-Trace.txt"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::GameDataCache, L"12345"), std::wstring(L".\\RACache\\Data\\12345.bin"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::SubmissionJournal, L"12345"), std::wstring(L".\\RACache\\12345-pending.txt"));
     }
 
     TEST_METHOD(TestReadTextNonExistant)
@@ -155,6 +177,102 @@ public:
         pData->Write("{\"Key\": 1}");
         Assert::AreEqual(std::string("{\"Key\": 1}"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345.json"));
     }
+
+    TEST_METHOD(TestReplaceText)
+    {
+        MockFileSystem mockFileSystem;
+        FileLocalStorage storage(mockFileSystem);
+
+        mockFileSystem.MockFile(L".\\RACache\\Data\\12345-User.txt", "Old");
+
+        auto pData = storage.ReplaceText(ra::services::StorageItemType::UserAchievements, L"12345");
+        Assert::IsFalse(pData == nullptr);
+
+        // existing file is untouched until the writer is committed
+        pData->Write("New");
+        Assert::AreEqual(std::string("Old"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt"));
+        Assert::AreEqual(std::string("New"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt.tmp"));
+
+        Assert::IsTrue(pData->Commit());
+        Assert::AreEqual(std::string("New"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt"));
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\RACache\\Data\\12345-User.txt.tmp"));
+    }
+
+    TEST_METHOD(TestReplaceTextNotCommitted)
+    {
+        MockFileSystem mockFileSystem;
+        FileLocalStorage storage(mockFileSystem);
+
+        mockFileSystem.MockFile(L".\\RACache\\Data\\12345-User.txt", "Old");
+
+        auto pData = storage.ReplaceText(ra::services::StorageItemType::UserAchievements, L"12345");
+        Assert::IsFalse(pData == nullptr);
+        pData->Write("New");
+
+        // destroying the writer without committing it discards the new data
+        pData.reset();
+        Assert::AreEqual(std::string("Old"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt"));
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\RACache\\Data\\12345-User.txt.tmp"));
+    }
+
+    TEST_METHOD(TestReplaceTextCommitFailed)
+    {
+        MockFileSystem mockFileSystem;
+        FileLocalStorage storage(mockFileSystem);
+
+        mockFileSystem.MockFile(L".\\RACache\\Data\\12345-User.txt", "Old");
+
+        auto pData = storage.ReplaceText(ra::services::StorageItemType::UserAchievements, L"12345");
+        Assert::IsFalse(pData == nullptr);
+        pData->Write("New");
+
+        // if the temporary file can't be moved, the failure is reported and the existing file is untouched
+        mockFileSystem.MoveFile(L".\\RACache\\Data\\12345-User.txt.tmp", L".\\RACache\\Data\\Moved.txt");
+        Assert::IsFalse(pData->Commit());
+        Assert::AreEqual(std::string("Old"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt"));
+    }
+
+    TEST_METHOD(TestReplaceTextWriteFailed)
+    {
+        MockFileSystemWriteFails mockFileSystem;
+        FileLocalStorage storage(mockFileSystem);
+
+        mockFileSystem.MockFile(L".\\RACache\\Data\\12345-User.txt", "Old");
+
+        auto pData = storage.ReplaceText(ra::services::StorageItemType::UserAchievements, L"12345");
+        Assert::IsFalse(pData == nullptr);
+        pData->Write("New");
+
+        // the temporary file is discarded instead of replacing the existing file
+        Assert::IsFalse(pData->Commit());
+        Assert::AreEqual(std::string("Old"), mockFileSystem.GetFileContents(L".\\RACache\\Data\\12345-User.txt"));
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\RACache\\Data\\12345-User.txt.tmp"));
+    }
+
+    TEST_METHOD(TestValidators)
+    {
+        MockFileSystem mockFileSystem;
+        FileLocalStorage storage(mockFileSystem);
+
+        Http::Validators pValidators;
+        pValidators.ETag = "\"abc123\"";
+        pValidators.LastModified = "Wed, 21 Oct 2015 07:28:00 GMT";
+
+        // validators without data are ignored
+        storage.SetValidators(ra::services::StorageItemType::GameData, L"12345", pValidators);
+        Assert::IsTrue(storage.GetValidators(ra::services::StorageItemType::GameData, L"12345").IsEmpty());
+
+        mockFileSystem.MockFile(L".\\RACache\\Data\\12345.json", "{}");
+        const auto pStored = storage.GetValidators(ra::services::StorageItemType::GameData, L"12345");
+        Assert::AreEqual(std::string("\"abc123\""), pStored.ETag);
+        Assert::AreEqual(std::string("Wed, 21 Oct 2015 07:28:00 GMT"), pStored.LastModified);
+        Assert::IsTrue(storage.GetValidators(ra::services::StorageItemType::CodeNotes, L"12345").IsEmpty());
+
+        // empty validators remove the record
+        storage.SetValidators(ra::services::StorageItemType::GameData, L"12345", {});
+        Assert::IsTrue(storage.GetValidators(ra::services::StorageItemType::GameData, L"12345").IsEmpty());
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\RACache\\Data\\12345.json.etag"));
+    }
 };
 
 } // namespace tests
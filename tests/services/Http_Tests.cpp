@@ -152,10 +152,75 @@ public:
             bCallbackCalled = true;
         });
 
+        // downloads should not delay other requests
         Assert::IsFalse(bCallbackCalled);
+        Assert::AreEqual(ra::services::TaskPriority::Low, mockThreadPool.NextTaskPriority());
         mockThreadPool.ExecuteNextTask();
         Assert::IsTrue(bCallbackCalled);
     }
+
+    TEST_METHOD(TestCallValidators)
+    {
+        MockHttpRequester mockHttp([](const Http::Request& request)
+        {
+            Assert::AreEqual(std::string("\"v1\""), request.GetValidators().ETag);
+
+            Http::Validators pValidators;
+            pValidators.ETag = "\"v2\"";
+            pValidators.LastModified = "Wed, 21 Oct 2015 07:28:00 GMT";
+            return Http::Response(Http::StatusCode::OK, "Hello", pValidators);
+        });
+
+        Http::Validators pValidators;
+        pValidators.ETag = "\"v1\"";
+        Http::Request request("foo.com");
+        request.SetValidators(pValidators);
+        auto response = request.Call();
+
+        Assert::AreEqual(Http::StatusCode::OK, response.StatusCode());
+        Assert::AreEqual(std::string("Hello"), response.Content());
+        Assert::AreEqual(std::string("\"v2\""), response.GetValidators().ETag);
+        Assert::AreEqual(std::string("Wed, 21 Oct 2015 07:28:00 GMT"), response.GetValidators().LastModified);
+    }
+
+    TEST_METHOD(TestDownloadNotModified)
+    {
+        MockFileSystem mockFileSystem;
+        mockFileSystem.MockFile(L".\\test.txt", "Hello");
+        MockHttpRequester mockHttp([](const Http::Request&)
+        {
+            return Http::Response(Http::StatusCode::NotModified, "");
+        });
+
+        Http::Validators pValidators;
+        pValidators.ETag = "\"v1\"";
+        Http::Request request("foo.com");
+        request.SetValidators(pValidators);
+        auto response = request.Download(L".\\test.txt");
+
+        // existing file is kept
+        Assert::AreEqual(Http::StatusCode::NotModified, response.StatusCode());
+        Assert::AreEqual(std::string("Hello"), mockFileSystem.GetFileContents(L".\\test.txt"));
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\test.txt.tmp"));
+    }
+
+    TEST_METHOD(TestDownloadError)
+    {
+        MockFileSystem mockFileSystem;
+        mockFileSystem.MockFile(L".\\test.txt", "Hello");
+        MockHttpRequester mockHttp([](const Http::Request&)
+        {
+            return Http::Response(Http::StatusCode::NotFound, "Not Found");
+        });
+
+        Http::Request request("foo.com");
+        auto response = request.Download(L".\\test.txt");
+
+        // existing file is not overwritten by the error
+        Assert::AreEqual(Http::StatusCode::NotFound, response.StatusCode());
+        Assert::AreEqual(std::string("Hello"), mockFileSystem.GetFileContents(L".\\test.txt"));
+        Assert::AreEqual(-1LL, mockFileSystem.GetFileSize(L".\\test.txt.tmp"));
+    }
 };
 
 } // namespace tests
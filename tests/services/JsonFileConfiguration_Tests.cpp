@@ -143,6 +143,11 @@ public:
         TestFeature(ra::services::Feature::PreferDecimal, "Prefer Decimal", false);
     }
 
+    TEST_METHOD(TestParallelEvaluation)
+    {
+        TestFeature(ra::services::Feature::ParallelEvaluation, "Parallel Evaluation", false);
+    }
+
     TEST_METHOD(TestHostNameNoFile)
     {
         MockFileSystem mockFileSystem;
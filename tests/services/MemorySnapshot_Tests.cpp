@@ -0,0 +1,90 @@
+#include "services\MemorySnapshot.hh"
+
+#include "RA_MemManager.h"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(MemorySnapshot_Tests)
+{
+private:
+    static rc_trigger_t* ParseTrigger(const char* sTrigger, std::vector<unsigned char>& pBuffer)
+    {
+        Expects(sTrigger != nullptr);
+
+        const auto nSize = rc_trigger_size(sTrigger);
+        Expects(nSize > 0);
+        pBuffer.resize(to_unsigned(nSize));
+
+        return rc_parse_trigger(pBuffer.data(), sTrigger, nullptr, 0);
+    }
+
+    static std::vector<const rc_memref_value_t*> GetMemRefs(const rc_trigger_t* pTrigger)
+    {
+        std::vector<const rc_memref_value_t*> vMemRefs;
+        for (const auto* pMemRef = pTrigger->memrefs; pMemRef != nullptr; pMemRef = pMemRef->next)
+            vMemRefs.push_back(pMemRef);
+
+        return vMemRefs;
+    }
+
+public:
+    TEST_METHOD(TestCapture)
+    {
+        std::array<unsigned char, 64> memory{};
+        for (size_t i = 0; i < memory.size(); ++i)
+            memory.at(i) = gsl::narrow_cast<unsigned char>(i);
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        const auto* pTrigger = ParseTrigger("0xH0004=1_0x 0010=2_0xX0030=3", pBuffer);
+
+        MemorySnapshot pSnapshot;
+        pSnapshot.SetMemRefs(GetMemRefs(pTrigger), gsl::narrow_cast<unsigned int>(memory.size()));
+        Assert::AreEqual(64U, pSnapshot.GetMemorySize());
+        pSnapshot.Capture();
+
+        Assert::AreEqual(0x04U, MemorySnapshot::Peek(0x04, 1, &pSnapshot));
+        Assert::AreEqual(0x1110U, MemorySnapshot::Peek(0x10, 2, &pSnapshot));
+        Assert::AreEqual(0x33323130U, MemorySnapshot::Peek(0x30, 4, &pSnapshot));
+
+        // only the referenced memory is captured
+        Assert::AreEqual(0U, MemorySnapshot::Peek(0x08, 1, &pSnapshot));
+
+        // values are only updated by Capture
+        memory.at(0x10) = 0x99;
+        Assert::AreEqual(0x1110U, MemorySnapshot::Peek(0x10, 2, &pSnapshot));
+        pSnapshot.Capture();
+        Assert::AreEqual(0x1199U, MemorySnapshot::Peek(0x10, 2, &pSnapshot));
+    }
+
+    TEST_METHOD(TestPeekPastEndOfMemory)
+    {
+        std::array<unsigned char, 8> memory{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        const auto* pTrigger = ParseTrigger("0xX0006=1_0x 0007=2_0xH0008=3", pBuffer);
+
+        MemorySnapshot pSnapshot;
+        pSnapshot.SetMemRefs(GetMemRefs(pTrigger), gsl::narrow_cast<unsigned int>(memory.size()));
+        pSnapshot.Capture();
+
+        // the bytes that are in memory are read, the rest are 0, the same as the live reader
+        Assert::AreEqual(rc_peek_callback(6, 4, nullptr), MemorySnapshot::Peek(6, 4, &pSnapshot));
+        Assert::AreEqual(0x0706U, MemorySnapshot::Peek(6, 4, &pSnapshot));
+        Assert::AreEqual(rc_peek_callback(7, 2, nullptr), MemorySnapshot::Peek(7, 2, &pSnapshot));
+        Assert::AreEqual(0x07U, MemorySnapshot::Peek(7, 2, &pSnapshot));
+        Assert::AreEqual(rc_peek_callback(8, 1, nullptr), MemorySnapshot::Peek(8, 1, &pSnapshot));
+        Assert::AreEqual(0U, MemorySnapshot::Peek(8, 1, &pSnapshot));
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
@@ -0,0 +1,133 @@
+#include "services\MemoryTrace.hh"
+
+#include "services\impl\StringTextReader.hh"
+#include "services\impl\StringTextWriter.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(MemoryTrace_Tests)
+{
+private:
+    static rc_trigger_t* ParseTrigger(const char* sTrigger, std::vector<unsigned char>& pBuffer)
+    {
+        Expects(sTrigger != nullptr);
+
+        const auto nSize = rc_trigger_size(sTrigger);
+        Expects(nSize > 0);
+        pBuffer.resize(to_unsigned(nSize));
+
+        return rc_parse_trigger(pBuffer.data(), sTrigger, nullptr, 0);
+    }
+
+    static std::vector<const rc_memref_value_t*> GetMemRefs(const rc_trigger_t* pTrigger)
+    {
+        std::vector<const rc_memref_value_t*> vMemRefs;
+        for (const auto* pMemRef = pTrigger->memrefs; pMemRef != nullptr; pMemRef = pMemRef->next)
+            vMemRefs.push_back(pMemRef);
+
+        return vMemRefs;
+    }
+
+public:
+    TEST_METHOD(TestRoundTrip)
+    {
+        std::array<unsigned char, 64> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        const auto* pTrigger = ParseTrigger("0xH0002=1_0x 0010=2_0xX0020=3_0xM0030=1", pBuffer);
+
+        std::string sTrace;
+        {
+            impl::StringTextWriter pWriter(sTrace);
+            MemoryTraceWriter pTrace(pWriter, gsl::narrow<unsigned int>(memory.size()), 2);
+            pTrace.SetMemRefs(GetMemRefs(pTrigger));
+
+            memory.at(2) = 1;
+            memory.at(5) = 99; // not referenced
+            pTrace.WriteFrame();
+
+            memory.at(0x11) = 0x12;
+            memory.at(0x22) = 0x34;
+            pTrace.WriteFrame();
+
+            pTrace.WriteFrame();
+
+            memory.at(0x30) = 0xFF;
+            pTrace.WriteFrame(); // keyframe
+
+            Assert::AreEqual(4U, pTrace.GetFrameCount());
+        }
+
+        impl::StringTextReader pReader(sTrace);
+        MemoryTraceReader pTrace(pReader);
+        Assert::IsTrue(pTrace.ReadHeader());
+        Assert::AreEqual(64U, pTrace.GetMemorySize());
+
+        std::array<unsigned char, 64> replay{};
+        replay.fill(0xCC);
+
+        Assert::IsTrue(pTrace.ReadFrame(replay));
+        Assert::AreEqual((unsigned char)1, replay.at(2));
+        Assert::AreEqual((unsigned char)0, replay.at(5)); // keyframe clears unreferenced memory
+
+        Assert::IsTrue(pTrace.ReadFrame(replay));
+        Assert::AreEqual((unsigned char)0x12, replay.at(0x11));
+        Assert::AreEqual((unsigned char)0x34, replay.at(0x22));
+
+        Assert::IsTrue(pTrace.ReadFrame(replay));
+        Assert::AreEqual((unsigned char)0x12, replay.at(0x11));
+
+        Assert::IsTrue(pTrace.ReadFrame(replay));
+        Assert::AreEqual((unsigned char)0xFF, replay.at(0x30));
+        Assert::AreEqual((unsigned char)1, replay.at(2));
+        Assert::AreEqual((unsigned char)0x34, replay.at(0x22));
+
+        Assert::IsFalse(pTrace.ReadFrame(replay));
+        Assert::IsFalse(pTrace.HasError());
+    }
+
+    TEST_METHOD(TestUnchangedFrameIsSmall)
+    {
+        std::array<unsigned char, 16> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        const auto* pTrigger = ParseTrigger("0xH0002=1_0xH0003=1", pBuffer);
+
+        std::string sTrace;
+        impl::StringTextWriter pWriter(sTrace);
+        MemoryTraceWriter pTrace(pWriter, gsl::narrow<unsigned int>(memory.size()));
+        pTrace.SetMemRefs(GetMemRefs(pTrigger));
+        Assert::AreEqual(12U, sTrace.length());
+
+        // keyframe: type, run count, one run (address, length, two bytes)
+        pTrace.WriteFrame();
+        Assert::AreEqual(12U + 1 + 4 + 8 + 2, sTrace.length());
+        const auto nSize = sTrace.length();
+
+        // nothing changed: type and an empty run count
+        pTrace.WriteFrame();
+        Assert::AreEqual(nSize + 5, sTrace.length());
+    }
+
+    TEST_METHOD(TestCorruptTrace)
+    {
+        const std::string sTrace("RAMT"); // truncated header
+
+        impl::StringTextReader pReader(sTrace);
+        MemoryTraceReader pTrace(pReader);
+        Assert::IsFalse(pTrace.ReadHeader());
+        Assert::IsTrue(pTrace.HasError());
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
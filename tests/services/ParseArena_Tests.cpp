@@ -0,0 +1,89 @@
+#include "services\ParseArena.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(ParseArena_Tests)
+{
+private:
+    static bool IsAligned(const void* pBuffer) noexcept
+    {
+        return (reinterpret_cast<uintptr_t>(pBuffer) % alignof(std::max_align_t)) == 0;
+    }
+
+public:
+    TEST_METHOD(TestAllocateContiguous)
+    {
+        ParseArena pArena(1024);
+        auto* pFirst = static_cast<unsigned char*>(pArena.Allocate(16));
+        auto* pSecond = static_cast<unsigned char*>(pArena.Allocate(3));
+        auto* pThird = static_cast<unsigned char*>(pArena.Allocate(8));
+
+        Assert::IsTrue(IsAligned(pFirst));
+        Assert::IsTrue(IsAligned(pSecond));
+        Assert::IsTrue(IsAligned(pThird));
+
+        // buffers are placed one after another, padded for alignment
+        Assert::IsTrue(pSecond == pFirst + 16);
+        Assert::IsTrue(pThird == pSecond + alignof(std::max_align_t));
+        Assert::AreEqual(1024U, pArena.GetBytesReserved());
+    }
+
+    TEST_METHOD(TestAllocateZeroFilled)
+    {
+        ParseArena pArena(64);
+        auto* pBuffer = static_cast<unsigned char*>(pArena.Allocate(32));
+        memset(pBuffer, 0xFF, 32);
+
+        pArena.Reset();
+        pBuffer = static_cast<unsigned char*>(pArena.Allocate(32));
+        for (int i = 0; i < 32; ++i)
+            Assert::AreEqual(0, static_cast<int>(pBuffer[i]));
+    }
+
+    TEST_METHOD(TestAllocateNewChunk)
+    {
+        ParseArena pArena(64);
+        auto* pFirst = static_cast<unsigned char*>(pArena.Allocate(48));
+        auto* pSecond = static_cast<unsigned char*>(pArena.Allocate(32));
+        Assert::IsTrue(pSecond != pFirst + 48);
+        Assert::AreEqual(128U, pArena.GetBytesReserved());
+
+        // the first buffer is still valid
+        memset(pFirst, 1, 48);
+        Assert::AreEqual(0, static_cast<int>(pSecond[0]));
+    }
+
+    TEST_METHOD(TestAllocateOversized)
+    {
+        ParseArena pArena(64);
+        pArena.Allocate(16);
+        auto* pLarge = pArena.Allocate(192);
+        Assert::IsNotNull(pLarge);
+        Assert::AreEqual(64U + 192U, pArena.GetBytesReserved());
+    }
+
+    TEST_METHOD(TestResetReusesMemory)
+    {
+        ParseArena pArena(64);
+        auto* pFirst = pArena.Allocate(48);
+        auto* pSecond = pArena.Allocate(48);
+        Assert::IsTrue(pArena.GetBytesUsed() >= 96U);
+
+        pArena.Reset();
+        Assert::AreEqual(0U, pArena.GetBytesUsed());
+
+        Assert::IsTrue(pFirst == pArena.Allocate(48));
+        Assert::IsTrue(pSecond == pArena.Allocate(48));
+        Assert::AreEqual(128U, pArena.GetBytesReserved());
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
@@ -0,0 +1,144 @@
+#include "ReplayHarness.hh"
+
+#include "services\MemoryTrace.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+namespace ra {
+namespace services {
+namespace tests {
+
+bool ReplayHarness::LoadPatchData(const std::string& sJson)
+{
+    rapidjson::Document document;
+    document.Parse(sJson.c_str());
+    if (document.HasParseError() || !document.IsObject())
+        return false;
+
+    const auto& PatchData = document.HasMember("PatchData") ? document["PatchData"] : document;
+    if (!PatchData.IsObject())
+        return false;
+
+    if (PatchData.HasMember("Achievements") && PatchData["Achievements"].IsArray())
+    {
+        for (const auto& achData : PatchData["Achievements"].GetArray())
+        {
+            if (!achData.HasMember("ID") || !achData.HasMember("MemAddr") || !achData["MemAddr"].IsString())
+            {
+                ++m_nInvalidDefinitions;
+                continue;
+            }
+
+            const char* sTrigger = achData["MemAddr"].GetString();
+            const auto nSize = rc_trigger_size(sTrigger);
+            if (nSize < 0)
+            {
+                ++m_nInvalidDefinitions;
+                continue;
+            }
+
+            auto& pBuffer = m_vBuffers.emplace_back(std::make_unique<unsigned char[]>(ra::to_unsigned(nSize)));
+            auto* pTrigger = rc_parse_trigger(pBuffer.get(), sTrigger, nullptr, 0);
+            m_pRuntime.ActivateAchievement(achData["ID"].GetUint(), pTrigger);
+        }
+    }
+
+    if (PatchData.HasMember("Leaderboards") && PatchData["Leaderboards"].IsArray())
+    {
+        for (const auto& lbData : PatchData["Leaderboards"].GetArray())
+        {
+            if (!lbData.HasMember("ID") || !lbData.HasMember("Mem") || !lbData["Mem"].IsString())
+            {
+                ++m_nInvalidDefinitions;
+                continue;
+            }
+
+            const char* sDefinition = lbData["Mem"].GetString();
+            const auto nSize = rc_lboard_size(sDefinition);
+            if (nSize < 0)
+            {
+                ++m_nInvalidDefinitions;
+                continue;
+            }
+
+            auto& pBuffer = m_vBuffers.emplace_back(std::make_unique<unsigned char[]>(ra::to_unsigned(nSize)));
+            auto* pLeaderboard = rc_parse_lboard(pBuffer.get(), sDefinition, nullptr, 0);
+            m_pRuntime.ActivateLeaderboard(lbData["ID"].GetUint(), pLeaderboard);
+        }
+    }
+
+    return true;
+}
+
+_Use_decl_annotations_
+bool ReplayHarness::Run(ra::services::TextReader& pTrace, Results& pResults)
+{
+    pResults = Results();
+
+    MemoryTraceReader pReader(pTrace);
+    if (!pReader.ReadHeader())
+        return false;
+
+    m_vMemory.assign(pReader.GetMemorySize(), 0);
+    InitializeMemory(m_vMemory);
+
+    std::vector<std::chrono::nanoseconds> vFrameTimes;
+    std::chrono::nanoseconds tTotal{};
+
+    while (pReader.ReadFrame(m_vMemory))
+    {
+        const auto tStart = std::chrono::steady_clock::now();
+        const auto& vChanges = m_pRuntime.Process();
+        const auto tElapsed = std::chrono::steady_clock::now() - tStart;
+
+        vFrameTimes.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(tElapsed));
+        tTotal += vFrameTimes.back();
+
+        for (const auto& pChange : vChanges)
+        {
+            switch (pChange.nType)
+            {
+                case AchievementRuntime::ChangeType::AchievementTriggered:
+                    ++pResults.nAchievementsTriggered;
+                    pResults.vTriggeredAchievements.push_back(pChange.nId);
+                    m_pRuntime.DeactivateAchievement(pChange.nId);
+                    break;
+
+                case AchievementRuntime::ChangeType::LeaderboardStarted:
+                    ++pResults.nLeaderboardsStarted;
+                    break;
+
+                case AchievementRuntime::ChangeType::LeaderboardTriggered:
+                    ++pResults.nLeaderboardsSubmitted;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    pResults.nFrames = gsl::narrow<unsigned int>(vFrameTimes.size());
+    if (!vFrameTimes.empty())
+    {
+        std::sort(vFrameTimes.begin(), vFrameTimes.end());
+
+        const auto Percentile = [&vFrameTimes](size_t nPercent) {
+            return vFrameTimes.at((vFrameTimes.size() - 1) * nPercent / 100);
+        };
+
+        pResults.tP50 = Percentile(50);
+        pResults.tP90 = Percentile(90);
+        pResults.tP99 = Percentile(99);
+        pResults.tMax = vFrameTimes.back();
+
+        if (tTotal.count() > 0)
+            pResults.fFramesPerSecond = vFrameTimes.size() * 1000000000.0 / tTotal.count();
+    }
+
+    return !pReader.HasError();
+}
+
+} // namespace tests
+} // namespace services
+} // namespace ra
@@ -0,0 +1,67 @@
+#ifndef RA_SERVICES_TESTS_REPLAY_HARNESS_HH
+#define RA_SERVICES_TESTS_REPLAY_HARNESS_HH
+#pragma once
+
+#include "services\AchievementRuntime.hh"
+#include "services\TextReader.hh"
+
+namespace ra {
+namespace services {
+namespace tests {
+
+/// <summary>
+/// Drives an <see cref="AchievementRuntime" /> from a recorded memory trace without an emulator.
+/// </summary>
+/// <remarks>
+/// The trace is applied to a buffer registered as the only memory bank, and the runtime is processed once per
+/// frame as fast as possible. Achievements are deactivated when they trigger, mirroring the live behavior.
+/// </remarks>
+class ReplayHarness
+{
+public:
+    struct Results
+    {
+        unsigned int nFrames = 0;
+        unsigned int nAchievementsTriggered = 0;
+        unsigned int nLeaderboardsStarted = 0;
+        unsigned int nLeaderboardsSubmitted = 0;
+        double fFramesPerSecond = 0.0;
+        std::chrono::nanoseconds tP50{};
+        std::chrono::nanoseconds tP90{};
+        std::chrono::nanoseconds tP99{};
+        std::chrono::nanoseconds tMax{};
+        std::vector<unsigned int> vTriggeredAchievements; // in the order they triggered
+    };
+
+    /// <summary>
+    /// Loads the achievements and leaderboards from a patch response.
+    /// </summary>
+    /// <param name="sJson">
+    /// The full server response, or just the PatchData object as stored in the offline cache.
+    /// </param>
+    /// <returns><c>true</c> if the patch data was loaded.</returns>
+    bool LoadPatchData(const std::string& sJson);
+
+    /// <summary>
+    /// Gets the number of definitions in the patch data that could not be parsed.
+    /// </summary>
+    unsigned int GetInvalidDefinitionCount() const noexcept { return m_nInvalidDefinitions; }
+
+    /// <summary>
+    /// Replays a memory trace through the loaded achievements and leaderboards.
+    /// </summary>
+    /// <returns><c>true</c> if the entire trace was replayed, <c>false</c> if it was corrupt.</returns>
+    bool Run(ra::services::TextReader& pTrace, _Out_ Results& pResults);
+
+private:
+    AchievementRuntime m_pRuntime;
+    std::vector<std::unique_ptr<unsigned char[]>> m_vBuffers;
+    std::vector<unsigned char> m_vMemory;
+    unsigned int m_nInvalidDefinitions = 0;
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_TESTS_REPLAY_HARNESS_HH
@@ -0,0 +1,204 @@
+#include "ReplayHarness.hh"
+
+#include "services\MemoryTrace.hh"
+#include "services\impl\FileTextReader.hh"
+#include "services\impl\StringTextReader.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(ReplayHarness_Tests)
+{
+private:
+    class TraceBuilder
+    {
+    public:
+        explicit TraceBuilder(unsigned int nMemorySize)
+        {
+            Write(MemoryTrace::Magic);
+            Write(MemoryTrace::Version);
+            Write(nMemorySize);
+        }
+
+        void KeyFrame(const std::vector<unsigned char>& vMemory)
+        {
+            m_sTrace.push_back(MemoryTrace::KeyFrame);
+            Write(1U);
+            Write(0U);
+            Write(gsl::narrow<unsigned int>(vMemory.size()));
+            m_sTrace.append(vMemory.begin(), vMemory.end());
+        }
+
+        void DeltaFrame(const std::vector<std::pair<unsigned int, unsigned char>>& vChanges)
+        {
+            m_sTrace.push_back(MemoryTrace::DeltaFrame);
+            Write(gsl::narrow<unsigned int>(vChanges.size()));
+            for (const auto& pChange : vChanges)
+            {
+                Write(pChange.first);
+                Write(1U);
+                m_sTrace.push_back(static_cast<char>(pChange.second));
+            }
+        }
+
+        const std::string& Trace() const noexcept { return m_sTrace; }
+
+    private:
+        void Write(unsigned int nValue)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                m_sTrace.push_back(static_cast<char>(nValue & 0xFF));
+                nValue >>= 8;
+            }
+        }
+
+        std::string m_sTrace;
+    };
+
+    static constexpr const char* PatchData =
+        "{\"Success\":true,\"PatchData\":{\"ID\":1,\"Title\":\"Test\",\"ConsoleID\":1,"
+        "\"Achievements\":["
+            "{\"ID\":5,\"MemAddr\":\"0xH0001=1\",\"Title\":\"A\",\"Flags\":3},"
+            "{\"ID\":6,\"MemAddr\":\"0xH0002=3.2.\",\"Title\":\"B\",\"Flags\":3},"
+            "{\"ID\":7,\"MemAddr\":\"0xH0003=9\",\"Title\":\"C\",\"Flags\":3}"
+        "],\"Leaderboards\":["
+            "{\"ID\":20,\"Mem\":\"STA:0xH0000=1::CAN:0xH0000=2::SUB:0xH0000=3::VAL:0xH0004\",\"Format\":\"VALUE\"}"
+        "]}}";
+
+    static std::wstring ReadEnvironment(const wchar_t* sName)
+    {
+        wchar_t* pValue = nullptr;
+        size_t nLength = 0;
+        if (_wdupenv_s(&pValue, &nLength, sName) != 0 || pValue == nullptr)
+            return std::wstring();
+
+        std::wstring sValue(pValue);
+        free(pValue);
+        return sValue;
+    }
+
+public:
+    // Benchmark entry point: replays a recorded trace (see _RA_StartMemoryTrace) through a set's achievements and
+    // leaderboards. Set RA_REPLAY_PATCH to the patch data (server response or RACache\Data\<gameid>.json) and
+    // RA_REPLAY_TRACE to the trace file, then run this test by itself. Does nothing if they aren't set.
+    TEST_METHOD(ReplayTraceFile)
+    {
+        const auto sPatchPath = ReadEnvironment(L"RA_REPLAY_PATCH");
+        const auto sTracePath = ReadEnvironment(L"RA_REPLAY_TRACE");
+        if (sPatchPath.empty() || sTracePath.empty())
+        {
+            Logger::WriteMessage("RA_REPLAY_PATCH and RA_REPLAY_TRACE not set, nothing to replay");
+            return;
+        }
+
+        std::ifstream pPatchFile(sPatchPath, std::ios::binary);
+        Assert::IsTrue(pPatchFile.is_open(), ra::StringPrintf(L"Could not open %s", sPatchPath).c_str());
+        std::ostringstream sPatchData;
+        sPatchData << pPatchFile.rdbuf();
+
+        ReplayHarness harness;
+        Assert::IsTrue(harness.LoadPatchData(sPatchData.str()), L"Could not parse patch data");
+
+        impl::FileTextReader pTrace(sTracePath);
+        ReplayHarness::Results results;
+        const bool bCompleted = harness.Run(pTrace, results);
+
+        Logger::WriteMessage(ra::StringPrintf("%u frames, %u achievements triggered, %u leaderboards started, %u "
+                                              "submitted, %u invalid definitions",
+                                              results.nFrames, results.nAchievementsTriggered,
+                                              results.nLeaderboardsStarted, results.nLeaderboardsSubmitted,
+                                              harness.GetInvalidDefinitionCount()).c_str());
+        Logger::WriteMessage(ra::StringPrintf("%u frames/s, p50 %dns, p90 %dns, p99 %dns, max %dns",
+                                              gsl::narrow_cast<unsigned int>(results.fFramesPerSecond),
+                                              results.tP50.count(), results.tP90.count(), results.tP99.count(),
+                                              results.tMax.count()).c_str());
+
+        Assert::IsTrue(bCompleted, L"Trace is corrupt");
+    }
+
+    TEST_METHOD(TestReplay)
+    {
+        ReplayHarness harness;
+        Assert::IsTrue(harness.LoadPatchData(PatchData));
+        Assert::AreEqual(0U, harness.GetInvalidDefinitionCount());
+
+        TraceBuilder builder(8);
+        builder.KeyFrame({0, 0, 0, 0, 0, 0, 0, 0});
+        builder.DeltaFrame({{0, 1}});          // leaderboard started
+        builder.DeltaFrame({{1, 1}, {2, 3}});  // achievement 5 triggers, 6 gets first hit
+        builder.DeltaFrame({});                // achievement 6 triggers
+        builder.DeltaFrame({{0, 3}, {4, 42}}); // leaderboard submitted
+        builder.DeltaFrame({{1, 0}});
+        builder.DeltaFrame({{1, 1}});          // achievement 5 no longer active
+
+        impl::StringTextReader pTrace(builder.Trace());
+        ReplayHarness::Results results;
+        Assert::IsTrue(harness.Run(pTrace, results));
+
+        Assert::AreEqual(7U, results.nFrames);
+        Assert::AreEqual(2U, results.nAchievementsTriggered);
+        Assert::AreEqual(2U, results.vTriggeredAchievements.size());
+        Assert::AreEqual(5U, results.vTriggeredAchievements.at(0));
+        Assert::AreEqual(6U, results.vTriggeredAchievements.at(1));
+        Assert::AreEqual(1U, results.nLeaderboardsStarted);
+        Assert::AreEqual(1U, results.nLeaderboardsSubmitted);
+
+        Assert::IsTrue(results.tP50 <= results.tP90);
+        Assert::IsTrue(results.tP90 <= results.tP99);
+        Assert::IsTrue(results.tP99 <= results.tMax);
+    }
+
+    TEST_METHOD(TestReplayCachedPatchData)
+    {
+        ReplayHarness harness;
+        Assert::IsTrue(harness.LoadPatchData(
+            "{\"Achievements\":[{\"ID\":5,\"MemAddr\":\"0xH0001=1\"},{\"ID\":6}],\"Leaderboards\":[]}"));
+        Assert::AreEqual(1U, harness.GetInvalidDefinitionCount());
+
+        TraceBuilder builder(2);
+        builder.KeyFrame({0, 1});
+
+        impl::StringTextReader pTrace(builder.Trace());
+        ReplayHarness::Results results;
+        Assert::IsTrue(harness.Run(pTrace, results));
+        Assert::AreEqual(1U, results.nFrames);
+        Assert::AreEqual(1U, results.nAchievementsTriggered);
+    }
+
+    TEST_METHOD(TestReplayCorruptTrace)
+    {
+        ReplayHarness harness;
+        Assert::IsTrue(harness.LoadPatchData(PatchData));
+
+        TraceBuilder builder(8);
+        builder.KeyFrame({0, 0, 0, 0, 0, 0, 0, 0});
+        builder.DeltaFrame({{8, 1}}); // out of range
+
+        impl::StringTextReader pTrace(builder.Trace());
+        ReplayHarness::Results results;
+        Assert::IsFalse(harness.Run(pTrace, results));
+        Assert::AreEqual(1U, results.nFrames);
+    }
+
+    TEST_METHOD(TestReplayInvalidHeader)
+    {
+        ReplayHarness harness;
+        impl::StringTextReader pTrace("not a trace");
+        ReplayHarness::Results results;
+        Assert::IsFalse(harness.Run(pTrace, results));
+        Assert::AreEqual(0U, results.nFrames);
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
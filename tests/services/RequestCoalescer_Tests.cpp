@@ -0,0 +1,239 @@
+#include "CppUnitTest.h"
+
+#include "services\RequestCoalescer.hh"
+
+#include "api\FetchAchievementInfo.hh"
+#include "api\FetchCodeNotes.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include "tests\mocks\MockClock.hh"
+#include "tests\mocks\MockServer.hh"
+#include "tests\mocks\MockThreadPool.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(RequestCoalescer_Tests)
+{
+private:
+    class RequestCoalescerHarness : public RequestCoalescer
+    {
+    public:
+        RequestCoalescerHarness() noexcept : m_Override(this) {}
+
+        ra::api::mocks::MockServer mockServer;
+        ra::services::mocks::MockClock mockClock;
+        ra::services::mocks::MockThreadPool mockThreadPool;
+
+        unsigned int nCodeNotesRequests = 0;
+        unsigned int nAchievementInfoRequests = 0;
+
+        void HandleRequests(ra::api::ApiResult nResult = ra::api::ApiResult::Success)
+        {
+            mockServer.HandleRequest<ra::api::FetchCodeNotes>([this, nResult](const ra::api::FetchCodeNotes::Request& request, ra::api::FetchCodeNotes::Response& response)
+            {
+                ++nCodeNotesRequests;
+                response.Result = nResult;
+                response.Notes.push_back({ request.GameId, L"Note", "Author" });
+                return true;
+            });
+
+            mockServer.HandleRequest<ra::api::FetchAchievementInfo>([this, nResult](const ra::api::FetchAchievementInfo::Request& request, ra::api::FetchAchievementInfo::Response& response)
+            {
+                ++nAchievementInfoRequests;
+                response.Result = nResult;
+                response.EarnedBy = request.AchievementId;
+                return true;
+            });
+        }
+
+    private:
+        ra::services::ServiceLocator::ServiceOverride<ra::services::RequestCoalescer> m_Override;
+    };
+
+    static void FetchCodeNotes(unsigned int nGameId, unsigned int& nCallbacks, unsigned int& nAddress)
+    {
+        ra::api::FetchCodeNotes::Request request;
+        request.GameId = nGameId;
+        request.CallAsync([&nCallbacks, &nAddress](const ra::api::FetchCodeNotes::Response& response)
+        {
+            ++nCallbacks;
+            nAddress = response.Notes.at(0).Address;
+        });
+    }
+
+    static void FetchAchievementInfo(unsigned int nAchievementId, unsigned int& nCallbacks, unsigned int& nEarnedBy)
+    {
+        ra::api::FetchAchievementInfo::Request request;
+        request.AchievementId = nAchievementId;
+        request.CallAsync([&nCallbacks, &nEarnedBy](const ra::api::FetchAchievementInfo::Response& response)
+        {
+            ++nCallbacks;
+            nEarnedBy = response.EarnedBy;
+        });
+    }
+
+public:
+    TEST_METHOD(TestIdenticalRequestsShareResponse)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests();
+
+        unsigned int nCallbacks = 0, nAddress1 = 0, nAddress2 = 0;
+        FetchCodeNotes(1234U, nCallbacks, nAddress1);
+        FetchCodeNotes(1234U, nCallbacks, nAddress2);
+
+        // only the first request should be queued
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(coalescer.mockThreadPool.PendingTasks()));
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        Assert::AreEqual(1U, coalescer.nCodeNotesRequests);
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(1234U, nAddress1);
+        Assert::AreEqual(1234U, nAddress2);
+    }
+
+    TEST_METHOD(TestDifferentRequestsNotShared)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests();
+
+        unsigned int nCallbacks = 0, nAddress1 = 0, nAddress2 = 0;
+        FetchCodeNotes(1234U, nCallbacks, nAddress1);
+        FetchCodeNotes(5678U, nCallbacks, nAddress2);
+
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(coalescer.mockThreadPool.PendingTasks()));
+        coalescer.mockThreadPool.ExecuteNextTask();
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        Assert::AreEqual(2U, coalescer.nCodeNotesRequests);
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(1234U, nAddress1);
+        Assert::AreEqual(5678U, nAddress2);
+    }
+
+    TEST_METHOD(TestCompletedRequestNotCached)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests();
+
+        unsigned int nCallbacks = 0, nAddress = 0;
+        FetchCodeNotes(1234U, nCallbacks, nAddress);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        // code notes can be modified, so a new request should be sent once the first completes
+        FetchCodeNotes(1234U, nCallbacks, nAddress);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        Assert::AreEqual(2U, coalescer.nCodeNotesRequests);
+        Assert::AreEqual(2U, nCallbacks);
+    }
+
+    TEST_METHOD(TestCachedResponse)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests();
+
+        unsigned int nCallbacks = 0, nEarnedBy = 0;
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(1U, nCallbacks);
+
+        // the cached response should still be provided asynchronously
+        nEarnedBy = 0;
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        Assert::AreEqual(1U, nCallbacks);
+        coalescer.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(55U, nEarnedBy);
+        Assert::AreEqual(1U, coalescer.nAchievementInfoRequests);
+
+        // after the cache expires, a new request should be sent
+        coalescer.mockClock.AdvanceTime(std::chrono::seconds(31));
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(3U, nCallbacks);
+        Assert::AreEqual(2U, coalescer.nAchievementInfoRequests);
+    }
+
+    TEST_METHOD(TestFailedResponseNotCached)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests(ra::api::ApiResult::Error);
+
+        unsigned int nCallbacks = 0, nEarnedBy = 0;
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(2U, coalescer.nAchievementInfoRequests);
+    }
+
+    TEST_METHOD(TestExceptionCompletesRequest)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.mockServer.HandleRequest<ra::api::FetchAchievementInfo>([](const ra::api::FetchAchievementInfo::Request&, ra::api::FetchAchievementInfo::Response&) -> bool
+        {
+            throw std::runtime_error("Connection lost");
+        });
+
+        unsigned int nCallbacks = 0;
+        std::string sError1, sError2;
+        auto fRequest = [&nCallbacks](std::string& sError)
+        {
+            ra::api::FetchAchievementInfo::Request request;
+            request.AchievementId = 55U;
+            request.CallAsync([&nCallbacks, &sError](const ra::api::FetchAchievementInfo::Response& response)
+            {
+                ++nCallbacks;
+                Assert::AreEqual(ra::api::ApiResult::Error, response.Result);
+                sError = response.ErrorMessage;
+            });
+        };
+
+        fRequest(sError1);
+        fRequest(sError2);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        // both requests should be told about the failure
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(std::string("Connection lost"), sError1);
+        Assert::AreEqual(std::string("Connection lost"), sError2);
+
+        // and the failed request should no longer be in flight
+        coalescer.HandleRequests();
+        unsigned int nEarnedBy = 0;
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(coalescer.mockThreadPool.PendingTasks()));
+        coalescer.mockThreadPool.ExecuteNextTask();
+        Assert::AreEqual(3U, nCallbacks);
+        Assert::AreEqual(55U, nEarnedBy);
+    }
+
+    TEST_METHOD(TestClearCache)
+    {
+        RequestCoalescerHarness coalescer;
+        coalescer.HandleRequests();
+
+        unsigned int nCallbacks = 0, nEarnedBy = 0;
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        coalescer.ClearCache();
+        FetchAchievementInfo(55U, nCallbacks, nEarnedBy);
+        coalescer.mockThreadPool.ExecuteNextTask();
+
+        Assert::AreEqual(2U, nCallbacks);
+        Assert::AreEqual(2U, coalescer.nAchievementInfoRequests);
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
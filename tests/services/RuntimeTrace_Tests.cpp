@@ -0,0 +1,160 @@
+#include "services\RuntimeTrace.hh"
+
+#include "RA_MemManager.h"
+
+#include "services\impl\StringTextWriter.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(RuntimeTrace_Tests)
+{
+private:
+    static rc_trigger_t* ParseTrigger(const char* sTrigger, std::vector<unsigned char>& pBuffer)
+    {
+        Expects(sTrigger != nullptr);
+
+        const auto nSize = rc_trigger_size(sTrigger);
+        Expects(nSize > 0);
+        pBuffer.resize(to_unsigned(nSize));
+
+        return rc_parse_trigger(pBuffer.data(), sTrigger, nullptr, 0);
+    }
+
+public:
+    TEST_METHOD(TestRecord)
+    {
+        std::array<unsigned char, 2> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1.3._R:0xH0001=1S0xH0001=2", pBuffer);
+        RuntimeTrace trace(7U, *pTrigger);
+        Assert::AreEqual(7U, trace.GetId());
+        Assert::AreEqual(3U, trace.GetConditionCount());
+        Assert::AreEqual(0U, trace.GetFrameCount());
+
+        memory.at(0) = 1;
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(1U);
+
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(2U);
+
+        memory.at(1) = 1;
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(3U);
+
+        Assert::AreEqual(3U, trace.GetFrameCount());
+        Assert::AreEqual(3U, trace.GetFrame(0));
+        Assert::AreEqual(1U, trace.GetFrame(2));
+
+        // frame 1: first condition true and hit
+        Assert::IsTrue(trace.IsTrue(2, 0));
+        Assert::IsFalse(trace.IsTrue(2, 1));
+        Assert::IsFalse(trace.IsTrue(2, 2));
+        Assert::AreEqual(1, trace.GetHitDelta(2, 0));
+        Assert::AreEqual(0, trace.GetHitDelta(2, 1));
+
+        // frame 3: ResetIf is true, so the accumulated hits are discarded
+        Assert::IsTrue(trace.IsTrue(0, 0));
+        Assert::IsTrue(trace.IsTrue(0, 1));
+        Assert::IsFalse(trace.IsTrue(0, 2));
+        Assert::AreEqual(-2, trace.GetHitDelta(0, 0));
+    }
+
+    TEST_METHOD(TestAddSource)
+    {
+        std::array<unsigned char, 2> memory{ 1, 2 };
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("A:0xH0000=0_0xH0001=3", pBuffer);
+        RuntimeTrace trace(1U, *pTrigger);
+
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(1U);
+        Assert::IsFalse(trace.IsTrue(0, 0));
+        Assert::IsTrue(trace.IsTrue(0, 1));
+    }
+
+    TEST_METHOD(TestWrapAround)
+    {
+        std::array<unsigned char, 1> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1", pBuffer);
+        RuntimeTrace trace(1U, *pTrigger, 4U);
+
+        for (unsigned int nFrame = 1; nFrame <= 10; ++nFrame)
+        {
+            memory.at(0) = (nFrame % 2) ? 1 : 0;
+            rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+            trace.Record(nFrame);
+        }
+
+        Assert::AreEqual(4U, trace.GetFrameCount());
+        Assert::AreEqual(10U, trace.GetFrame(0));
+        Assert::AreEqual(7U, trace.GetFrame(3));
+        Assert::IsFalse(trace.IsTrue(0, 0));
+        Assert::IsTrue(trace.IsTrue(1, 0));
+        Assert::AreEqual(0, trace.GetHitDelta(0, 0));
+        Assert::AreEqual(1, trace.GetHitDelta(1, 0));
+
+        trace.Clear();
+        Assert::AreEqual(0U, trace.GetFrameCount());
+    }
+
+    TEST_METHOD(TestManyConditions)
+    {
+        std::array<unsigned char, 1> memory{ 1 };
+        InitializeMemory(memory);
+
+        // more than eight conditions spill into a second byte of truth values
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1_0xH0000=1_0xH0000=1_0xH0000=1_0xH0000=1_"
+                                      "0xH0000=1_0xH0000=1_0xH0000=1_0xH0000=2_0xH0000=1", pBuffer);
+        RuntimeTrace trace(1U, *pTrigger);
+        Assert::AreEqual(10U, trace.GetConditionCount());
+
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(1U);
+        Assert::IsTrue(trace.IsTrue(0, 7));
+        Assert::IsFalse(trace.IsTrue(0, 8));
+        Assert::IsTrue(trace.IsTrue(0, 9));
+    }
+
+    TEST_METHOD(TestWrite)
+    {
+        std::array<unsigned char, 2> memory{};
+        InitializeMemory(memory);
+
+        std::vector<unsigned char> pBuffer;
+        auto* pTrigger = ParseTrigger("0xH0000=1_0xH0001=1", pBuffer);
+        RuntimeTrace trace(12U, *pTrigger);
+
+        memory.at(0) = 1;
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(5U);
+
+        memory.at(1) = 1;
+        rc_test_trigger(pTrigger, rc_peek_callback, nullptr, nullptr);
+        trace.Record(6U);
+
+        std::string sOutput;
+        ra::services::impl::StringTextWriter pWriter(sOutput);
+        trace.Write(pWriter);
+
+        Assert::AreEqual(std::string("12:2:2\n5:10:1,0\n6:11:1,1\n"), sOutput);
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
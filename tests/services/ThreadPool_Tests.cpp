@@ -0,0 +1,194 @@
+#include "CppUnitTest.h"
+
+#include "services\impl\ThreadPool.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include "tests\mocks\MockClock.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(ThreadPool_Tests)
+{
+private:
+    // drives the scheduler directly instead of starting threads so the order tasks are started in is deterministic
+    class ThreadPoolHarness : public ThreadPool
+    {
+    public:
+        explicit ThreadPoolHarness(size_t nThreads) noexcept { SetThreadCount(nThreads); }
+
+        ra::services::mocks::MockClock mockClock;
+
+        void Queue(TaskPriority nPriority, int nId)
+        {
+            Enqueue(nPriority, [this, nId]() { m_nLastStarted = nId; });
+        }
+
+        // starts the next task and returns its id, or 0 if nothing can be started
+        int StartNext()
+        {
+            QueuedTask pTask;
+            size_t nPriority = 0;
+            if (!TakeNextTask(pTask, nPriority))
+                return 0;
+
+            pTask.fTask();
+            m_mRunning.insert_or_assign(m_nLastStarted, nPriority);
+            return m_nLastStarted;
+        }
+
+        void Finish(int nId)
+        {
+            const auto pIter = m_mRunning.find(nId);
+            Assert::IsTrue(pIter != m_mRunning.end(), L"Task not running");
+            CompleteTask(pIter->second);
+            m_mRunning.erase(pIter);
+        }
+
+    private:
+        int m_nLastStarted = 0;
+        std::map<int, size_t> m_mRunning;
+    };
+
+public:
+    TEST_METHOD(TestStartedInPriorityOrder)
+    {
+        ThreadPoolHarness pool(8);
+        pool.Queue(TaskPriority::Idle, 1);
+        pool.Queue(TaskPriority::Low, 2);
+        pool.Queue(TaskPriority::Normal, 3);
+        pool.Queue(TaskPriority::High, 4);
+        pool.Queue(TaskPriority::Critical, 5);
+        pool.Queue(TaskPriority::Normal, 6);
+
+        Assert::AreEqual(5, pool.StartNext());
+        Assert::AreEqual(4, pool.StartNext());
+        Assert::AreEqual(3, pool.StartNext());
+        Assert::AreEqual(6, pool.StartNext());
+        Assert::AreEqual(2, pool.StartNext());
+        Assert::AreEqual(1, pool.StartNext());
+        Assert::AreEqual(0, pool.StartNext());
+    }
+
+    TEST_METHOD(TestSingleThreadConfigured)
+    {
+        // the pool always has at least two threads, and normal work must still be able to run
+        ThreadPoolHarness pool(1);
+        pool.Queue(TaskPriority::Normal, 1);
+        pool.Queue(TaskPriority::Normal, 2);
+
+        Assert::AreEqual(1, pool.StartNext());
+        Assert::AreEqual(0, pool.StartNext()); // the other thread is kept for critical and high priority work
+
+        pool.Queue(TaskPriority::High, 3);
+        Assert::AreEqual(3, pool.StartNext());
+
+        pool.Finish(1);
+        Assert::AreEqual(0, pool.StartNext()); // still busy with the high priority work
+
+        pool.Finish(3);
+        Assert::AreEqual(2, pool.StartNext());
+    }
+
+    TEST_METHOD(TestThreadReservedForHighPriority)
+    {
+        ThreadPoolHarness pool(4);
+        pool.Queue(TaskPriority::Normal, 1);
+        pool.Queue(TaskPriority::Low, 2);
+        pool.Queue(TaskPriority::Idle, 3);
+        pool.Queue(TaskPriority::Normal, 4);
+
+        // the per-priority limits would allow all four, but one thread has to stay free
+        Assert::AreEqual(1, pool.StartNext());
+        Assert::AreEqual(4, pool.StartNext());
+        Assert::AreEqual(2, pool.StartNext());
+        Assert::AreEqual(0, pool.StartNext());
+
+        pool.Queue(TaskPriority::Critical, 5);
+        Assert::AreEqual(5, pool.StartNext());
+
+        // the thread freed up by the normal task is the only one left, so it's still kept free
+        pool.Finish(1);
+        Assert::AreEqual(0, pool.StartNext());
+
+        pool.Finish(5);
+        Assert::AreEqual(3, pool.StartNext());
+    }
+
+    TEST_METHOD(TestLowAndIdleLimits)
+    {
+        ThreadPoolHarness pool(8);
+        for (int i = 1; i <= 5; ++i)
+            pool.Queue(TaskPriority::Low, i);
+        pool.Queue(TaskPriority::Idle, 6);
+        pool.Queue(TaskPriority::Idle, 7);
+
+        // half of the threads for low priority work
+        Assert::AreEqual(1, pool.StartNext());
+        Assert::AreEqual(2, pool.StartNext());
+        Assert::AreEqual(3, pool.StartNext());
+        Assert::AreEqual(4, pool.StartNext());
+
+        // one thread for idle work
+        Assert::AreEqual(6, pool.StartNext());
+        Assert::AreEqual(0, pool.StartNext());
+
+        pool.Finish(2);
+        Assert::AreEqual(5, pool.StartNext());
+
+        pool.Finish(6);
+        Assert::AreEqual(7, pool.StartNext());
+    }
+
+    TEST_METHOD(TestStarvedTaskStartedFirst)
+    {
+        ThreadPoolHarness pool(8);
+        pool.Queue(TaskPriority::Idle, 1);
+        pool.mockClock.AdvanceTime(std::chrono::seconds(1));
+        pool.Queue(TaskPriority::Normal, 2);
+
+        // hasn't waited long enough to jump ahead
+        Assert::AreEqual(2, pool.StartNext());
+
+        pool.Queue(TaskPriority::Normal, 3);
+        pool.mockClock.AdvanceTime(std::chrono::seconds(2));
+        pool.Queue(TaskPriority::Normal, 4);
+        pool.Queue(TaskPriority::High, 5);
+
+        // high priority work is always started first
+        Assert::AreEqual(5, pool.StartNext());
+
+        // the idle task has waited longer than the normal ones
+        Assert::AreEqual(1, pool.StartNext());
+        Assert::AreEqual(3, pool.StartNext());
+        Assert::AreEqual(4, pool.StartNext());
+    }
+
+    TEST_METHOD(TestQueueStatistics)
+    {
+        ThreadPoolHarness pool(4);
+        pool.Queue(TaskPriority::Normal, 1);
+        pool.Queue(TaskPriority::Normal, 2);
+        pool.mockClock.AdvanceTime(std::chrono::milliseconds(50));
+        Assert::AreEqual(1, pool.StartNext());
+        pool.mockClock.AdvanceTime(std::chrono::milliseconds(100));
+        Assert::AreEqual(2, pool.StartNext());
+
+        const auto pStatistics = pool.GetQueueStatistics(TaskPriority::Normal);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(pStatistics.nTasks));
+        Assert::AreEqual(200LL, static_cast<long long>(pStatistics.tTotalWait.count()));
+        Assert::AreEqual(150LL, static_cast<long long>(pStatistics.tMaxWait.count()));
+
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(pool.GetQueueStatistics(TaskPriority::High).nTasks));
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace services
+} // namespace ra
@@ -0,0 +1,256 @@
+#include "CppUnitTest.h"
+
+#include "services\impl\WindowsHttpRequester.hh"
+
+#include "services\impl\StringTextWriter.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+#include "tests\mocks\MockClock.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using ra::services::mocks::MockClock;
+
+namespace ra {
+namespace services {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(WindowsHttpRequester_Tests)
+{
+private:
+    // hands out fake handles and remembers which are still open, so no network access is needed
+    class MockTransport : public WindowsHttpRequester::Transport
+    {
+    public:
+        Handle OpenSession(const std::wstring&, unsigned int& nStatusCode) const override
+        {
+            ++nSessionsOpened;
+            if (nSessionError != 0)
+            {
+                nStatusCode = nSessionError;
+                return nullptr;
+            }
+
+            return Open(L"");
+        }
+
+        void SetMaxConnectionsPerServer(Handle, unsigned int) const noexcept override {}
+
+        Handle Connect(Handle hSession, const std::wstring& sHostName, unsigned int& nStatusCode) const override
+        {
+            Assert::IsTrue(IsOpen(hSession), L"Session not open");
+
+            if (nConnectError != 0)
+            {
+                nStatusCode = nConnectError;
+                return nullptr;
+            }
+
+            return Open(sHostName);
+        }
+
+        unsigned int Send(Handle hConnect, const std::wstring& sPath, const Http::Request&,
+                          TextWriter& pContentWriter, Http::Validators&) const override
+        {
+            Assert::IsTrue(IsOpen(hConnect), L"Connection not open");
+
+            vSent.emplace_back(m_mOpen.at(hConnect) + L"/" + sPath);
+            vSentOn.push_back(hConnect);
+            if (nSendStatus == 200)
+                pContentWriter.Write("OK");
+
+            return nSendStatus;
+        }
+
+        void Close(Handle hHandle) const noexcept override
+        {
+            m_mOpen.erase(hHandle);
+        }
+
+        bool IsOpen(Handle hHandle) const { return m_mOpen.find(hHandle) != m_mOpen.end(); }
+        size_t OpenHandles() const noexcept { return m_mOpen.size(); }
+
+        unsigned int nSessionError = 0;
+        unsigned int nConnectError = 0;
+        unsigned int nSendStatus = 200;
+
+        mutable unsigned int nSessionsOpened = 0;
+        mutable std::vector<std::wstring> vSent;
+        mutable std::vector<Handle> vSentOn;
+
+    private:
+        Handle Open(const std::wstring& sHostName) const
+        {
+            Handle hHandle = &m_pHandles.at(m_nNextHandle++);
+            m_mOpen.emplace(hHandle, sHostName);
+            return hHandle;
+        }
+
+        mutable std::array<char, 32> m_pHandles{};
+        mutable size_t m_nNextHandle = 0;
+        mutable std::map<Handle, std::wstring> m_mOpen;
+    };
+
+    class WindowsHttpRequesterHarness
+    {
+    public:
+        MockClock mockClock;
+        std::shared_ptr<MockTransport> pMockTransport = std::make_shared<MockTransport>();
+        MockTransport& mockTransport = *pMockTransport;
+        WindowsHttpRequester requester{pMockTransport};
+
+        unsigned int Get(const std::string& sUrl)
+        {
+            Http::Request request(sUrl);
+            std::string sContent;
+            StringTextWriter pWriter(sContent);
+            Http::Validators pValidators;
+            return requester.Request(request, pWriter, pValidators);
+        }
+    };
+
+public:
+    TEST_METHOD(TestConnectionReused)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php?r=patch"));
+
+        Assert::AreEqual(1U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles())); // session + connection
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.vSent.size()));
+        Assert::AreEqual(std::wstring(L"host.com/dorequest.php"), harness.mockTransport.vSent.at(0));
+        Assert::AreEqual(std::wstring(L"host.com/dorequest.php?r=patch"), harness.mockTransport.vSent.at(1));
+        Assert::IsTrue(harness.mockTransport.vSentOn.at(0) == harness.mockTransport.vSentOn.at(1), L"Connection not reused");
+    }
+
+    TEST_METHOD(TestConnectionPerHost)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(200U, harness.Get("https://media.host.com/Badge/12345.png"));
+        Assert::AreEqual(200U, harness.Get("http://host.com/login_app.php"));
+
+        Assert::AreEqual(1U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(3U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles())); // session + two connections
+        Assert::AreEqual(std::wstring(L"media.host.com/Badge/12345.png"), harness.mockTransport.vSent.at(1));
+        Assert::IsFalse(harness.mockTransport.vSentOn.at(0) == harness.mockTransport.vSentOn.at(1), L"Connection shared between hosts");
+        Assert::IsTrue(harness.mockTransport.vSentOn.at(0) == harness.mockTransport.vSentOn.at(2), L"Connection not reused");
+    }
+
+    TEST_METHOD(TestSessionOpenFailed)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        harness.mockTransport.nSessionError = 12007;
+        Assert::AreEqual(12007U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+        Assert::IsTrue(harness.mockTransport.vSent.empty());
+
+        // the next request should try again
+        harness.mockTransport.nSessionError = 0;
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+    }
+
+    TEST_METHOD(TestConnectFailedNotKept)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        harness.mockTransport.nConnectError = 12029;
+        Assert::AreEqual(12029U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles())); // just the session
+        Assert::IsTrue(harness.mockTransport.vSent.empty());
+
+        // the failed connection isn't remembered, so the next request connects again
+        harness.mockTransport.nConnectError = 0;
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(1U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+        Assert::AreEqual(1U, gsl::narrow_cast<unsigned int>(harness.mockTransport.vSent.size()));
+    }
+
+    TEST_METHOD(TestSendFailedReleasesSession)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        harness.mockTransport.nSendStatus = 12002;
+        Assert::AreEqual(12002U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+
+        // the failed request must not keep the idle session alive
+        harness.mockClock.AdvanceTime(std::chrono::seconds(61));
+        harness.mockTransport.nSendStatus = 200;
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+        Assert::IsFalse(harness.mockTransport.IsOpen(harness.mockTransport.vSentOn.at(0)), L"Old connection not closed");
+    }
+
+    TEST_METHOD(TestIdleSessionReplaced)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(200U, harness.Get("http://media.host.com/Badge/12345.png"));
+        Assert::AreEqual(3U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+
+        // not idle long enough
+        harness.mockClock.AdvanceTime(std::chrono::seconds(60));
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(1U, harness.mockTransport.nSessionsOpened);
+
+        // idle too long. the old session and all of its connections are closed
+        harness.mockClock.AdvanceTime(std::chrono::seconds(61));
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, harness.mockTransport.nSessionsOpened);
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+        Assert::IsFalse(harness.mockTransport.IsOpen(harness.mockTransport.vSentOn.at(0)), L"Old connection not closed");
+        Assert::IsFalse(harness.mockTransport.IsOpen(harness.mockTransport.vSentOn.at(1)), L"Old connection not closed");
+        Assert::IsTrue(harness.mockTransport.IsOpen(harness.mockTransport.vSentOn.at(3)), L"New connection not open");
+    }
+
+    TEST_METHOD(TestSetUserAgentClosesSession)
+    {
+        WindowsHttpRequesterHarness harness;
+
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+
+        harness.requester.SetUserAgent("RetroAchievements Toolkit 1.0");
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(harness.mockTransport.OpenHandles()));
+
+        Assert::AreEqual(200U, harness.Get("http://host.com/dorequest.php"));
+        Assert::AreEqual(2U, harness.mockTransport.nSessionsOpened);
+    }
+
+    TEST_METHOD(TestHandlesClosedWhenDestroyed)
+    {
+        MockClock mockClock;
+        auto pTransport = std::make_shared<MockTransport>();
+        {
+            WindowsHttpRequester requester(pTransport);
+
+            Http::Request request("http://host.com/dorequest.php");
+            std::string sContent;
+            StringTextWriter pWriter(sContent);
+            Http::Validators pValidators;
+            Assert::AreEqual(200U, requester.Request(request, pWriter, pValidators));
+            Assert::AreEqual(std::string("OK"), sContent);
+            Assert::AreEqual(2U, gsl::narrow_cast<unsigned int>(pTransport->OpenHandles()));
+        }
+
+        // the requester has gone away, but the transport is still shared with the test
+        Assert::AreEqual(0U, gsl::narrow_cast<unsigned int>(pTransport->OpenHandles()));
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace services
+} // namespace ra
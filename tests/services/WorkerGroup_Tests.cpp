@@ -0,0 +1,63 @@
+#include "services\WorkerGroup.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(WorkerGroup_Tests)
+{
+private:
+    static void Increment(size_t nIndex, void* pContext) noexcept
+    {
+        auto* vCounts = static_cast<std::vector<unsigned int>*>(pContext);
+        ++vCounts->at(nIndex);
+    }
+
+    static void AssertEachProcessedOnce(WorkerGroup& pGroup, size_t nCount)
+    {
+        std::vector<unsigned int> vCounts(nCount);
+        pGroup.ForEach(nCount, Increment, &vCounts);
+
+        for (size_t nIndex = 0; nIndex < nCount; ++nIndex)
+            Assert::AreEqual(1U, vCounts.at(nIndex), std::to_wstring(nIndex).c_str());
+    }
+
+public:
+    TEST_METHOD(TestSingleWorker)
+    {
+        WorkerGroup pGroup(1);
+        Assert::AreEqual(1U, pGroup.GetWorkerCount());
+        AssertEachProcessedOnce(pGroup, 10);
+    }
+
+    TEST_METHOD(TestMultipleWorkers)
+    {
+        WorkerGroup pGroup(4);
+        Assert::AreEqual(4U, pGroup.GetWorkerCount());
+        AssertEachProcessedOnce(pGroup, 1000);
+    }
+
+    TEST_METHOD(TestFewerItemsThanWorkers)
+    {
+        WorkerGroup pGroup(4);
+        AssertEachProcessedOnce(pGroup, 0);
+        AssertEachProcessedOnce(pGroup, 1);
+        AssertEachProcessedOnce(pGroup, 3);
+    }
+
+    TEST_METHOD(TestRepeatedDispatch)
+    {
+        // simulates the per-frame barrier
+        WorkerGroup pGroup(3);
+        for (int i = 0; i < 500; ++i)
+            AssertEachProcessedOnce(pGroup, 100);
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
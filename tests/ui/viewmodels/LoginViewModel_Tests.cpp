@@ -8,12 +8,14 @@
 #include "tests\mocks\MockEmulatorContext.hh"
 #include "tests\mocks\MockServer.hh"
 #include "tests\mocks\MockSessionTracker.hh"
+#include "tests\mocks\MockSubmissionJournal.hh"
 #include "tests\mocks\MockUserContext.hh"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using ra::api::mocks::MockServer;
 using ra::data::mocks::MockEmulatorContext;
 using ra::data::mocks::MockSessionTracker;
+using ra::data::mocks::MockSubmissionJournal;
 using ra::data::mocks::MockUserContext;
 using ra::services::mocks::MockConfiguration;
 using ra::ui::mocks::MockDesktop;
@@ -37,6 +39,7 @@ private:
         MockUserContext mockUserContext;
         MockEmulatorContext mockEmulatorContext;
         MockSessionTracker mockSessionTracker;
+        MockSubmissionJournal mockSubmissionJournal;
     };
 
 public:
@@ -130,6 +133,7 @@ public:
 
         // session tracker should know user name
         Assert::AreEqual(std::wstring(L"User"), vmLogin.mockSessionTracker.GetUsername());
+        Assert::AreEqual(std::wstring(L"User"), vmLogin.mockSubmissionJournal.GetUsername());
 
         // emulator should have been notified to rebuild the RetroAchievements menu
         Assert::IsTrue(bWasMenuRebuilt);
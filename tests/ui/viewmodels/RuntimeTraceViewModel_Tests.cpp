@@ -0,0 +1,103 @@
+#include "CppUnitTest.h"
+
+#include "ui\viewmodels\RuntimeTraceViewModel.hh"
+
+#include "services\AchievementRuntime.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+#include "tests\mocks\MockGameContext.hh"
+#include "tests\mocks\MockLocalStorage.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using ra::data::mocks::MockGameContext;
+using ra::services::StorageItemType;
+using ra::services::mocks::MockLocalStorage;
+
+namespace ra {
+namespace ui {
+namespace viewmodels {
+namespace tests {
+
+TEST_CLASS(RuntimeTraceViewModel_Tests)
+{
+private:
+    class AchievementRuntimeHarness : public ra::services::AchievementRuntime
+    {
+    public:
+        AchievementRuntimeHarness() noexcept : m_Override(this) {}
+
+    private:
+        ra::services::ServiceLocator::ServiceOverride<ra::services::AchievementRuntime> m_Override;
+    };
+
+public:
+    TEST_METHOD(TestNoHistory)
+    {
+        MockGameContext mockGameContext;
+        MockLocalStorage mockLocalStorage;
+        AchievementRuntimeHarness runtime;
+
+        RuntimeTraceViewModel vmRuntimeTrace;
+        vmRuntimeTrace.Load(6U);
+        Assert::AreEqual(std::wstring(L"Achievement History - 6"), vmRuntimeTrace.GetWindowTitle());
+        Assert::AreEqual(std::wstring(L"No history has been recorded for this achievement."), vmRuntimeTrace.GetHistory());
+    }
+
+    TEST_METHOD(TestStoredHistory)
+    {
+        MockGameContext mockGameContext;
+        MockLocalStorage mockLocalStorage;
+        AchievementRuntimeHarness runtime;
+        mockLocalStorage.MockStoredData(StorageItemType::RuntimeTrace, L"6", "6:2:3\n1:00:0,0\n2:10:1,0\n13:11:-3,1\n");
+
+        RuntimeTraceViewModel vmRuntimeTrace;
+        vmRuntimeTrace.Load(6U);
+        Assert::AreEqual(std::wstring(L"Conditions are numbered through the core group followed by each alt group.\r\n"
+                                      L"T = true, . = false, n:+x = hit count of condition n changed by x\r\n\r\n"
+                                      L"         1  ..\r\n"
+                                      L"         2  T.  1:+1\r\n"
+                                      L"        13  TT  1:-3  2:+1\r\n"),
+                         vmRuntimeTrace.GetHistory());
+    }
+
+    TEST_METHOD(TestLiveHistoryPreferred)
+    {
+        std::array<unsigned char, 2> memory{};
+        InitializeMemory(memory);
+
+        MockGameContext mockGameContext;
+        MockLocalStorage mockLocalStorage;
+        AchievementRuntimeHarness runtime;
+        mockLocalStorage.MockStoredData(StorageItemType::RuntimeTrace, L"6", "6:1:1\n1:1:1\n");
+
+        std::array<unsigned char, 256> sBuffer{};
+        runtime.ActivateAchievement(6U, rc_parse_trigger(sBuffer.data(), "0xH0000=1_0xH0001=1", nullptr, 0));
+        runtime.SetTraced(6U, true);
+
+        std::vector<ra::services::AchievementRuntime::Change> vChanges;
+        runtime.Process(vChanges);
+        memory.at(0) = 1;
+        runtime.Process(vChanges);
+
+        RuntimeTraceViewModel vmRuntimeTrace;
+        vmRuntimeTrace.Load(6U);
+        Assert::AreEqual(std::wstring(L"Conditions are numbered through the core group followed by each alt group.\r\n"
+                                      L"T = true, . = false, n:+x = hit count of condition n changed by x\r\n\r\n"
+                                      L"         1  ..\r\n"
+                                      L"         2  T.  1:+1\r\n"),
+                         vmRuntimeTrace.GetHistory());
+
+        // once the achievement is deactivated, the stored history is shown
+        runtime.DeactivateAchievement(6U);
+        vmRuntimeTrace.Load(6U);
+        Assert::AreEqual(std::wstring(L"Conditions are numbered through the core group followed by each alt group.\r\n"
+                                      L"T = true, . = false, n:+x = hit count of condition n changed by x\r\n\r\n"
+                                      L"         1  T  1:+1\r\n"),
+                         vmRuntimeTrace.GetHistory());
+    }
+};
+
+} // namespace tests
+} // namespace viewmodels
+} // namespace ui
+} // namespace ra